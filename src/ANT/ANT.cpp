@@ -25,7 +25,9 @@
 
 #include "ANT.h"
 #include "ANTMessage.h"
+#include "ANTReplay.h"
 #include "TrainSidebar.h" // for RT_MODE_{ERGO,SPIN,CALIBRATE}
+#include "RealtimeController.h" // to publish telemetry
 #include <QMessageBox>
 #include <QTime>
 #include <QProgressDialog>
@@ -96,7 +98,8 @@ ANT::ANT(QObject *parent, DeviceConfiguration *devConf, QString athlete) : QThre
     trainAthlete = athlete;
 
     // device status and settings
-    Status=0;
+    Status.storeRelease(0);
+    publisher = NULL;
     deviceFilename = devConf ? devConf->portSpec : "";
     baud=115200;
     powerchannels=0;
@@ -111,6 +114,10 @@ ANT::ANT(QObject *parent, DeviceConfiguration *devConf, QString athlete) : QThre
 
     fecChannel = -1;
 
+    // capture replay
+    replay = NULL;
+    replaySpeed = 1.0;
+
     // current and desired modes/load/gradients
     // set so first time through current != desired
     currentMode = 0;
@@ -175,6 +182,7 @@ ANT::ANT(QObject *parent, DeviceConfiguration *devConf, QString athlete) : QThre
 
 ANT::~ANT()
 {
+    if (replay) delete replay;
 #if defined GC_HAVE_LIBUSB
     delete usb2;
 #endif
@@ -237,7 +245,8 @@ void ANT::run()
     int status; // control commands from controller
     powerchannels = 0;
 
-    Status = ANT_RUNNING;
+    Status.storeRelease(ANT_RUNNING);
+    published.start();
     QString strBuf;
 #if defined GC_HAVE_LIBUSB
     usbMode = USBNone;
@@ -268,13 +277,13 @@ void ANT::run()
 
     while(1)
     {
-        // read more bytes from the device
-        uint8_t byte;
+        // drain whatever the device has buffered and frame it in bulk
+        uint8_t buffer[ANT_READ_BUFFER_SIZE];
 
-        int rc = rawRead(&byte, 1);
+        int rc = rawRead(buffer, ANT_READ_BUFFER_SIZE);
 
         if (rc > 0)
-            receiveByte((unsigned char)byte);
+            receiveBytes((const unsigned char*)buffer, rc);
         else {
 
             // Recognise USB device removal. Linux transitions through -5 (I/O error)
@@ -283,7 +292,7 @@ void ANT::run()
             if ((rc == -ENXIO) || (rc == -EIO && OperatingSystem == WINDOWS))
             {
                 qDebug() << "Error communicating with USB ANT device!! Device removed?";
-                Status = 0;
+                Status.storeRelease(0);
             }
 
             msleep(5);
@@ -292,9 +301,15 @@ void ANT::run()
         //----------------------------------------------------------------------
         // LISTEN TO CONTROLLER FOR COMMANDS
         //----------------------------------------------------------------------
-        pvars.lock();
-        status = this->Status;
-        pvars.unlock();
+        status = Status.loadAcquire();
+
+        // the thread owns the telemetry, so publish a copy for everyone else
+        if (publisher && (status&ANT_RUNNING) && !(status&ANT_PAUSED) && published.elapsed() >= TELEMETRY_PERIOD) {
+            RealtimeData rtData;
+            getRealtimeData(rtData);
+            publisher->publishRealtimeData(rtData);
+            published.restart();
+        }
 
         // do we have a channel to search / stop
         if (!channelQueue.isEmpty()) {
@@ -511,7 +526,7 @@ ANT::setup()
     // Error if we've not received an acknowlegement
     if (!ANT_Reset_Acknowledge) {
         qDebug() << "ANT+ reset not acknowledged, closing..";
-        Status = 0;
+        Status.storeRelease(0);
     }
 
     sendMessage(ANTMessage::setNetworkKey(1, key));
@@ -554,19 +569,10 @@ ANT::setup()
 int
 ANT::restart()
 {
-    int status;
-
-    // get current status
-    pvars.lock();
-    status = this->Status;
-    pvars.unlock();
-
     // what state are we in anyway?
+    int status = Status.loadAcquire();
     if (status&ANT_RUNNING && status&ANT_PAUSED) {
-            status &= ~ANT_PAUSED;
-            pvars.lock();
-            this->Status = status;
-            pvars.unlock();
+            Status.fetchAndAndOrdered(~ANT_PAUSED);
             return 0; // ok its running again!
     }
     return 2;
@@ -575,22 +581,14 @@ ANT::restart()
 int
 ANT::pause()
 {
-    int status;
-
     // get current status
-    pvars.lock();
-    status = this->Status;
-    pvars.unlock();
+    int status = Status.loadAcquire();
 
     if (status&ANT_PAUSED) return 2;
     else if (!(status&ANT_RUNNING)) return 4;
     else {
             // ok we're running and not paused so lets pause
-            status |= ANT_PAUSED;
-            pvars.lock();
-            this->Status = status;
-            pvars.unlock();
-
+            Status.fetchAndOrOrdered(ANT_PAUSED);
             return 0;
     }
 }
@@ -619,9 +617,7 @@ ANT::stop()
             antChannel[i]->close();
 
     // what state are we in anyway?
-    pvars.lock();
-    Status = 0; // Terminate it!
-    pvars.unlock();
+    Status.storeRelease(0); // Terminate it!
 
     //short wait before returning, resolves intermittent USB error if device restarted immediately
     msleep(125);
@@ -998,6 +994,56 @@ ANT::receiveByte(unsigned char byte) {
 }
 
 
+//
+// Frame a block of bytes read from the device, complete messages
+// sat in the block are validated and copied in one go, any message
+// that straddles two reads goes through the byte state machine
+//
+void
+ANT::receiveBytes(const unsigned char *bytes, int count) {
+
+    int i=0;
+    while (i < count) {
+
+        if (state == ST_WAIT_FOR_SYNC) {
+
+            // skip junk up to the next sync byte
+            const unsigned char *sync = (const unsigned char *)memchr(bytes+i, ANT_SYNC_BYTE, count-i);
+            if (sync == NULL) return;
+            i = sync - bytes;
+
+            if (i+1 < count) {
+
+                // bad length, same as the state machine we drop
+                // the sync and length and look for the next sync
+                int len = bytes[i+1];
+                if (len == 0 || len > ANT_MAX_LENGTH) {
+                    i += 2;
+                    continue;
+                }
+
+                // sync, length, id, data and checksum
+                int total = len + 4;
+                if (i + total <= count) {
+
+                    unsigned char sum = 0;
+                    for (int j=0; j<total-1; j++) sum ^= bytes[i+j];
+
+                    if (sum == bytes[i+total-1]) {
+                        memcpy(rxMessage, bytes+i, total-1);
+                        processMessage();
+                    }
+                    i += total;
+                    continue;
+                }
+            }
+        }
+
+        // partial message
+        receiveByte(bytes[i++]);
+    }
+}
+
 //
 // Pass inbound message to channel for handling
 //
@@ -1068,6 +1114,13 @@ ANT::processMessage(void) {
 
 int ANT::closePort()
 {
+    if (replay) {
+        replay->close();
+        delete replay;
+        replay = NULL;
+        return 0;
+    }
+
 #ifdef WIN32
 #ifdef GC_HAVE_LIBUSB
     switch (usbMode) {
@@ -1111,6 +1164,19 @@ bool ANT::find()
 
 int ANT::openPort()
 {
+    // an antlog.raw capture rather than a device
+    if (deviceFilename.endsWith(".raw")) {
+        replay = new ANTReplay();
+        if (replay->open(deviceFilename, replaySpeed)) {
+            channels = ANT_MAX_CHANNELS;
+            return 0;
+        }
+        delete replay;
+        replay = NULL;
+        channels = 0;
+        return -1;
+    }
+
 #ifdef WIN32
 #ifdef GC_HAVE_LIBUSB
     int rc;
@@ -1199,6 +1265,8 @@ int ANT::openPort()
 
 int ANT::rawWrite(uint8_t *bytes, int size) // unix!!
 {
+    if (replay) return replay->write(bytes, size);
+
 #if !GC_HAVE_LIBUSB
     Q_UNUSED(bytes);
     Q_UNUSED(size);
@@ -1255,6 +1323,8 @@ int ANT::rawWrite(uint8_t *bytes, int size) // unix!!
 
 int ANT::rawRead(uint8_t bytes[], int size)
 {
+    if (replay) return replay->read(bytes, size);
+
 #ifdef WIN32
 #ifdef GC_HAVE_LIBUSB
     switch (usbMode) {
@@ -1280,17 +1350,11 @@ int ANT::rawRead(uint8_t bytes[], int size)
         return usb2->read((char *)bytes, size);
     }
 #endif
-    int i=0;
-    uint8_t byte;
-
-    // read one byte at a time sleeping when no data ready
-    // until we timeout waiting then return error
-    for (i=0; i<size; i++) {
-        int rc = read(devicePort, &byte, 1);
-        if (rc == -1 || rc == 0) return -1; // error!
-        else bytes[i] = byte;
-    }
-    return i;
+    // the port is non-blocking so we get whatever is
+    // available up to size, or an error when there is none
+    int rc = read(devicePort, bytes, size);
+    if (rc == -1 || rc == 0) return -1; // error!
+    return rc;
 
 #endif
     return -1; // keep compiler happy.
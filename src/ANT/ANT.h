@@ -32,7 +32,7 @@
 // QT stuff
 //
 #include <QThread>
-#include <QMutex>
+#include <QAtomicInt>
 #include <QObject>
 #include <QQueue>
 #include <QStringList>
@@ -90,6 +90,8 @@
 
 class ANTMessage;
 class ANTChannel;
+class ANTReplay;
+class RealtimeController;
 
 typedef struct ant_sensor_type {
   bool user; // can user select this when calibrating ?
@@ -212,6 +214,10 @@ struct setChannelAtom {
 #define ANT_MAX_MESSAGE_SIZE 12
 #define ANT_MAX_CHANNELS     8
 
+// bytes we ask the device for on each read, the USB2 sticks
+// deliver up to 64 bytes per bulk transfer
+#define ANT_READ_BUFFER_SIZE 256
+
 // Channel messages
 #define RESPONSE_NO_ERROR               0
 #define EVENT_RX_SEARCH_TIMEOUT         1
@@ -461,9 +467,12 @@ public slots:
     void slotStopBroadcastTimer(int number);
     void slotControlTimerEvent();
 
-    // get telemetry
+    // get telemetry, only from the ANT thread when there is a publisher
     void getRealtimeData(RealtimeData &);             // return current realtime data
 
+    // the thread publishes telemetry through the controller, see TelemetryBus.h
+    void setPublisher(RealtimeController *controller) { publisher = controller; }
+
     // kickr command loading - only ANT device we know about to do this so not generic
     void setLoad(double);
     void setGradient(double);
@@ -498,6 +507,7 @@ public:
     // transmission
     void sendMessage(ANTMessage);
     void receiveByte(unsigned char byte);
+    void receiveBytes(const unsigned char *bytes, int count);
     void handleChannelEvent(void);
     void processMessage(void);
 
@@ -585,6 +595,7 @@ public:
     // serial i/o lifted from Computrainer.cpp
     void setDevice(QString devname);
     void setBaud(int baud);
+    void setReplaySpeed(double x) { replaySpeed = x; } // when device is an antlog.raw capture
     int openPort();
     int closePort();
     int rawRead(uint8_t bytes[], int size);
@@ -679,8 +690,10 @@ private:
     RealtimeData telemetry;
     CalibrationData calibration;
 
-    QMutex pvars;  // lock/unlock access to telemetry data between thread and controller
-    int Status;     // what status is the client in?
+    RealtimeController *publisher; // telemetry is published from the thread
+    QElapsedTimer published;       // since we last published
+
+    QAtomicInt Status; // what status is the client in? set by the controller
     bool configuring; // set to true if we're in configuration mode.
     int channels;  // how many 4 or 8 ? depends upon the USB stick...
 
@@ -695,6 +708,10 @@ private:
     struct termios deviceSettings;  // unix!!
 #endif
 
+    // replaying an antlog.raw capture instead of a device
+    ANTReplay *replay;
+    double replaySpeed;
+
 #if defined GC_HAVE_LIBUSB
     LibUsb *usb2;                   // used for USB2 support
     enum UsbMode { USBNone, USB1, USB2 };
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "ANTReplay.h"
+#include "ANT.h" // for message definitions
+
+#include <QFile>
+#include <QMutexLocker>
+
+// antlog.raw records are 'R' or 'S', 8 byte little endian
+// timestamp in ms and then the 12 byte message, see ANTLogger
+#define ANTLOG_RECORD_SIZE (1 + 8 + ANT_MAX_MESSAGE_SIZE)
+
+ANTReplay::ANTReplay() : next(0), pos(0), speed(1.0)
+{
+}
+
+bool
+ANTReplay::open(QString filename, double speed)
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+    QByteArray capture = file.readAll();
+    file.close();
+
+    QMutexLocker locker(&lock);
+
+    stream.clear();
+    ends.clear();
+    due.clear();
+    injected.clear();
+    next = pos = 0;
+    this->speed = speed;
+
+    qint64 first = -1;
+    const unsigned char *record = (const unsigned char *)capture.constData();
+    for (int offset=0; offset + ANTLOG_RECORD_SIZE <= capture.size(); offset += ANTLOG_RECORD_SIZE, record += ANTLOG_RECORD_SIZE) {
+
+        // we only replay what the stick sent us
+        if (record[0] != 'R') continue;
+
+        qint64 millis = 0;
+        for (int i=8; i>0; i--) millis = (millis << 8) | record[i];
+        if (first < 0) first = millis;
+
+        // the logged message has no checksum, so add it back
+        const unsigned char *message = record + 9;
+        int length = message[ANT_OFFSET_LENGTH];
+        if (message[ANT_OFFSET_SYNC] != ANT_SYNC_BYTE || length == 0 || length > ANT_MAX_LENGTH) continue;
+
+        unsigned char checksum = 0;
+        for (int i=0; i<length+3; i++) checksum ^= message[i];
+
+        stream.append((const char *)message, length+3);
+        stream.append((char)checksum);
+        ends << stream.size();
+        due << (millis - first);
+    }
+
+    timer.start();
+    return due.count() > 0;
+}
+
+void
+ANTReplay::close()
+{
+    QMutexLocker locker(&lock);
+
+    stream.clear();
+    ends.clear();
+    due.clear();
+    injected.clear();
+    next = pos = 0;
+}
+
+bool
+ANTReplay::atEnd()
+{
+    QMutexLocker locker(&lock);
+    return next >= due.count() && injected.isEmpty();
+}
+
+int
+ANTReplay::read(uint8_t bytes[], int size)
+{
+    QMutexLocker locker(&lock);
+
+    int n=0;
+
+    // responses to our own messages go first
+    if (injected.size()) {
+        n = qMin(size, injected.size());
+        memcpy(bytes, injected.constData(), n);
+        injected.remove(0, n);
+    }
+
+    // then whatever is due from the capture
+    double now = timer.elapsed() * speed;
+    while (n < size && next < due.count() && (speed <= 0 || due[next] <= now)) {
+
+        int take = qMin(size - n, ends[next] - pos);
+        memcpy(bytes + n, stream.constData() + pos, take);
+        n += take;
+        pos += take;
+        if (pos == ends[next]) next++;
+    }
+    return n ? n : -1;
+}
+
+int
+ANTReplay::write(uint8_t *bytes, int size)
+{
+    // acknowledge a reset with a startup notification
+    if (size > ANT_OFFSET_ID && bytes[ANT_OFFSET_SYNC] == ANT_SYNC_BYTE && bytes[ANT_OFFSET_ID] == ANT_SYSTEM_RESET) {
+
+        unsigned char startup[5] = { ANT_SYNC_BYTE, 1, ANT_NOTIF_STARTUP, 0, 0 };
+        for (int i=0; i<4; i++) startup[4] ^= startup[i];
+
+        QMutexLocker locker(&lock);
+        injected.append((const char *)startup, 5);
+    }
+    return size;
+}
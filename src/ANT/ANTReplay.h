@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef _GC_ANTReplay_h
+#define _GC_ANTReplay_h 1
+
+#include <QString>
+#include <QByteArray>
+#include <QVector>
+#include <QMutex>
+#include <QElapsedTimer>
+
+#include <stdint.h>
+
+//
+// Pretends to be an ANT stick by replaying an antlog.raw capture
+// written by ANTLogger. The received messages in the capture are
+// framed again (sync, length, id, data and checksum) and handed out
+// by read() as they fall due, so they go through exactly the same
+// decoder as bytes read from a real stick.
+//
+// Messages we send are dropped, apart from a reset which gets a
+// startup notification so ANT::setup() doesn't give up on us.
+//
+// Used to benchmark and debug the receive path without hardware.
+//
+class ANTReplay
+{
+    public:
+        ANTReplay();
+
+        // speed 1.0 is real time, 10.0 is ten times faster and
+        // zero means as fast as the decoder can consume them
+        bool open(QString filename, double speed=1.0);
+        void close();
+
+        // device i/o, read returns -1 when nothing is due
+        int read(uint8_t bytes[], int size);
+        int write(uint8_t *bytes, int size);
+
+        // all messages have been read
+        bool atEnd();
+        int messages() const { return due.count(); }
+
+    private:
+        QMutex lock;                    // write() is called from the controller thread
+
+        QByteArray stream;              // framed messages back to back
+        QVector<int> ends;              // offset of the end of each message in stream
+        QVector<qint64> due;            // when each message is due, ms from the start
+        QByteArray injected;            // responses to messages we were sent
+
+        int next;                       // next message to read
+        int pos;                        // read position in stream
+        double speed;
+        QElapsedTimer timer;
+};
+
+#endif // _GC_ANTReplay_h
@@ -39,6 +39,7 @@ ANTlocalController::ANTlocalController(TrainSidebar *parent, DeviceConfiguration
     }
 
     myANTlocal = new ANT (parent, dc, cyclist);
+    myANTlocal->setPublisher(this);
     logger = new ANTLogger(this, athletePath);
 
     connect(myANTlocal, SIGNAL(foundDevice(int,int,int)), this, SIGNAL(foundDevice(int,int,int)));
@@ -169,9 +170,12 @@ ANTlocalController::getRealtimeData(RealtimeData &rtData)
         logger->close();
         return;
     }
-    // get latest telemetry
-    myANTlocal->getRealtimeData(rtData);
-    processRealtimeData(rtData);
+    // get latest telemetry published by the ANT thread, when
+    // pairing there is no bus so we look at it directly
+    if (!latestRealtimeData(rtData)) {
+        myANTlocal->getRealtimeData(rtData);
+        processRealtimeData(rtData);
+    }
 }
 
 uint8_t
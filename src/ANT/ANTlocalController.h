@@ -58,6 +58,7 @@ public:
 
     // telemetry push pull
     bool doesPush(), doesPull(), doesLoad();
+    bool doesPublish() { return true; } // from the ANT thread
     void getRealtimeData(RealtimeData &rtData);
     void pushRealtimeData(RealtimeData &rtData);
 
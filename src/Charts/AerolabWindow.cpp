@@ -27,6 +27,7 @@
 #include "Colors.h"
 #include "HelpWhatsThis.h"
 #include "Units.h"
+#include "AerolabSolver.h"
 #include <QtGui>
 #include <qwt_plot_zoomer.h>
 
@@ -226,6 +227,12 @@ AerolabWindow::AerolabWindow(Context *context) :
   QPushButton *btnEstCdACrr = new QPushButton(tr("&Estimate CdA and Crr"), this);
   smoothLayout->addWidget(btnEstCdACrr);
 
+  btnFit = new QPushButton(tr("&Fit laps"), this);
+  btnFit->setToolTip(tr("Fit CdA and Crr to the selected intervals jointly, or the whole activity if none are selected"));
+  smoothLayout->addWidget(btnFit);
+  solver = new AerolabSolver(this);
+  fitRide = "";
+
   btnSave = new QPushButton(tr("&Save parameters"), this);
   smoothLayout->addWidget(btnSave);
 
@@ -268,6 +275,8 @@ AerolabWindow::AerolabWindow(Context *context) :
   connect(constantAlt, SIGNAL(stateChanged(int)), this, SLOT(setConstantAlt(int)));
   connect(comboDistance, SIGNAL(currentIndexChanged(int)), this, SLOT(setByDistance(int)));
   connect(btnEstCdACrr, SIGNAL(clicked()), this, SLOT(doEstCdACrr()));
+  connect(btnFit, SIGNAL(clicked()), this, SLOT(doFitCdACrr()));
+  connect(solver, SIGNAL(finished()), this, SLOT(fitCompleted()));
   connect(btnSave, SIGNAL(clicked()), this, SLOT(saveParametersInRide()));
   connect(context, SIGNAL(configChanged(qint32)), aerolab, SLOT(configChanged(qint32)));
   connect(context, SIGNAL(configChanged(qint32)), this, SLOT(configChanged(qint32)));
@@ -638,6 +647,59 @@ AerolabWindow::doEstCdACrr()
     }
 }
 
+void
+AerolabWindow::doFitCdACrr()
+{
+    RideItem *ride = myRideItem;
+    if (ride == NULL || ride->ride() == NULL || solver->isRunning()) return;
+    fitRide = ride->fileName;
+
+    // each selected interval is a lap with its own elevation offset
+    QList<AerolabData> laps;
+    foreach(IntervalItem *interval, ride->intervalsSelected())
+        laps << AerolabData(ride->ride(), interval->name, interval->start, interval->stop, constantAlt->isChecked());
+    if (laps.isEmpty()) laps << AerolabData(ride->ride(), tr("Activity"), 0, 0, constantAlt->isChecked());
+
+    // sweep the slider ranges, with the current efficiency and mass
+    // a fit outside them couldn't be applied
+    solver->setData(laps);
+    solver->setRho(aerolab->getRho());
+    solver->setRange(AerolabSolver::CdA, cdaSlider->minimum() / 10000.0, cdaSlider->maximum() / 10000.0, 1000);
+    solver->setRange(AerolabSolver::Crr, crrSlider->minimum() / 1000000.0, crrSlider->maximum() / 1000000.0, 1000);
+    solver->setRange(AerolabSolver::Eta, aerolab->getEta(), aerolab->getEta(), 1);
+    solver->setRange(AerolabSolver::Mass, aerolab->getTotalMass(), aerolab->getTotalMass(), 1);
+
+    btnFit->setEnabled(false);
+    solver->start(AerolabSolver::Grid);
+}
+
+void
+AerolabWindow::fitCompleted()
+{
+    btnFit->setEnabled(true);
+
+    // another ride was selected whilst fitting
+    if (myRideItem == NULL || fitRide != myRideItem->fileName) return;
+
+    AerolabFit fit = solver->result();
+    if (!fit.ok) {
+        QMessageBox::warning(this, tr("Fit CdA and Crr"), fit.error);
+        return;
+    }
+
+    // the sliders set the line edits and the plot, at their resolution
+    crrSlider->setValue(qRound(fit.parms[AerolabSolver::Crr] * 1000000));
+    cdaSlider->setValue(qRound(fit.parms[AerolabSolver::CdA] * 10000));
+    refresh(myRideItem, false);
+
+    // report what was applied
+    QMessageBox::information(this, tr("Fit CdA and Crr"),
+                             tr("CdA %1 +/- %2\nCrr %3 +/- %4\n\n%5 laps, %6 samples, RMS error %7 m")
+                             .arg(aerolab->getCda(), 0, 'f', 4).arg(fit.ci[AerolabSolver::CdA], 0, 'f', 4)
+                             .arg(aerolab->getCrr(), 0, 'f', 6).arg(fit.ci[AerolabSolver::Crr], 0, 'f', 6)
+                             .arg(fit.laps).arg(fit.n).arg(fit.rmse, 0, 'f', 2));
+}
+
 
 void
 AerolabWindow::zoomInterval(IntervalItem *which) {
@@ -32,6 +32,7 @@ class QLineEdit;
 class QLCDNumber;
 class RideItem;
 class IntervalItem;
+class AerolabSolver;
 
 class AerolabWindow : public GcChartWindow {
   Q_OBJECT
@@ -62,6 +63,8 @@ class AerolabWindow : public GcChartWindow {
   void setEoffsetFromSlider();
   void setEoffsetFromText(const QString text);
   void doEstCdACrr();
+  void doFitCdACrr();
+  void fitCompleted();
   void setAutoEoffset(int value);
   void setConstantAlt(int value);
   void setByDistance(int value);
@@ -113,6 +116,11 @@ class AerolabWindow : public GcChartWindow {
   QLineEdit *commentEdit;
 
   QPushButton *btnSave;
+  QPushButton *btnFit;
+
+  // fits the selected laps jointly in the background
+  AerolabSolver *solver;
+  QString fitRide; // filename of the ride being fitted
 
   void refresh(RideItem *_rideItem, bool newzoom);
   bool hasNewParametersInRide();
@@ -2556,7 +2556,7 @@ AllPlotWindow::setShowNP(int value)
     bool checked = ( ( value == Qt::Checked ) && showNP->isEnabled()) ? true : false;
 
     // recalc only does it if it needs to
-    if (value && current && current->ride()) current->ride()->recalculateDerivedSeries();
+    if (value && current && current->ride()) current->ride()->recalculateDerivedSeries(RideFile::IsoPower);
 
     allPlot->setShowNP(checked);
     foreach (AllPlot *plot, allPlots)
@@ -2579,7 +2579,7 @@ AllPlotWindow::setShowANTISS(int value)
     bool checked = ( ( value == Qt::Checked ) && showANTISS->isEnabled()) ? true : false;
 
     // recalc only does it if it needs to
-    if (value && current && current->ride()) current->ride()->recalculateDerivedSeries();
+    if (value && current && current->ride()) current->ride()->recalculateDerivedSeries(RideFile::anTISS);
 
     allPlot->setShowANTISS(checked);
     foreach (AllPlot *plot, allPlots)
@@ -2602,7 +2602,7 @@ AllPlotWindow::setShowATISS(int value)
     bool checked = ( ( value == Qt::Checked ) && showATISS->isEnabled()) ? true : false;
 
     // recalc only does it if it needs to
-    if (value && current && current->ride()) current->ride()->recalculateDerivedSeries();
+    if (value && current && current->ride()) current->ride()->recalculateDerivedSeries(RideFile::aTISS);
 
     allPlot->setShowATISS(checked);
     foreach (AllPlot *plot, allPlots)
@@ -2625,7 +2625,7 @@ AllPlotWindow::setShowXP(int value)
     bool checked = ( ( value == Qt::Checked ) && showXP->isEnabled()) ? true : false;
 
     // recalc only does it if it needs to
-    if (value && current && current->ride()) current->ride()->recalculateDerivedSeries();
+    if (value && current && current->ride()) current->ride()->recalculateDerivedSeries(RideFile::xPower);
 
     allPlot->setShowXP(checked);
     foreach (AllPlot *plot, allPlots)
@@ -2648,7 +2648,7 @@ AllPlotWindow::setShowAP(int value)
     bool checked = ( ( value == Qt::Checked ) && showAP->isEnabled()) ? true : false;
 
     // recalc only does it if it needs to
-    if (value && current && current->ride()) current->ride()->recalculateDerivedSeries();
+    if (value && current && current->ride()) current->ride()->recalculateDerivedSeries(RideFile::aPower);
 
     allPlot->setShowAP(checked);
     foreach (AllPlot *plot, allPlots)
@@ -26,6 +26,7 @@
 #include "LTMWindow.h"
 #include "RideMetric.h"
 #include "RideCache.h"
+#include "MetricAggregator.h"
 #include "RideFileCache.h"
 #include "Banister.h"
 #include "Estimator.h"
@@ -377,6 +378,19 @@ LTMPlot::setData(LTMSettings *set)
     stackY.clear();
     stacks.clear();
 
+    // aggregate all the plain metric curves in a single pass, the
+    // results are cached so each curve picks them up as it is created
+    if (settings->groupBy != LTM_TOD) {
+        QList<MetricAggregateRequest> requests;
+        foreach (MetricDetail metricDetail, settings->metrics) {
+            if (metricDetail.type == METRIC_DB && metricDetail.metric && SearchFilterBox::isNull(metricDetail.datafilter))
+                requests << aggregateRequest(metricDetail, metricDetail.curveStyle == QwtPlotCurve::Steps);
+        }
+        if (requests.count() > 1)
+            context->athlete->rideCache->aggregator()->aggregate(settings->specification, settings->groupBy,
+                                                                 settings->start.date(), requests);
+    }
+
     int r=0;
 
     foreach (MetricDetail metricDetail, settings->metrics) {
@@ -2668,6 +2682,25 @@ LTMPlot::createCurveData(Context *context, LTMSettings *settings, MetricDetail m
 
 }
 
+// the aggregation request for a metric curve, the rules for
+// ramp and time units are the same as for the other curve types
+MetricAggregateRequest
+LTMPlot::aggregateRequest(MetricDetail &metricDetail, bool wantZero)
+{
+    MetricAggregateRequest request(metricDetail.metric);
+
+    if (metricDetail.uunits == "Ramp" ||
+        metricDetail.uunits == tr("Ramp")) request.type = RideMetric::Total;
+
+    // convert seconds to hours
+    if (metricDetail.metric->units(true) == "seconds" ||
+        metricDetail.metric->units(true) == tr("seconds")) request.hours = true;
+
+    request.wantzero = wantZero;
+    request.useMetricUnits = GlobalContext::context()->useMetricUnits;
+    return request;
+}
+
 void
 LTMPlot::createMetricData(Context *context, LTMSettings *settings, MetricDetail metricDetail,
                                               QVector<double>&x,QVector<double>&y,int&n, bool forceZero)
@@ -2692,6 +2725,40 @@ LTMPlot::createMetricData(Context *context, LTMSettings *settings, MetricDetail
     if (!SearchFilterBox::isNull(metricDetail.datafilter))
         spec.addMatches(SearchFilterBox::matches(context, metricDetail.datafilter));
 
+    // metric values are aggregated by the ride cache in one columnar pass
+    // and shared with the other curves, only metadata is aggregated here
+    if (metricDetail.type == METRIC_DB && metricDetail.metric) {
+
+        MetricAggregate aggregate = context->athlete->rideCache->aggregator()->aggregate(spec, settings->groupBy,
+                                                    settings->start.date(), aggregateRequest(metricDetail, wantZero));
+        int startGroup = groupForDate(settings->start.date(), settings->groupBy);
+
+        for (int i=0; i<aggregate.groups.count(); i++) {
+
+            int currentDay = aggregate.groups[i];
+            if (lastDay && wantZero) {
+                while (lastDay<currentDay && n<=maxdays) {
+                    lastDay++;
+                    n++;
+                    x[n]=lastDay - startGroup;
+                    y[n]=0;
+                }
+            } else {
+                n++;
+            }
+
+            // drop out of range
+            if (n>maxdays) break;
+            // first time thru
+            if (n<0) n=0;
+
+            y[n] = aggregate.values[i];
+            x[n] = currentDay - startGroup;
+            lastDay = currentDay;
+        }
+        return;
+    }
+
     //
     double ymean_prev=0.0;
 
@@ -43,6 +43,7 @@ class LTMScaleDraw;
 class CompareScaleDraw;
 class StressCalculator;
 class LTMToolTip;
+class MetricAggregateRequest;
 
 class LTMPlot : public QwtPlot
 {
@@ -129,6 +130,7 @@ class LTMPlot : public QwtPlot
 
         // create curve data from metadata or metric (from ridecache)
         void createMetricData(Context *,LTMSettings *, MetricDetail, QVector<double>&, QVector<double>&, int&, bool=false);
+        MetricAggregateRequest aggregateRequest(MetricDetail &, bool);
         void createFormulaData(Context *,LTMSettings *, MetricDetail, QVector<double>&, QVector<double>&, int&, bool=false);
 
         // create curve data from bests (from ridefile cache)
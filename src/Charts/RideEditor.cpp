@@ -1756,6 +1756,25 @@ RideEditor::endCommand(bool undo, RideCommand *cmd)
 
             break;
         }
+        case RideCommand::SetPointValues:
+        {
+            SetPointValuesCommand *spv = (SetPointValuesCommand*)cmd;
+
+            // the ends of each run are enough for the LUW to
+            // work out the range to highlight at the end
+            foreach(const SetPointValuesCommand::Column &c, spv->columns) {
+                QModelIndex top = model->index(c.rows.first(), model->columnFor(c.series));
+                QModelIndex bottom = model->index(c.rows.last(), model->columnFor(c.series));
+
+                if (inLUW) {
+                    itemselection << top << bottom;
+                } else {
+                    table->selectionModel()->select(QItemSelection(top, bottom), QItemSelectionModel::Select);
+                    table->selectionModel()->setCurrentIndex(top, QItemSelectionModel::Select);
+                }
+            }
+            break;
+        }
         case RideCommand::InsertPoint:
         {
             InsertPointCommand *ip = (InsertPointCommand *)cmd;
@@ -3103,7 +3122,7 @@ XDataEditor::selectIntervals(QList<IntervalItem*> intervals)
         // what is the first dataPoint index for this interval?
         int start = _model->series->timeIndex(interval->start);
         int end = _model->series->timeIndex(interval->stop);
-        if (end < _model->series->datapoints.count()-1) end--;
+        if (end < _model->series->count()-1) end--;
 
         // select all the rows
         selectionModel()->clearSelection();
@@ -3335,16 +3354,13 @@ XDataEditor::insRow()
 void
 XDataEditor::appRow()
 {
-    QVector<XDataPoint*> rows;
-    rows << new XDataPoint;
+    QVector<XDataPoint> rows(1);
     _model->appendRows(rows);  
 }
 void
 XDataEditor::appRows(int count)
 {
-    QVector<XDataPoint*> rows;
-    for (int i=0;i<count;i++)
-    rows << new XDataPoint;
+    QVector<XDataPoint> rows(count);
     _model->appendRows(rows);
 }
 void
@@ -17,6 +17,7 @@
  */
 
 #include "CloudService.h"
+#include "CloudSyncEngine.h"
 
 #include "Athlete.h"
 #include "RideCache.h"
@@ -693,7 +694,7 @@ FolderNameDialog::FolderNameDialog(QWidget *parent) : QDialog(parent)
 }
 
 CloudServiceSyncDialog::CloudServiceSyncDialog(Context *context, CloudService *store)
-    : QDialog(context->mainWindow, Qt::Dialog), context(context), store(store), downloading(false), aborted(false)
+    : QDialog(context->mainWindow, Qt::Dialog), context(context), store(store), downloading(false), engine(NULL), running(NULL), statuscol(0)
 {
     setWindowTitle(tr("Synchronise ") + store->uiName());
     setMinimumSize(850 *dpiXFactor,450 *dpiYFactor);
@@ -731,10 +732,6 @@ CloudServiceSyncDialog::CloudServiceSyncDialog(Context *context, CloudService *s
     QVBoxLayout *uploadLayout = new QVBoxLayout(upload);
     QVBoxLayout *syncLayout = new QVBoxLayout(sync);
 
-    // notification when upload/download completes
-    connect (store, SIGNAL(writeComplete(QString,QString)), this, SLOT(completedWrite(QString,QString)));
-    connect (store, SIGNAL(readComplete(QByteArray*,QString,QString)), this, SLOT(completedRead(QByteArray*,QString,QString)));
-
     // combo box
     athleteCombo = new QComboBox(this);
     athleteCombo->addItem(context->athlete->cyclist);
@@ -1307,375 +1304,158 @@ CloudServiceSyncDialog::refreshCount()
 void
 CloudServiceSyncDialog::downloadClicked()
 {
+    // abort, the engine tells us when it has stopped
     if (downloading == true) {
-        rideListDown->setSortingEnabled(true);
-        rideListUp->setSortingEnabled(true);
-        progressLabel->setText("");
-        downloadButton->setText(tr("Download"));
-        downloading=false;
-        aborted=true;
-        cancelButton->show();
+        if (engine) engine->abort();
         return;
-    } else {
-        rideListDown->setSortingEnabled(false);
-        rideListUp->setSortingEnabled(true);
-        downloading=true;
-        aborted=false;
-        downloadButton->setText(tr("Abort"));
-        cancelButton->hide();
     }
 
+    rideListDown->setSortingEnabled(false);
+    rideListUp->setSortingEnabled(false);
+    rideListSync->setSortingEnabled(false);
+    downloading=true;
+    downloadButton->setText(tr("Abort"));
+    cancelButton->hide();
+
     // keeping track of progress...
     downloadcounter = 0;
     successful = 0;
     downloadtotal = 0;
-    listindex = 0;
 
-    QTreeWidget *which = NULL;
     switch(tabs->currentIndex()) {
-        case 0 : which = rideListDown; break;
-        case 1 : which = rideListUp; break;
+        case 0 : running = rideListDown; statuscol = 5; break;
+        case 1 : running = rideListUp; statuscol = 7; break;
         default:
-        case 2 : which = rideListSync; break;
-    }
-
-    for (int i=0; i<which->invisibleRootItem()->childCount(); i++) {
-        QTreeWidgetItem *curr = which->invisibleRootItem()->child(i);
-        QCheckBox *check = (QCheckBox*)which->itemWidget(curr, 0);
-        if (check->isChecked()) {
-            downloadtotal++;
-        }
+        case 2 : running = rideListSync; statuscol = 7; break;
     }
 
-    if (downloadtotal) {
-        progressBar->setMaximum(downloadtotal);
-        progressBar->setMinimum(0);
-        progressBar->setValue(0);
-    }
-
-    // even if nothing to download this
-    // cleans up variables et al
-    sync = false;
-    switch(tabs->currentIndex()) {
-        case 0 : downloadNext(); break;
-        case 1 : uploadNext(); break;
-        case 2 : sync = true; syncNext(); break;
-    }
-}
-
-bool
-CloudServiceSyncDialog::syncNext()
-{
-    // the actual download/upload is kicked off using the uploader / downloader
-    // if in sync mode the completedRead / completedWrite functions
-    // just call completedSync to get the next Sync done
-    for (int i=listindex; i<rideListSync->invisibleRootItem()->childCount(); i++) {
-        QTreeWidgetItem *curr = rideListSync->invisibleRootItem()->child(i);
-        QCheckBox *check = (QCheckBox*)rideListSync->itemWidget(curr, 0);
-
-        if (check->isChecked()) {
-
-            listindex = i+1; // start from the next one
-
-            progressLabel->setText(QString(tr("Processed %1 of %2")).arg(downloadcounter).arg(downloadtotal));
-            if (curr->text(6) == tr("Download")) {
-                curr->setText(7, tr("Downloading"));
-                rideListSync->setCurrentItem(curr);
-
-                QByteArray *data = new QByteArray;
-                store->readFile(data, curr->text(1), curr->text(8)); // filename
-                QApplication::processEvents();
-
-            } else {
-                curr->setText(7, tr("Uploading"));
-                rideListSync->setCurrentItem(curr);
-
-                // read in the file
-                QStringList errors;
-                QFile file(context->athlete->home->activities().canonicalPath() + "/" + curr->text(1));
-                RideFile *ride = RideFileFactory::instance().openRideFile(context, file, errors);
-
-                if (ride) {
-
-                    // get a compressed version
-                    QByteArray data;
-                    store->compressRide(ride, data, QFileInfo(curr->text(1)).baseName() + ".json");
-
-                    store->writeFile(data, QFileInfo(curr->text(1)).baseName() + store->uploadExtension(), ride);
-                    QApplication::processEvents();
-                    delete ride; // clean up!
-                    return true;
-
+    // a new sync, so anything left from an interrupted one is forgotten
+    engine = new CloudSyncEngine(context, store, "sync");
+    engine->clearJournal();
+    engine->setOverwrite(overwrite->isChecked());
+    connect(engine, SIGNAL(jobState(int,QString)), this, SLOT(jobState(int,QString)));
+    connect(engine, SIGNAL(jobFinished(int,bool,QString)), this, SLOT(jobFinished(int,bool,QString)));
+    connect(engine, SIGNAL(rideSaved(QString)), this, SLOT(rideSaved(QString)));
+    connect(engine, SIGNAL(finished(int,int)), this, SLOT(syncFinished(int,int)));
+
+    for (int i=0; i<running->invisibleRootItem()->childCount(); i++) {
+        QTreeWidgetItem *curr = running->invisibleRootItem()->child(i);
+        QCheckBox *check = (QCheckBox*)running->itemWidget(curr, 0);
+        if (!check->isChecked()) continue;
+
+        downloadtotal++;
+
+        switch(tabs->currentIndex()) {
+        case 0:
+            {
+                // skip existing if overwrite not set
+                QCheckBox *exists = (QCheckBox*)rideListDown->itemWidget(curr, 4);
+                if (exists->isChecked() && !overwrite->isChecked()) {
+                    curr->setText(5, tr("File exists"));
+                    downloadcounter++;
                 } else {
-                    curr->setText(7, tr("Parse failure"));
-                    QApplication::processEvents();
+                    curr->setText(5, tr("Queued"));
+                    engine->add(CloudSyncJob::Download, curr->text(1), curr->text(6), i);
                 }
-
             }
-            return true;
+            break;
+        case 1:
+            {
+                // skip existing if overwrite not set
+                QCheckBox *exists = (QCheckBox*)rideListUp->itemWidget(curr, 6);
+                if (exists->isChecked() && !overwrite->isChecked()) {
+                    curr->setText(7, tr("File exists"));
+                    downloadcounter++;
+                } else {
+                    curr->setText(7, tr("Queued"));
+                    engine->add(CloudSyncJob::Upload, curr->text(1), "", i);
+                }
+            }
+            break;
+        default:
+        case 2:
+            curr->setText(7, tr("Queued"));
+            if (curr->text(6) == tr("Download")) engine->add(CloudSyncJob::Download, curr->text(1), curr->text(8), i);
+            else engine->add(CloudSyncJob::Upload, curr->text(1), "", i);
+            break;
         }
     }
 
-    //
-    // Our work is done!
-    //
-    rideListDown->setSortingEnabled(true);
-    rideListUp->setSortingEnabled(true);
-    rideListSync->setSortingEnabled(true);
-    progressLabel->setText(tr("Sync complete"));
-    downloadButton->setText(tr("Synchronize"));
-    downloading=false;
-    aborted=false;
-    sync=false;
-    cancelButton->show();
-    selectAllSync->setChecked(Qt::Unchecked);
-    for (int i=0; i<rideListSync->invisibleRootItem()->childCount(); i++) {
-        QTreeWidgetItem *curr = rideListSync->invisibleRootItem()->child(i);
-        QCheckBox *check = (QCheckBox*)rideListSync->itemWidget(curr, 0);
-        check->setChecked(false);
-    }
-    progressLabel->setText(QString(tr("Processed %1 of %2 successfully")).arg(successful).arg(downloadtotal));
-
-    // save the ride cache, we don't want to lose that if we crash etc.
-    context->athlete->rideCache->save();
+    progressBar->setMaximum(downloadtotal);
+    progressBar->setMinimum(0);
+    progressBar->setValue(downloadcounter);
+    progressLabel->setText(QString(tr("Processed %1 of %2")).arg(downloadcounter).arg(downloadtotal));
 
-    return false;
+    // even if nothing to do this cleans up when finished
+    engine->start();
 }
 
-bool
-CloudServiceSyncDialog::downloadNext()
+void
+CloudServiceSyncDialog::jobState(int row, QString message)
 {
-    for (int i=listindex; i<rideListDown->invisibleRootItem()->childCount(); i++) {
-        QTreeWidgetItem *curr = rideListDown->invisibleRootItem()->child(i);
-        QCheckBox *check = (QCheckBox*)rideListDown->itemWidget(curr, 0);
-        QCheckBox *exists = (QCheckBox*)rideListDown->itemWidget(curr, 4);
+    QTreeWidgetItem *curr = running->invisibleRootItem()->child(row);
+    if (curr == NULL) return;
 
-        // skip existing if overwrite not set
-        if (check->isChecked() && exists->isChecked() && !overwrite->isChecked()) {
-            curr->setText(5, tr("File exists"));
-            progressBar->setValue(++downloadcounter);
-            continue;
-        }
-
-        if (check->isChecked()) {
-
-            listindex = i+1; // start from the next one
-            curr->setText(5, tr("Downloading"));
-            rideListDown->setCurrentItem(curr);
-            progressLabel->setText(QString(tr("Downloaded %1 of %2")).arg(downloadcounter).arg(downloadtotal));
-
-            QByteArray *data = new QByteArray; // gets deleted when read completes
-            store->readFile(data, curr->text(1), curr->text(6));
-            QApplication::processEvents();
-            //delete data;
-            return true;
-        }
-    }
-
-    //
-    // Our work is done!
-    //
-    rideListDown->setSortingEnabled(true);
-    rideListUp->setSortingEnabled(true);
-    progressLabel->setText(tr("Downloads complete"));
-    downloadButton->setText(tr("Download"));
-    downloading=false;
-    aborted=false;
-    cancelButton->show();
-    selectAll->setChecked(Qt::Unchecked);
-    for (int i=0; i<rideListDown->invisibleRootItem()->childCount(); i++) {
-        QTreeWidgetItem *curr = rideListDown->invisibleRootItem()->child(i);
-        QCheckBox *check = (QCheckBox*)rideListDown->itemWidget(curr, 0);
-        check->setChecked(false);
-    }
-    progressLabel->setText(QString(tr("Downloaded %1 of %2 successfully")).arg(successful).arg(downloadtotal));
-
-    // save the ride cache, we don't want to lose that if we crash etc.
-    context->athlete->rideCache->save();
-
-    return false;
+    curr->setText(statuscol, message);
+    running->setCurrentItem(curr);
 }
 
 void
-CloudServiceSyncDialog::completedRead(QByteArray *data, QString name, QString /*message*/)
+CloudServiceSyncDialog::jobFinished(int row, bool success, QString message)
 {
-    QTreeWidget *which = sync ? rideListSync : rideListDown;
-    int col = sync ? 7 : 5;
-
-    // was abort pressed?
-    if (aborted == true) {
-        QTreeWidgetItem *curr = which->invisibleRootItem()->child(listindex-1);
-        curr->setText(col, tr("Aborted"));
-        return;
-    }
-
-    // uncompress and parse, note the filename is passed and may be
-    // different to what we asked for (sometimes the data is converted
-    // from one file format to another).
-    QStringList errors;
-    RideFile *ride = store->uncompressRide(data, name, errors);
-
-    // was allocated in before calling readfile
-    delete data;
+    QTreeWidgetItem *curr = running->invisibleRootItem()->child(row);
+    if (curr) curr->setText(statuscol, message);
 
+    if (success) successful++;
     progressBar->setValue(++downloadcounter);
-
-    QTreeWidgetItem *curr = which->invisibleRootItem()->child(listindex-1);
-    if (ride) {
-        if (saveRide(ride, errors) == true) {
-            curr->setText(col, tr("Saved"));
-            successful++;
-        } else {
-            curr->setText(col, errors.join(" "));
-        }
-
-        // delete once saved
-        delete ride;
-    } else {
-        curr->setText(col, errors.join(" "));
-    }
-
-    QApplication::processEvents();
-
-    if (sync)
-        syncNext();
-    else
-        downloadNext();
+    progressLabel->setText(QString(tr("Processed %1 of %2")).arg(downloadcounter).arg(downloadtotal));
 }
 
-bool
-CloudServiceSyncDialog::uploadNext()
+void
+CloudServiceSyncDialog::rideSaved(QString filename)
 {
-    for (int i=listindex; i<rideListUp->invisibleRootItem()->childCount(); i++) {
-        QTreeWidgetItem *curr = rideListUp->invisibleRootItem()->child(i);
-        QCheckBox *check = (QCheckBox*)rideListUp->itemWidget(curr, 0);
-        QCheckBox *exists = (QCheckBox*)rideListUp->itemWidget(curr, 6);
-
-        // skip existing if overwrite not set
-        if (check->isChecked() && exists->isChecked() && !overwrite->isChecked()) {
-            curr->setText(7, tr("File exists"));
-            progressBar->setValue(++downloadcounter);
-            continue;
-        }
-
-        if (check->isChecked()) {
-
-            listindex = i+1; // start from the next one
-            curr->setText(7, tr("Uploading"));
-            rideListUp->setCurrentItem(curr);
-            progressLabel->setText(QString(tr("Uploaded %1 of %2")).arg(downloadcounter).arg(downloadtotal));
-
-            // read in the file - TEMPORARILY *** WE DON'T USE IN MEMORY VERSION ***
-            QStringList errors;
-            QFile file(context->athlete->home->activities().canonicalPath() + "/" + curr->text(1));
-            RideFile *ride = RideFileFactory::instance().openRideFile(context, file, errors);
-
-            if (ride) {
-
-                    // get a compressed version
-                    QByteArray data;
-                    store->compressRide(ride, data, QFileInfo(curr->text(1)).baseName() + ".json");
-                    store->writeFile(data, QFileInfo(curr->text(1)).baseName() + store->uploadExtension(), ride);
-                    QApplication::processEvents();
-                    delete ride; // clean up!
-                    return true;
-
-            } else {
-                curr->setText(7, tr("Parse failure"));
-                QApplication::processEvents();
-            }
-        }
-    }
+    // add to the ride list
+    rideFiles << QFileInfo(filename).baseName();
+    context->athlete->addRide(filename, true);
+}
 
+void
+CloudServiceSyncDialog::syncFinished(int, int)
+{
     //
     // Our work is done!
     //
     rideListDown->setSortingEnabled(true);
     rideListUp->setSortingEnabled(true);
-    progressLabel->setText(tr("Uploads complete"));
-    downloadButton->setText(tr("Upload"));
+    rideListSync->setSortingEnabled(true);
     downloading=false;
-    aborted=false;
     cancelButton->show();
-    selectAllUp->setChecked(Qt::Unchecked);
-    for (int i=0; i<rideListUp->invisibleRootItem()->childCount(); i++) {
-        QTreeWidgetItem *curr = rideListUp->invisibleRootItem()->child(i);
-        QCheckBox *check = (QCheckBox*)rideListUp->itemWidget(curr, 0);
-        check->setChecked(false);
-    }
-    progressLabel->setText(QString(tr("Uploaded %1 of %2 successfully")).arg(successful).arg(downloadtotal));
-    return false;
-}
 
-void
-CloudServiceSyncDialog::completedWrite(QString, QString result)
-{
-    QTreeWidget *which = sync ? rideListSync : rideListUp;
+    // the tab we started on, the user may have moved since
+    if (running == rideListDown) selectAll->setChecked(Qt::Unchecked);
+    else if (running == rideListUp) selectAllUp->setChecked(Qt::Unchecked);
+    else selectAllSync->setChecked(Qt::Unchecked);
 
-    // was abort pressed?
-    if (aborted == true) {
-        QTreeWidgetItem *curr = which->invisibleRootItem()->child(listindex-1);
-        curr->setText(7, tr("Aborted"));
-        return;
+    switch(tabs->currentIndex()) {
+        case 0 : downloadButton->setText(tr("Download")); break;
+        case 1 : downloadButton->setText(tr("Upload")); break;
+        default:
+        case 2 : downloadButton->setText(tr("Synchronize")); break;
     }
-
-    progressBar->setValue(++downloadcounter);
-
-    QTreeWidgetItem *curr = which->invisibleRootItem()->child(listindex-1);
-    curr->setText(7, result);
-    if (result == tr("Completed.")) successful++;
-    QApplication::processEvents();
-
-    if (sync)
-        syncNext();
-    else
-        uploadNext();
-}
-
-bool
-CloudServiceSyncDialog::saveRide(RideFile *ride, QStringList &errors)
-{
-    QDateTime ridedatetime = ride->startTime();
-
-    QChar zero = QLatin1Char ( '0' );
-    QString targetnosuffix = QString ( "%1_%2_%3_%4_%5_%6" )
-                           .arg ( ridedatetime.date().year(), 4, 10, zero )
-                           .arg ( ridedatetime.date().month(), 2, 10, zero )
-                           .arg ( ridedatetime.date().day(), 2, 10, zero )
-                           .arg ( ridedatetime.time().hour(), 2, 10, zero )
-                           .arg ( ridedatetime.time().minute(), 2, 10, zero )
-                           .arg ( ridedatetime.time().second(), 2, 10, zero );
-
-    QString filename = context->athlete->home->activities().canonicalPath() + "/" + targetnosuffix + ".json";
-
-    // exists?
-    QFileInfo fileinfo(filename);
-    if (fileinfo.exists() && overwrite->isChecked() == false) {
-        errors << tr("File exists");
-        return false;
+    for (int i=0; i<running->invisibleRootItem()->childCount(); i++) {
+        QTreeWidgetItem *curr = running->invisibleRootItem()->child(i);
+        QCheckBox *check = (QCheckBox*)running->itemWidget(curr, 0);
+        check->setChecked(false);
     }
+    progressLabel->setText(QString(tr("Processed %1 of %2 successfully")).arg(successful).arg(downloadtotal));
 
-    // process linked defaults
-    GlobalContext::context()->rideMetadata->setLinkedDefaults(ride);
-
-    // run the processor first... import
-    DataProcessorFactory::instance().autoProcess(ride, "Auto", "Import");
-    ride->recalculateDerivedSeries();
-    // now metrics have been calculated
-    DataProcessorFactory::instance().autoProcess(ride, "Save", "ADD");
-
-    JsonFileReader reader;
-    QFile file(filename);
-    reader.writeRideFile(context, ride, file);
-
-    // add to the ride list
-    rideFiles<<targetnosuffix;
-    context->athlete->addRide(fileinfo.fileName(), true);
+    // save the ride cache, we don't want to lose that if we crash etc.
+    if (running != rideListUp) context->athlete->rideCache->save();
 
-    return true;
+    engine->deleteLater();
+    engine = NULL;
 }
 
-
 //
 // Upgrade settings now we have migrated to a cloud service factory
 // and notion of setting up "accounts" etc
@@ -1760,9 +1540,6 @@ CloudServiceAutoDownload::run()
             // instantiate
             CloudService *service = CloudServiceFactory::instance().newService(worklist[i], context);
 
-            // we want to trap received files
-            connect(service, SIGNAL(readComplete(QByteArray*,QString,QString)), this, SLOT(readComplete(QByteArray*,QString,QString)));
-
             // open connection
             QStringList errors;
             if (service->open(errors) == false) {
@@ -1835,40 +1612,36 @@ CloudServiceAutoDownload::run()
     }
 
     //
-    // Worker loop to process the list, blocking on each download
-    // and timeout if no response in 30 seconds for each
-    //
-    // Since this is asynchronous, the actual data is processed
-    // by the receivedFile method
+    // Download through a sync engine for each provider, we block
+    // on each in turn but the engine has several downloads in flight
+    // and saves them on the thread pool. The engine lives in this
+    // thread, as the providers do, and saved files are added to the
+    // ride cache back on the gui thread
     //
+    int done = 0, total = downloadlist.count();
+    foreach(CloudService *provider, providers) {
 
-    double progress=0;
-    double inc = 100.0f / double(downloadlist.count());
-    for(int i=0; i<downloadlist.count(); i++) {
-
-        // update progress indicator
-        context->notifyAutoDownloadProgress(downloadlist[i].provider->uiName(), progress, i, downloadlist.count());
-
-        CloudServiceDownloadEntry download= downloadlist[i];
-
-        // we block on read completing
-        QEventLoop loop;
-        connect(download.provider, SIGNAL(readComplete(QByteArray*,QString,QString)), &loop, SLOT(quit()));
-        QTimer::singleShot(30000,&loop, SLOT(quit())); // timeout after 30 seconds
-
-        // preallocate
-        downloadlist[i].data = new QByteArray;
+        CloudSyncEngine engine(context, provider, "autodownload");
+        connect(&engine, SIGNAL(rideSaved(QString)), this, SLOT(rideSaved(QString)), Qt::QueuedConnection);
+        connect(&engine, &CloudSyncEngine::jobFinished, [&](int, bool, QString) {
+            done++;
+            context->notifyAutoDownloadProgress(provider->uiName(), 100.0f * done / total, done, total);
+        });
 
-        download.provider->readFile(downloadlist[i].data, download.entry->name, download.entry->id);
+        for(int i=0; i<downloadlist.count(); i++)
+            if (downloadlist[i].provider == provider)
+                engine.add(CloudSyncJob::Download, downloadlist[i].entry->name, downloadlist[i].entry->id, i);
 
-        // block on timeout or readComplete...
-        loop.exec();
+        // anything an interrupted run left over
+        total += engine.resume();
 
-        // update progress
-        progress += inc;
+        context->notifyAutoDownloadProgress(provider->uiName(), 100.0f * done / total, done, total);
 
-        // if last one we need to signal done.
-        if ((i+1) == downloadlist.count()) context->notifyAutoDownloadProgress(download.provider->uiName(), progress, i+1, downloadlist.count());
+        // block until done
+        QEventLoop loop;
+        connect(&engine, SIGNAL(finished(int,int)), &loop, SLOT(quit()));
+        engine.start();
+        if (engine.isRunning()) loop.exec();
     }
 
     // time to see completion
@@ -1892,79 +1665,10 @@ CloudServiceAutoDownload::run()
 }
 
 void
-CloudServiceAutoDownload::readComplete(QByteArray*data,QString name,QString)
+CloudServiceAutoDownload::rideSaved(QString filename)
 {
-    // find the entry I belong too
-    CloudServiceDownloadEntry entry;
-    bool found=false;
-    foreach(CloudServiceDownloadEntry p, downloadlist) {
-        if (p.data == data) {
-            entry=p;
-            found=true;
-        }
-    }
-
-    if (!found) {
-        qDebug() <<"Autodownload: received file has no download entry";
-        return;
-    }
-
-    // ok. so we now know what request it was for
-    // so can process the result
-    // uncompress and parse, note the filename is passed and may be
-    // different to what we asked for (sometimes the data is converted
-    // from one file format to another).
-    QStringList errors;
-    RideFile *ride = entry.provider->uncompressRide(data, name, errors);
-
-    // free up regardless
-    delete data;
-
-    // can't process the content received.
-    if (ride == NULL) return;
-
-    // lets save this one away as json with the right filename
-    QDateTime ridedatetime = ride->startTime();
-
-    QChar zero = QLatin1Char ('0');
-    QString targetnosuffix = QString ( "%1_%2_%3_%4_%5_%6" )
-                           .arg ( ridedatetime.date().year(), 4, 10, zero )
-                           .arg ( ridedatetime.date().month(), 2, 10, zero )
-                           .arg ( ridedatetime.date().day(), 2, 10, zero )
-                           .arg ( ridedatetime.time().hour(), 2, 10, zero )
-                           .arg ( ridedatetime.time().minute(), 2, 10, zero )
-                           .arg ( ridedatetime.time().second(), 2, 10, zero );
-
-    QString filename = context->athlete->home->activities().canonicalPath() + "/" + targetnosuffix + ".json";
-
-    // exists? -- totally should never happen unless readdir timestamp mismatches actual ride
-    //            could happen if same file available at two services XXX should check above... XXX
-    QFileInfo fileinfo(filename);
-    if (fileinfo.exists()) {
-        qDebug()<<"auto download got a duplicate:"<<filename;
-        delete ride;
-        return;
-    }
-
-    // process linked defaults
-    GlobalContext::context()->rideMetadata->setLinkedDefaults(ride);
-
-    // run the processor first... import
-    DataProcessorFactory::instance().autoProcess(ride, "Auto", "Import");
-    ride->recalculateDerivedSeries();
-    // now metrics have been calculated
-    DataProcessorFactory::instance().autoProcess(ride, "Save", "ADD");
-
-    JsonFileReader reader;
-    QFile file(filename);
-    reader.writeRideFile(context, ride, file);
-
-    // delete temporary in-memory copy
-    delete ride;
-
     // add to the ride list -- but don't select it
-    context->athlete->addRide(fileinfo.fileName(), true, false);
-
+    context->athlete->addRide(filename, true, false);
 }
 
 
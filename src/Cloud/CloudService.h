@@ -49,6 +49,7 @@
 
 class RideItem;
 class CloudServiceEntry;
+class CloudSyncEngine;
 
 // Representing an Athlete when the service allows for
 // a coach or manager relationship -- i.e. it lists athletes
@@ -335,16 +336,21 @@ class CloudServiceSyncDialog : public QDialog
         void selectAllUpChanged(int);
         void selectAllSyncChanged(int);
 
-        void completedRead(QByteArray *data, QString name, QString message);
-        void completedWrite(QString name,QString message);
+        // from the sync engine
+        void jobState(int row, QString message);
+        void jobFinished(int row, bool success, QString message);
+        void rideSaved(QString filename);
+        void syncFinished(int successful, int total);
+
     private:
         Context *context;
         CloudService *store;
         QList<CloudServiceEntry*> workouts;
 
         bool downloading;
-        bool sync;
-        bool aborted;
+        CloudSyncEngine *engine;    // whilst downloading
+        QTreeWidget *running;       // the list being worked on
+        int statuscol;              // and the column showing progress
 
         // Quick lists for checking if file exists
         // locally (rideFiles) or remotely (uploadFiles)
@@ -354,16 +360,7 @@ class CloudServiceSyncDialog : public QDialog
         // keeping track of progress...
         int downloadcounter,    // *x* of n downloading
             downloadtotal,      // x of *n* downloading
-            successful,         // how many downloaded ok?
-            listindex;          // where in rideList we've got to
-
-        bool saveRide(RideFile *, QStringList &);
-        bool syncNext();        // kick off another download/upload
-                                // returns false if none left
-        bool downloadNext();    // kick off another download
-                                // returns false if none left
-        bool uploadNext();     // kick off another upload
-                                // returns false if none left
+            successful;         // how many downloaded ok?
 
         // tabs - Upload/Download
         QTabWidget *tabs;
@@ -466,8 +463,8 @@ class CloudServiceAutoDownload : public QThread {
         // thread worker to generate download requests
         void run();
 
-        // receiver for downloaded files to add to the ridecache
-        void readComplete(QByteArray*,QString,QString);
+        // downloaded files are added to the ridecache on the gui thread
+        void rideSaved(QString filename);
 
     private:
 
@@ -0,0 +1,555 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "CloudSyncEngine.h"
+#include "CloudService.h"
+
+#include "Athlete.h"
+#include "Context.h"
+#include "RideFile.h"
+#include "JsonRideFile.h"
+#include "DataProcessor.h"  // to run auto data processors
+#include "RideMetadata.h"   // for linked defaults processing
+
+#include <QCoreApplication>
+#include <QFileInfo>
+#include <QFile>
+#include <QtConcurrent>
+
+//
+// Pipeline stages that run on the thread pool, each only touches its own job
+//
+
+// parse the activity and compress it ready to upload
+static void prepareUpload(CloudSyncJob *job, Context *context, CloudService *store)
+{
+    QStringList errors;
+    QFile file(context->athlete->home->activities().canonicalPath() + "/" + job->name);
+    job->ride = RideFileFactory::instance().openRideFile(context, file, errors);
+    if (job->ride == NULL) {
+        job->message = CloudSyncEngine::tr("Parse failure");
+        return;
+    }
+
+    store->compressRide(job->ride, job->upload, QFileInfo(job->name).baseName() + ".json");
+    job->remotename = QFileInfo(job->name).baseName() + store->uploadExtension();
+}
+
+// uncompress and parse what was downloaded, it is processed in the
+// engine's thread and then saved by saveDownload
+static void parseDownload(CloudSyncJob *job, Context *context, CloudService *store, bool overwrite)
+{
+    // note the filename is passed and may be different to what we
+    // asked for (sometimes the data is converted from one format to another)
+    QStringList errors;
+    RideFile *ride = store->uncompressRide(job->data, job->remotename, errors);
+    delete job->data;
+    job->data = NULL;
+
+    if (ride == NULL) {
+        job->message = errors.join(" ");
+        return;
+    }
+
+    QDateTime ridedatetime = ride->startTime();
+
+    QChar zero = QLatin1Char ( '0' );
+    QString targetnosuffix = QString ( "%1_%2_%3_%4_%5_%6" )
+                           .arg ( ridedatetime.date().year(), 4, 10, zero )
+                           .arg ( ridedatetime.date().month(), 2, 10, zero )
+                           .arg ( ridedatetime.date().day(), 2, 10, zero )
+                           .arg ( ridedatetime.time().hour(), 2, 10, zero )
+                           .arg ( ridedatetime.time().minute(), 2, 10, zero )
+                           .arg ( ridedatetime.time().second(), 2, 10, zero );
+
+    QString filename = context->athlete->home->activities().canonicalPath() + "/" + targetnosuffix + ".json";
+
+    // exists?
+    QFileInfo fileinfo(filename);
+    if (fileinfo.exists() && overwrite == false) {
+        job->message = CloudSyncEngine::tr("File exists");
+        delete ride;
+        return;
+    }
+
+    job->ride = ride;
+    job->filename = fileinfo.fileName();
+}
+
+// save the processed download as json
+static void saveDownload(CloudSyncJob *job, Context *context)
+{
+    JsonFileReader reader;
+    QFile file(context->athlete->home->activities().canonicalPath() + "/" + job->filename);
+    if (!reader.writeRideFile(context, job->ride, file)) {
+        job->message = CloudSyncEngine::tr("Cannot write %1").arg(job->filename);
+        job->filename = "";
+    }
+
+    delete job->ride;
+    job->ride = NULL;
+}
+
+//
+// Download buffers we gave up on, the service may still write to them so
+// they are freed when its reply arrives or, failing that, with the service
+//
+class CloudSyncBuffers : public QObject
+{
+    public:
+        CloudSyncBuffers(CloudService *store) : QObject(store) {
+            connect(store, &CloudService::readComplete, this, [this](QByteArray *data, QString, QString) {
+                if (buffers.removeOne(data)) delete data;
+            });
+        }
+        ~CloudSyncBuffers() { qDeleteAll(buffers); }
+
+        void add(QByteArray *data) { buffers << data; }
+
+    private:
+        QList<QByteArray*> buffers;
+};
+
+//
+// CloudSyncEngine
+//
+CloudSyncEngine::CloudSyncEngine(Context *context, CloudService *store, QString journal, int window) :
+    context(context), store(store), window(window), overwrite(false), running(false), aborted(false), scheduled(false),
+    successful(0), failed(0), uploading(NULL)
+{
+    timer = new QTimer(this);
+    connect(timer, SIGNAL(timeout()), this, SLOT(tick()));
+
+    // owned by the service, since it may outlive us
+    abandoned = new CloudSyncBuffers(store);
+
+    connect(store, SIGNAL(readComplete(QByteArray*,QString,QString)), this, SLOT(readComplete(QByteArray*,QString,QString)));
+    connect(store, SIGNAL(writeComplete(QString,QString)), this, SLOT(writeComplete(QString,QString)));
+
+    if (journal == "") return;
+
+    // what an earlier run got through
+    journalname = QString("%1/%2.%3.journal").arg(context->athlete->home->cache().canonicalPath()).arg(store->id()).arg(journal);
+    QFile file(journalname);
+    if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        QList<QByteArray> lines = file.readAll().split('\n');
+        foreach(QByteArray line, lines) {
+
+            // "<Q|C> <U|D> <name>\t<id>"
+            QString text = QString::fromUtf8(line);
+            int tab = text.indexOf('\t');
+            if (text.length() < 5 || tab < 0) continue;
+
+            CloudSyncJob job;
+            job.direction = text.at(2) == 'U' ? CloudSyncJob::Upload : CloudSyncJob::Download;
+            job.name = text.mid(4, tab-4);
+            job.id = text.mid(tab+1);
+
+            if (text.at(0) == 'C') journalDone.insert(job.key());
+            else journalQueued << job;
+        }
+        file.close();
+    }
+}
+
+CloudSyncEngine::~CloudSyncEngine()
+{
+    // the thread pool stages are working on our jobs
+    QHashIterator<QFutureWatcher<void>*, CloudSyncJob*> i(watchers);
+    while (i.hasNext()) {
+        i.next();
+        i.key()->waitForFinished();
+        delete i.key();
+    }
+
+    foreach(CloudSyncJob *job, jobs) {
+        // a transfer still in flight may write to its buffer, so
+        // the service frees it, unless it has already gone
+        if (job->state == CloudSyncJob::Transferring && job->data && abandoned) abandoned->add(job->data);
+        else delete job->data;
+        if (job->ride) delete job->ride;
+        delete job;
+    }
+}
+
+void
+CloudSyncEngine::add(int direction, QString name, QString id, int tag)
+{
+    if (running) return;
+
+    CloudSyncJob *job = new CloudSyncJob;
+    job->direction = direction;
+    job->name = name;
+    job->id = id;
+    job->tag = tag;
+    jobs << job;
+
+    journal('Q', job);
+}
+
+void
+CloudSyncEngine::clearJournal()
+{
+    if (journalname != "") QFile::remove(journalname);
+    journalDone.clear();
+    journalQueued.clear();
+}
+
+int
+CloudSyncEngine::resume()
+{
+    QSet<QString> have;
+    foreach(CloudSyncJob *job, jobs) have.insert(job->key());
+
+    int count = 0;
+    foreach(CloudSyncJob job, journalQueued) {
+        if (have.contains(job.key()) || journalDone.contains(job.key())) continue;
+        add(job.direction, job.name, job.id, -1);
+        have.insert(job.key());
+        count++;
+    }
+    return count;
+}
+
+void
+CloudSyncEngine::start()
+{
+    if (running) return;
+
+    running = true;
+    aborted = false;
+    successful = failed = 0;
+    timer->start(1000);
+    later();
+}
+
+void
+CloudSyncEngine::abort()
+{
+    if (!running) return;
+    aborted = true;
+
+    // whatever is on the thread pool finishes, everything else stops now
+    foreach(CloudSyncJob *job, jobs) {
+        switch(job->state) {
+        case CloudSyncJob::Transferring:
+            abandon(job);
+            // fall through
+        case CloudSyncJob::Pending:
+        case CloudSyncJob::Ready:
+        case CloudSyncJob::Waiting:
+            finish(job, CloudSyncJob::Aborted, tr("Aborted"));
+            break;
+        default:
+            break;
+        }
+    }
+    later();
+}
+
+void
+CloudSyncEngine::later()
+{
+    // services may reply before readFile/writeFile even return
+    // so we never schedule more work from within a reply
+    if (scheduled) return;
+    scheduled = true;
+    QTimer::singleShot(0, this, SLOT(schedule()));
+}
+
+void
+CloudSyncEngine::schedule()
+{
+    scheduled = false;
+    if (!running) return;
+
+    int busy = 0, transfers = 0;
+    foreach(CloudSyncJob *job, jobs) {
+        if (job->state == CloudSyncJob::Preparing || job->state == CloudSyncJob::Saving) busy++;
+        if (job->state == CloudSyncJob::Transferring && job->direction == CloudSyncJob::Download) transfers++;
+    }
+
+    foreach(CloudSyncJob *job, jobs) {
+        if (aborted) break;
+
+        if (job->state == CloudSyncJob::Pending) {
+            if (job->direction == CloudSyncJob::Download && transfers < window) {
+                transfers++;
+                startRead(job);
+            } else if (job->direction == CloudSyncJob::Upload && busy < window) {
+                busy++;
+                startPrepare(job);
+            }
+        } else if (job->state == CloudSyncJob::Ready && uploading == NULL) {
+            startWrite(job);
+        }
+    }
+
+    // all done?
+    if (!watchers.isEmpty()) return;
+    foreach(CloudSyncJob *job, jobs) if (!job->done()) return;
+
+    running = false;
+    timer->stop();
+
+    // a clean run has nothing to resume
+    if (!aborted && failed == 0 && journalname != "") QFile::remove(journalname);
+
+    emit finished(successful, jobs.count());
+}
+
+void
+CloudSyncEngine::tick()
+{
+    QDateTime now = QDateTime::currentDateTime();
+    bool changed = false;
+
+    foreach(CloudSyncJob *job, jobs) {
+
+        // backoff is over
+        if (job->state == CloudSyncJob::Waiting && job->retry <= now) {
+            job->state = job->ride ? CloudSyncJob::Ready : CloudSyncJob::Pending;
+            changed = true;
+        }
+
+        // no reply
+        if (job->state == CloudSyncJob::Transferring && job->started.elapsed() > CLOUDSYNC_TIMEOUT) {
+            abandon(job);
+            attemptFailed(job, tr("Timed out"));
+            changed = true;
+        }
+    }
+    if (changed) later();
+}
+
+void
+CloudSyncEngine::startPrepare(CloudSyncJob *job)
+{
+    job->state = CloudSyncJob::Preparing;
+    emit jobState(job->tag, tr("Preparing"));
+
+    QFutureWatcher<void> *watcher = new QFutureWatcher<void>(this);
+    watchers.insert(watcher, job);
+    connect(watcher, SIGNAL(finished()), this, SLOT(prepared()));
+    watcher->setFuture(QtConcurrent::run(prepareUpload, job, context, store));
+}
+
+void
+CloudSyncEngine::prepared()
+{
+    QFutureWatcher<void> *watcher = static_cast<QFutureWatcher<void>*>(sender());
+    CloudSyncJob *job = watchers.take(watcher);
+    watcher->deleteLater();
+    if (job == NULL) return;
+
+    if (aborted) finish(job, CloudSyncJob::Aborted, tr("Aborted"));
+    else if (job->ride == NULL) finish(job, CloudSyncJob::Failed, job->message);
+    else job->state = CloudSyncJob::Ready;
+
+    later();
+}
+
+void
+CloudSyncEngine::startWrite(CloudSyncJob *job)
+{
+    uploading = job;
+    job->state = CloudSyncJob::Transferring;
+    job->started.start();
+    emit jobState(job->tag, tr("Uploading"));
+
+    // some services reply with an error before returning false
+    if (!store->writeFile(job->upload, job->remotename, job->ride) && uploading == job) {
+        uploading = NULL;
+        attemptFailed(job, tr("Upload failed"));
+    }
+}
+
+void
+CloudSyncEngine::writeComplete(QString, QString message)
+{
+    // only ever one upload in flight, since not all services name it
+    CloudSyncJob *job = uploading;
+    if (job == NULL) return;
+    uploading = NULL;
+
+    // services say so in their own translation context
+    QString completed = QCoreApplication::translate(store->metaObject()->className(), "Completed.");
+    if (message == completed || message == "Completed.") {
+        journal('C', job);
+        finish(job, CloudSyncJob::Complete, message);
+    } else {
+        attemptFailed(job, message);
+    }
+    later();
+}
+
+void
+CloudSyncEngine::startRead(CloudSyncJob *job)
+{
+    job->data = new QByteArray;
+    job->state = CloudSyncJob::Transferring;
+    job->started.start();
+    emit jobState(job->tag, tr("Downloading"));
+
+    if (!store->readFile(job->data, job->name, job->id) && job->state == CloudSyncJob::Transferring) {
+        delete job->data;
+        job->data = NULL;
+        attemptFailed(job, tr("Download failed"));
+    }
+}
+
+void
+CloudSyncEngine::readComplete(QByteArray *data, QString name, QString message)
+{
+    CloudSyncJob *job = NULL;
+    foreach(CloudSyncJob *p, jobs) {
+        if (p->direction == CloudSyncJob::Download && p->state == CloudSyncJob::Transferring && p->data == data) {
+            job = p;
+            break;
+        }
+    }
+
+    // a reply after we gave up on it, CloudSyncBuffers frees it
+    if (job == NULL) return;
+
+    if (data->isEmpty()) {
+        delete data;
+        job->data = NULL;
+        attemptFailed(job, message);
+    } else {
+        job->remotename = name;
+        startSave(job);
+    }
+    later();
+}
+
+void
+CloudSyncEngine::startSave(CloudSyncJob *job)
+{
+    job->state = CloudSyncJob::Saving;
+    emit jobState(job->tag, tr("Saving"));
+
+    QFutureWatcher<void> *watcher = new QFutureWatcher<void>(this);
+    watchers.insert(watcher, job);
+    connect(watcher, SIGNAL(finished()), this, SLOT(parsed()));
+    watcher->setFuture(QtConcurrent::run(parseDownload, job, context, store, overwrite));
+}
+
+void
+CloudSyncEngine::parsed()
+{
+    QFutureWatcher<void> *watcher = static_cast<QFutureWatcher<void>*>(sender());
+    CloudSyncJob *job = watchers.take(watcher);
+    watcher->deleteLater();
+    if (job == NULL) return;
+
+    if (aborted || job->ride == NULL) {
+        if (aborted) finish(job, CloudSyncJob::Aborted, tr("Aborted"));
+        else finish(job, CloudSyncJob::Failed, job->message);
+        later();
+        return;
+    }
+
+    // processors aren't thread safe, so they run here one ride at a time
+
+    // process linked defaults
+    GlobalContext::context()->rideMetadata->setLinkedDefaults(job->ride);
+
+    // run the processor first... import
+    DataProcessorFactory::instance().autoProcess(job->ride, "Auto", "Import");
+    job->ride->recalculateDerivedSeries();
+    // now metrics have been calculated
+    DataProcessorFactory::instance().autoProcess(job->ride, "Save", "ADD");
+
+    watcher = new QFutureWatcher<void>(this);
+    watchers.insert(watcher, job);
+    connect(watcher, SIGNAL(finished()), this, SLOT(saved()));
+    watcher->setFuture(QtConcurrent::run(saveDownload, job, context));
+}
+
+void
+CloudSyncEngine::saved()
+{
+    QFutureWatcher<void> *watcher = static_cast<QFutureWatcher<void>*>(sender());
+    CloudSyncJob *job = watchers.take(watcher);
+    watcher->deleteLater();
+    if (job == NULL) return;
+
+    if (job->filename != "") {
+        journal('C', job);
+        emit rideSaved(job->filename);
+        finish(job, CloudSyncJob::Complete, tr("Saved"));
+    } else {
+        finish(job, CloudSyncJob::Failed, job->message);
+    }
+    later();
+}
+
+void
+CloudSyncEngine::attemptFailed(CloudSyncJob *job, QString message)
+{
+    job->attempts++;
+    if (!aborted && job->attempts < CLOUDSYNC_RETRIES) {
+        job->state = CloudSyncJob::Waiting;
+        job->retry = QDateTime::currentDateTime().addMSecs(CLOUDSYNC_BACKOFF << (job->attempts-1));
+        emit jobState(job->tag, tr("%1 - retrying").arg(message));
+    } else {
+        finish(job, CloudSyncJob::Failed, message);
+    }
+}
+
+void
+CloudSyncEngine::abandon(CloudSyncJob *job)
+{
+    if (job->direction == CloudSyncJob::Download) {
+        if (job->data) {
+            if (abandoned) abandoned->add(job->data);
+            else delete job->data; // the service has gone
+        }
+        job->data = NULL;
+    } else if (uploading == job) {
+        uploading = NULL;
+    }
+}
+
+void
+CloudSyncEngine::finish(CloudSyncJob *job, int state, QString message)
+{
+    job->state = state;
+    job->message = message;
+
+    if (job->ride) delete job->ride;
+    job->ride = NULL;
+    job->upload.clear();
+
+    if (state == CloudSyncJob::Complete) successful++;
+    if (state == CloudSyncJob::Failed) failed++;
+
+    emit jobFinished(job->tag, state == CloudSyncJob::Complete, message);
+}
+
+void
+CloudSyncEngine::journal(QChar what, CloudSyncJob *job)
+{
+    if (journalname == "") return;
+
+    QFile file(journalname);
+    if (!file.open(QIODevice::Append | QIODevice::Text)) return;
+    file.write(QString("%1 %2\t%3\n").arg(what).arg(job->key()).arg(job->id).toUtf8());
+    file.close();
+}
@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef GC_CloudSyncEngine_h
+#define GC_CloudSyncEngine_h
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QHash>
+#include <QSet>
+#include <QByteArray>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+#include <QPointer>
+#include <QTimer>
+
+class Context;
+class CloudService;
+class CloudSyncBuffers;
+class RideFile;
+
+//
+// Moves activities between the athlete and a cloud service without any
+// user interface, used by the sync dialog and by auto download.
+//
+// Each job runs through a pipeline:
+//
+//   upload     parse and compress (thread pool) -> write to the service
+//   download   read from the service -> uncompress (thread pool) -> process -> save (thread pool)
+//
+// The data processors aren't thread safe, so downloads are processed one
+// at a time in the engine's thread, as they were before there was an engine.
+//
+// Up to CLOUDSYNC_WINDOW downloads are in flight at once, they are matched
+// to their job by the buffer passed to readFile. Services don't reliably
+// name the file in writeComplete so only one upload is written at a time,
+// but the next ones are parsed and compressed whilst it transfers.
+//
+// A transfer that fails or gets no reply within CLOUDSYNC_TIMEOUT is tried
+// again after a backoff, up to CLOUDSYNC_RETRIES times. Parse errors are
+// not retried.
+//
+// Jobs are recorded in a journal in the athlete cache folder as they are
+// queued and completed. If a run is interrupted resume() queues what was
+// left over, skipping what was already completed; jobs that are add()ed
+// are always transferred. The journal is removed once a run completes
+// without any failures, and clearJournal() forgets an interrupted run
+// when the user starts a new one.
+//
+// Download buffers for replies we gave up waiting for belong to the
+// service until the reply arrives, or the service is deleted.
+//
+// The engine must live in the thread that owns the service, files are
+// saved to the activities folder but it is up to the caller to add them
+// to the ride cache when rideSaved is signalled.
+//
+#define CLOUDSYNC_WINDOW    4
+#define CLOUDSYNC_RETRIES   3
+#define CLOUDSYNC_TIMEOUT   60000 // ms
+#define CLOUDSYNC_BACKOFF   2000  // ms, doubled on each retry
+
+class CloudSyncJob
+{
+    public:
+        CloudSyncJob() : direction(Download), tag(-1), state(Pending), attempts(0), data(NULL), ride(NULL) {}
+
+        enum { Upload, Download } direction_;
+        enum { Pending, Preparing, Ready, Transferring, Waiting, Saving, Complete, Failed, Aborted } state_;
+
+        int direction;
+        QString name;           // local filename to upload, remote name to download
+        QString id;             // remote id to download
+        int tag;                // the caller's, passed back in signals
+
+        int state;
+        int attempts;
+        QString message;
+
+        // in flight
+        QString remotename;     // uploaded as, or as named by the service on download
+        QString filename;       // saved as, in the activities folder
+        QByteArray *data;       // download buffer
+        QByteArray upload;      // compressed upload
+        RideFile *ride;         // kept whilst uploading, services may want its metadata
+        QDateTime retry;        // when waiting
+        QElapsedTimer started;  // when transferring
+
+        QString key() const { return QString("%1 %2").arg(direction == Upload ? "U" : "D").arg(name); }
+        bool done() const { return state == Complete || state == Failed || state == Aborted; }
+};
+
+class CloudSyncEngine : public QObject
+{
+    Q_OBJECT
+
+    public:
+        // journal names the journal, leave empty for none
+        CloudSyncEngine(Context *context, CloudService *store, QString journal = "", int window = CLOUDSYNC_WINDOW);
+        ~CloudSyncEngine();
+
+        // overwrite existing activities when downloading
+        void setOverwrite(bool x) { overwrite = x; }
+
+        // queue a job, only before start()
+        void add(int direction, QString name, QString id, int tag);
+
+        // queue whatever an interrupted run left, returns how many
+        int resume();
+
+        // forget an interrupted run, only before add()
+        void clearJournal();
+
+        void start();
+        void abort();
+
+        bool isRunning() const { return running; }
+        int count() const { return jobs.count(); }
+
+    signals:
+        void jobState(int tag, QString message);
+        void jobFinished(int tag, bool success, QString message);
+        void rideSaved(QString filename);
+        void finished(int successful, int total);
+
+    private slots:
+        void readComplete(QByteArray *data, QString name, QString message);
+        void writeComplete(QString name, QString message);
+        void prepared();
+        void parsed();
+        void saved();
+        void tick();
+        void schedule();
+
+    private:
+        void later();
+        void startPrepare(CloudSyncJob *job);
+        void startRead(CloudSyncJob *job);
+        void startWrite(CloudSyncJob *job);
+        void startSave(CloudSyncJob *job);
+        void attemptFailed(CloudSyncJob *job, QString message);
+        void finish(CloudSyncJob *job, int state, QString message);
+        void abandon(CloudSyncJob *job);
+        void journal(QChar what, CloudSyncJob *job);
+
+        Context *context;
+        CloudService *store;
+        int window;
+        bool overwrite, running, aborted, scheduled;
+        int successful, failed;
+
+        QList<CloudSyncJob*> jobs;
+        CloudSyncJob *uploading;
+        QHash<QFutureWatcher<void>*, CloudSyncJob*> watchers;
+        QPointer<CloudSyncBuffers> abandoned; // late replies may still write to them
+        QTimer *timer;
+
+        QString journalname;
+        QSet<QString> journalDone;
+        QList<CloudSyncJob> journalQueued;
+};
+
+#endif
@@ -30,6 +30,7 @@
 #include "HrZones.h"
 #include "PaceZones.h"
 #include "Measures.h"
+#include "Profiler.h"
 
 #include <QTemporaryFile>
 #include <QFile>
@@ -108,6 +109,16 @@ APIWebService::athleteData(QStringList &paths, HttpRequest &request, HttpRespons
             return;
         }
 
+        // GET Diagnostics
+        // http://localhost:12021/athlete/diagnostics
+        // optional query parameters:
+        //      ?enable=1   start profiling (0 to stop)
+        //      ?reset=1    zero the counters
+        if (paths[0] == "diagnostics") {
+            listDiagnostics(athlete, paths, request, response);
+            return;
+        }
+
     } else if (paths.count() == 3) {
 
         QString athlete = paths[0];
@@ -699,3 +710,18 @@ APIWebService::listMeasures(QString athlete, QStringList paths, HttpRequest &req
     response.write("\n");
 
 }
+
+void
+APIWebService::listDiagnostics(QString, QStringList, HttpRequest &request, HttpResponse &response)
+{
+    response.setHeader("Content-Type", "text; charset=ISO-8859-1");
+
+    // the profile is for everything this process has done
+    // so includes any other athletes it has served
+    QString enable(request.getParameter("enable"));
+    if (enable != "") Profiler::setEnabled(enable != "0");
+    if (request.getParameter("reset") == "1") Profiler::reset();
+
+    if (!Profiler::isEnabled()) response.write("# profiling is off, use ?enable=1 to start\n");
+    response.write(Profiler::csv().toLocal8Bit());
+}
@@ -24,6 +24,7 @@
 #include "Colors.h"
 #include "RideMetadata.h"
 #include "RideCache.h"
+#include "DataFilter.h"
 #include "Estimator.h"
 #include "RideFileCache.h"
 #include "RideMetric.h"
@@ -37,6 +38,7 @@
 #include "CalendarDownload.h"
 #include "PMCData.h"
 #include "Banister.h"
+#include "AthleteTimeline.h"
 #include "ErgDB.h"
 #ifdef GC_HAVE_ICAL
 #include "ICalendar.h"
@@ -164,6 +166,9 @@ Athlete::Athlete(Context *context, const QDir &homeDir)
     // Daily Measures
     measures = new Measures(home->config(), true);
 
+    // Per-date lookups, before the ride cache so it sees config changes first
+    timeline = new AthleteTimeline(context);
+
     // auto downloader
     cloudAutoDownload = new CloudServiceAutoDownload(context);
     connect(context, SIGNAL(refreshEnd()), cloudAutoDownload, SLOT(autoDownload()));
@@ -237,6 +242,9 @@ Athlete::~Athlete()
     // close the ride cache down first
     delete rideCache;
 
+    // filter results kept for the rides just deleted
+    DataFilter::forget(context);
+
     // save those preset charts
     LTMSettings reader;
     reader.writeChartXML(home->config(), presets); // don't write it until we fix the code
@@ -254,6 +262,7 @@ Athlete::~Athlete()
     delete routes;
     delete seasons;
     delete measures;
+    delete timeline;
 
     foreach (Zones* zones, zones_) delete zones;
     foreach (HrZones* hrzones, hrzones_) delete hrzones;
@@ -492,10 +501,7 @@ Athlete::getWeight(QDate date, RideFile *ride)
     double weight;
 
     // daily weight first
-    if (measures->getGroup(Measures::Body))
-        weight = measures->getGroup(Measures::Body)->getFieldValue(date);
-    else
-        weight = 0.0;
+    weight = timeline->getFieldValue(measures->getGroup(Measures::Body), date);
 
     // ride (if available)
     if (!weight && ride)
@@ -595,10 +601,6 @@ PDEstimate
 Athlete::getPDEstimateFor(QDate date, QString model, bool wpk, QString sport)
 {
     // whats the estimate for this date
-    foreach(PDEstimate est, getPDEstimates()) {
-        if (est.model == model && est.wpk == wpk && est.sport == sport && est.from <= date && est.to >= date)
-            return est;
-    }
-    return PDEstimate();
+    return timeline->getPDEstimateFor(date, model, wpk, sport);
 }
 
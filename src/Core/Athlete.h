@@ -64,6 +64,7 @@ class Leaf;
 class DataFilterRuntime;
 class CloudServiceAutoDownload;
 class Banister;
+class AthleteTimeline;
 
 class Athlete : public QObject
 {
@@ -95,6 +96,7 @@ class Athlete : public QObject
         QList<RideFileCache*> cpxCache;
         RideCache *rideCache;
         Measures *measures;
+        AthleteTimeline *timeline; // per-date zones, measures and estimates
 
         // cloud download
         CloudServiceAutoDownload *cloudAutoDownload;
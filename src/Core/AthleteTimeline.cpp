@@ -0,0 +1,296 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "AthleteTimeline.h"
+
+#include "Athlete.h"
+#include "Context.h"
+#include "RideCache.h"
+#include "Estimator.h"
+#include "Zones.h"
+#include "HrZones.h"
+#include "PaceZones.h"
+
+#include <algorithm>
+
+// the zones mark open ended ranges with these, see Zones.cpp
+static const QDate date_zero(1900, 01, 01);
+static const QDate date_infinity(9999,12,31);
+
+AthleteTimeline::AthleteTimeline(Context *context) : context(context), generation(0), estimatesGeneration(-1)
+{
+    // must be connected before the ride cache so we are up to date
+    // by the time it refreshes after the zones change
+    connect(context, SIGNAL(configChanged(qint32)), this, SLOT(configChanged(qint32)));
+}
+
+void
+AthleteTimeline::configChanged(qint32 state)
+{
+    // zones are re-read in place, measures and estimates
+    // have their own version so are checked on lookup
+    if (state & CONFIG_ZONES) {
+        lock.lockForWrite();
+        ranges.clear();
+        generation++;
+        lock.unlock();
+    }
+}
+
+//
+// Zone ranges
+//
+template<class T>
+AthleteTimelineIndex
+AthleteTimeline::rangeIndex(const T *zones)
+{
+    lock.lockForRead();
+    int current = generation;
+    bool found = ranges.contains(zones);
+    AthleteTimelineIndex returning = ranges.value(zones);
+    lock.unlock();
+
+    if (found) return returning;
+
+    // the range only changes at a start or end date, the open ended
+    // markers are left out and covered by before and after instead
+    // (lookups outside them go straight to whichRange)
+    QList<QDate> bounds;
+    for (int i=0; i<zones->getRangeSize(); i++) {
+        QDate start = zones->getStartDate(i), end = zones->getEndDate(i);
+        if (!start.isNull() && start > date_zero && start < date_infinity) bounds << start;
+        if (!end.isNull() && end > date_zero && end < date_infinity) bounds << end;
+    }
+    std::sort(bounds.begin(), bounds.end());
+
+    if (bounds.isEmpty()) {
+
+        // same range whatever the date
+        returning.before = returning.after = zones->whichRange(QDate::currentDate());
+
+    } else if (bounds.first().daysTo(bounds.last()) >= TIMELINE_MAXDAYS) {
+
+        returning.scan = true;
+
+    } else {
+
+        // ranges are ordered by date so this is a short loop per day
+        returning.first = bounds.first();
+        returning.before = zones->whichRange(bounds.first().addDays(-1));
+        returning.after = zones->whichRange(bounds.last());
+        returning.index.resize(bounds.first().daysTo(bounds.last()) + 1);
+        for (int i=0; i<returning.index.count(); i++)
+            returning.index[i] = zones->whichRange(returning.first.addDays(i));
+    }
+
+    // unless the zones changed whilst we were at it
+    lock.lockForWrite();
+    if (generation == current) ranges.insert(zones, returning);
+    lock.unlock();
+
+    return returning;
+}
+
+int
+AthleteTimeline::zoneRange(const Zones *zones, QDate date)
+{
+    if (zones == NULL) return -1;
+    if (!date.isValid() || date <= date_zero || date >= date_infinity) return zones->whichRange(date);
+
+    AthleteTimelineIndex days = rangeIndex(zones);
+    return days.scan ? zones->whichRange(date) : days.at(date);
+}
+
+int
+AthleteTimeline::hrZoneRange(const HrZones *zones, QDate date)
+{
+    if (zones == NULL) return -1;
+    if (!date.isValid() || date <= date_zero || date >= date_infinity) return zones->whichRange(date);
+
+    AthleteTimelineIndex days = rangeIndex(zones);
+    return days.scan ? zones->whichRange(date) : days.at(date);
+}
+
+int
+AthleteTimeline::paceZoneRange(const PaceZones *zones, QDate date)
+{
+    if (zones == NULL) return -1;
+    if (!date.isValid() || date <= date_zero || date >= date_infinity) return zones->whichRange(date);
+
+    AthleteTimelineIndex days = rangeIndex(zones);
+    return days.scan ? zones->whichRange(date) : days.at(date);
+}
+
+//
+// Measures
+//
+void
+AthleteTimeline::getMeasure(MeasuresGroup *group, QDate date, Measure &here)
+{
+    // always set to not found before searching
+    here = Measure();
+
+    if (group == NULL) return;
+    if (!date.isValid()) {
+        group->getMeasure(date, here);
+        return;
+    }
+
+    lock.lockForRead();
+    MeasureTable table = measures.value(group);
+    lock.unlock();
+
+    if (table.version != group->version()) {
+
+        table = MeasureTable();
+        table.version = group->version();
+        table.measures = group->measures();
+
+        // body measures carry forward to the next one, the
+        // rest only apply on the day they were taken
+        bool carry = (group->getSymbol() == "Body");
+        int n = table.measures.count();
+
+        if (n && !table.measures.first().when.date().isValid()) {
+
+            table.days.scan = true;
+
+        } else if (n && table.measures.first().when.date().daysTo(table.measures.last().when.date()) >= TIMELINE_MAXDAYS) {
+
+            table.days.scan = true;
+
+        } else if (n) {
+
+            // measures are in date order, last one on the day wins
+            table.days.first = table.measures.first().when.date();
+            table.days.before = -1;
+            table.days.after = carry ? n-1 : -1;
+            table.days.index.resize(table.days.first.daysTo(table.measures.last().when.date()) + 1);
+
+            int next = 0, last = -1;
+            for (int i=0; i<table.days.index.count(); i++) {
+
+                QDate day = table.days.first.addDays(i);
+                int today = -1;
+                while (next < n && table.measures.at(next).when.date() <= day) today = last = next++;
+
+                table.days.index[i] = carry ? last : today;
+            }
+        }
+
+        lock.lockForWrite();
+        measures.insert(group, table);
+        lock.unlock();
+    }
+
+    if (table.days.scan) {
+        group->getMeasure(date, here);
+    } else {
+        int i = table.days.at(date);
+        if (i >= 0) here = table.measures.at(i);
+    }
+}
+
+double
+AthleteTimeline::getFieldValue(MeasuresGroup *group, QDate date, int field)
+{
+    Measure measure;
+    getMeasure(group, date, measure);
+
+    // metric units only
+    if (field >= 0 && field < MAX_MEASURES) return measure.values[field];
+    else return 0.0;
+}
+
+//
+// PD Estimates
+//
+PDEstimate
+AthleteTimeline::getPDEstimateFor(QDate date, QString model, bool wpk, QString sport)
+{
+    RideCache *rideCache = context->athlete->rideCache;
+    if (rideCache == NULL || rideCache->estimator == NULL || !date.isValid()) return PDEstimate();
+    Estimator *estimator = rideCache->estimator;
+
+    QString key = QString("%1|%2|%3").arg(model).arg(wpk ? 1 : 0).arg(sport);
+
+    lock.lockForRead();
+    bool found = estimatesGeneration == estimator->generation.loadAcquire() && estimateDays.contains(key);
+    QList<PDEstimate> list = estimates;
+    AthleteTimelineIndex days = estimateDays.value(key);
+    lock.unlock();
+
+    if (!found) {
+
+        estimator->lock.lock();
+        int current = estimator->generation.loadAcquire();
+        list = estimator->estimates;
+        estimator->lock.unlock();
+
+        // span of the estimates for this model
+        QDate from, to;
+        bool undated = false;
+        foreach(const PDEstimate &est, list) {
+            if (est.model != model || est.wpk != wpk || est.sport != sport) continue;
+            if (!est.from.isValid() || !est.to.isValid()) undated = true;
+            else {
+                if (!from.isValid() || est.from < from) from = est.from;
+                if (!to.isValid() || est.to > to) to = est.to;
+            }
+        }
+
+        days = AthleteTimelineIndex();
+        if (undated || (from.isValid() && from.daysTo(to) >= TIMELINE_MAXDAYS)) {
+
+            days.scan = true;
+
+        } else if (from.isValid()) {
+
+            // first estimate in the list that covers the day wins
+            days.first = from;
+            days.index.fill(-1, from.daysTo(to) + 1);
+            for (int i=0; i<list.count(); i++) {
+                const PDEstimate &est = list.at(i);
+                if (est.model != model || est.wpk != wpk || est.sport != sport) continue;
+
+                for (qint64 d = from.daysTo(est.from); d <= from.daysTo(est.to); d++)
+                    if (d >= 0 && days.index.at(d) == -1) days.index[d] = i;
+            }
+        }
+
+        lock.lockForWrite();
+        if (estimatesGeneration != current) {
+            estimateDays.clear();
+            estimates = list;
+            estimatesGeneration = current;
+        }
+        estimateDays.insert(key, days);
+        lock.unlock();
+    }
+
+    if (days.scan) {
+        foreach(const PDEstimate &est, list) {
+            if (est.model == model && est.wpk == wpk && est.sport == sport && est.from <= date && est.to >= date)
+                return est;
+        }
+        return PDEstimate();
+    }
+
+    int i = days.at(date);
+    return i >= 0 ? list.at(i) : PDEstimate();
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef _GC_AthleteTimeline_h
+#define _GC_AthleteTimeline_h 1
+
+#include "Measures.h"
+#include "PDModel.h"
+
+#include <QObject>
+#include <QVector>
+#include <QHash>
+#include <QDate>
+#include <QReadWriteLock>
+
+class Context;
+class Zones;
+class HrZones;
+class PaceZones;
+
+//
+// Per-date settings lookups for metrics, the PMC and the charts.
+//
+// Zone ranges, measures and PD estimates are held as an index per day,
+// so finding what applies on a date is an array lookup rather than a
+// scan over the ranges, measures or estimates. CP, W', FTP, LTHR and
+// resting HR come straight from the zone range that applies.
+//
+// Each table is built the first time it is needed and dropped when its
+// source changes; zones on CONFIG_ZONES, measures when the group's
+// version moves on and estimates when the estimator's generation does.
+// Tables are copied out under the lock so lookups are thread safe.
+//
+#define TIMELINE_MAXDAYS (366*200) // beyond this we just scan
+
+class AthleteTimelineIndex
+{
+    public:
+        AthleteTimelineIndex() : before(-1), after(-1), scan(false) {}
+
+        // index for the date, days outside the table take before/after
+        int at(QDate date) const {
+            if (index.isEmpty()) return after;
+            qint64 offset = first.daysTo(date);
+            if (offset < 0) return before;
+            if (offset >= index.count()) return after;
+            return index.at(offset);
+        }
+
+        QDate first;
+        QVector<int> index;
+        int before, after;
+        bool scan; // too sparse to tabulate, look up at source
+};
+
+class AthleteTimeline : public QObject
+{
+    Q_OBJECT
+
+    public:
+        AthleteTimeline(Context *context);
+
+        // zone range that applies on date, as whichRange()
+        int zoneRange(const Zones *zones, QDate date);
+        int hrZoneRange(const HrZones *zones, QDate date);
+        int paceZoneRange(const PaceZones *zones, QDate date);
+
+        // measure that applies on date, as MeasuresGroup::getMeasure()
+        void getMeasure(MeasuresGroup *group, QDate date, Measure &here);
+        double getFieldValue(MeasuresGroup *group, QDate date, int field=0);
+
+        // estimate that applies on date, as Athlete::getPDEstimateFor()
+        PDEstimate getPDEstimateFor(QDate date, QString model, bool wpk, QString sport);
+
+    public slots:
+        void configChanged(qint32);
+
+    private:
+        struct MeasureTable {
+            MeasureTable() : version(-1) {}
+            int version;
+            QList<Measure> measures;
+            AthleteTimelineIndex days;
+        };
+
+        template<class T> AthleteTimelineIndex rangeIndex(const T *zones);
+
+        Context *context;
+        QReadWriteLock lock;
+        int generation; // bumped when zones change
+
+        QHash<const void*, AthleteTimelineIndex> ranges;
+        QHash<const MeasuresGroup*, MeasureTable> measures;
+
+        int estimatesGeneration;
+        QList<PDEstimate> estimates;
+        QHash<QString, AthleteTimelineIndex> estimateDays;
+};
+
+#endif // _GC_AthleteTimeline_h
@@ -60,7 +60,9 @@ QMutex pythonMutex;
 #include "Zones.h"
 #include "PaceZones.h"
 #include "HrZones.h"
+#include "AthleteTimeline.h"
 #include "UserChart.h"
+#include "Profiler.h"
 
 #include "DataFilter_yacc.h"
 
@@ -1485,6 +1487,46 @@ Leaf::findSymbols(QStringList &symbols)
     }
 }
 
+void
+Leaf::findFunctions(QStringList &functions)
+{
+    switch(type) {
+    case Leaf::Script :
+        functions << function;
+        break;
+    case Leaf::Compound :
+        foreach(Leaf *p, *(lvalue.b)) p->findFunctions(functions);
+        break;
+
+    case Leaf::Operation:
+    case Leaf::BinaryOperation:
+    case Leaf::Logical :
+        lvalue.l->findFunctions(functions);
+        if (op) rvalue.l->findFunctions(functions);
+        break;
+    case Leaf::UnaryOperation:
+        lvalue.l->findFunctions(functions);
+        break;
+    case Leaf::Function:
+        functions << function;
+        foreach(Leaf* l, fparms) l->findFunctions(functions);
+        break;
+    case Leaf::Index:
+    case Leaf::Select:
+        lvalue.l->findFunctions(functions);
+        fparms[0]->findFunctions(functions);
+        break;
+    case Leaf::Conditional:
+        cond.l->findFunctions(functions);
+        lvalue.l->findFunctions(functions);
+        if (rvalue.l) rvalue.l->findFunctions(functions);
+        break;
+
+    default:
+        break;
+    }
+}
+
 void Leaf::print(int level, DataFilterRuntime *df)
 {
     qDebug()<<"LEVEL"<<level;
@@ -3112,7 +3154,80 @@ void Leaf::validateFilter(Context *context, DataFilterRuntime *df, Leaf *leaf)
     }
 }
 
-DataFilter::DataFilter(QObject *parent, Context *context) : QObject(parent), context(context), treeRoot(NULL), parent_(parent)
+//
+// Filter results memoised by context and fingerprint, see DataFilter::results
+// only the most recently used DATAFILTER_MEMOS fingerprints are kept for each
+//
+#define DATAFILTER_MEMOS 32
+struct DataFilterMemo {
+    QVector<RideItem*> items;
+    QVector<quint64> versions; // RideItem::version when evaluated, 0 if not
+    QBitArray pass;
+    QHash<RideItem*, int> index;
+};
+struct DataFilterMemos {
+    QHash<QString, DataFilterMemo> memo;
+    QStringList recent; // fingerprints, least recently used first
+};
+static QMutex memoLock;
+static QHash<Context*, DataFilterMemos> memos;
+
+// functions whose result only depends on their parameters and the ride
+static const QStringList memoFunctions = {
+    "cos", "tan", "sin", "acos", "atan", "asin", "cosh", "tanh", "sinh", "acosh", "atanh", "asinh",
+    "exp", "log", "ceil", "floor", "round", "fabs", "isinf", "isnan", "sqrt", "bool",
+    "sum", "mean", "max", "min", "count", "c", "variance", "stddev", "median", "mode",
+    "isset", "isNumber", "isString", "metadata", "filename", "tolower", "toupper", "trim", "replace", "join", "split",
+    "week", "month", "weekdate", "monthdate"
+};
+
+// does the expression only depend on the ride it is evaluated for?
+static bool memoisable(DataFilterRuntime *df, Leaf *leaf)
+{
+    if (leaf == NULL) return true;
+
+    switch(leaf->type) {
+    case Leaf::Float :
+    case Leaf::Integer :
+    case Leaf::String :
+        return true;
+
+    case Leaf::Symbol :
+        {
+            // metrics and metadata, and first class ride attributes
+            // but not Today, Current, user symbols or sample data
+            QString symbol = *(leaf->lvalue.n);
+            return df->lookupMap.contains(symbol) || isCoggan(symbol) ||
+                   !symbol.compare("Date", Qt::CaseInsensitive) || !symbol.compare("Time", Qt::CaseInsensitive) ||
+                   !symbol.compare("RECINTSECS", Qt::CaseInsensitive) || !symbol.compare("NA", Qt::CaseInsensitive) ||
+                   symbol == "isRide" || symbol == "isSwim" || symbol == "isRun" || symbol == "isXtrain" || symbol == "isAero";
+        }
+
+    case Leaf::Operation :
+        if (leaf->op == ASSIGN) return false;
+        // intentional fallthrough
+    case Leaf::Logical :
+    case Leaf::BinaryOperation :
+        return memoisable(df, leaf->lvalue.l) && memoisable(df, leaf->rvalue.l);
+
+    case Leaf::UnaryOperation :
+        return memoisable(df, leaf->lvalue.l);
+
+    case Leaf::Conditional :
+        return memoisable(df, leaf->cond.l) && memoisable(df, leaf->lvalue.l) && memoisable(df, leaf->rvalue.l);
+
+    case Leaf::Function :
+        if (leaf->series || df->functions.contains(leaf->function) || !memoFunctions.contains(leaf->function)) return false;
+        foreach(Leaf *parm, leaf->fparms) if (!memoisable(df, parm)) return false;
+        return true;
+
+    default:
+        // scripts, indexing, blocks etc
+        return false;
+    }
+}
+
+DataFilter::DataFilter(QObject *parent, Context *context) : QObject(parent), context(context), treeRoot(NULL), memoise(false), parent_(parent)
 {
     // let folks know who owns this rumtime for signalling
     rt.owner = this;
@@ -3140,7 +3255,7 @@ DataFilter::DataFilter(QObject *parent, Context *context) : QObject(parent), con
     //connect(context, SIGNAL(rideSelected(RideItem*)), this, SLOT(dynamicParse()));
 }
 
-DataFilter::DataFilter(QObject *parent, Context *context, QString formula) : QObject(parent), context(context), treeRoot(NULL), parent_(parent)
+DataFilter::DataFilter(QObject *parent, Context *context, QString formula) : QObject(parent), context(context), treeRoot(NULL), memoise(false), parent_(parent)
 {
     // let folks know who owns this rumtime for signalling
     rt.owner = this;
@@ -3180,6 +3295,7 @@ DataFilter::DataFilter(QObject *parent, Context *context, QString formula) : QOb
         treeRoot=NULL;
 
     errors = DataFiltererrors;
+    setMemoise();
 }
 
 Result DataFilter::evaluate(RideItem *item, RideFilePoint *p)
@@ -3208,6 +3324,86 @@ Result DataFilter::evaluate(RideItem *item, RideFilePoint *p)
     return res;
 }
 
+void
+DataFilter::setMemoise()
+{
+    memoise = treeRoot && errors.count() == 0 && sig != "" && rt.functions.count() == 0 && memoisable(&rt, treeRoot);
+}
+
+QBitArray
+DataFilter::results(const QVector<RideItem*> &rides, const Specification &spec)
+{
+    QBitArray returning(rides.count());
+
+    if (!memoise) {
+        for(int i=0; i<rides.count(); i++)
+            if (spec.pass(rides.at(i)) && evaluate(rides.at(i), NULL).number() != 0) returning.setBit(i);
+        return returning;
+    }
+
+    // take what we had, we don't hold the lock whilst evaluating
+    memoLock.lock();
+    DataFilterMemo last = memos.value(context).memo.value(sig);
+    memoLock.unlock();
+
+    DataFilterMemo memo;
+    memo.items = rides;
+    memo.versions.fill(0, rides.count());
+    for(int i=0; i<rides.count(); i++) {
+        RideItem *item = rides.at(i);
+        memo.index.insert(item, i);
+
+        // outside the spec so not evaluated, versions start at 1
+        if (!spec.pass(item)) continue;
+
+        // usually rides are where they were last time
+        int j = (i < last.items.count() && last.items.at(i) == item) ? i : last.index.value(item, -1);
+
+        if (j >= 0 && last.versions.at(j) == item->version) {
+            if (last.pass.testBit(j)) returning.setBit(i);
+        } else if (evaluate(item, NULL).number() != 0) {
+            returning.setBit(i);
+        }
+        memo.versions[i] = item->version;
+    }
+    memo.pass = returning;
+
+    memoLock.lock();
+    DataFilterMemos &kept = memos[context];
+    kept.recent.removeOne(sig);
+    while (kept.recent.count() >= DATAFILTER_MEMOS) kept.memo.remove(kept.recent.takeFirst());
+    kept.recent.append(sig);
+    kept.memo.insert(sig, memo);
+    memoLock.unlock();
+
+    return returning;
+}
+
+void
+DataFilter::forget(Context *context)
+{
+    // the rides are going, don't keep pointers to them
+    QMutexLocker locker(&memoLock);
+    memos.remove(context);
+}
+
+bool
+DataFilter::passes(RideItem *item)
+{
+    if (memoise && item) {
+        QMutexLocker locker(&memoLock);
+        QHash<Context*, DataFilterMemos>::const_iterator kept = memos.constFind(context);
+        if (kept != memos.constEnd()) {
+            QHash<QString, DataFilterMemo>::const_iterator memo = kept.value().memo.constFind(sig);
+            if (memo != kept.value().memo.constEnd()) {
+                int i = memo.value().index.value(item, -1);
+                if (i >= 0 && memo.value().versions.at(i) == item->version) return memo.value().pass.testBit(i);
+            }
+        }
+    }
+    return evaluate(item, NULL).number() != 0;
+}
+
 Result DataFilter::evaluate(Specification spec, DateRange dr)
 {
     // if there is no current ride item then there is no data
@@ -3275,6 +3471,7 @@ QStringList DataFilter::check(QString query)
     }
 
     errors = DataFiltererrors;
+    setMemoise();
     return errors;
 }
 
@@ -3285,15 +3482,15 @@ QStringList DataFilter::parseFilter(Context *context, QString query, QStringList
     rt.isdynamic=false;
     rt.symbols.clear();
 
-    // regardless of fail/pass set the signature
-    setSignature(query);
-
     //DataFilterdebug = 2; // no debug -- needs bison -t in src.pro
     DataFilterroot = NULL;
 
     // if something was left behind clear it up now
     clearFilter();
 
+    // regardless of fail/pass set the signature
+    setSignature(query);
+
     // Parse from string
     DataFiltererrors.clear(); // clear out old errors
     DataFilter_setString(query);
@@ -3327,14 +3524,31 @@ QStringList DataFilter::parseFilter(Context *context, QString query, QStringList
         // clear current filter list
         filenames.clear();
 
-        // get all fields...
-        foreach(RideItem *item, context->athlete->rideCache->rides()) {
+        // only rides changed since last time are evaluated
+        errors = DataFiltererrors;
+        setMemoise();
+        if (memoise) {
+            const QVector<RideItem*> &rides = context->athlete->rideCache->rides();
+            QBitArray pass = results(rides);
+            for(int i=0; i<rides.count(); i++)
+                if (pass.testBit(i)) filenames << rides.at(i)->fileName;
+        } else {
 
-            // evaluate each ride...
-            Result result = treeRoot->eval(&rt, treeRoot, Result(0), 0,item, NULL);
-            if (result.isNumber && result.number()) {
-                filenames << item->fileName;
+            // get all fields...
+#ifdef GC_WANT_PYTHON
+            rt.beginPythonBatch(context->athlete->rideCache->rides());
+#endif
+            foreach(RideItem *item, context->athlete->rideCache->rides()) {
+
+                // evaluate each ride...
+                Result result = treeRoot->eval(&rt, treeRoot, Result(0), 0,item, NULL);
+                if (result.isNumber && result.number()) {
+                    filenames << item->fileName;
+                }
             }
+#ifdef GC_WANT_PYTHON
+            rt.endPythonBatch();
+#endif
         }
         emit results(filenames);
         if (list) *list = filenames;
@@ -3354,6 +3568,9 @@ DataFilter::dynamicParse()
         filenames.clear();
 
         // get all fields...
+#ifdef GC_WANT_PYTHON
+        rt.beginPythonBatch(context->athlete->rideCache->rides());
+#endif
         foreach(RideItem *item, context->athlete->rideCache->rides()) {
 
             // evaluate each ride...
@@ -3361,6 +3578,9 @@ DataFilter::dynamicParse()
             if (result.isNumber && result.number())
                 filenames << item->fileName;
         }
+#ifdef GC_WANT_PYTHON
+        rt.endPythonBatch();
+#endif
         emit results(filenames);
         if (list) *list = filenames;
     }
@@ -3375,11 +3595,17 @@ void DataFilter::clearFilter()
         errors.clear();
     }
     rt.isdynamic = false;
+    memoise = false;
     sig = "";
 }
 
 void DataFilter::configChanged(qint32)
 {
+    // metric and metadata definitions may have changed
+    memoLock.lock();
+    memos.clear();
+    memoLock.unlock();
+
     rt.lookupMap.clear();
     rt.lookupType.clear();
 
@@ -3524,6 +3750,8 @@ Result Leaf::eval(DataFilterRuntime *df, Leaf *leaf, const Result &x, long it, R
             return res;
         }
 
+        PROFILE(Profiler::Function, leaf->function);
+
         if (leaf->function == "isNumber") {
             return eval(df, leaf->fparms[0],x, it, m, p, c, s, d).isNumber;
         }
@@ -3855,7 +4083,7 @@ Result Leaf::eval(DataFilterRuntime *df, Leaf *leaf, const Result &x, long it, R
             if (m->context->athlete->zones(m->sport)) {
 
                 // if range is -1 we need to fall back to a default value
-                zoneRange = m->context->athlete->zones(m->sport)->whichRange(m->dateTime.date());
+                zoneRange = m->context->athlete->timeline->zoneRange(m->context->athlete->zones(m->sport), m->dateTime.date());
                 FTP = CP = zoneRange >= 0 ? m->context->athlete->zones(m->sport)->getCP(zoneRange) : 0;
                 AeTP = zoneRange >= 0 ? m->context->athlete->zones(m->sport)->getAeT(zoneRange) : 0;
                 WPRIME = zoneRange >= 0 ? m->context->athlete->zones(m->sport)->getWprime(zoneRange) : 0;
@@ -3879,9 +4107,7 @@ Result Leaf::eval(DataFilterRuntime *df, Leaf *leaf, const Result &x, long it, R
             //
             // LTHR, AeTHR, MaxHR, RHR
             //
-            int hrZoneRange = m->context->athlete->hrZones(m->sport) ?
-                              m->context->athlete->hrZones(m->sport)->whichRange(m->dateTime.date())
-                              : -1;
+            int hrZoneRange = m->context->athlete->timeline->hrZoneRange(m->context->athlete->hrZones(m->sport), m->dateTime.date());
 
             int LTHR = hrZoneRange != -1 ?  m->context->athlete->hrZones(m->sport)->getLT(hrZoneRange) : 0;
             int AeTHR = hrZoneRange != -1 ?  m->context->athlete->hrZones(m->sport)->getAeT(hrZoneRange) : 0;
@@ -3891,9 +4117,7 @@ Result Leaf::eval(DataFilterRuntime *df, Leaf *leaf, const Result &x, long it, R
             //
             // CV
             //
-            int paceZoneRange = m->context->athlete->paceZones(m->isSwim) ?
-                                m->context->athlete->paceZones(m->isSwim)->whichRange(m->dateTime.date()) :
-                                -1;
+            int paceZoneRange = m->context->athlete->timeline->paceZoneRange(m->context->athlete->paceZones(m->isSwim), m->dateTime.date());
 
             double CV = (paceZoneRange != -1) ? m->context->athlete->paceZones(m->isSwim)->getCV(paceZoneRange) : 0.0;
             double AeTV = (paceZoneRange != -1) ? m->context->athlete->paceZones(m->isSwim)->getAeT(paceZoneRange) : 0.0;
@@ -4688,16 +4912,16 @@ Result Leaf::eval(DataFilterRuntime *df, Leaf *leaf, const Result &x, long it, R
                 // now we need to get all the values into returning
                 int index=0;
                 if (km || secs || (index=xds->valuename.indexOf(series)) != -1) {
-                    foreach(XDataPoint *p, xds->datapoints) {
+                    for (int row=0; row<xds->count(); row++) {
 
                         // honor interval boundaries when limits are set
-                        if (p->secs < s.secsStart()) continue;
-                        if (s.secsEnd() > -1 && p->secs > s.secsEnd()) break;
+                        if (xds->secs(row) < s.secsStart()) continue;
+                        if (s.secsEnd() > -1 && xds->secs(row) > s.secsEnd()) break;
 
                         double value=0;
-                        if (km) value = p->km;
-                        else if (secs) value = p->secs;
-                        else if (index >=0)  value =p->number[index];
+                        if (km) value = xds->km(row);
+                        else if (secs) value = xds->secs(row);
+                        else if (index >=0)  value = xds->value(row, index);
 
                         returning.asNumeric() << value;
                         returning.number()  += value;
@@ -4731,11 +4955,9 @@ Result Leaf::eval(DataFilterRuntime *df, Leaf *leaf, const Result &x, long it, R
                 if (leaf->function == "xdatavalues") {
 
                     for (int idx=0; idx <xds->valuename.count(); idx++) {
-                        foreach(XDataPoint *p, xds->datapoints) {
-
-                            returning.asNumeric() << p->number[idx];
-                            returning.number()  += p->number[idx];
-                        }
+                        const QVector<double> values = xds->column(idx);
+                        returning.asNumeric() << values;
+                        foreach(double value, values) returning.number() += value;
                     }
                 }
             }
@@ -7649,7 +7871,24 @@ Result Leaf::eval(DataFilterRuntime *df, Leaf *leaf, const Result &x, long it, R
  #ifdef GC_WANT_PYTHON
         if (m == NULL) return Result(0); // no ride then no context
 
-        if (leaf->function == "python")  return Result(df->runPythonScript(m->context, *leaf->lvalue.s, m, c, s));
+        if (leaf->function == "python") {
+
+            // filtering a block of rides, so run for them all at once
+            if (df->pythonBatch.count() && leaf->lvalue.s && c == df->pythonMetrics.value(m, NULL) &&
+                s.interval() == NULL && s.signature() == Specification().signature()) {
+
+                QHash<Leaf*, QHash<RideItem*, double> >::iterator it = df->pythonResults.find(leaf);
+                if (it == df->pythonResults.end()) {
+                    QVector<double> results = df->runPythonScripts(m->context, *leaf->lvalue.s, df->pythonBatch, c, s);
+                    QHash<RideItem*, double> values;
+                    for (int i=0; i<results.count(); i++) values.insert(df->pythonBatch.at(i), results.at(i));
+                    it = df->pythonResults.insert(leaf, values);
+                }
+                QHash<RideItem*, double>::const_iterator value = it.value().constFind(m);
+                if (value != it.value().constEnd()) return Result(value.value());
+            }
+            return Result(df->runPythonScript(m->context, *leaf->lvalue.s, m, c, s));
+        }
  #endif
         return Result(0);
     }
@@ -8352,4 +8591,46 @@ DataFilterRuntime::runPythonScript(Context *context, QString script, RideItem *m
 
     return result;
 }
+
+QVector<double>
+DataFilterRuntime::runPythonScripts(Context *context, QString script, QVector<RideItem*> items, const QHash<QString,RideMetric*> *metrics, Specification spec)
+{
+    if (python == NULL) return QVector<double>(items.count(), 0);
+
+    QList<ScriptContext> contexts;
+    foreach(RideItem *item, items) contexts << ScriptContext(context, item, pythonMetrics.value(item, metrics), spec);
+
+    // get the lock, once for the whole block
+    pythonMutex.lock();
+
+    QVector<double> results;
+    python->canvas = NULL;
+    python->chart = NULL;
+
+    try {
+
+        // run it
+        results = python->runBatch(contexts, script);
+
+    } catch(std::exception& ex) {
+        Q_UNUSED(ex)
+
+        python->messages.clear();
+
+    } catch(...) {
+
+        python->messages.clear();
+
+    }
+    if (results.count() != items.count()) results = QVector<double>(items.count(), 0);
+
+    // clear context
+    python->canvas = NULL;
+    python->chart = NULL;
+
+    // free up the interpreter
+    pythonMutex.unlock();
+
+    return results;
+}
 #endif
@@ -25,6 +25,7 @@
 #include <QList>
 #include <QMap>
 #include <QHash>
+#include <QBitArray>
 #include <QStringList>
 #include <QTextDocument>
 #include "RideCache.h"
@@ -138,6 +139,7 @@ class Leaf {
         void validateFilter(Context *context, DataFilterRuntime *, Leaf*); // validate
         bool isNumber(DataFilterRuntime *df, Leaf *leaf);
         void findSymbols(QStringList &symbols); // when working with formulas
+        void findFunctions(QStringList &functions); // and the functions and scripts they call
         void clear(Leaf*);
         QString toString(); // return as string
         QString signature() { return toString(); }
@@ -210,6 +212,21 @@ public:
 #ifdef GC_WANT_PYTHON
     // embedded python runtime
     double runPythonScript(Context *context, QString script, RideItem *m, const QHash<QString,RideMetric*> *metrics, Specification spec);
+
+    // run it for a block of rides in one go, results are in the same order
+    QVector<double> runPythonScripts(Context *context, QString script, QVector<RideItem*> items, const QHash<QString,RideMetric*> *metrics, Specification spec);
+
+    // whilst filtering a block of rides python() is run for all of them
+    // the first time it is evaluated and the results are looked up after,
+    // user metrics pass the metrics each ride's script can see
+    void beginPythonBatch(QVector<RideItem*> items,
+                          QHash<RideItem*, const QHash<QString,RideMetric*>*> metrics = QHash<RideItem*, const QHash<QString,RideMetric*>*>()) {
+        pythonBatch = items; pythonMetrics = metrics; pythonResults.clear();
+    }
+    void endPythonBatch() { pythonBatch.clear(); pythonMetrics.clear(); pythonResults.clear(); }
+    QVector<RideItem*> pythonBatch;
+    QHash<RideItem*, const QHash<QString,RideMetric*>*> pythonMetrics;
+    QHash<Leaf*, QHash<RideItem*, double> > pythonResults;
 #endif
 
     DataFilter *owner;
@@ -250,6 +267,17 @@ class DataFilter : public QObject
         QStringList getErrors() { return errors; };
         void colorSyntax(QTextDocument *content, int pos);
 
+        // pass/fail of each ride, as evaluate(item, NULL) would give. When
+        // the expression only depends on the ride itself results are kept
+        // by fingerprint and ride version, so only changed rides are
+        // evaluated and filters with the same fingerprint share them.
+        // Rides that fail spec are never evaluated, and fail.
+        QBitArray results(const QVector<RideItem*> &rides, const Specification &spec = Specification());
+        bool passes(RideItem *item);
+
+        // drop the results kept for an athlete, when it closes
+        static void forget(Context *context);
+
         static QStringList builtins(Context *); // return list of functions supported
 
         int refcount; // used by user metrics
@@ -272,8 +300,10 @@ class DataFilter : public QObject
 
     private:
         void setSignature(QString &query);
+        void setMemoise();
 
         Leaf *treeRoot;
+        bool memoise;
         QStringList errors;
 
         QStringList filenames;
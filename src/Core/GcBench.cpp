@@ -0,0 +1,441 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "GcBench.h"
+
+#include "Context.h"
+#include "Athlete.h"
+#include "RideCache.h"
+#include "RideItem.h"
+#include "RideFile.h"
+#include "RideFileCache.h"
+#include "RideMetric.h"
+#include "Specification.h"
+#include "DataFilter.h"
+#include "PMCData.h"
+#include "Estimator.h"
+#include "LTMSettings.h"
+#include "GoldenCheetah.h" // for chartPropertiesFromFile
+
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QDataStream>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDirIterator>
+#include <QHash>
+#include <QTemporaryFile>
+#include <QThread>
+#include <QDateTime>
+
+#include <algorithm>
+#include <random>
+#include <cmath>
+#include <cstdio>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+// elapsed time in ms, with sub-ms resolution
+static double elapsed(QElapsedTimer &timer) { return timer.nsecsElapsed() / 1000000.0; }
+
+GcBench::GcBench(Context *context) : context(context)
+{
+}
+
+void
+GcBench::record(QString name, double ms, qint64 samples)
+{
+    for (int i=0; i<stages.count(); i++) {
+        if (stages[i].name == name) {
+            stages[i].ms << ms;
+            stages[i].samples += samples;
+            stages[i].rss = peakRSS();
+            return;
+        }
+    }
+
+    Stage add;
+    add.name = name;
+    add.ms << ms;
+    add.samples = samples;
+    add.rss = peakRSS();
+    stages << add;
+}
+
+void
+GcBench::run(QString files, QString charts)
+{
+    const RideMetricFactory &factory = RideMetricFactory::instance();
+    QVector<RideItem*> rides = context->athlete->rideCache->rides();
+    QElapsedTimer timer;
+
+    // file readers, per format
+    if (files != "") readers(files);
+
+    // refresh, as when the athlete's config or the metrics change
+    foreach(RideItem *item, rides) {
+        item->isstale = true;
+        item->staleconfig = 0;
+
+        timer.start();
+        item->refresh();
+        record("RideItem::refresh", elapsed(timer));
+    }
+
+    // mean max cache and metrics, the ride is opened first
+    foreach(RideItem *item, rides) {
+
+        bool wasopen = item->isOpen();
+        RideFile *f = item->ride();
+        if (f == NULL) continue;
+
+        // remove the .cpx so it is computed
+        QFile::remove(context->athlete->home->cache().canonicalPath() + "/" + QFileInfo(item->fileName).baseName() + ".cpx");
+        timer.start();
+        RideFileCache updater(context, item->path + "/" + item->fileName, item->getWeight(), f, false, true);
+        record("RideFileCache::compute", elapsed(timer), f->dataPoints().count());
+
+        timer.start();
+        QHash<QString,RideMetricPtr> computed = RideMetric::computeMetrics(item, Specification(), factory.allMetrics());
+        record("computeMetrics", elapsed(timer), f->dataPoints().count());
+
+        if (!wasopen) item->close();
+    }
+
+    // formulas from the sample charts
+    if (charts != "") formulas(charts);
+
+    // pmc, for all dates
+    PMCData pmc(context, Specification(), "coggan_tss");
+    for (int i=0; i<5; i++) {
+        pmc.invalidate();
+        timer.start();
+        pmc.refresh();
+        record("PMCData::refresh", elapsed(timer), rides.count());
+    }
+
+    // estimates, waiting for any already running
+    Estimator *estimator = context->athlete->rideCache->estimator;
+    estimator->wait();
+    timer.start();
+    estimator->calculate();
+    estimator->wait();
+    record("Estimator::run", elapsed(timer), rides.count());
+
+    // ride cache, to a scratch file
+    QTemporaryFile rideDB;
+    if (rideDB.open()) {
+        rideDB.close();
+        for (int i=0; i<3; i++) {
+            timer.start();
+            context->athlete->rideCache->save(false, rideDB.fileName());
+            record("RideCache::save", elapsed(timer), rides.count());
+        }
+    }
+}
+
+void
+GcBench::readers(QString files)
+{
+    QElapsedTimer timer;
+    QDir folder(files);
+
+    foreach(QString name, folder.entryList(QDir::Files, QDir::Name)) {
+
+        QString suffix = QFileInfo(name).suffix().toLower();
+        if (!RideFileFactory::instance().suffixes().contains(suffix)) continue;
+
+        QFile file(folder.absoluteFilePath(name));
+        QStringList errors;
+        QList<RideFile*> extra;
+
+        timer.start();
+        RideFile *ride = RideFileFactory::instance().openRideFile(context, file, errors, &extra);
+        double ms = elapsed(timer);
+
+        if (ride) {
+            record(QString("read %1").arg(suffix), ms, ride->dataPoints().count());
+            delete ride;
+        }
+        foreach(RideFile *x, extra) delete x;
+    }
+}
+
+void
+GcBench::formulas(QString charts)
+{
+    QElapsedTimer timer;
+    QDir folder(charts);
+    QVector<RideItem*> rides = context->athlete->rideCache->rides();
+
+    foreach(QString name, folder.entryList(QStringList() << "*.gchart", QDir::Files, QDir::Name)) {
+        foreach(const auto &properties, GcChartWindow::chartPropertiesFromFile(folder.absoluteFilePath(name))) {
+
+            // ltm charts hold their settings marshalled
+            QString settings = properties.value("settings");
+            if (settings == "") continue;
+
+            QByteArray unmarshall = QByteArray::fromBase64(settings.toLatin1());
+            QDataStream s(&unmarshall, QIODevice::ReadOnly);
+            LTMSettings ltm;
+            s >> ltm;
+
+            foreach(const MetricDetail &metric, ltm.metrics) {
+                if (metric.type != METRIC_FORMULA || metric.formula == "") continue;
+
+                DataFilter parser(NULL, context, metric.formula);
+                if (parser.errorList().count()) continue;
+
+                foreach(RideItem *item, rides) {
+                    timer.start();
+                    parser.evaluate(item, NULL);
+                    record("DataFilter", elapsed(timer));
+                }
+            }
+        }
+    }
+}
+
+double
+GcBench::percentile(QVector<double> sorted, double p)
+{
+    if (sorted.isEmpty()) return 0;
+    int index = qBound(0, int(std::ceil(p * sorted.count())) - 1, sorted.count()-1);
+    return sorted.at(index);
+}
+
+void
+GcBench::report()
+{
+    fprintf(stderr, "%-28s %8s %10s %12s %10s %10s %10s %10s %8s\n", "stage", "count", "total ms", "per sec",
+            "p50 ms", "p90 ms", "p99 ms", "max ms", "rss MB");
+
+    foreach(const Stage &stage, stages) {
+        QVector<double> sorted = stage.ms;
+        std::sort(sorted.begin(), sorted.end());
+        double total = 0;
+        foreach(double ms, sorted) total += ms;
+
+        fprintf(stderr, "%-28s %8d %10.1f %12.1f %10.3f %10.3f %10.3f %10.3f %8lld\n",
+                stage.name.toLocal8Bit().constData(), sorted.count(), total,
+                total > 0 ? sorted.count() * 1000.0 / total : 0.0,
+                percentile(sorted, 0.5), percentile(sorted, 0.9), percentile(sorted, 0.99), sorted.last(),
+                stage.rss / (1024 * 1024));
+    }
+}
+
+bool
+GcBench::write(QString filename)
+{
+    QJsonArray list;
+    foreach(const Stage &stage, stages) {
+        QVector<double> sorted = stage.ms;
+        std::sort(sorted.begin(), sorted.end());
+        double total = 0;
+        foreach(double ms, sorted) total += ms;
+
+        QJsonObject s;
+        s["name"] = stage.name;
+        s["count"] = sorted.count();
+        s["samples"] = double(stage.samples);
+        s["total_ms"] = total;
+        s["per_sec"] = total > 0 ? sorted.count() * 1000.0 / total : 0.0;
+        s["samples_per_sec"] = total > 0 ? stage.samples * 1000.0 / total : 0.0;
+        s["p50_ms"] = percentile(sorted, 0.5);
+        s["p90_ms"] = percentile(sorted, 0.9);
+        s["p99_ms"] = percentile(sorted, 0.99);
+        s["max_ms"] = sorted.last();
+        s["peak_rss"] = double(stage.rss);
+        list << s;
+    }
+
+    QJsonObject root;
+    root["when"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    root["athlete"] = context->athlete->cyclist;
+    root["activities"] = context->athlete->rideCache->count();
+    root["threads"] = QThread::idealThreadCount();
+    root["peak_rss"] = double(peakRSS());
+    root["stages"] = list;
+    if (!comparison.isEmpty()) root["comparison"] = comparison;
+
+    QFile file(filename);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate)) return false;
+    file.write(QJsonDocument(root).toJson());
+    file.close();
+    return true;
+}
+
+int
+GcBench::compare(QString filename, double threshold)
+{
+    QFile file(filename);
+    if (!file.open(QFile::ReadOnly)) return -1;
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    file.close();
+    if (!doc.isObject()) return -1;
+
+    // baseline stages by name
+    QHash<QString, QJsonObject> baseline;
+    foreach(const QJsonValue &value, doc.object()["stages"].toArray()) {
+        QJsonObject stage = value.toObject();
+        baseline.insert(stage["name"].toString(), stage);
+    }
+
+    fprintf(stderr, "\n%-28s %12s %12s %9s %12s %12s %9s\n", "stage", "base p50", "p50", "change", "base p90", "p90", "change");
+
+    int regressions = 0;
+    comparison = QJsonArray();
+    foreach(const Stage &stage, stages) {
+
+        if (!baseline.contains(stage.name)) continue;
+        QJsonObject base = baseline.value(stage.name);
+
+        QVector<double> sorted = stage.ms;
+        std::sort(sorted.begin(), sorted.end());
+        double p50 = percentile(sorted, 0.5), p90 = percentile(sorted, 0.9);
+        double bp50 = base["p50_ms"].toDouble(), bp90 = base["p90_ms"].toDouble();
+
+        // percent slower, anything under a microsecond is noise
+        double c50 = bp50 > 0.001 ? (p50 - bp50) * 100.0 / bp50 : 0;
+        double c90 = bp90 > 0.001 ? (p90 - bp90) * 100.0 / bp90 : 0;
+        bool regressed = c50 > threshold || c90 > threshold;
+        if (regressed) regressions++;
+
+        fprintf(stderr, "%-28s %12.3f %12.3f %8.1f%% %12.3f %12.3f %8.1f%% %s\n",
+                stage.name.toLocal8Bit().constData(), bp50, p50, c50, bp90, p90, c90, regressed ? "REGRESSION" : "");
+
+        QJsonObject s;
+        s["name"] = stage.name;
+        s["p50_change"] = c50;
+        s["p90_change"] = c90;
+        s["regression"] = regressed;
+        comparison << s;
+    }
+    fprintf(stderr, "%d stages more than %.1f%% slower than %s\n", regressions, threshold, filename.toLocal8Bit().constData());
+    return regressions;
+}
+
+bool
+GcBench::copyAthlete(QDir from, QString to, QStringList &errors)
+{
+    if (!from.exists()) {
+        errors << QString("%1 does not exist").arg(from.absolutePath());
+        return false;
+    }
+    if (!QDir().mkpath(to)) {
+        errors << QString("Could not create %1").arg(to);
+        return false;
+    }
+
+    QDirIterator it(from.absolutePath(), QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        QString path = it.next();
+        QString target = to + "/" + from.relativeFilePath(path);
+
+        if (it.fileInfo().isDir()) {
+            if (!QDir().mkpath(target)) errors << QString("Could not create %1").arg(target);
+        } else if (!QFile::copy(path, target)) {
+            errors << QString("Could not copy %1").arg(path);
+        }
+    }
+    return errors.isEmpty();
+}
+
+int
+GcBench::generate(QDir athlete, int count, QStringList &errors)
+{
+    AthleteDirectoryStructure home(athlete);
+    if (!home.subDirsExist()) home.createAllSubdirs();
+
+    // same seed so the same athlete is generated every time
+    std::mt19937 random(2026);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    // one a day, ending yesterday
+    QDateTime start(QDate::currentDate().addDays(-count), QTime(7, 0, 0));
+    int written = 0;
+
+    for (int n=0; n<count; n++) {
+
+        QDateTime when = start.addDays(n).addSecs(int(unit(random) * 10) * 3600);
+        QFile file(home.activities().absoluteFilePath(when.toString("yyyy_MM_dd_HH_mm_ss") + ".json"));
+        if (file.exists()) continue;
+
+        RideFile *ride = new RideFile(when, 1.0);
+        ride->setDeviceType("GoldenCheetah Benchmark");
+        ride->setFileFormat("GoldenCheetah Json");
+        ride->setTag("Sport", "Bike");
+
+        // 45 minutes to 3 hours of blocks of steady effort, intervals and freewheeling
+        int duration = 2700 + int(unit(random) * 8100);
+        double ftp = 250, target = 0, watts = 0, hr = 60, alt = 100, km = 0;
+        int block = 0;
+
+        for (int secs=0; secs<duration; secs++) {
+
+            if (block-- <= 0) {
+                block = 30 + int(unit(random) * 600);
+                target = unit(random) < 0.1 ? 0 : ftp * (0.5 + unit(random) * 0.7);
+            }
+
+            RideFilePoint p;
+            p.secs = secs;
+            watts = std::max(0.0, watts + (target - watts) * 0.3 + (unit(random) - 0.5) * 40);
+            p.watts = round(watts);
+            p.cad = p.watts > 0 ? round(80 + unit(random) * 20) : 0;
+            hr += ((60 + watts * 0.45) - hr) / 30.0;
+            p.hr = round(hr);
+            alt += (unit(random) - 0.5) * 0.8;
+            p.alt = alt;
+            p.kph = 15 + watts * 0.06;
+            km += p.kph / 3600.0;
+            p.km = km;
+
+            ride->appendPoint(p);
+        }
+
+        if (RideFileFactory::instance().writeRideFile(NULL, ride, file, "json")) written++;
+        else errors << QString("Could not write %1").arg(file.fileName());
+
+        delete ride;
+    }
+    return written;
+}
+
+qint64
+GcBench::peakRSS()
+{
+#ifdef Q_OS_WIN
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return counters.PeakWorkingSetSize;
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef Q_OS_MAC
+    return usage.ru_maxrss; // bytes
+#else
+    return qint64(usage.ru_maxrss) * 1024; // kilobytes
+#endif
+#endif
+}
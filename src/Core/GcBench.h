@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef _GC_GcBench_h
+#define _GC_GcBench_h 1
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QList>
+#include <QDir>
+#include <QJsonArray>
+
+class Context;
+
+//
+// Benchmarks the core engines against an opened athlete, from the
+// command line with --bench (see main.cpp), so regressions in the hot
+// paths can be caught before a release:
+//
+//   open athlete               the ride cache load (and window setup)
+//   read <suffix>              RideFileFactory per file format, for
+//                              the files passed with --bench-files
+//   RideItem::refresh          every activity, marked stale
+//   RideFileCache::compute     every activity, the .cpx is rewritten
+//   computeMetrics             every activity, all the metrics
+//   DataFilter                 formula metrics in the .gchart files
+//                              passed with --bench-charts, per activity
+//   PMCData::refresh           Coggan TSS for all dates
+//   Estimator::run             the PD model estimates
+//   RideCache::save            rideDB.json, to a temporary file
+//
+// Each stage reports its throughput, latency percentiles and the peak
+// resident set size so far. Results are written as json, and compared
+// with the json from an earlier run to flag regressions.
+//
+// The stages rewrite caches and refresh every activity, so main.cpp
+// runs them on a scratch copy of the athlete made by copyAthlete(), or
+// on a synthetic athlete in a temporary folder. generate() fills an
+// athlete with synthetic activities so a large athlete can be
+// benchmarked without sharing anyone's data.
+//
+#define GCBENCH_THRESHOLD 10.0 // percent slower than the baseline to fail
+
+class GcBench
+{
+    public:
+        GcBench(Context *context);
+
+        // run all the stages, files and charts may be empty
+        void run(QString files, QString charts);
+
+        // add a measurement, for stages timed elsewhere
+        void record(QString stage, double ms, qint64 samples=0);
+
+        // summary to stderr and json to filename
+        void report();
+        bool write(QString filename);
+
+        // compare the median and p90 latencies with a json file written
+        // by an earlier run, returns how many stages are more than
+        // threshold percent slower, or -1 if it couldn't be read
+        int compare(QString baseline, double threshold=GCBENCH_THRESHOLD);
+
+        // add count synthetic activities to an athlete folder
+        static int generate(QDir athlete, int count, QStringList &errors);
+
+        // copy an athlete folder, to benchmark it without changing it
+        static bool copyAthlete(QDir from, QString to, QStringList &errors);
+
+        // peak resident set size in bytes, 0 if not known
+        static qint64 peakRSS();
+
+    private:
+        struct Stage {
+            QString name;
+            QVector<double> ms;     // latency of each item
+            qint64 samples;         // data points processed
+            qint64 rss;             // peak rss when it finished
+        };
+
+        void readers(QString files);
+        void formulas(QString charts);
+
+        static double percentile(QVector<double> sorted, double p);
+
+        Context *context;
+        QList<Stage> stages;
+        QJsonArray comparison; // from compare(), written with the results
+};
+
+#endif // _GC_GcBench_h
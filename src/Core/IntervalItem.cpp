@@ -94,14 +94,19 @@ IntervalItem::setValues(QString name, double duration1, double duration2,
 }
 
 void
-IntervalItem::refresh()
+IntervalItem::refresh(const QStringList &metrics)
 {
     // metrics
     const RideMetricFactory &factory = RideMetricFactory::instance();
 
-    // resize and set to zero
-    metrics_.fill(0, factory.metricCount());
-    count_.fill(0, factory.metricCount());
+    // resize and set to zero, unless just updating some
+    if (metrics.isEmpty()) {
+        metrics_.fill(0, factory.metricCount());
+        count_.fill(0, factory.metricCount());
+    } else {
+        metrics_.resize(factory.metricCount());
+        count_.resize(factory.metricCount());
+    }
 
     // don't open on our account - we should be called with a ride available
     RideFile *f = rideItem_->ride_;
@@ -109,7 +114,8 @@ IntervalItem::refresh()
 
 
     // ok, lets collect the metrics
-    QHash<QString,RideMetricPtr> computed=RideMetric::computeMetrics(rideItem_, Specification(this, f->recIntSecs()), factory.allMetrics());
+    QHash<QString,RideMetricPtr> computed=RideMetric::computeMetrics(rideItem_, Specification(this, f->recIntSecs()),
+                                                                     metrics.isEmpty() ? factory.allMetrics() : metrics);
     // take a deep copy, quick before the thread exits.
     //XXXcomputed.detach();
 
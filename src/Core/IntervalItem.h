@@ -72,8 +72,8 @@ class IntervalItem
         // order to show on plot
         void setDisplaySequence(int seq) { displaySequence = seq; }
 
-        // precomputed metrics
-        void refresh();
+        // precomputed metrics, all of them or just those listed
+        void refresh(const QStringList &metrics = QStringList());
         QVector<double> metrics_;
         QVector<double> count_;
         QMap <int, double>stdmean_;
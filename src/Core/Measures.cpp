@@ -29,6 +29,7 @@
 #include <QJsonObject>
 
 #include <QDebug>
+#include <QAtomicInt>
 
 ///////////////////////////// Measure class /////////////////////////////////
 
@@ -69,7 +70,7 @@ Measure::getSourceDescription() const
 
 ///////////////////////////// MeasuresGroup class ///////////////////////////
 
-MeasuresGroup::MeasuresGroup(QString symbol, QString name, QStringList symbols, QStringList names, QStringList metricUnits, QStringList imperialUnits, QList<double>unitsFactors, QList<QStringList> headers,  QDir dir, bool withData) : dir(dir), withData(withData), symbol(symbol), name(name), symbols(symbols), names(names), metricUnits(metricUnits), imperialUnits(imperialUnits), unitsFactors(unitsFactors), headers(headers)
+MeasuresGroup::MeasuresGroup(QString symbol, QString name, QStringList symbols, QStringList names, QStringList metricUnits, QStringList imperialUnits, QList<double>unitsFactors, QList<QStringList> headers,  QDir dir, bool withData) : dir(dir), withData(withData), symbol(symbol), name(name), symbols(symbols), names(names), metricUnits(metricUnits), imperialUnits(imperialUnits), unitsFactors(unitsFactors), headers(headers), version_(nextVersion())
 {
     // don't load data if not requested
     if (!withData) return;
@@ -99,6 +100,16 @@ MeasuresGroup::setMeasures(QList<Measure>&x)
 {
     measures_ = x;
     std::sort(measures_.begin(), measures_.end()); // date order
+    version_ = nextVersion();
+}
+
+int
+MeasuresGroup::nextVersion()
+{
+    // unique across groups, so a lookup table built
+    // from one group is never mistaken for another's
+    static QAtomicInt versions;
+    return versions.fetchAndAddRelaxed(1) + 1;
 }
 
 QDate
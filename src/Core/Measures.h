@@ -88,12 +88,13 @@ public:
     // Default constructor intended to access metadata,
     // directory and withData must be provided to access data.
     MeasuresGroup(QString symbol, QString name, QStringList symbols, QStringList names, QStringList metricUnits, QStringList imperialUnits, QList<double> unitsFactors, QList<QStringList> headers,  QDir dir=QDir(), bool withData=false);
-    MeasuresGroup(QDir dir=QDir(), bool withData=false) : dir(dir), withData(withData) {}
+    MeasuresGroup(QDir dir=QDir(), bool withData=false) : dir(dir), withData(withData), version_(nextVersion()) {}
     ~MeasuresGroup() {}
     void write();
     QList<Measure>& measures() { return measures_; }
     void setMeasures(QList<Measure>&x);
     void getMeasure(QDate date, Measure&) const;
+    int version() const { return version_; } // changes with the measures
 
     // Common access to Measures
     QString getSymbol() const { return symbol; }
@@ -128,7 +129,9 @@ private:
     QList<double> unitsFactors;
     QList<QStringList> headers;
     QList<Measure> measures_;
+    int version_;
 
+    static int nextVersion();
     bool serialize(QString, QList<Measure> &);
     bool unserialize(QFile &, QList<Measure> &);
 };
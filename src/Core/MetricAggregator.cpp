@@ -0,0 +1,276 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "MetricAggregator.h"
+
+#include "Context.h"
+#include "RideCache.h"
+#include "RideItem.h"
+#include "RideFile.h" // for RideFile::NA
+
+#include <cmath>
+
+// we don't want the caches to grow without bound when users
+// flick through lots of date ranges and filters, each set of
+// rows can be as long as the ride cache so we keep fewer
+static const int MAXRESULTS = 1024;
+static const int MAXROWS = 128;
+
+QString
+MetricAggregateRequest::key() const
+{
+    return QString("%1:%2:%3%4%5%6").arg(metric ? metric->symbol() : QString())
+                                    .arg(type)
+                                    .arg(aggzero ? "z" : "-")
+                                    .arg(wantzero ? "w" : "-")
+                                    .arg(hours ? "h" : "-")
+                                    .arg(useMetricUnits ? "m" : "i");
+}
+
+MetricAggregator::MetricAggregator(Context *context, RideCache *cache) : QObject(cache), context(context), cache(cache), valid(false)
+{
+    // anything that changes ride metrics or the list of rides
+    connect(context, SIGNAL(configChanged(qint32)), this, SLOT(configChanged(qint32)));
+    connect(context, SIGNAL(rideAdded(RideItem*)), this, SLOT(rideChanged(RideItem*)));
+    connect(context, SIGNAL(rideDeleted(RideItem*)), this, SLOT(rideChanged(RideItem*)));
+    connect(context, SIGNAL(refreshUpdate(QDate)), this, SLOT(refreshUpdate(QDate)));
+    connect(context, SIGNAL(refreshEnd()), this, SLOT(invalidate()));
+    connect(cache, SIGNAL(itemChanged(RideItem*)), this, SLOT(rideChanged(RideItem*)));
+}
+
+void
+MetricAggregator::invalidate()
+{
+    valid = false;
+    items.clear();
+    dates.clear();
+    columns.clear();
+    rows.clear();
+    results.clear();
+}
+
+void
+MetricAggregator::validate()
+{
+    // rides added, removed or replaced without us being told,
+    // compared ride by ride since a delete and add keeps the count
+    if (valid && items != cache->rides()) invalidate();
+    if (valid) return;
+
+    items = cache->rides();
+    dates.resize(items.count());
+    for(int i=0; i<items.count(); i++) dates[i] = items[i]->dateTime.date();
+
+    valid = true;
+}
+
+int
+MetricAggregator::groupForDate(QDate date, int groupby, QDate start)
+{
+    switch(groupby) {
+    case Week: return 1 + ((date.toJulianDay() - start.toJulianDay()) / 7); // must start from 1 not zero!
+    case Month: return (date.year()*12) + date.month();
+    case Year: return date.year();
+    case All: return 1;
+    case Day:
+    default: return date.toJulianDay();
+    }
+}
+
+MetricAggregator::Column
+MetricAggregator::column(const RideMetric *metric)
+{
+    int index = metric->index();
+
+    if (columns.contains(index)) return columns.value(index);
+
+    // extract the column, same rules as RideItem::getForSymbol et al
+    // when the metrics are missing or out of date the value is zero
+    // and counts are never zero
+    int metricCount = RideMetricFactory::instance().metricCount();
+    bool stddev = metric->type() == RideMetric::StdDev;
+
+    Column add;
+    add.values.fill(0, items.count());
+    add.counts.fill(1, items.count());
+    if (stddev) add.stdmeans.fill(0, items.count());
+
+    for(int i=0; i<items.count(); i++) {
+        RideItem *item = items[i];
+        if (item->metrics().size() != metricCount) continue;
+
+        add.values[i] = item->metrics()[index];
+        if (index < item->counts().size() && item->counts()[index]) add.counts[i] = item->counts()[index];
+        if (stddev) add.stdmeans[i] = item->stdmeans().value(index, 0.0f);
+    }
+    columns.insert(index, add);
+    return add;
+}
+
+QVector<int>
+MetricAggregator::rowsFor(Specification &spec, QString signature)
+{
+    if (rows.contains(signature)) return rows.value(signature);
+
+    QVector<int> add;
+    for(int i=0; i<items.count(); i++)
+        if (spec.pass(items[i])) add << i;
+
+    if (rows.count() >= MAXROWS) rows.clear();
+    rows.insert(signature, add);
+    return add;
+}
+
+MetricAggregate
+MetricAggregator::aggregate(Specification spec, int groupby, QDate start, MetricAggregateRequest request)
+{
+    QList<MetricAggregateRequest> requests;
+    requests << request;
+    return aggregate(spec, groupby, start, requests).at(0);
+}
+
+QVector<MetricAggregate>
+MetricAggregator::aggregate(Specification spec, int groupby, QDate start, QList<MetricAggregateRequest> requests)
+{
+    QVector<MetricAggregate> returning(requests.count());
+
+    validate();
+
+    // look in the result cache first, we only aggregate what's missing
+    QString signature = spec.signature();
+    QString prefix = QString("%1|%2|%3|").arg(signature).arg(groupby).arg(start.toJulianDay());
+    QList<int> todo;
+    for(int i=0; i<requests.count(); i++) {
+        if (requests[i].metric == NULL) continue;
+        QString key = prefix + requests[i].key();
+        if (results.contains(key)) returning[i] = results.value(key);
+        else todo << i;
+    }
+    if (todo.isEmpty()) return returning;
+
+    // aggregation state per request
+    struct State {
+        Column column;          // implicitly shared, so cheap
+        double conversion, conversionSum;
+        int group;              // last group we added to
+        double seconds;         // seconds aggregated in the current group
+        double ymean;           // running mean for stddev
+    };
+    QVector<State> state(todo.count());
+    for(int t=0; t<todo.count(); t++) {
+        const MetricAggregateRequest &request = requests[todo[t]];
+        state[t].column = column(request.metric);
+        state[t].conversion = request.metric->conversion();
+        state[t].conversionSum = request.metric->conversionSum();
+        state[t].group = 0;
+        state[t].seconds = 0;
+        state[t].ymean = 0;
+    }
+
+    // one pass over the rides, all metrics at once
+    // the rules here are the same as those LTM has always used
+    foreach(int row, rowsFor(spec, signature)) {
+
+        int group = groupForDate(dates[row], groupby, start);
+
+        for(int t=0; t<todo.count(); t++) {
+
+            const MetricAggregateRequest &request = requests[todo[t]];
+            State &s = state[t];
+            MetricAggregate &out = returning[todo[t]];
+
+            double value = s.column.values.at(row);
+
+            // check values are bounded and available
+            if (std::isnan(value) || std::isinf(value)) value = 0;
+            if (value == RideFile::NA) continue;
+
+            // convert from stored metric value to imperial
+            if (request.useMetricUnits == false) {
+                value *= s.conversion;
+                value += s.conversionSum;
+            }
+            if (request.hours) value /= 3600;
+
+            // zeroes don't count unless asked for
+            if (!value && !request.wantzero) continue;
+
+            // counts are whole numbers
+            unsigned long seconds = s.column.counts.at(row);
+
+            if (group > s.group) {
+
+                // new group
+                out.groups << group;
+                out.values << value;
+
+                s.group = group;
+                s.ymean = s.column.stdmeans.count() ? s.column.stdmeans.at(row) : 0;
+                s.seconds = (value || request.aggzero) ? seconds : 0;
+
+            } else {
+
+                // sum totals, average averages and choose best for peaks
+                double &y = out.values.last();
+
+                switch (request.type) {
+                case RideMetric::Total:
+                    y += value;
+                    break;
+                case RideMetric::Average:
+                    // weighted by count, otherwise high value but short
+                    // rides will skew the overall average
+                    if (value || request.aggzero) y = ((y*s.seconds)+(seconds*value)) / (s.seconds+seconds);
+                    break;
+                case RideMetric::Low:
+                    if (value < y) y = value;
+                    break;
+                case RideMetric::Peak:
+                    if (value > y) y = value;
+                    break;
+                case RideMetric::MeanSquareRoot:
+                    if (value) y = sqrt((pow(y,2)*s.seconds + pow(value,2)*seconds)/(s.seconds+seconds));
+                    break;
+                case RideMetric::StdDev:
+                    if (value) {
+                        // combining two standard deviations, see LTMPlot
+                        double ymean_next = s.column.stdmeans.count() ? s.column.stdmeans.at(row) : 0;
+                        double ymean = (s.seconds*s.ymean + ymean_next*seconds)/(s.seconds + seconds);
+
+                        y = pow(y,2)*(s.seconds-1) + pow(value,2)*(seconds-1);
+                        y += pow(s.ymean - ymean,2)*s.seconds + pow(ymean_next - ymean,2)*seconds;
+                        y /= (s.seconds + seconds);
+                        y = sqrt(y);
+
+                        s.ymean = ymean;
+                    }
+                    break;
+                }
+
+                // increment group counter if nonzero or we aggregate zeroes
+                if (value || request.aggzero) s.seconds += seconds;
+            }
+        }
+    }
+
+    // remember for next time
+    if (results.count() + todo.count() > MAXRESULTS) results.clear();
+    foreach(int i, todo) results.insert(prefix + requests[i].key(), returning[i]);
+
+    return returning;
+}
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef _GC_MetricAggregator_h
+#define _GC_MetricAggregator_h 1
+
+#include "RideMetric.h"
+#include "Specification.h"
+
+#include <QObject>
+#include <QVector>
+#include <QHash>
+#include <QDate>
+
+class Context;
+class RideCache;
+class RideItem;
+
+//
+// The metric aggregator holds a columnar copy of the precomputed
+// metrics in the ride cache; one contiguous column per metric rather
+// than one metric vector per ride. Charts that want metric values
+// grouped by day, week, month or year (LTM, trends tiles etc) can
+// ask for several metrics at once and they will be aggregated in a
+// single pass over the rides that pass the specification.
+//
+// Results are cached by specification signature, so repainting a
+// chart with the same filter and date range is just a lookup.
+//
+// Everything is invalidated when the ride cache changes, columns are
+// then rebuilt lazily the next time they are needed.
+//
+// NOTE: this is not thread safe, it is expected to be called from
+//       the GUI thread (which is where the charts live).
+//
+
+// what to aggregate, one per metric in a batch
+class MetricAggregateRequest
+{
+    public:
+        MetricAggregateRequest() : metric(NULL), type(RideMetric::Average), aggzero(false),
+                                   wantzero(false), hours(false), useMetricUnits(true) {}
+        MetricAggregateRequest(const RideMetric *metric) : metric(metric), type(metric->type()),
+                                   aggzero(metric->aggregateZero()), wantzero(false), hours(false),
+                                   useMetricUnits(true) {}
+
+        const RideMetric *metric;
+        int type;               // RideMetric::Total, Average, Peak etc
+        bool aggzero;           // zero values are included in averages
+        bool wantzero;          // zero values create a group (e.g. bar charts)
+        bool hours;             // convert seconds to hours
+        bool useMetricUnits;    // or convert to imperial
+
+        // used to key the result cache
+        QString key() const;
+};
+
+// aggregated values, one entry per group that has data
+// groups are in ascending order, values in display units
+class MetricAggregate
+{
+    public:
+        QVector<int> groups;
+        QVector<double> values;
+};
+
+class MetricAggregator : public QObject
+{
+    Q_OBJECT
+
+    public:
+
+        // group by, note these match the LTM_DAY .. LTM_ALL values
+        // so LTM settings can be passed without translation
+        enum groupby { Day=1, Week=2, Month=3, Year=4, All=6 };
+        typedef enum groupby GroupBy;
+
+        MetricAggregator(Context *context, RideCache *cache);
+
+        // aggregate all requested metrics in one pass, week numbers are
+        // counted from start, as they are for LTM charts
+        QVector<MetricAggregate> aggregate(Specification spec, int groupby, QDate start,
+                                           QList<MetricAggregateRequest> requests);
+
+        // convenience for a single metric
+        MetricAggregate aggregate(Specification spec, int groupby, QDate start,
+                                  MetricAggregateRequest request);
+
+        // group number for a date
+        static int groupForDate(QDate date, int groupby, QDate start);
+
+    public slots:
+
+        // the ride cache changed in some way, drop everything
+        void invalidate();
+        void configChanged(qint32) { invalidate(); }
+        void rideChanged(RideItem*) { invalidate(); }
+        void refreshUpdate(QDate) { invalidate(); }
+
+    private:
+
+        // a column of metric values across all rides, in date order
+        struct Column {
+            QVector<double> values;
+            QVector<double> counts;
+            QVector<double> stdmeans;
+        };
+
+        // lazily build the columnar store
+        void validate();
+        Column column(const RideMetric *metric);
+        QVector<int> rowsFor(Specification &spec, QString signature);
+
+        Context *context;
+        RideCache *cache;
+
+        // the store, indexed by row (ride)
+        bool valid;
+        QVector<RideItem*> items;
+        QVector<QDate> dates;
+        QHash<int, Column> columns;
+
+        // caches, keyed by specification signature
+        QHash<QString, QVector<int> > rows;
+        QHash<QString, MetricAggregate> results;
+};
+
+#endif // _GC_MetricAggregator_h
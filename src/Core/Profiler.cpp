@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "Profiler.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QThreadStorage>
+
+#include <algorithm>
+
+QAtomicInt Profiler::enabled(0);
+
+// every thread's counters, when a thread finishes its counters are
+// folded into the retired ones, so threads in the pool can come and go
+static QMutex registryMutex;
+static QList<ProfilerCounter*> registry;
+static QHash<QString, ProfilerCounter*> retired;
+
+// the calling thread's counters, by kind then name
+struct ProfilerThread {
+    ~ProfilerThread();
+    QHash<QString, ProfilerCounter*> counters[Profiler::Kinds];
+};
+
+ProfilerThread::~ProfilerThread()
+{
+    QMutexLocker locker(&registryMutex);
+    for (int kind=0; kind<Profiler::Kinds; kind++) {
+        foreach(ProfilerCounter *counter, counters[kind]) {
+
+            QString key = QString("%1 %2").arg(kind).arg(counter->name);
+            ProfilerCounter *into = retired.value(key, NULL);
+            if (into == NULL) {
+                into = new ProfilerCounter(kind, counter->name);
+                retired.insert(key, into);
+                registry << into;
+            }
+            into->count.fetchAndAddRelaxed(counter->count.loadAcquire());
+            into->nsecs.fetchAndAddRelaxed(counter->nsecs.loadAcquire());
+            if (counter->max.loadAcquire() > into->max.loadAcquire()) into->max.storeRelease(counter->max.loadAcquire());
+
+            registry.removeOne(counter);
+            delete counter;
+        }
+    }
+}
+static QThreadStorage<ProfilerThread*> local;
+
+ProfilerCounter *
+Profiler::counter(int kind, const QString &name)
+{
+    if (!local.hasLocalData()) local.setLocalData(new ProfilerThread);
+    QHash<QString, ProfilerCounter*> &counters = local.localData()->counters[kind];
+
+    ProfilerCounter *counter = counters.value(name, NULL);
+    if (counter == NULL) {
+
+        // first time this thread has seen it
+        counter = new ProfilerCounter(kind, name);
+        counters.insert(name, counter);
+
+        registryMutex.lock();
+        registry << counter;
+        registryMutex.unlock();
+    }
+    return counter;
+}
+
+void
+Profiler::reset()
+{
+    QMutexLocker locker(&registryMutex);
+    foreach(ProfilerCounter *counter, registry) {
+        counter->count.storeRelease(0);
+        counter->nsecs.storeRelease(0);
+        counter->max.storeRelease(0);
+    }
+}
+
+QList<Profiler::Entry>
+Profiler::snapshot()
+{
+    QHash<QString, int> index;
+    QList<Entry> returning;
+
+    registryMutex.lock();
+    foreach(ProfilerCounter *counter, registry) {
+
+        qint64 count = counter->count.loadAcquire();
+        if (count == 0) continue;
+
+        QString key = QString("%1 %2").arg(counter->kind).arg(counter->name);
+        int i = index.value(key, -1);
+        if (i < 0) {
+            Entry add;
+            add.kind = counter->kind;
+            add.name = counter->name;
+            add.count = add.nsecs = add.max = 0;
+            index.insert(key, i = returning.count());
+            returning << add;
+        }
+
+        Entry &entry = returning[i];
+        entry.count += count;
+        entry.nsecs += counter->nsecs.loadAcquire();
+        entry.max = qMax(entry.max, counter->max.loadAcquire());
+    }
+    registryMutex.unlock();
+
+    std::sort(returning.begin(), returning.end(), [](const Entry &a, const Entry &b) { return a.nsecs > b.nsecs; });
+    return returning;
+}
+
+QString
+Profiler::kindName(int kind)
+{
+    switch (kind) {
+    case Metric : return "metric";
+    case Function : return "function";
+    case Reader : return "reader";
+    case Cache : return "cache";
+    }
+    return "";
+}
+
+QString
+Profiler::report()
+{
+    QString returning = QString("%1 %2 %3 %4 %5 %6\n").arg("kind", -10).arg("name", -32).arg("count", 10)
+                        .arg("total ms", 12).arg("mean ms", 10).arg("max ms", 10);
+
+    foreach(const Entry &entry, snapshot()) {
+        returning += QString("%1 %2 %3 %4 %5 %6\n")
+                     .arg(kindName(entry.kind), -10)
+                     .arg(entry.name, -32)
+                     .arg(entry.count, 10)
+                     .arg(entry.nsecs / 1000000.0, 12, 'f', 1)
+                     .arg(entry.nsecs / 1000000.0 / entry.count, 10, 'f', 3)
+                     .arg(entry.max / 1000000.0, 10, 'f', 3);
+    }
+    return returning;
+}
+
+QString
+Profiler::csv()
+{
+    QString returning = "kind, name, count, total_ms, mean_ms, max_ms\n";
+
+    foreach(const Entry &entry, snapshot()) {
+        returning += QString("%1, %2, %3, %4, %5, %6\n")
+                     .arg(kindName(entry.kind))
+                     .arg(entry.name)
+                     .arg(entry.count)
+                     .arg(entry.nsecs / 1000000.0, 0, 'f', 3)
+                     .arg(entry.nsecs / 1000000.0 / entry.count, 0, 'f', 3)
+                     .arg(entry.max / 1000000.0, 0, 'f', 3);
+    }
+    return returning;
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef _GC_Profiler_h
+#define _GC_Profiler_h 1
+
+#include <QString>
+#include <QList>
+#include <QAtomicInteger>
+#include <QElapsedTimer>
+
+//
+// Low overhead instrumentation of the hot paths, so we can see why
+// refreshing a particular athlete is slow.
+//
+// Time spent is aggregated by kind and name, e.g. per metric symbol or
+// per DataFilter function; nested scopes are counted in both. Each thread
+// has its own counters so the hot path takes no locks, the counters are
+// summed when a snapshot is taken.
+//
+// It is off unless enabled with --profile, from the diagnostics dialog
+// or the /athlete/diagnostics API, when off a scope costs a single load.
+//
+#define PROFILE(kind, name) ProfilerScope profilerScope_(kind, name)
+
+class ProfilerCounter
+{
+    public:
+        ProfilerCounter(int kind, QString name) : kind(kind), name(name), count(0), nsecs(0), max(0) {}
+
+        void add(qint64 elapsed) {
+            count.fetchAndAddRelaxed(1);
+            nsecs.fetchAndAddRelaxed(elapsed);
+            qint64 was = max.loadAcquire();
+            while (elapsed > was && !max.testAndSetRelaxed(was, elapsed)) was = max.loadAcquire();
+        }
+
+        const int kind;
+        const QString name;
+        QAtomicInteger<qint64> count, nsecs, max;
+};
+
+class Profiler
+{
+    public:
+        enum { Metric=0, Function, Reader, Cache, Kinds };
+
+        struct Entry {
+            int kind;
+            QString name;
+            qint64 count, nsecs, max;
+        };
+
+        static bool isEnabled() { return enabled.loadAcquire() != 0; }
+        static void setEnabled(bool x) { enabled.storeRelease(x ? 1 : 0); }
+
+        // zero all the counters
+        static void reset();
+
+        // the calling thread's counter, created on first use
+        static ProfilerCounter *counter(int kind, const QString &name);
+
+        // count something without timing it, e.g. a cache hit
+        static void count(int kind, const QString &name) { if (isEnabled()) counter(kind, name)->add(0); }
+
+        // all threads summed, most expensive first
+        static QList<Entry> snapshot();
+
+        static QString kindName(int kind);
+        static QString report(); // aligned text for the terminal
+        static QString csv();
+
+    private:
+        static QAtomicInt enabled;
+};
+
+class ProfilerScope
+{
+    public:
+        ProfilerScope(int kind, const QString &name) : counter(NULL) {
+            if (Profiler::isEnabled()) {
+                counter = Profiler::counter(kind, name);
+                timer.start();
+            }
+        }
+        ~ProfilerScope() { if (counter) counter->add(timer.nsecsElapsed()); }
+
+    private:
+        ProfilerCounter *counter;
+        QElapsedTimer timer;
+};
+
+#endif // _GC_Profiler_h
@@ -21,6 +21,7 @@
 #include "Athlete.h"
 #include "RideFileCache.h"
 #include "RideCacheModel.h"
+#include "MetricAggregator.h"
 #include "Specification.h"
 #include "DataProcessor.h"
 #include "Estimator.h"
@@ -68,6 +69,7 @@ RideCache::RideCache(Context *context) : context(context)
     progress_ = 100;
     exiting = false;
     estimator = new Estimator(context);
+    aggregator_ = new MetricAggregator(context, this);
 
     // initial load of user defined metrics - do once we have an initial context
     // but before we refresh or check metrics for the first time
@@ -401,6 +403,7 @@ RideCache::removeRide(const QString& filenameToDelete) {
         QString deleteMe = QFileInfo(filenameToDelete).baseName() + "." + extension;
         QFile::remove(context->athlete->home->cache().canonicalPath() + "/" + deleteMe);
     }
+    CpxPack::instance(context->athlete->home->cache().canonicalPath())->remove(QFileInfo(filenameToDelete).baseName());
 
     if (select) {
 
@@ -520,12 +523,64 @@ RideCache::threadCompleted(RideCacheRefreshThread*thread)
 
     if (refreshThreads.count() == 0) {
         //fprintf(stderr,"refresh ended\n"); fflush(stderr);
+        computeDeferred();
         context->notifyRefreshEnd();
         garbageCollect();
         save();
     }
 }
 
+void
+RideCache::deferPython(RideItem *item)
+{
+    updateMutex.lock();
+    deferred_ << item;
+    updateMutex.unlock();
+}
+
+// run on the last refresh thread, once the other metrics are all
+// up to date, so each python user metric runs its scripts together
+void
+RideCache::computeDeferred()
+{
+    const RideMetricFactory &factory = RideMetricFactory::instance();
+
+    // rides by metric, and what each ride still has to do
+    QHash<QString, QVector<RideItem*> > todo;
+    QHash<RideItem*, QStringList> pending;
+    QVector<RideItem*> items = deferred_;
+    foreach(RideItem *item, items) {
+        foreach(QString symbol, item->deferred) todo[symbol] << item;
+        pending.insert(item, item->deferred);
+        item->deferred.clear();
+    }
+    deferred_.clear();
+
+    // in the order computeMetrics would have done them, so those
+    // that use another python metric see its new value
+    foreach(QString symbol, factory.allMetrics()) {
+
+        if (!todo.contains(symbol)) continue;
+        QVector<RideItem*> rides = todo.value(symbol);
+
+        // cancelled, so make sure they are recomputed next time
+        if (updates < 0) {
+            foreach(RideItem *item, rides) item->udbversion = 0;
+            continue;
+        }
+
+        RideMetric *m = factory.newMetric(symbol);
+        if (m && m->isUser()) static_cast<UserMetric*>(m)->computeBatch(rides, pending);
+        delete m;
+
+        foreach(RideItem *item, rides) pending[item].removeOne(symbol);
+    }
+
+    // the current ride wasn't notified when it was refreshed
+    RideItem *current = context->currentRideItem();
+    if (current && items.contains(current)) context->notifyRideChanged(current);
+}
+
 void
 RideCache::progressing(int value)
 {
@@ -898,8 +953,11 @@ void RideCacheRefreshThread::run()
         // we have one to do
         RideItem *item = cache->reverse_[n];
         if(item->isstale) {
-            item->refresh();
-            if (item == item->context->currentRideItem())
+            item->refresh(true);
+
+            // if it has python metrics to do it is notified once they're done
+            if (item->deferred.count()) cache->deferPython(item);
+            else if (item == item->context->currentRideItem())
                 item->context->notifyRideChanged(item);
         }
     }
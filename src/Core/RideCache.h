@@ -40,6 +40,9 @@ class AthleteBest;
 class RideCacheModel;
 class Estimator;
 class Banister;
+class MetricAggregator;
+class AthleteTimeline;
+class GcBench;
 
 class RideCache : public QObject
 {
@@ -53,6 +56,9 @@ class RideCache : public QObject
         // table models
         RideCacheModel *model() { return model_; }
 
+        // columnar metric aggregation for the trend charts
+        MetricAggregator *aggregator() { return aggregator_; }
+
         // query the cache
         int count() const { return rides_.count(); }
         RideItem *getRide(QString filename);
@@ -88,6 +94,10 @@ class RideCache : public QObject
         int nextRefresh(); // returns -1 when all done
         void threadCompleted(RideCacheRefreshThread*);
 
+        // python user metrics are batched across the rides refreshed
+        void deferPython(RideItem *);
+        void computeDeferred();
+
         // the ride list
 	    QVector<RideItem*>&rides() { return rides_; } 
 
@@ -145,6 +155,8 @@ class RideCache : public QObject
         friend class ::MainWindow; // save dialog
         friend class ::LTMPlot; // get weekly performances
         friend class ::Banister; // get weekly performances
+        friend class ::AthleteTimeline; // get estimates
+        friend class ::GcBench; // times the estimator
         friend class ::Leaf; // get weekly performances
         friend class ::RideItem; // adds to deletelist in destructor
         friend class ::NavigationModel; // checks deletelist during redo/undo
@@ -157,7 +169,9 @@ class RideCache : public QObject
         // delete_ is a list of items to garbage collect (delete later)
         // deletelist is a list of items that no longer exist (deleted)
         QVector<RideItem*> rides_, reverse_, delete_, deletelist;
+        QVector<RideItem*> deferred_; // refreshed, python metrics to do
         RideCacheModel *model_;
+        MetricAggregator *aggregator_;
         bool exiting;
 	    double progress_; // percent
 
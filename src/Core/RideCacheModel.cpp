@@ -25,6 +25,8 @@
 
 #include "RideCacheModel.h"
 
+#include <QRegularExpression>
+
 RideCacheModel::RideCacheModel(Context *context, RideCache *cache) : QAbstractTableModel(cache), context(context), rideCache(cache)
 {
     factory = &RideMetricFactory::instance();
@@ -62,14 +64,33 @@ RideCacheModel::flags(const QModelIndex &index) const
 QVariant 
 RideCacheModel::data(const QModelIndex &index, int role) const
 {
-    Q_UNUSED(role);
-
     if (!index.isValid() || index.row() < 0 || index.row() >= rideCache->count() ||
         index.column() < 0 || index.column() >= columns_) return QVariant();
 
-    const RideItem *item = rideCache->rides().at(index.row());
+    int row = index.row();
+    int column = index.column();
+
+    // refresh the row if the item changed since we cached it
+    checkRow(row);
+
+    // first time this column was asked for
+    if (values[column].isEmpty()) {
+        values[column].resize(rideCache->count());
+        keys[column].resize(rideCache->count());
+    }
 
-    switch (index.column()) {
+    QVariant &cached = values[column][row];
+    if (!cached.isValid()) {
+        cached = value(rideCache->rides().at(row), column);
+        keys[column][row] = sortKey(cached);
+    }
+    return role == SortRole ? keys[column][row] : cached;
+}
+
+QVariant
+RideCacheModel::value(const RideItem *item, int column) const
+{
+    switch (column) {
         case 0 : return item->path;
         case 1 : return item->fileName;
         case 2 : return item->dateTime;
@@ -81,29 +102,26 @@ RideCacheModel::data(const QModelIndex &index, int role) const
         {
             // from here we're either a metric or meta
             // lets work that out ...
-            if (index.column()-5 < factory->metricCount()) {
+            if (column-5 < factory->metricCount()) {
 
-                // is a metric
-                int i=index.column()-5;
-
-                // unpack metric value into ridemetric and use it to get a stringified
-                // version using the right metric/imperial conversion
-                RideMetric *m = const_cast<RideMetric*>(factory->rideMetric(factory->metricName(i)));
+                // is a metric, unpack metric value into ridemetric and use it to get
+                // a stringified version using the right metric/imperial conversion
+                RideMetric *m = columnMetrics[column-5];
 
                 // bit of a kludge, but will return times as QTime,
                 // stuff with no decimal places as a number,
                 // but not if high precision, which means
                 // metrics with high precision don't sort this is crap XXX
                 if (m->isTime()) {
-                    return QTime(0,0,0).addSecs(rideCache->rides().at(index.row())->metrics_[m->index()]);
+                    return QTime(0,0,0).addSecs(item->metrics_[m->index()]);
                 } else if (m->units(true) != "km" && m->precision() > 0) {
-                    m->setValue(rideCache->rides().at(index.row())->metrics_[m->index()]);
+                    m->setValue(item->metrics_[m->index()]);
                     return m->toString(GlobalContext::context()->useMetricUnits); // string
                 } else {
 
                     // make low precision numbers sort, including distance which we picked
                     // up as a special case. not sure about pace ....
-                    double value = rideCache->rides().at(index.row())->metrics_[m->index()];
+                    double value = item->metrics_[m->index()];
 
                     // convert to imperial if needed
                     if (GlobalContext::context()->useMetricUnits == false) 
@@ -115,19 +133,68 @@ RideCacheModel::data(const QModelIndex &index, int role) const
             } else {
 
                 // is a metadata
-                int i = index.column() -5 - factory->metricCount();
+                int i = column -5 - factory->metricCount();
                 return item->getText(metadata[i].name, "");
             }
         }
     }
 }
 
+// dates sort as dates, numbers as numbers and anything else as text
+QVariant
+RideCacheModel::sortKey(const QVariant &value)
+{
+    static const QRegularExpression alpha("[^0-9.,]");
+
+    if (value.type() == QVariant::DateTime) return value;
+
+    QString string = value.toString();
+    if (string.contains(alpha)) return string;
+    return string.toDouble();
+}
+
+void
+RideCacheModel::checkRow(int row) const
+{
+    if (rowItems.count() != rideCache->count()) {
+        rowItems.fill(NULL, rideCache->count());
+        rowVersions.fill(0, rideCache->count());
+        values.fill(QVector<QVariant>(), columns_);
+        keys.fill(QVector<QVariant>(), columns_);
+    }
+
+    const RideItem *item = rideCache->rides().at(row);
+    if (rowItems[row] == item && rowVersions[row] == item->version) return;
+
+    rowItems[row] = item;
+    rowVersions[row] = item->version;
+    for (int i=0; i<columns_; i++) {
+        if (!values[i].isEmpty()) {
+            values[i][row] = QVariant();
+            keys[i][row] = QVariant();
+        }
+    }
+}
+
+void
+RideCacheModel::clearCache()
+{
+    values.clear();
+    keys.clear();
+    rowItems.clear();
+    rowVersions.clear();
+}
+
 void
 RideCacheModel::itemChanged(RideItem *item)
 {
     // ok so lets signal that
     int row = rideCache->rides().indexOf(item);
-    if (row >= 0 && row <= rideCache->count()) {
+    if (row >= 0 && row < rideCache->count()) {
+
+        // metadata changes don't change the version
+        if (row < rowItems.count()) rowItems[row] = NULL;
+
         emit dataChanged(createIndex(row,0), createIndex(row,columns_-1));
     }
     //XXX hack to get the navigator to redraw
@@ -135,7 +202,7 @@ RideCacheModel::itemChanged(RideItem *item)
 }
 
 void RideCacheModel::beginReset() { beginResetModel(); }
-void RideCacheModel::endReset() { endResetModel(); }
+void RideCacheModel::endReset() { clearCache(); endResetModel(); }
 
 void 
 RideCacheModel::itemAdded(RideItem*)
@@ -149,6 +216,18 @@ void
 RideCacheModel::startRemove(int index)
 {
     beginRemoveRows(QModelIndex(), index, index);
+
+    // rows below move up
+    if (index < rowItems.count()) {
+        rowItems.remove(index);
+        rowVersions.remove(index);
+        for (int i=0; i<values.count(); i++) {
+            if (!values[i].isEmpty()) {
+                values[i].remove(index);
+                keys[i].remove(index);
+            }
+        }
+    }
 }
 
 void
@@ -189,6 +268,12 @@ RideCacheModel::configChanged(qint32)
     // get field config
     metadata = GlobalContext::context()->rideMetadata->getFields();
 
+    // units, metrics or fields may have changed
+    clearCache();
+    columnMetrics.resize(factory->metricCount());
+    for (int i=0; i<factory->metricCount(); i++)
+        columnMetrics[i] = const_cast<RideMetric*>(factory->rideMetric(factory->metricName(i)));
+
     // set new column count
     // 0    QString path;
     // 1    QString fileName;
@@ -30,14 +30,24 @@
 #include <QAbstractTableModel>
 #include <QModelIndex>
 #include <QVariant>
+#include <QVector>
 
 class Context;
 
+//
+// Values are formatted once and cached by column, along with a key to
+// sort them by (SortRole), so the navigator can sort and group large
+// numbers of activities without reformatting metrics on every compare.
+// Only columns that are asked for are cached, rows are refreshed when
+// their RideItem changes (see RideItem::version).
+//
 class RideCacheModel : public QAbstractTableModel
 {
     Q_OBJECT
 
     public:
+        enum { SortRole = Qt::UserRole + 10 };
+
         RideCacheModel(Context *, RideCache *);
 
         // must reimplement these
@@ -71,6 +81,11 @@ class RideCacheModel : public QAbstractTableModel
         void endRemove(int);
 
     private:
+        QVariant value(const RideItem *item, int column) const;
+        static QVariant sortKey(const QVariant &value);
+        void checkRow(int row) const;
+        void clearCache();
+
         Context *context;
         RideCache *rideCache;
         RideMetricFactory *factory;
@@ -80,6 +95,13 @@ class RideCacheModel : public QAbstractTableModel
 
         // the fields as defined
         QList<FieldDefinition> metadata;
+        QVector<RideMetric*> columnMetrics; // by metric column
+
+        // cache, [column][row], empty until a column is asked for
+        // the item and its version each row was cached for
+        mutable QVector<QVector<QVariant> > values, keys;
+        mutable QVector<const RideItem*> rowItems;
+        mutable QVector<quint64> rowVersions;
 };
 
 #endif
@@ -20,6 +20,7 @@
 #include "RideDB.h"
 #include "RideFileCache.h"
 #include "Settings.h"
+#include "Profiler.h"
 #ifdef GC_WANT_HTTP
 #include "APIWebService.h"
 #endif
@@ -132,6 +133,10 @@ rideelement: ride_tuple
 ride_tuple: string ':' string                                   { 
                                                                      if ($1 == "filename") jc->item.fileName = $3;
                                                                      else if ($1 == "fingerprint") jc->item.fingerprint = $3.toULongLong();
+                                                                     else if ($1 == "configfingerprints") {
+                                                                         jc->item.configfingerprints_.clear();
+                                                                         foreach(QString x, $3.split(",")) jc->item.configfingerprints_ << x.toULongLong();
+                                                                     }
                                                                      else if ($1 == "crc") jc->item.crc = $3.toULongLong();
                                                                      else if ($1 == "metacrc") jc->item.metacrc = $3.toULongLong();
                                                                      else if ($1 == "timestamp") jc->item.timestamp = $3.toULongLong();
@@ -321,6 +326,8 @@ string: STRING                                               { jc->JsonString =
 void 
 RideCache::load()
 {
+    PROFILE(Profiler::Cache, QStringLiteral("RideCache::load"));
+
     // only load if it exists !
     QFile rideDB(QString("%1/%2").arg(context->athlete->home->cache().canonicalPath()).arg("rideDB.json"));
     if (rideDB.exists() && rideDB.open(QFile::ReadOnly)) {
@@ -479,6 +486,7 @@ QString ConstructNameNumberNumberString(QString s0, QString name, QString s1, do
 //
 void RideCache::save(bool opendata, QString filename)
 {
+    PROFILE(Profiler::Cache, QStringLiteral("RideCache::save"));
 
     // now save data away - use passed filename if set
     QFile rideDB(QString("%1/%2").arg(context->athlete->home->cache().canonicalPath()).arg("rideDB.json"));
@@ -533,6 +541,11 @@ void RideCache::save(bool opendata, QString filename)
                 // we don't send this info when sharing as opendata
                 stream << "\t\t\"filename\":\"" <<item->fileName <<"\",\n";
                 stream << "\t\t\"fingerprint\":\"" <<item->fingerprint <<"\",\n";
+                if (item->configfingerprints_.count()) {
+                    QStringList fingerprints;
+                    foreach(unsigned long x, item->configfingerprints_) fingerprints << QString::number(x);
+                    stream << "\t\t\"configfingerprints\":\"" <<fingerprints.join(",") <<"\",\n";
+                }
                 stream << "\t\t\"crc\":\"" <<item->crc <<"\",\n";
                 stream << "\t\t\"metacrc\":\"" <<item->metacrc <<"\",\n";
                 stream << "\t\t\"timestamp\":\"" <<item->timestamp <<"\",\n";
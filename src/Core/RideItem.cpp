@@ -21,6 +21,8 @@
 #include "RideMetric.h"
 #include "RideFile.h"
 #include "RideFileCache.h"
+#include "RideFileIndex.h"
+#include "HrvSeries.h"
 #include "RideMetadata.h"
 #include "IntervalItem.h"
 #include "Route.h"
@@ -28,33 +30,44 @@
 #include "Zones.h"
 #include "HrZones.h"
 #include "PaceZones.h"
+#include "AthleteTimeline.h"
 #include "Settings.h"
 #include "Colors.h" // for ColorEngine
 #include "AddIntervalDialog.h" // till we fixup ridefilecache to have offsets
 #include "TimeUtils.h" // time_to_string()
 #include "WPrime.h" // for matches
+#include "Profiler.h"
 
 #include <cmath>
+#include <atomic>
 #include <QtAlgorithms>
 #include <QMap>
 #include <QMapIterator>
 #include <QByteArray>
 
+// the parts of the config fingerprint
+enum { PowerFingerprint, HrFingerprint, PaceFingerprint, HrvFingerprint, OtherFingerprint, FingerprintCount };
+
+// versions are never reused, so a memo keyed by item and version can't
+// be fooled by an item deleted and another allocated at the same address
+static std::atomic<quint64> versions(0);
+static quint64 nextVersion() { return ++versions; }
+
 // used to create a temporary ride item that is not in the cache and just
 // used to enable using the same calling semantics in things like the
 // merge wizard and interval navigator
 RideItem::RideItem() 
     : 
-    ride_(NULL), fileCache_(NULL), context(NULL), isdirty(false), isstale(true), isedit(false), skipsave(false), path(""), fileName(""),
-    color(QColor(1,1,1)), sport(""), isBike(false), isRun(false), isSwim(false), isXtrain(false), isAero(false), samples(false), zoneRange(-1), hrZoneRange(-1), paceZoneRange(-1), fingerprint(0), metacrc(0), crc(0), timestamp(0), dbversion(0), udbversion(0), weight(0) {
+    ride_(NULL), fileCache_(NULL), index_(NULL), hrv_(NULL), context(NULL), isdirty(false), isstale(true), staleconfig(0), isedit(false), skipsave(false), path(""), fileName(""),
+    color(QColor(1,1,1)), sport(""), isBike(false), isRun(false), isSwim(false), isXtrain(false), isAero(false), samples(false), zoneRange(-1), hrZoneRange(-1), paceZoneRange(-1), fingerprint(0), metacrc(0), crc(0), timestamp(0), dbversion(0), udbversion(0), weight(0), version(nextVersion()) {
     metrics_.fill(0, RideMetricFactory::instance().metricCount());
     count_.fill(0, RideMetricFactory::instance().metricCount());
 }
 
 RideItem::RideItem(RideFile *ride, Context *context) 
     : 
-    ride_(ride), fileCache_(NULL), context(context), isdirty(false), isstale(true), isedit(false), skipsave(false), path(""), fileName(""),
-    color(QColor(1,1,1)), sport(""), isBike(false), isRun(false), isSwim(false), isXtrain(false), isAero(false), samples(false), zoneRange(-1), hrZoneRange(-1), paceZoneRange(-1), fingerprint(0), metacrc(0), crc(0), timestamp(0), dbversion(0), udbversion(0), weight(0)
+    ride_(ride), fileCache_(NULL), index_(NULL), hrv_(NULL), context(context), isdirty(false), isstale(true), staleconfig(0), isedit(false), skipsave(false), path(""), fileName(""),
+    color(QColor(1,1,1)), sport(""), isBike(false), isRun(false), isSwim(false), isXtrain(false), isAero(false), samples(false), zoneRange(-1), hrZoneRange(-1), paceZoneRange(-1), fingerprint(0), metacrc(0), crc(0), timestamp(0), dbversion(0), udbversion(0), weight(0), version(nextVersion())
 {
     metrics_.fill(0, RideMetricFactory::instance().metricCount());
     count_.fill(0, RideMetricFactory::instance().metricCount());
@@ -62,9 +75,9 @@ RideItem::RideItem(RideFile *ride, Context *context)
 
 RideItem::RideItem(QString path, QString fileName, QDateTime &dateTime, Context *context, bool planned)
     :
-    ride_(NULL), fileCache_(NULL), context(context), isdirty(false), isstale(true), isedit(false), skipsave(false), path(path), fileName(fileName),
+    ride_(NULL), fileCache_(NULL), index_(NULL), hrv_(NULL), context(context), isdirty(false), isstale(true), staleconfig(0), isedit(false), skipsave(false), path(path), fileName(fileName),
     dateTime(dateTime), color(QColor(1,1,1)), planned(planned), sport(""), isBike(false), isRun(false), isSwim(false), isXtrain(false), isAero(false), samples(false), zoneRange(-1), hrZoneRange(-1), paceZoneRange(-1), fingerprint(0),
-    metacrc(0), crc(0), timestamp(0), dbversion(0), udbversion(0), weight(0) 
+    metacrc(0), crc(0), timestamp(0), dbversion(0), udbversion(0), weight(0), version(nextVersion()) 
 {
     metrics_.fill(0, RideMetricFactory::instance().metricCount());
     count_.fill(0, RideMetricFactory::instance().metricCount());
@@ -74,8 +87,8 @@ RideItem::RideItem(QString path, QString fileName, QDateTime &dateTime, Context
 // pre-computed metrics and storing ride metadata
 RideItem::RideItem(RideFile *ride, QDateTime &dateTime, Context *context)
     :
-    ride_(ride), fileCache_(NULL), context(context), isdirty(true), isstale(true), isedit(false), skipsave(false), dateTime(dateTime),
-    zoneRange(-1), hrZoneRange(-1), paceZoneRange(-1), fingerprint(0), metacrc(0), crc(0), timestamp(0), dbversion(0), udbversion(0), weight(0)
+    ride_(ride), fileCache_(NULL), index_(NULL), hrv_(NULL), context(context), isdirty(true), isstale(true), staleconfig(0), isedit(false), skipsave(false), dateTime(dateTime),
+    zoneRange(-1), hrZoneRange(-1), paceZoneRange(-1), fingerprint(0), metacrc(0), crc(0), timestamp(0), dbversion(0), udbversion(0), weight(0), version(nextVersion())
 {
     metrics_.fill(0, RideMetricFactory::instance().metricCount());
     count_.fill(0, RideMetricFactory::instance().metricCount());
@@ -115,6 +128,7 @@ RideItem::setFrom(RideItem&here, bool temp) // used when loading cache/rideDB.js
     hrZoneRange = here.hrZoneRange;
     paceZoneRange = here.paceZoneRange;
     fingerprint = here.fingerprint;
+    configfingerprints_ = here.configfingerprints_;
     metacrc = here.metacrc;
     crc = here.crc;
     timestamp = here.timestamp;
@@ -131,6 +145,7 @@ RideItem::setFrom(RideItem&here, bool temp) // used when loading cache/rideDB.js
     weight = here.weight;
     overrides_ = here.overrides_;
     samples = here.samples;
+    version = nextVersion();
 }
 
 // set the metric array
@@ -149,6 +164,7 @@ RideItem::setFrom(QHash<QString, RideMetricPtr> computed)
             stdvariance_.insert(i.value()->index(), stdvariance);
         }
     }
+    version = nextVersion();
 }
 
 // calculate metadata crc
@@ -358,6 +374,7 @@ RideItem::notifyRideDataChanged()
 {
     // refresh the metrics
     isstale=true;
+    staleconfig=0;
 
     // wipe user data
     userCache.clear();
@@ -382,6 +399,7 @@ RideItem::notifyRideMetadataChanged()
 {
     // refresh the metrics
     isstale=true;
+    staleconfig=0;
     refresh();
 
     emit rideMetadataChanged();
@@ -398,6 +416,7 @@ RideItem::saved()
 {
     setDirty(false);
     isstale=true;
+    staleconfig=0;
     refresh(); // update !
     context->notifyRideSaved(this);
 }
@@ -407,9 +426,25 @@ RideItem::reverted()
 {
     setDirty(false);
     isstale=true;
+    staleconfig=0;
     refresh();
 }
 
+// a deferred metric has been computed
+void
+RideItem::setMetric(int index, double value, double count)
+{
+    if (index < 0 || index >= metrics_.count()) return;
+
+    // clean any bad values
+    if (std::isinf(value) || std::isnan(value)) value = count = 0.00f;
+    metrics_[index] = value;
+    count_[index] = count;
+
+    // anything memoised against the old values is now out of date
+    version = nextVersion();
+}
+
 void
 RideItem::setDirty(bool val)
 {
@@ -433,6 +468,7 @@ RideItem::setFileName(QString path, QString fileName)
 {
     this->path = path;
     this->fileName = fileName;
+    version = nextVersion();
 }
 
 bool
@@ -464,6 +500,7 @@ RideItem::setStartTime(QDateTime newDateTime)
 {
     dateTime = newDateTime;
     ride()->setStartTime(newDateTime);
+    version = nextVersion();
 }
 
 // check if we need to be refreshed
@@ -476,6 +513,12 @@ RideItem::checkStale()
     // just change it .. its as quick to change as it is to check !
     color = GlobalContext::context()->colorEngine->colorFor(getText(GlobalContext::context()->rideMetadata->getColorField(), ""));
 
+    // athlete config that has changed for the date of the ride, if
+    // that is all that changed then only metrics that read it need
+    // to be recomputed
+    int config = RideMetric::NoConfig;
+    double before = 0;
+
     // upgraded metrics
     if (udbversion != UserMetricSchemaVersion || dbversion != DBSchemaVersion) {
 
@@ -484,81 +527,131 @@ RideItem::checkStale()
     } else {
 
         // has weight changed?
+        before = weight;
         unsigned long prior  = 1000.0f * weight;
         unsigned long now = 1000.0f * getWeight();
 
         if (prior != now) {
 
             getWeight();
-            isstale = true;
+            config |= RideMetric::WeightConfig;
+        }
 
-        } else {
+        // or have cp / zones or routes fingerprints changed ?
+        // note we now get the fingerprint from the zone range
+        // and not the entire config so that if you add a new
+        // range (e.g. set CP from today) but none of the other
+        // ranges change then there is no need to recompute the
+        // metrics for older rides !
+        // HRV fingerprint added to detect changes on HRV Measures
 
-            // or have cp / zones or routes fingerprints changed ?
-            // note we now get the fingerprint from the zone range
-            // and not the entire config so that if you add a new
-            // range (e.g. set CP from today) but none of the other
-            // ranges change then there is no need to recompute the
-            // metrics for older rides !
-            // HRV fingerprint added to detect changes on HRV Measures
-
-            // get the new zone configuration fingerprint that applies for the ride date
-            unsigned long rfingerprint = static_cast<unsigned long>(context->athlete->zones(sport)->getFingerprint(dateTime.date()))
-                        + (appsettings->cvalue(context->athlete->cyclist, context->athlete->zones(sport)->useCPforFTPSetting(), 0).toInt() ? 1 : 0)
-                        + static_cast<unsigned long>(context->athlete->paceZones(isSwim)->getFingerprint(dateTime.date()))
-                        + static_cast<unsigned long>(context->athlete->hrZones(sport)->getFingerprint(dateTime.date()))
-                        + static_cast<unsigned long>(context->athlete->routes->getFingerprint())
-                        + static_cast<unsigned long>(getHrvFingerprint())
-                        + appsettings->cvalue(context->athlete->cyclist, GC_DISCOVERY, 57).toInt(); // 57 does not include search for PEAKS
-
-            if (fingerprint != rfingerprint) {
+        // get the new zone configuration fingerprint that applies for the ride date
+        QVector<unsigned long> fingerprints = configFingerprints();
+        unsigned long rfingerprint = 0;
+        foreach(unsigned long x, fingerprints) rfingerprint += x;
 
-                isstale = true;
+        if (fingerprint != rfingerprint) {
 
-            } else {
+            // we can only tell what changed if we know what it was
+            if (configfingerprints_.count() != fingerprints.count() || configfingerprints_[OtherFingerprint] != fingerprints[OtherFingerprint]) {
 
-                // or has file content changed ?
-                QString fullPath =  QString(context->athlete->home->activities().absolutePath()) + "/" + fileName;
-                QFile file(fullPath);
+                isstale = true;
 
-                // has timestamp changed ?
-                if (timestamp < QFileInfo(file).lastModified().toSecsSinceEpoch()) {
+            } else {
 
-                    // if timestamp has changed then check crc
-                    unsigned long fcrc = RideFile::computeFileCRC(fullPath);
+                if (configfingerprints_[HrFingerprint] != fingerprints[HrFingerprint]) config |= RideMetric::HrZonesConfig;
+                if (configfingerprints_[PaceFingerprint] != fingerprints[PaceFingerprint]) config |= RideMetric::PaceZonesConfig;
+                if (configfingerprints_[HrvFingerprint] != fingerprints[HrvFingerprint]) config |= RideMetric::HrvConfig;
 
-                    if (crc == 0 || crc != fcrc) {
-                        crc = fcrc; // update as expensive to calculate
+                // CP and W' are used to discover efforts
+                if (configfingerprints_[PowerFingerprint] != fingerprints[PowerFingerprint]) {
+                    if (appsettings->cvalue(context->athlete->cyclist, GC_DISCOVERY, 57).toInt() & RideFileInterval::intervalTypeBits(RideFileInterval::EFFORT))
                         isstale = true;
-                    }
+                    else
+                        config |= RideMetric::PowerZonesConfig;
                 }
+            }
 
+        } else {
 
-                // no intervals ?
-                if (samples && intervals_.count() == 0)
-                    isstale = true;
+            // remember, so next time we know what changed
+            configfingerprints_ = fingerprints;
+        }
+
+        if (!isstale) {
+
+            // or has file content changed ?
+            QString fullPath =  QString(context->athlete->home->activities().absolutePath()) + "/" + fileName;
+            QFile file(fullPath);
 
+            // has timestamp changed ?
+            if (timestamp < QFileInfo(file).lastModified().toSecsSinceEpoch()) {
+
+                // if timestamp has changed then check crc
+                unsigned long fcrc = RideFile::computeFileCRC(fullPath);
+
+                if (crc == 0 || crc != fcrc) {
+                    crc = fcrc; // update as expensive to calculate
+                    isstale = true;
+                }
             }
+
+
+            // no intervals ?
+            if (samples && intervals_.count() == 0)
+                isstale = true;
+
         }
     }
 
-    // still reckon its clean? what about the cache ?
-    if (isstale == false) isstale = RideFileCache::checkStale(context, this);
+    // still reckon its clean? what about the cache ? when the weight
+    // changed it must be good for the old weight, the refresh then
+    // rebuilds it (and its W/kg mean max) for the new one
+    if (isstale == false) isstale = RideFileCache::checkStale(context, this, (config & RideMetric::WeightConfig) ? before : 0);
 
     // we need to mark stale in case "special" fields may have changed (e.g. CP)
     if (metacrc != metaCRC()) isstale = true;
 
+    // just the config then
+    if (isstale) staleconfig = RideMetric::NoConfig;
+    else if (config) {
+        isstale = true;
+        staleconfig = config;
+    }
+
     return isstale;
 }
 
+// the parts of the fingerprint, see checkStale()
+QVector<unsigned long>
+RideItem::configFingerprints()
+{
+    QVector<unsigned long> returning(FingerprintCount);
+
+    returning[PowerFingerprint] = static_cast<unsigned long>(context->athlete->zones(sport)->getFingerprint(dateTime.date()))
+                                + (appsettings->cvalue(context->athlete->cyclist, context->athlete->zones(sport)->useCPforFTPSetting(), 0).toInt() ? 1 : 0);
+    returning[PaceFingerprint] = static_cast<unsigned long>(context->athlete->paceZones(isSwim)->getFingerprint(dateTime.date()));
+    returning[HrFingerprint] = static_cast<unsigned long>(context->athlete->hrZones(sport)->getFingerprint(dateTime.date()));
+    returning[HrvFingerprint] = static_cast<unsigned long>(getHrvFingerprint());
+    returning[OtherFingerprint] = static_cast<unsigned long>(context->athlete->routes->getFingerprint())
+                                + appsettings->cvalue(context->athlete->cyclist, GC_DISCOVERY, 57).toInt(); // 57 does not include search for PEAKS
+    return returning;
+}
+
 void
-RideItem::refresh()
+RideItem::refresh(bool deferPython)
 {
     if (!isstale) return;
 
+    PROFILE(Profiler::Cache, QStringLiteral("RideItem::refresh"));
+
     // update current state coz we'll fix it below
     isstale = false;
 
+    // only some metrics need recomputing ?
+    int config = staleconfig;
+    staleconfig = RideMetric::NoConfig;
+
     // open ride file will extract details too, but only if not
     // already open since its a user entry point and will call
     // refresh when opened. We don't want a recursion here.
@@ -607,14 +700,9 @@ RideItem::refresh()
         samples = f->dataPoints().count() > 0;
 
         // zone ranges
-        if (context->athlete->zones(sport)) zoneRange = context->athlete->zones(sport)->whichRange(dateTime.date());
-        else zoneRange = -1;
-
-        if (context->athlete->hrZones(sport)) hrZoneRange = context->athlete->hrZones(sport)->whichRange(dateTime.date());
-        else hrZoneRange = -1;
-
-        if (context->athlete->paceZones(isSwim)) paceZoneRange = context->athlete->paceZones(isSwim)->whichRange(dateTime.date());
-        else paceZoneRange = -1;
+        zoneRange = context->athlete->timeline->zoneRange(context->athlete->zones(sport), dateTime.date());
+        hrZoneRange = context->athlete->timeline->hrZoneRange(context->athlete->hrZones(sport), dateTime.date());
+        paceZoneRange = context->athlete->timeline->paceZoneRange(context->athlete->paceZones(isSwim), dateTime.date());
 
         // RideFile cache refresh before metrics, as meanmax may be used in user formulas
         RideFileCache updater(context, context->athlete->home->activities().canonicalPath() + "/" + fileName, getWeight(), ride_, true);
@@ -622,13 +710,45 @@ RideItem::refresh()
         // refresh metrics etc
         const RideMetricFactory &factory = RideMetricFactory::instance();
 
-        // ressize and initialize so we can store metric values at
-        // RideMetric::index offsets into the metrics_ qvector
-        metrics_.fill(0, factory.metricCount());
-        count_.fill(0, factory.metricCount());
+        // just those that read the config that changed, the rest stand
+        QStringList affected;
+        if (config) {
+
+            affected = factory.affectedBy(config);
+
+            // derived series use CP
+            if ((config & RideMetric::PowerZonesConfig) && !doclose) {
+                ride_->wstale = true;
+                ride_->recalculateDerivedSeries(true);
+            }
+
+        } else {
+
+            // ressize and initialize so we can store metric values at
+            // RideMetric::index offsets into the metrics_ qvector
+            metrics_.fill(0, factory.metricCount());
+            count_.fill(0, factory.metricCount());
+        }
+
+        // the hrv metrics share one pass over the R-R data
+        if (f->xdata("HRV")) hrv_ = new HrvSeries(f->xdata("HRV"));
+
+        // python user metrics left for the cache to run together
+        QStringList wanted = config ? affected : factory.allMetrics();
+        deferred.clear();
+        if (deferPython) {
+            for (int j=0; j<wanted.count();) {
+                const RideMetric *m = factory.haveMetric(wanted[j]) ? factory.rideMetric(wanted[j]) : NULL;
+                if (m && m->isUser() && static_cast<const UserMetric*>(m)->usesPython()) deferred << wanted.takeAt(j);
+                else j++;
+            }
+        }
 
         // we compute all with not specification (not an interval)
-        QHash<QString,RideMetricPtr> computed= RideMetric::computeMetrics(this, Specification(), factory.allMetrics());
+        QHash<QString,RideMetricPtr> computed= RideMetric::computeMetrics(this, Specification(), wanted);
+
+        delete hrv_;
+        hrv_ = NULL;
 
         // snaffle away all the computed values into the array
         QHashIterator<QString, RideMetricPtr> i(computed);
@@ -653,16 +773,21 @@ RideItem::refresh()
             }
 
         // Update auto intervals AFTER ridefilecache as used for bests
-        updateIntervals();
+        // when config changed they're the same, but their metrics aren't
+        if (config) {
+            index_ = new RideFileIndex(f);
+            foreach(IntervalItem *interval, intervals_) interval->refresh(affected);
+            delete index_;
+            index_ = NULL;
+            context->notifyIntervalsUpdate(this);
+        } else {
+            updateIntervals();
+        }
 
         // update fingerprints etc, crc done above
-        fingerprint = static_cast<unsigned long>(context->athlete->zones(sport)->getFingerprint(dateTime.date()))
-                    + (appsettings->cvalue(context->athlete->cyclist, context->athlete->zones(sport)->useCPforFTPSetting(), 0).toInt() ? 1 : 0)
-                    + static_cast<unsigned long>(context->athlete->paceZones(isSwim)->getFingerprint(dateTime.date()))
-                    + static_cast<unsigned long>(context->athlete->hrZones(sport)->getFingerprint(dateTime.date()))
-                    + static_cast<unsigned long>(context->athlete->routes->getFingerprint()) +
-                    + static_cast<unsigned long>(getHrvFingerprint())
-                    + appsettings->cvalue(context->athlete->cyclist, GC_DISCOVERY, 57).toInt(); // 57 does not include search for PEAKS
+        configfingerprints_ = configFingerprints();
+        fingerprint = 0;
+        foreach(unsigned long x, configfingerprints_) fingerprint += x;
 
         dbversion = DBSchemaVersion;
         udbversion = UserMetricSchemaVersion;
@@ -674,6 +799,9 @@ RideItem::refresh()
         // Construct the summary text used on the calendar
         metadata_.insert("Calendar Text", GlobalContext::context()->rideMetadata->calendarText(this));
 
+        // anything memoised against the old values is now out of date
+        version = nextVersion();
+
         // close if we opened it
         if (doclose) {
             close();
@@ -697,7 +825,7 @@ RideItem::getWeight(int type)
 {
     // get any body measurements first
     MeasuresGroup* pBodyMeasures = context->athlete->measures->getGroup(Measures::Body);
-    double m = pBodyMeasures ? pBodyMeasures->getFieldValue(dateTime.date(), type) : 0.0;
+    double m = context->athlete->timeline->getFieldValue(pBodyMeasures, dateTime.date(), type);
 
     // return what was asked for!
     if (type == Measure::WeightKg) {
@@ -726,7 +854,7 @@ RideItem::getHrvMeasure(QString fieldSymbol)
     // get HRV measure for the date of the ride
     MeasuresGroup *pHrvMeasures = context->athlete->measures->getGroup(Measures::Hrv);
     if (pHrvMeasures) {
-        return pHrvMeasures->getFieldValue(dateTime.date(), pHrvMeasures->getFieldSymbols().indexOf(fieldSymbol));
+        return context->athlete->timeline->getFieldValue(pHrvMeasures, dateTime.date(), pHrvMeasures->getFieldSymbols().indexOf(fieldSymbol));
     } else {
         return 0.0;
     }
@@ -739,7 +867,7 @@ RideItem::getHrvFingerprint()
     MeasuresGroup* pHrvMeasures = context->athlete->measures->getGroup(Measures::Hrv);
     if (pHrvMeasures) {
         Measure hrvMeasure;
-        pHrvMeasures->getMeasure(dateTime.date(), hrvMeasure);
+        context->athlete->timeline->getMeasure(pHrvMeasures, dateTime.date(), hrvMeasure);
         return hrvMeasure.getFingerprint();
     } else {
         return 0;
@@ -879,6 +1007,9 @@ RideItem::updateIntervals()
         return;
     }
 
+    // intervals can share the work of computing their metrics
+    index_ = new RideFileIndex(f);
+
     // Get CP and W' estimates for date of ride
     double CP = 0;
     double WPRIME = 0;
@@ -1570,6 +1701,9 @@ RideItem::updateIntervals()
         }
     }
 
+    delete index_;
+    index_ = NULL;
+
     // tell the world we changed
     context->notifyIntervalsUpdate(this);
 
@@ -30,6 +30,8 @@
 
 class RideFile;
 class RideFileCache;
+class RideFileIndex;
+class HrvSeries;
 class RideCache;
 class RideCacheModel;
 class IntervalItem;
@@ -58,6 +60,12 @@ class RideItem : public QObject
         RideFile *ride_;
         RideFileCache *fileCache_;
 
+        // only whilst updating intervals, see RideFileIndex.h
+        RideFileIndex *index_;
+
+        // only whilst computing metrics, see HrvSeries.h
+        HrvSeries *hrv_;
+
         // precomputed metrics & user overrides
         QVector<double> metrics_;
         QVector<double> count_;
@@ -81,6 +89,8 @@ class RideItem : public QObject
 
         unsigned long metaCRC();
 
+        QVector<unsigned long> configFingerprints();
+
     public slots:
         void modified();
         void reverted();
@@ -99,6 +109,7 @@ class RideItem : public QObject
         Context *context; // to notify widgets when date/time changes
         bool isdirty;     // ride data has changed and needs saving
         bool isstale;     // metric data is out of date and needs recomputing
+        int staleconfig;  // only because this athlete config changed, see RideMetric::ConfigDependency
         bool isedit;      // is being edited at the moment
         bool skipsave;    // on exit we don't save the state to force rebuild at startup
 
@@ -108,6 +119,11 @@ class RideItem : public QObject
         // record of any overrides, used by formula "isset" function
         QStringList overrides_;
 
+        // config fingerprints that add up to the fingerprint, known once
+        // metrics have been computed or found to be up to date, they
+        // are saved with the cache so we know what changed at startup
+        QVector<unsigned long> configfingerprints_;
+
         // set metric values e.g. when working with intervals
         void setFrom(QHash<QString, RideMetricPtr>);
 
@@ -165,6 +181,7 @@ class RideItem : public QObject
         int dbversion; // metric version
         int udbversion; // user metric version
         double weight; // what weight was used ?
+        quint64 version; // changes whenever metrics or metadata do, unique across items
 
         // access to the cached data !
         RideFile *ride(bool open=true);
@@ -216,14 +233,23 @@ class RideItem : public QObject
         bool checkStale(); // check if we need to refresh
         bool isStale() { return isstale; }
 
-        // refresh when stale
-        void refresh();
+        // refresh when stale, the cache refresh defers user metrics
+        // that call python() and batches them across rides afterwards
+        void refresh(bool deferPython=false);
+        QStringList deferred; // python user metrics not yet computed
+        void setMetric(int index, double value, double count);
 
         // get/set
         void setRide(RideFile *);
         void setFileName(QString, QString);
         void setStartTime(QDateTime);
 
+        // index of the ride samples, NULL unless intervals are being refreshed
+        RideFileIndex *rideFileIndex() const { return index_; }
+
+        // R-R arrays, NULL unless the activity's metrics are being refreshed
+        HrvSeries *hrvSeries() const { return hrv_; }
+
         // sorting
         bool operator<(RideItem right) const { return dateTime < right.dateTime; }
 
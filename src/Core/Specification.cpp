@@ -110,6 +110,40 @@ Specification::isEmpty(RideFile *ride) const
     return false;
 }
 
+QString
+FilterSet::signature() const
+{
+    // order of names is irrelevant, but order of sets is not
+    // each name is prefixed by its length so no two differ
+    QString returning;
+    foreach(QSet<QString> set, filters_) {
+        QStringList names = set.values();
+        names.sort();
+        returning += "[";
+        foreach(QString name, names) returning += QString("%1:%2").arg(name.length()).arg(name);
+        returning += "]";
+    }
+    return returning;
+}
+
+QString
+Specification::signature() const
+{
+    QString returning = QString("%1-%2%3").arg(dr.from.toString(Qt::ISODate))
+                                          .arg(dr.to.toString(Qt::ISODate))
+                                          .arg(fs.signature());
+
+    // the interval is identified by its ride and where it is
+    if (it) {
+        QString ride = it->rideItem() ? it->rideItem()->fileName : QString();
+        returning += QString("{%1:%2@%3-%4/%5}").arg(ride.length()).arg(ride)
+                                               .arg(it->start, 0, 'g', 17)
+                                               .arg(it->stop, 0, 'g', 17)
+                                               .arg(recintsecs, 0, 'g', 17);
+    }
+    return returning;
+}
+
 void
 Specification::setRideItem(RideItem *ri)
 {
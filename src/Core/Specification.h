@@ -72,6 +72,10 @@ class FilterSet
         }
 
         int count() { return filters_.count(); }
+
+        // a signature so results can be cached per filter set, the
+        // names themselves so two different sets never share one
+        QString signature() const;
 };
 
 class RideFileIterator;
@@ -96,7 +100,7 @@ class Specification
         bool isEmpty(RideFile *) const;
 
         // non-null if exists
-        IntervalItem *interval() { return it; }
+        IntervalItem *interval() const { return it; }
 
         // set criteria
         void setDateRange(DateRange dr);
@@ -110,6 +114,11 @@ class Specification
         FilterSet filterSet() { return fs; }
         bool isFiltered() { return (fs.count() > 0); }
 
+        // signature of the date range, filters and interval, when two
+        // specifications have the same signature they will pass the same
+        // ride items and the same samples
+        QString signature() const;
+
         // just start/stop and item for now
         // when working with samples
         void print();
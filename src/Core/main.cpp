@@ -28,6 +28,12 @@
 #include "PowerProfile.h"
 #include "GcCrashDialog.h" // for versionHTML
 #include "OverviewItems.h"
+#include "RideFile.h"
+#include "BatchExport.h"
+#include "GcBench.h"
+#include "Profiler.h"
+#include "AthleteTab.h"
+#include "RideCache.h"
 
 #include <QApplication>
 #include <QtGui>
@@ -53,6 +59,7 @@
 #endif
 
 #include <QStandardPaths>
+#include <QTemporaryDir>
 
 #include <gsl/gsl_errno.h>
 
@@ -98,6 +105,9 @@ void terminate(int code)
     delete appsettings;
     application->exit();
 
+    // --profile reports on the way out
+    if (Profiler::isEnabled()) fprintf(stderr, "%s", Profiler::report().toLocal8Bit().constData());
+
     // because QT starts a bunch of threads (e.g. reading XcbEvents)
     // calling exit() during startup is a no-no. So we go nuclear and
     // exit without calling the static destructors via _Exit(), unless we did
@@ -253,6 +263,10 @@ main(int argc, char *argv[])
     bool server = false;
     nogui = false;
     bool help = false;
+    QString exportFormat, exportFolder;
+    QString benchFile, benchFiles, benchCharts, benchBaseline;
+    int benchGenerate = 0;
+    double benchThreshold = GCBENCH_THRESHOLD;
 
     // honour command line switches
     QString arg;
@@ -282,6 +296,14 @@ main(int argc, char *argv[])
 #else
             fprintf(stderr, "--debug             to direct diagnostic messages to the terminal instead of goldencheetah.log\n");
 #endif
+            fprintf(stderr, "--export format folder to export all of the athlete's activities and exit, format is csv or an export suffix e.g. tcx\n");
+            fprintf(stderr, "--bench file        to benchmark a scratch copy of the athlete, write the results as json to file and exit\n");
+            fprintf(stderr, "--bench-files folder to also benchmark reading the activity files in folder\n");
+            fprintf(stderr, "--bench-charts folder to also benchmark the formulas in the .gchart files in folder\n");
+            fprintf(stderr, "--bench-generate n  to add n synthetic activities to the copy, or to a new athlete if none is given\n");
+            fprintf(stderr, "--bench-baseline file to compare with the results of an earlier run, exit 2 if any stage is slower\n");
+            fprintf(stderr, "--bench-threshold pct how much slower than the baseline is a regression, default %.0f\n", GCBENCH_THRESHOLD);
+            fprintf(stderr, "--profile           to time metrics, formulas, file readers and caches and report on exit\n");
             fprintf(stderr, "--debug-file file   to direct diagnostic messages to file\n");
             fprintf(stderr, "--debug-rules \"rules\" to specify which diagnostic messages to output, using the same syntax as QT_LOGGING_RULES\n");
             fprintf(stderr, "--debug-format \"format\" to specify the format of diagnostic messages, using the same syntax as QT_MESSAGE_PATTERN\n");
@@ -339,6 +361,32 @@ main(int argc, char *argv[])
 #else
             debug = true;
 #endif
+        } else if (arg == "--export" && i+1 < sargs.length()) {
+            exportFormat = QString(sargs[i]).toLower();
+            exportFolder = QString(sargs[i+1]);
+            nogui = true;
+            i += 2;
+        } else if (arg == "--profile") {
+            Profiler::setEnabled(true);
+        } else if (arg == "--bench" && i < sargs.length()) {
+            benchFile = QString(sargs[i]);
+            nogui = true;
+            i++;
+        } else if (arg == "--bench-files" && i < sargs.length()) {
+            benchFiles = QString(sargs[i]);
+            i++;
+        } else if (arg == "--bench-charts" && i < sargs.length()) {
+            benchCharts = QString(sargs[i]);
+            i++;
+        } else if (arg == "--bench-generate" && i < sargs.length()) {
+            benchGenerate = QString(sargs[i]).toInt();
+            i++;
+        } else if (arg == "--bench-baseline" && i < sargs.length()) {
+            benchBaseline = QString(sargs[i]);
+            i++;
+        } else if (arg == "--bench-threshold" && i < sargs.length()) {
+            benchThreshold = QString(sargs[i]).toDouble();
+            i++;
         } else if (arg == "--debug-file" && i < sargs.length()) {
             debugFile = QString(sargs[i]);
             i++;
@@ -426,6 +474,9 @@ main(int argc, char *argv[])
 #endif
 #endif
 
+    // benchmarks open the athlete without a display
+    if (benchFile != "" && qgetenv("QT_QPA_PLATFORM").isEmpty()) qputenv("QT_QPA_PLATFORM", "offscreen");
+
     // create the application -- only ever ONE regardless of restarts
     application = new QApplication(argc, argv);
 
@@ -648,6 +699,106 @@ main(int argc, char *argv[])
             
         }
 
+        // batch export from the command line, for scheduled conversions
+        if (exportFormat != "") {
+
+            QString athlete = lastOpened.toStringList().value(0);
+            QDir folder(exportFolder);
+            if (athlete == "" || !home.exists(athlete)) {
+                fprintf(stderr, "No athlete to export, specify the folder and/or athlete.\n");
+                terminate(1);
+            }
+            if (!folder.exists()) {
+                fprintf(stderr, "Export folder %s does not exist.\n", exportFolder.toLocal8Bit().constData());
+                terminate(1);
+            }
+            // no athlete is opened, so only the formats that don't need one
+            QStringList formats;
+            foreach(QString suffix, RideFileFactory::instance().writeSuffixes())
+                if (BatchExport::standalone(suffix)) formats << suffix;
+            if (exportFormat != "csv" && !formats.contains(exportFormat)) {
+                fprintf(stderr, "Cannot export as %s, use csv or one of: %s\n", exportFormat.toLocal8Bit().constData(),
+                        formats.join(" ").toLocal8Bit().constData());
+                terminate(1);
+            }
+
+            // no athlete is opened, so no context
+            AthleteDirectoryStructure structure(QDir(home.absolutePath() + "/" + athlete));
+            QStringList names = structure.activities().entryList(QDir::Files, QDir::Name);
+            BatchExport exporter(NULL, exportFormat, folder, false);
+            for (int i=0; i<names.count(); i++) exporter.add(structure.activities().absolutePath() + "/" + names[i], i);
+
+            QObject::connect(&exporter, &BatchExport::jobFinished, [&names](int tag, bool, QString message) {
+                fprintf(stderr, "%s: %s\n", names[tag].toLocal8Bit().constData(), message.toLocal8Bit().constData());
+            });
+            bool success = exporter.exec();
+            terminate(success ? 0 : 1);
+        }
+
+        // benchmark the core engines from the command line, see GcBench.h
+        if (benchFile != "") {
+
+            // the stages rewrite caches and refresh every activity, so we
+            // work on a scratch copy of the athlete, or a synthetic one
+            QString athlete = lastOpened.toStringList().value(0);
+            bool real = athlete != "" && home.exists(athlete);
+            if (!real && benchGenerate <= 0) {
+                fprintf(stderr, "No athlete to benchmark, specify the folder and/or athlete or use --bench-generate.\n");
+                terminate(1);
+            }
+
+            QTemporaryDir scratch;
+            if (!scratch.isValid()) {
+                fprintf(stderr, "Could not create a scratch folder to benchmark in.\n");
+                terminate(1);
+            }
+            if (!real) athlete = "Benchmark";
+
+            QStringList errors;
+            QString copy = scratch.path() + "/" + athlete;
+            if (real && !GcBench::copyAthlete(QDir(home.absolutePath() + "/" + athlete), copy, errors)) {
+                foreach(QString error, errors) fprintf(stderr, "%s\n", error.toLocal8Bit().constData());
+                scratch.remove();
+                terminate(1);
+            }
+
+            if (benchGenerate > 0) {
+                int added = GcBench::generate(QDir(copy), benchGenerate, errors);
+                foreach(QString error, errors) fprintf(stderr, "%s\n", error.toLocal8Bit().constData());
+                fprintf(stderr, "Generated %d activities.\n", added);
+            }
+            home.setPath(scratch.path());
+
+            // opening loads the ride cache, and refreshes anything stale
+            QElapsedTimer timer;
+            timer.start();
+            appsettings->initializeQSettingsAthlete(home.canonicalPath(), athlete);
+            home.cd(athlete);
+            MainWindow *mainWindow = new MainWindow(home);
+            Context *context = mainWindow->athleteTab()->context;
+            while (context->athlete->rideCache->isRunning()) {
+                application->processEvents();
+                QThread::msleep(10);
+            }
+            double opened = timer.nsecsElapsed() / 1000000.0;
+
+            GcBench bench(context);
+            bench.record("open athlete", opened, context->athlete->rideCache->count());
+            bench.run(benchFiles, benchCharts);
+            bench.report();
+
+            int regressions = 0;
+            if (benchBaseline != "") {
+                regressions = bench.compare(benchBaseline, benchThreshold);
+                if (regressions < 0) fprintf(stderr, "Could not read baseline %s\n", benchBaseline.toLocal8Bit().constData());
+            }
+
+            bool success = bench.write(benchFile);
+            if (!success) fprintf(stderr, "Could not write %s\n", benchFile.toLocal8Bit().constData());
+            scratch.remove();
+            terminate(!success || regressions < 0 ? 1 : (regressions > 0 ? 2 : 0));
+        }
+
 #ifdef GC_WANT_HTTP
 
         // The API server offers webservices (default port 12021, see httpserver.ini)
@@ -785,6 +936,8 @@ main(int argc, char *argv[])
 
     } while (restarting);
 
+    if (Profiler::isEnabled()) fprintf(stderr, "%s", Profiler::report().toLocal8Bit().constData());
+
     delete application;
 
     return ret;
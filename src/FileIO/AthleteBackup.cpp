@@ -23,6 +23,7 @@
 
 #include "Athlete.h"
 #include "AthleteBackup.h"
+#include "AthleteSnapshot.h"
 #include "Settings.h"
 #include "GcUpgrade.h"
 
@@ -68,7 +69,8 @@ AthleteBackup::backupOnClose()
         return;
     }
 
-    backup(tr("Abort Backup and Reset Counter"));
+    // on close we only store what changed since the last time
+    snapshot(tr("Abort Backup and Reset Counter"));
 
     appsettings->setCValue(athlete, GC_AUTOBACKUP_COUNTER, 0);
 
@@ -107,8 +109,63 @@ AthleteBackup::backupImmediate()
 
 }
 
+void
+AthleteBackup::restoreImmediate()
+{
+    backupFolder = appsettings->cvalue(athlete, GC_AUTOBACKUP_FOLDER, "").toString();
+    QString snapshot = QFileDialog::getOpenFileName(NULL, tr("Select Backup Snapshot"), backupFolder,
+                                                    tr("Backup Snapshots (*.snapshot)"));
+    if (snapshot == "") return;
+
+    QList<AthleteSnapshot::Entry> entries;
+    QString name;
+    if (!AthleteSnapshot::readSnapshot(snapshot, entries, &name)) {
+        QMessageBox::warning(NULL, tr("Athlete Restore"), tr("%1 is not a backup snapshot.").arg(snapshot));
+        return;
+    }
+
+    QString dir = QFileDialog::getExistingDirectory(NULL, tr("Select Directory to Restore %1 into").arg(name),
+                            "", QFileDialog::ShowDirsOnly | QFileDialog::DontResolveSymlinks);
+    if (dir == "") return;
+
+    QProgressDialog progress(tr("Restoring backup for athlete %1 ...").arg(name), tr("Abort Restore"), 0, entries.count(), NULL);
+    progress.setWindowModality(Qt::WindowModal);
+
+    QStringList errors;
+    AthleteSnapshot store(QFileInfo(snapshot).absolutePath());
+    if (store.restore(snapshot, QDir(dir), &progress, errors)) {
+        QMessageBox::information(NULL, tr("Athlete Restore"), tr("Backup successfully restored into \n%1").arg(dir));
+    } else if (errors.count()) {
+        QMessageBox::warning(NULL, tr("Athlete Restore"), errors.join("\n"));
+    }
+}
+
 // -- private methods
 
+bool
+AthleteBackup::snapshot(QString progressText)
+{
+    // each athlete has its own store, see AthleteSnapshot.h
+    AthleteSnapshot store(backupFolder + "/GC_" + athlete + ".snapshots");
+
+    QStringList folders;
+    foreach (QDir folder, sourceFolderList) folders << folder.dirName();
+
+    QProgressDialog progress(tr("Backing up changed files for athlete %1 ...").arg(athlete), progressText, 0, 0, NULL);
+    progress.setWindowModality(Qt::WindowModal);
+
+    QStringList errors;
+    QString written = store.backup(athleteDirs->root(), folders, athlete, &progress, errors);
+
+    // and drop the oldest, along with anything only they refer to
+    if (written != "") store.prune(appsettings->cvalue(athlete, GC_AUTOBACKUP_KEEP, 30).toInt(), errors);
+
+    if (errors.count()) {
+        QMessageBox::warning(NULL, tr("Athlete Backup"), tr("Backup for athlete %1 failed.\n%2").arg(athlete).arg(errors.join("\n")));
+    }
+    return written != "";
+}
+
 bool
 AthleteBackup::backup(QString progressText)
 {
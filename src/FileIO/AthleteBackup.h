@@ -34,12 +34,16 @@ class AthleteBackup : public QObject
         void backupOnClose();
         void backupImmediate();
 
+        // restore a snapshot taken on close into a chosen folder
+        void restoreImmediate();
+
     private:
         AthleteDirectoryStructure *athleteDirs;
         QString athlete;
         QString backupFolder;
         QList<QDir> sourceFolderList;
         bool backup(QString progressText);
+        bool snapshot(QString progressText);
 
 };
 
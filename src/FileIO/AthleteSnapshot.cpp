@@ -0,0 +1,454 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "AthleteSnapshot.h"
+
+#include <QApplication>
+#include <QProgressDialog>
+#include <QCryptographicHash>
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QTextStream>
+#include <QDirIterator>
+#include <QThread>
+#include <QHash>
+#include <QSet>
+#include <QMutex>
+#include <QtConcurrent>
+#include <algorithm>
+
+static QString objectPathFor(const QString &store, const QByteArray &hash)
+{
+    QString hex = QString::fromLatin1(hash);
+    return store + "/objects/" + hex.left(2) + "/" + hex;
+}
+
+// a chunk of an object, see AthleteSnapshot.h
+static bool writeChunk(QIODevice &out, const QByteArray &chunk)
+{
+    // media files and the like won't compress
+    QByteArray packed = qCompress(chunk);
+    bool compressed = packed.size() < chunk.size();
+    const QByteArray &payload = compressed ? packed : chunk;
+
+    quint32 length = payload.size();
+    char header[5] = { compressed ? 'Z' : 'R', char(length >> 24), char(length >> 16), char(length >> 8), char(length) };
+    return out.write(header, 5) == 5 && out.write(payload) == payload.size();
+}
+
+// a file that has changed since the last snapshot
+struct SnapshotWork {
+    QString source;
+    AthleteSnapshot::Entry entry;
+    QString error;
+};
+
+// hash, compress and store a changed file, runs on the thread pool
+class SnapshotWriter
+{
+    public:
+        SnapshotWriter(QString store) : store(store) {}
+
+        void operator()(SnapshotWork &work) const {
+
+            QFile file(work.source);
+            if (!file.open(QIODevice::ReadOnly)) {
+                work.error = QObject::tr("Cannot read %1").arg(work.source);
+                return;
+            }
+
+            // hash it a chunk at a time, we may not need to store it
+            QCryptographicHash hash(QCryptographicHash::Sha256);
+            work.entry.size = 0;
+            while (!file.atEnd()) {
+                QByteArray chunk = file.read(ATHLETESNAPSHOT_CHUNK);
+                if (chunk.isEmpty()) {
+                    work.error = QObject::tr("Cannot read %1").arg(work.source);
+                    return;
+                }
+                hash.addData(chunk);
+                work.entry.size += chunk.size();
+            }
+            work.entry.hash = hash.result().toHex();
+
+            // already got this content
+            QString path = objectPathFor(store, work.entry.hash);
+            if (QFile::exists(path)) return;
+
+            QDir().mkpath(QFileInfo(path).absolutePath());
+            QSaveFile out(path);
+            if (!out.open(QIODevice::WriteOnly) || out.write("C", 1) != 1) {
+                work.error = QObject::tr("Cannot write %1").arg(path);
+                return;
+            }
+
+            // and again to store it, it must not have changed since
+            hash.reset();
+            file.seek(0);
+            while (!file.atEnd()) {
+                QByteArray chunk = file.read(ATHLETESNAPSHOT_CHUNK);
+                if (chunk.isEmpty()) {
+                    work.error = QObject::tr("Cannot read %1").arg(work.source);
+                    return;
+                }
+                hash.addData(chunk);
+                if (!writeChunk(out, chunk)) {
+                    work.error = QObject::tr("Cannot write %1").arg(path);
+                    return;
+                }
+            }
+            if (hash.result().toHex() != work.entry.hash) {
+                work.error = QObject::tr("%1 changed whilst it was backed up").arg(work.source);
+                return;
+            }
+            if (!out.commit()) work.error = QObject::tr("Cannot write %1").arg(path);
+        }
+
+    private:
+        QString store;
+};
+
+// check an object hashes to its name, runs on the thread pool
+class SnapshotVerifier
+{
+    public:
+        SnapshotVerifier(const AthleteSnapshot *snapshot, QStringList *errors, QMutex *lock)
+            : snapshot(snapshot), errors(errors), lock(lock) {}
+
+        void operator()(const QByteArray &hash) const {
+            if (!snapshot->readObject(hash, NULL)) {
+                QMutexLocker locker(lock);
+                *errors << QObject::tr("Backup object %1 is missing or corrupt").arg(QString::fromLatin1(hash));
+            }
+        }
+
+    private:
+        const AthleteSnapshot *snapshot;
+        QStringList *errors;
+        QMutex *lock;
+};
+
+// keep the gui alive whilst the thread pool works
+static bool waitFor(QFuture<void> &future, QProgressDialog *progress)
+{
+    while (!future.isFinished()) {
+        if (progress) {
+            progress->setValue(future.progressValue());
+            if (progress->wasCanceled()) future.cancel();
+        }
+        QApplication::processEvents();
+        QThread::msleep(20);
+    }
+    future.waitForFinished();
+    return !future.isCanceled();
+}
+
+AthleteSnapshot::AthleteSnapshot(QString store) : store(store)
+{
+}
+
+QString
+AthleteSnapshot::objectPath(const QByteArray &hash) const
+{
+    return objectPathFor(store.absolutePath(), hash);
+}
+
+bool
+AthleteSnapshot::readObject(const QByteArray &hash, QIODevice *content) const
+{
+    QFile file(objectPath(hash));
+    char type;
+    if (!file.open(QIODevice::ReadOnly) || !file.getChar(&type)) return false;
+
+    QCryptographicHash check(QCryptographicHash::Sha256);
+
+    if (type == 'Z' || type == 'R') {
+
+        // version 1 stored the content whole
+        QByteArray stored = file.readAll();
+        QByteArray data = (type == 'Z') ? qUncompress(stored) : stored;
+        check.addData(data);
+        if (content && content->write(data) != data.size()) return false;
+
+    } else if (type == 'C') {
+
+        while (!file.atEnd()) {
+            uchar header[5];
+            if (file.read(reinterpret_cast<char*>(header), 5) != 5) return false;
+
+            quint32 length = (quint32(header[1]) << 24) | (quint32(header[2]) << 16) | (quint32(header[3]) << 8) | quint32(header[4]);
+            if (length > quint32(2 * ATHLETESNAPSHOT_CHUNK)) return false; // corrupt, don't try and allocate it
+
+            QByteArray payload = file.read(length);
+            if (quint32(payload.size()) != length) return false;
+
+            QByteArray chunk;
+            if (header[0] == 'Z') chunk = qUncompress(payload);
+            else if (header[0] == 'R') chunk = payload;
+            else return false;
+
+            check.addData(chunk);
+            if (content && content->write(chunk) != chunk.size()) return false;
+        }
+
+    } else {
+        return false;
+    }
+
+    return check.result().toHex() == hash;
+}
+
+QString
+AthleteSnapshot::latest() const
+{
+    QStringList snapshots = store.entryList(QStringList() << "*.snapshot", QDir::Files, QDir::Name);
+    if (snapshots.isEmpty()) return QString();
+    return store.absoluteFilePath(snapshots.last());
+}
+
+bool
+AthleteSnapshot::readSnapshot(QString filename, QList<Entry> &entries, QString *athlete)
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) return false;
+
+    QTextStream in(&file);
+#if QT_VERSION < 0x060000
+    in.setCodec("UTF-8");
+#endif
+    QStringList header = in.readLine().split(" ");
+    if (header.count() < 3 || header.at(0) != "GCSNAPSHOT" || header.at(1).toInt() > ATHLETESNAPSHOT_VERSION) return false;
+    if (athlete) *athlete = header.mid(2).join(" ");
+
+    entries.clear();
+    while (!in.atEnd()) {
+        QString line = in.readLine();
+        if (line.isEmpty()) continue;
+
+        // the path is last as it may contain spaces
+        int a = line.indexOf(' ');
+        int b = line.indexOf(' ', a+1);
+        int c = line.indexOf(' ', b+1);
+        if (a < 0 || b < 0 || c < 0) return false;
+
+        Entry entry;
+        entry.hash = line.left(a).toLatin1();
+        entry.size = line.mid(a+1, b-a-1).toLongLong();
+        entry.mtime = line.mid(b+1, c-b-1).toLongLong();
+        entry.path = line.mid(c+1);
+        entries << entry;
+    }
+    return true;
+}
+
+QString
+AthleteSnapshot::backup(QDir root, QStringList folders, QString athlete, QProgressDialog *progress, QStringList &errors)
+{
+    if (!store.mkpath("objects")) {
+        errors << QObject::tr("Cannot create backup folder %1").arg(store.absolutePath());
+        return QString();
+    }
+
+    // what we had last time
+    QHash<QString, Entry> previous;
+    QList<Entry> last;
+    QString lastSnapshot = latest();
+    if (!lastSnapshot.isEmpty() && readSnapshot(lastSnapshot, last))
+        foreach(Entry entry, last) previous.insert(entry.path, entry);
+
+    // unchanged files are carried over without reading them
+    QList<Entry> entries;
+    QList<SnapshotWork> work;
+    foreach(QString folder, folders) {
+        QDir dir(root.absoluteFilePath(folder));
+        foreach (QFileInfo info, dir.entryInfoList(QDir::Files | QDir::NoDotAndDotDot | QDir::NoSymLinks)) {
+
+            Entry entry;
+            entry.path = folder + "/" + info.fileName();
+            entry.size = info.size();
+            entry.mtime = info.lastModified().toMSecsSinceEpoch();
+
+            QHash<QString, Entry>::const_iterator it = previous.constFind(entry.path);
+            if (it != previous.constEnd() && it.value().size == entry.size && it.value().mtime == entry.mtime) {
+                entry.hash = it.value().hash;
+                entries << entry;
+            } else {
+                SnapshotWork changed;
+                changed.source = info.canonicalFilePath();
+                changed.entry = entry;
+                work << changed;
+            }
+        }
+    }
+
+    // store what changed
+    if (work.count()) {
+        if (progress) progress->setRange(0, work.count());
+
+        QFuture<void> future = QtConcurrent::map(work, SnapshotWriter(store.absolutePath()));
+        if (!waitFor(future, progress)) return QString();
+
+        foreach(SnapshotWork changed, work) {
+            if (changed.error.isEmpty()) entries << changed.entry;
+            else errors << changed.error;
+        }
+        if (errors.count()) return QString();
+    }
+
+    // nothing changed, the last snapshot is still current
+    if (work.isEmpty() && !lastSnapshot.isEmpty() && entries.count() == last.count()) return lastSnapshot;
+
+    // write the snapshot last, so it only exists if complete
+    std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) { return a.path < b.path; });
+
+    QString filename = store.absoluteFilePath(QDateTime::currentDateTime().toString("yyyy_MM_dd_HH_mm_ss") + ".snapshot");
+    QSaveFile out(filename);
+    if (!out.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        errors << QObject::tr("Cannot write %1").arg(filename);
+        return QString();
+    }
+
+    QByteArray text = QString("GCSNAPSHOT %1 %2\n").arg(ATHLETESNAPSHOT_VERSION).arg(athlete).toUtf8();
+    foreach(Entry entry, entries) {
+        text += entry.hash + " " + QByteArray::number(entry.size) + " " + QByteArray::number(entry.mtime) + " "
+              + entry.path.toUtf8() + "\n";
+    }
+    out.write(text);
+
+    if (!out.commit()) {
+        errors << QObject::tr("Cannot write %1").arg(filename);
+        return QString();
+    }
+    if (progress) progress->setValue(progress->maximum());
+    return filename;
+}
+
+bool
+AthleteSnapshot::restore(QString snapshot, QDir target, QProgressDialog *progress, QStringList &errors)
+{
+    QList<Entry> entries;
+    if (!readSnapshot(snapshot, entries)) {
+        errors << QObject::tr("%1 is not a backup snapshot").arg(snapshot);
+        return false;
+    }
+    if (progress) progress->setRange(0, entries.count());
+
+    // one file at a time, a chunk at a time
+    for (int i=0; i<entries.count(); i++) {
+
+        const Entry &entry = entries.at(i);
+        if (progress) {
+            progress->setValue(i);
+            QApplication::processEvents();
+            if (progress->wasCanceled()) return false;
+        }
+
+        // never write outside the target
+        QString path = QDir::cleanPath(entry.path);
+        if (QDir::isAbsolutePath(path) || path.startsWith("..")) {
+            errors << QObject::tr("Skipped %1, not in the athlete folder").arg(entry.path);
+            continue;
+        }
+
+        QString filename = target.absoluteFilePath(path);
+        target.mkpath(QFileInfo(filename).absolutePath());
+        QSaveFile out(filename);
+        if (!out.open(QIODevice::WriteOnly)) {
+            errors << QObject::tr("Cannot write %1").arg(filename);
+            continue;
+        }
+
+        // only replaces the file if it was all there and matched its hash
+        if (!readObject(entry.hash, &out)) {
+            out.cancelWriting();
+            errors << QObject::tr("%1 is missing or corrupt in the backup").arg(entry.path);
+            continue;
+        }
+        if (!out.commit()) {
+            errors << QObject::tr("Cannot write %1").arg(filename);
+            continue;
+        }
+
+        // so the next backup of the restored folder sees it as unchanged
+        QFile restored(filename);
+        if (restored.open(QIODevice::Append)) {
+            restored.setFileTime(QDateTime::fromMSecsSinceEpoch(entry.mtime), QFileDevice::FileModificationTime);
+            restored.close();
+        }
+    }
+    if (progress) progress->setValue(entries.count());
+
+    return errors.isEmpty();
+}
+
+bool
+AthleteSnapshot::verify(QString snapshot, QProgressDialog *progress, QStringList &errors)
+{
+    QList<Entry> entries;
+    if (!readSnapshot(snapshot, entries)) {
+        errors << QObject::tr("%1 is not a backup snapshot").arg(snapshot);
+        return false;
+    }
+
+    // each object once, however many files share it
+    QSet<QByteArray> unique;
+    foreach(Entry entry, entries) unique.insert(entry.hash);
+    QList<QByteArray> hashes = unique.values();
+
+    if (progress) progress->setRange(0, hashes.count());
+
+    QMutex lock;
+    QFuture<void> future = QtConcurrent::map(hashes, SnapshotVerifier(this, &errors, &lock));
+    if (!waitFor(future, progress)) return false;
+
+    return errors.isEmpty();
+}
+
+int
+AthleteSnapshot::prune(int keep, QStringList &errors)
+{
+    QStringList snapshots = store.entryList(QStringList() << "*.snapshot", QDir::Files, QDir::Name);
+    if (keep <= 0 || snapshots.count() <= keep) return 0;
+
+    // objects the ones we keep refer to, if we can't read one
+    // of them we can't tell what is safe to remove
+    QSet<QByteArray> used;
+    for (int i=snapshots.count()-keep; i<snapshots.count(); i++) {
+        QList<Entry> entries;
+        if (!readSnapshot(store.absoluteFilePath(snapshots.at(i)), entries)) {
+            errors << QObject::tr("Cannot read %1, old backups were not removed").arg(snapshots.at(i));
+            return 0;
+        }
+        foreach(Entry entry, entries) used.insert(entry.hash);
+    }
+
+    int removed = 0;
+    for (int i=0; i<snapshots.count()-keep; i++) {
+        if (store.remove(snapshots.at(i))) removed++;
+        else errors << QObject::tr("Cannot remove %1").arg(store.absoluteFilePath(snapshots.at(i)));
+    }
+
+    // and whatever only they referred to
+    QDirIterator it(store.absoluteFilePath("objects"), QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        QString path = it.next();
+        if (!used.contains(it.fileName().toLatin1())) QFile::remove(path);
+    }
+    return removed;
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef _GC_AthleteSnapshot_h
+#define _GC_AthleteSnapshot_h 1
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QList>
+#include <QDir>
+
+class QProgressDialog;
+class QIODevice;
+
+//
+// Incremental athlete backups
+//
+// A snapshot store is a directory per athlete holding the contents of
+// every file ever backed up, named by the sha-256 of the content, and
+// a snapshot file for each backup listing the files it contains:
+//
+//   objects/xx/<hash>                  'C' + the content in chunks
+//   yyyy_MM_dd_HH_mm_ss.snapshot
+//
+// Each chunk is 'Z' or 'R', a 4 byte big endian length and then that many
+// bytes of qCompress()ed content, or of content that won't compress. The
+// content is read, hashed, compressed and written ATHLETESNAPSHOT_CHUNK at
+// a time so memory use doesn't depend on the size of the files. Objects
+// written by version 1 are 'Z' or 'R' then the whole content, and can
+// still be read.
+//
+// The snapshot is text, a "GCSNAPSHOT <version> <athlete>" line then
+// one "<hash> <size> <mtime> <path>" line per file, with the path
+// relative to the athlete folder.
+//
+// Files whose size and modification time are the same as in the last
+// snapshot are not read at all. Changed files are hashed and only
+// compressed and written if the store doesn't already hold the same
+// content, this work runs on the global thread pool. The snapshot is
+// written last so an interrupted backup leaves the previous one intact.
+//
+// prune() removes all but the most recent snapshots and then any objects
+// that none of the remaining snapshots refer to.
+//
+#define ATHLETESNAPSHOT_VERSION 2
+#define ATHLETESNAPSHOT_CHUNK   (1024*1024) // bytes
+
+class AthleteSnapshot
+{
+    public:
+
+        struct Entry {
+            QString path;
+            qint64 size;
+            qint64 mtime; // ms since epoch, utc
+            QByteArray hash; // hex
+        };
+
+        AthleteSnapshot(QString store);
+
+        // snapshot the folders (relative to root), returns the snapshot file
+        // or an empty string if cancelled or it failed
+        QString backup(QDir root, QStringList folders, QString athlete, QProgressDialog *progress, QStringList &errors);
+
+        // restore into target, verifying each file as it is written
+        bool restore(QString snapshot, QDir target, QProgressDialog *progress, QStringList &errors);
+
+        // check every object the snapshot refers to decompresses to its hash
+        bool verify(QString snapshot, QProgressDialog *progress, QStringList &errors);
+
+        // keep the most recent snapshots, returns how many were removed
+        int prune(int keep, QStringList &errors);
+
+        // most recent snapshot in the store, empty if none
+        QString latest() const;
+
+        static bool readSnapshot(QString filename, QList<Entry> &entries, QString *athlete=NULL);
+
+        // write the content of an object to content (which may be NULL just
+        // to check it), false if missing or it doesn't match its hash
+        bool readObject(const QByteArray &hash, QIODevice *content) const;
+
+    private:
+        QString objectPath(const QByteArray &hash) const;
+
+        QDir store;
+};
+
+#endif // _GC_AthleteSnapshot_h
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "BatchExport.h"
+
+#include "RideFile.h"
+#include "CsvRideFile.h"
+
+#include <QCoreApplication>
+#include <QEventLoop>
+#include <QFileInfo>
+#include <QFile>
+#include <QThread>
+#include <QtConcurrent>
+
+// runs on the thread pool, only touches its own job
+static void exportJob(BatchExportJob *job, Context *context, QString format, bool overwrite)
+{
+    if (QFile(job->target).exists()) {
+        if (overwrite == false) {
+            job->state = BatchExportJob::Skipped;
+            job->message = BatchExport::tr("Exists - not exported");
+            return;
+        }
+        QFile(job->target).remove();
+    }
+
+    if (context == NULL && !BatchExport::standalone(format)) {
+        job->state = BatchExportJob::Failed;
+        job->message = BatchExport::tr("Needs an athlete");
+        return;
+    }
+
+    QStringList errors;
+    QFile in(job->source);
+    RideFile *ride = RideFileFactory::instance().openRideFile(context, in, errors);
+    if (ride == NULL) {
+        job->state = BatchExportJob::Failed;
+        job->message = BatchExport::tr("Read error");
+        return;
+    }
+
+    QFile out(job->target);
+    bool success = false;
+    if (format == "csv") {
+        CsvFileReader writer;
+        success = writer.writeRideFile(context, ride, out, CsvFileReader::gc);
+    } else {
+        success = RideFileFactory::instance().writeRideFile(context, ride, out, format);
+    }
+    delete ride; // free memory!
+
+    job->state = success ? BatchExportJob::Complete : BatchExportJob::Failed;
+    job->message = success ? BatchExport::tr("Exported") : BatchExport::tr("Write failed");
+}
+
+BatchExport::BatchExport(Context *context, QString format, QDir folder, bool overwrite, int window) :
+    context(context), format(format), folder(folder), overwrite(overwrite), window(window),
+    running(false), aborted(false), next(0), successful(0)
+{
+    if (this->window <= 0) this->window = QThread::idealThreadCount();
+}
+
+BatchExport::~BatchExport()
+{
+    // jobs in flight still refer to their job
+    aborted = true;
+    foreach(QFutureWatcher<void> *watcher, watchers.keys()) watcher->waitForFinished();
+    qDeleteAll(watchers.keys());
+    qDeleteAll(jobs);
+}
+
+void
+BatchExport::add(QString source, int tag)
+{
+    if (running) return;
+
+    BatchExportJob *job = new BatchExportJob();
+    job->source = source;
+    job->target = folder.absolutePath() + "/" + QFileInfo(source).baseName() + "." + format;
+    job->tag = tag;
+    jobs << job;
+}
+
+void
+BatchExport::start()
+{
+    if (running) return;
+
+    running = true;
+    aborted = false;
+    next = successful = 0;
+    schedule();
+}
+
+void
+BatchExport::abort()
+{
+    // no more are started, the last one in flight to
+    // finish signals we are finished
+    aborted = true;
+}
+
+bool
+BatchExport::exec()
+{
+    QEventLoop loop;
+    connect(this, SIGNAL(finished(int,int)), &loop, SLOT(quit()));
+    start();
+    if (running) loop.exec();
+    return successful == jobs.count();
+}
+
+bool
+BatchExport::standalone(QString format)
+{
+    // fitlog is mostly metrics, computed from a RideItem with the athlete's
+    // context, the other writers leave those parts out when there isn't one
+    return format != "fitlog";
+}
+
+void
+BatchExport::schedule()
+{
+    if (!running) return;
+
+    while (!aborted && watchers.count() < window && next < jobs.count()) {
+
+        BatchExportJob *job = jobs[next++];
+        job->state = BatchExportJob::Running;
+        emit jobStarted(job->tag);
+
+        QFutureWatcher<void> *watcher = new QFutureWatcher<void>();
+        connect(watcher, SIGNAL(finished()), this, SLOT(completed()));
+        watchers.insert(watcher, job);
+        watcher->setFuture(QtConcurrent::run(exportJob, job, context, format, overwrite));
+    }
+
+    // all done?
+    if (watchers.isEmpty() && (aborted || next == jobs.count())) {
+        running = false;
+        emit finished(successful, jobs.count());
+    }
+}
+
+void
+BatchExport::completed()
+{
+    QFutureWatcher<void> *watcher = static_cast<QFutureWatcher<void>*>(sender());
+    BatchExportJob *job = watchers.take(watcher);
+    watcher->deleteLater();
+    if (job == NULL) return;
+
+    if (job->state == BatchExportJob::Complete || job->state == BatchExportJob::Skipped) successful++;
+    emit jobFinished(job->tag, job->state == BatchExportJob::Complete, job->message);
+
+    schedule();
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef _GC_BatchExport_h
+#define _GC_BatchExport_h 1
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QHash>
+#include <QDir>
+#include <QFutureWatcher>
+
+class Context;
+
+//
+// Exports activities to another file format on the thread pool, used by
+// the batch processing dialog and by --export on the command line.
+//
+// Each job reads an activity and writes it out, the ride is freed before
+// the job finishes so no more than window rides are in memory at once.
+// Jobs are started as others finish, abort() stops any more from starting
+// and waits for those in flight.
+//
+// The format is a RideFileFactory write suffix, or "csv" for the all data
+// csv export. The context may be NULL when there is no athlete open, some
+// writers then leave out data they compute from metrics, and formats that
+// cannot be written at all without an athlete fail, see standalone().
+//
+class BatchExportJob
+{
+    public:
+        BatchExportJob() : tag(-1), state(Pending) {}
+
+        enum { Pending, Running, Complete, Skipped, Failed };
+
+        QString source;     // activity file, full path
+        QString target;     // exported file, full path
+        int tag;            // the caller's, passed back in signals
+
+        int state;
+        QString message;
+};
+
+class BatchExport : public QObject
+{
+    Q_OBJECT
+
+    public:
+        BatchExport(Context *context, QString format, QDir folder, bool overwrite, int window = 0);
+        ~BatchExport();
+
+        // queue an activity, only before start()
+        void add(QString source, int tag);
+
+        void start();
+        void abort();
+
+        // start and wait for all jobs, returns true if none failed,
+        // existing files that were skipped are not failures
+        bool exec();
+
+        // can the format be written without an athlete (NULL context)
+        static bool standalone(QString format);
+
+        bool isRunning() const { return running; }
+        int count() const { return jobs.count(); }
+
+    signals:
+        void jobStarted(int tag);
+        void jobFinished(int tag, bool success, QString message);
+        void finished(int successful, int total);
+
+    private slots:
+        void completed();
+        void schedule();
+
+    private:
+        Context *context;
+        QString format;
+        QDir folder;
+        bool overwrite;
+        int window;
+        bool running, aborted;
+        int next, successful;
+
+        QList<BatchExportJob*> jobs;
+        QHash<QFutureWatcher<void>*, BatchExportJob*> watchers;
+};
+
+#endif // _GC_BatchExport_h
@@ -127,10 +127,8 @@ RideFile *CsvFileReader::openRideFile(QFile &file, QStringList &errors, QList<Ri
     double lastKM=0; // when deriving distance from speed
     XDataSeries *rowSeries=NULL;
     XDataSeries *trainSeries=NULL;
-    XDataSeries *rrSeries=NULL;
     XDataSeries *ibikeSeries=NULL;
     XDataSeries *xdataSeries=NULL;
-    XDataSeries *vo2Series=NULL;
 
     /* Joule 1.0
     Version,Date/Time,Km,Minutes,RPE,Tags,"Weight, kg","Work, kJ",FTP,"Sample Rate, s",Device Type,Firmware Version,Last Updated,Category 1,Category 2
@@ -799,12 +797,12 @@ RideFile *CsvFileReader::openRideFile(QFile &file, QStringList &errors, QList<Ri
                      else {
                          watts = line.section(',', 2, 2).toDouble();
                      }
-                     XDataPoint *p = new XDataPoint();
-                     p->secs = minutes*60.0;
-                     p->km = km;
-                     p->number[0] = line.section(',', 2, 2).toDouble();  // CALC-POWER
-                     p->number[1] = line.section(',', 17, 17).toDouble();  // Rho
-                     ibikeSeries->datapoints.append(p);
+                     XDataPoint p;
+                     p.secs = minutes*60.0;
+                     p.km = km;
+                     p.number[0] = line.section(',', 2, 2).toDouble();  // CALC-POWER
+                     p.number[1] = line.section(',', 17, 17).toDouble();  // Rho
+                     ibikeSeries->append(p);
 
                      cad = line.section(',', 4, 4).toDouble();
                      hr = line.section(',', 5, 5).toDouble();
@@ -1146,13 +1144,13 @@ RideFile *CsvFileReader::openRideFile(QFile &file, QStringList &errors, QList<Ri
 
                         // add ALL data series to XDATA
                         // with NO conversion, stored exactly as found
-                        XDataPoint *p = new XDataPoint();
-                        p->secs = lastsecs;
-                        p->km = lastKM;
+                        XDataPoint p;
+                        p.secs = lastsecs;
+                        p.km = lastKM;
                         for(int i=0; i<25; i++)
-                            p->number[i] = els[i].toDouble();
+                            p.number[i] = els[i].toDouble();
 
-                        rowSeries->datapoints.append(p);
+                        rowSeries->append(p);
                     }
 
                } else if (csvType == xdata) {
@@ -1188,16 +1186,16 @@ RideFile *CsvFileReader::openRideFile(QFile &file, QStringList &errors, QList<Ri
                        QStringList els = line.split(",", Qt::KeepEmptyParts);
                        if (els.count() != xdataSeries->valuename.count()+2) continue;
                        // add ALL data series to XDATA
-                       XDataPoint *p = new XDataPoint();
-                       p->secs = els[0].toDouble();
-                       p->km = els[1].toDouble();
-                       for(int i=2; i<els.count(); i++) p->number[i-2] = els[i].toDouble();
-                       xdataSeries->datapoints.append(p);
+                       XDataPoint p;
+                       p.secs = els[0].toDouble();
+                       p.km = els[1].toDouble();
+                       for(int i=2; i<els.count(); i++) p.number[i-2] = els[i].toDouble();
+                       xdataSeries->append(p);
 
                        // only time and distance as standard series
-                       rideFile->appendPoint(p->secs, // time in seconds
+                       rideFile->appendPoint(p.secs, // time in seconds
                                              0, 0,    // cad, hr
-                                             p->km,   // distance (km)
+                                             p.km,   // distance (km)
                                              0, 0, 0, 0, 0, 0, 0, 0,
                                              -255,    // temp
                                              0, 0, 0, 0, 0, 0.0, 0.0,
@@ -1251,12 +1249,12 @@ RideFile *CsvFileReader::openRideFile(QFile &file, QStringList &errors, QList<Ri
                             trainSeries->unitname << "Watts";
                         }
 
-                        XDataPoint *p = new XDataPoint();
-                        p->secs = minutes * 60.0;
-                        p->km = km;
-                        p->number[0] = target;
+                        XDataPoint p;
+                        p.secs = minutes * 60.0;
+                        p.km = km;
+                        p.number[0] = target;
 
-                        trainSeries->datapoints.append(p);
+                        trainSeries->append(p);
                     }
                }
             }
@@ -1369,14 +1367,14 @@ RideFile *CsvFileReader::openRideFile(QFile &file, QStringList &errors, QList<Ri
     if (csvType == rowpro) rideFile->setTag("Sport","Row");
 
     if (trainSeries != NULL) {
-        if (trainSeries->datapoints.count()>0)
+        if (trainSeries->count()>0)
             rideFile->addXData("TRAIN", trainSeries);
         else
             delete trainSeries;
     }
 
     if (ibikeSeries != NULL) {
-        if (ibikeSeries->datapoints.count()>0)
+        if (ibikeSeries->count()>0)
             rideFile->addXData("AERO", ibikeSeries);
         else
             delete ibikeSeries;
@@ -1389,8 +1387,23 @@ RideFile *CsvFileReader::openRideFile(QFile &file, QStringList &errors, QList<Ri
         return NULL;
     }
 
+    // any associated .vo2 and .rr files become XDATA
+    readCompanionXData(rideFile, file.fileName().replace(".csv",".vo2"),
+                                 file.fileName().replace(".csv",".rr"));
+
+    // all done
+    return rideFile;
+}
+
+void
+CsvFileReader::readCompanionXData(RideFile *rideFile, QString vo2filename, QString rrfilename)
+{
+    int lineno;
+    XDataSeries *vo2Series=NULL;
+    XDataSeries *rrSeries=NULL;
+
     // Is there an associated .vo2 file?
-    QFile vo2file(file.fileName().replace(".csv",".vo2"));
+    QFile vo2file(vo2filename);
     if (vo2file.open(QFile::ReadOnly))
     {
         // create the XDATA series
@@ -1430,16 +1443,16 @@ RideFile *CsvFileReader::openRideFile(QFile &file, QStringList &errors, QList<Ri
                     QStringList values = line.split(",", Qt::KeepEmptyParts);
 
                     // and add
-                    XDataPoint *p = new XDataPoint();
-                    p->secs = values.at(0).toDouble();
-                    p->km = 0;
-                    p->number[0] = values.at(1).toDouble();
-                    p->number[1] = values.at(2).toDouble();
-                    p->number[2] = values.at(3).toDouble();
-                    p->number[3] = values.at(4).toDouble();
-                    p->number[4] = values.at(5).toDouble();
-                    p->number[5] = values.at(6).toDouble();
-                    vo2Series->datapoints.append(p);
+                    XDataPoint p;
+                    p.secs = values.at(0).toDouble();
+                    p.km = 0;
+                    p.number[0] = values.at(1).toDouble();
+                    p.number[1] = values.at(2).toDouble();
+                    p.number[2] = values.at(3).toDouble();
+                    p.number[3] = values.at(4).toDouble();
+                    p.number[4] = values.at(5).toDouble();
+                    p.number[5] = values.at(6).toDouble();
+                    vo2Series->append(p);
                 }
 
                 // onto next line
@@ -1450,10 +1463,11 @@ RideFile *CsvFileReader::openRideFile(QFile &file, QStringList &errors, QList<Ri
         vo2file.close();
 
         // add if we got any ....
-        if (vo2Series->datapoints.count() > 0)
+        if (vo2Series->count() > 0)
         {
             rideFile->addXData("VO2", vo2Series);
         }
+        else delete vo2Series;
     }
 
 
@@ -1461,8 +1475,8 @@ RideFile *CsvFileReader::openRideFile(QFile &file, QStringList &errors, QList<Ri
     //
     // typically only for GC csv, but lets not constrain that
     // so long as the filename matches we'll import it into XDATA
-    QFile rrfile(file.fileName().replace(".csv",".rr"));
-    if (!rrfile.open(QFile::ReadOnly)) return rideFile;
+    QFile rrfile(rrfilename);
+    if (!rrfile.open(QFile::ReadOnly)) return;
 
     // create the XDATA series
     rrSeries = new XDataSeries();
@@ -1501,12 +1515,12 @@ RideFile *CsvFileReader::openRideFile(QFile &file, QStringList &errors, QList<Ri
                 QStringList values = line.split(",", Qt::KeepEmptyParts);
 
                 // and add
-                XDataPoint *p = new XDataPoint();
-                p->secs = values.at(0).toDouble();
-                p->km = 0;
-                p->number[0] = values.at(2).toDouble();
+                XDataPoint p;
+                p.secs = values.at(0).toDouble();
+                p.km = 0;
+                p.number[0] = values.at(2).toDouble();
 
-                rrSeries->datapoints.append(p);
+                rrSeries->append(p);
             }
 
             // onto next line
@@ -1517,10 +1531,8 @@ RideFile *CsvFileReader::openRideFile(QFile &file, QStringList &errors, QList<Ri
     rrfile.close();
 
     // add if we got any ....
-    if (rrSeries->datapoints.count() > 0) rideFile->addXData("HRV", rrSeries);
-
-    // all done
-    return rideFile;
+    if (rrSeries->count() > 0) rideFile->addXData("HRV", rrSeries);
+    else delete rrSeries;
 }
 
 bool
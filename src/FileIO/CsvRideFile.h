@@ -35,6 +35,9 @@ struct CsvFileReader : public RideFileReader {
     // write but able to select format
     bool writeRideFile(Context *context, const RideFile *ride, QFile &file, CsvType format) const;
     bool hasWrite() const { return true; }
+
+    // vo2 and r-r data recorded alongside a train session
+    static void readCompanionXData(RideFile *ride, QString vo2filename, QString rrfilename);
 };
 
 #endif // _CsvRideFile_h
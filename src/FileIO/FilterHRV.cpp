@@ -24,100 +24,34 @@
 #include "MeasuresDownload.h"
 #include "Measures.h"
 #include "Athlete.h"
+#include "HrvSeries.h"
 
 void FilterHrv(XDataSeries *rr, double rr_min, double rr_max, double filt, int hwin)
 {
-    int n = rr->datapoints.count();
-    int win = 0;
-    int idx_lead = hwin;
-    int idx_lag = -hwin;
-
-    double average, filtlim;
-    double sum = 0.0;
-
     if (rr->valuename.length()==1)
         {
             rr->valuename << "R-R flag";
             rr->unitname << "bool";
         }
 
-    // Flag R-R values which are outside min/max with -1. The values
-    // flagged with -1 are *NOT* included when calculating the window
-    // average. This deviates from the filtering methodology used
-    // by https://physionet.org/tutorials/hrv-toolkit/ where all are
-    // included.
-    for (int idx=0; idx < n; idx++)
-        {
-            if (rr_min < rr->datapoints[idx]->number[0] &&
-                rr_max > rr->datapoints[idx]->number[0])
-                {
-                    rr->datapoints[idx]->number[1] = 1;
-                }
-            else
-                {
-                    rr->datapoints[idx]->number[1] = -1;
-                }
-        }
+    // filter on contiguous arrays, see HrvSeries.h
+    HrvSeries series(rr);
+    series.filter(rr_min, rr_max, filt, hwin);
+    series.writeFlags(rr);
+}
 
-    if (n>2*hwin)
-        {
-            // Initialize R-R sum for the value in the window around
-            // current value.
-            for (int idx=0; idx < hwin; idx++)
-                {
-                    if (rr->datapoints[idx]->number[1] == 1)
-                        {
-                            sum += rr->datapoints[idx]->number[0];
-                            win++;
-                        }
-                }
-            win--;
-
-            for (int idx=0; idx < n; idx++)
-                {
-
-                    // Append new values to the window
-                    if (idx_lead < n && rr->datapoints[idx_lead]->number[1] == 1)
-                        {
-                            sum += rr->datapoints[idx_lead]->number[0];
-                            win++;
-                        }
-                    // Remove trailing values from the window
-                    if (idx_lag >= 0 && rr->datapoints[idx_lag]->number[1] >= 0)
-                        {
-                            sum -= rr->datapoints[idx_lag]->number[0];
-                            win--;
-                        }
-
-                    // Flag values which are outside +- (filt * 100) percent
-                    // of the average value in a window around current value
-                    // with 0.
-                    if (rr->datapoints[idx]->number[1] == 1)
-                        {
-                            // Don't include current when calculating average.
-                            sum -= rr->datapoints[idx]->number[0];
-
-                            average = sum / win;
-                            filtlim = filt * average;
-
-                            if (rr->datapoints[idx]->number[0] <= average + filtlim &&
-                                rr->datapoints[idx]->number[0] >= average - filtlim)
-                                {
-                                    rr->datapoints[idx]->number[1] = 1;
-                                }
-                            else
-                                {
-                                    rr->datapoints[idx]->number[1] = 0;
-                                }
-
-                            // Add current value to the window
-                            sum += rr->datapoints[idx]->number[0];
-                        }
-
-                    idx_lead++;
-                    idx_lag++;
-                }
-        }
+void FilterHrv(RideFile *ride, double rr_min, double rr_max, double filt, int hwin)
+{
+    XDataSeries *rr = ride->xdata("HRV");
+    if (rr == NULL || rr->count() == 0) return;
+
+    FilterHrv(rr, rr_min, rr_max, filt, hwin);
+
+    // sliding window metrics for the charts, replacing any earlier ones
+    XDataSeries *windows = HrvSeries(rr).windows();
+    delete ride->xdata(HRV_WINDOWS);
+    ride->xdata().remove(HRV_WINDOWS);
+    if (windows) ride->addXData(HRV_WINDOWS, windows);
 }
 
 class FilterHrvOutliers;
@@ -255,7 +189,7 @@ FilterHrvOutliers::postProcess(RideFile *ride, DataProcessorConfig *config=0, QS
     Q_UNUSED(op)
 
     XDataSeries *series = ride->xdata("HRV");
-    if (series && series->datapoints.count() > 0) {
+    if (series && series->count() > 0) {
 
         // Read settings
         double rrMax;
@@ -278,7 +212,7 @@ FilterHrvOutliers::postProcess(RideFile *ride, DataProcessorConfig *config=0, QS
             rrWindow = (int) ((FilterHrvOutliersConfig*)(config))->hrvWindow->value();
             setRestHrv = (bool) ((FilterHrvOutliersConfig*)(config))->setRestHrv->checkState();
         }
-        FilterHrv(series, rrMin, rrMax, rrFilt, rrWindow);
+        FilterHrv(ride, rrMin, rrMax, rrFilt, rrWindow);
 
         // refresh if present in RideCache
         RideItem *rideItem = nullptr;
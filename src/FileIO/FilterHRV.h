@@ -23,4 +23,8 @@
 
 void FilterHrv(XDataSeries *rr, double rr_min, double rr_max, double filt, int hwin);
 
+// filter the ride's HRV xdata and regenerate the "HRV Windows" from the
+// new flags, so they are never out of step with each other
+void FilterHrv(RideFile *ride, double rr_min, double rr_max, double filt, int hwin);
+
 #endif // _FilterHRV_h
@@ -1621,32 +1621,32 @@ struct FitFileParser
     void appendXData(RideFile *rf) {
         if (rf == nullptr) { return; }
 
-        if (!weatherXdata->datapoints.empty())
+        if (!weatherXdata->isEmpty())
             rf->addXData("WEATHER", weatherXdata);
         else
             delete weatherXdata;
 
-        if (!swimXdata->datapoints.empty())
+        if (!swimXdata->isEmpty())
             rf->addXData("SWIM", swimXdata);
         else
             delete swimXdata;
 
-        if (!hrvXdata->datapoints.empty())
+        if (!hrvXdata->isEmpty())
             rf->addXData("HRV", hrvXdata);
         else
             delete hrvXdata;
 
-        if (!gearsXdata->datapoints.empty())
+        if (!gearsXdata->isEmpty())
             rf->addXData("GEARS", gearsXdata);
         else
             delete gearsXdata;
 
-        if (!deveXdata->datapoints.empty())
+        if (!deveXdata->isEmpty())
             rf->addXData("DEVELOPER", deveXdata);
         else
             delete deveXdata;
 
-        if (!extraXdata->datapoints.empty())
+        if (!extraXdata->isEmpty())
             rf->addXData("EXTRA", extraXdata);
         else
             delete extraXdata;
@@ -1748,17 +1748,18 @@ struct FitFileParser
             const auto file_xdata = rideFile->xdata();
             for (auto it = file_xdata.begin(); it != file_xdata.end(); ++it) {
                 XDataSeries *s = new XDataSeries(*(it.value()));
-                s->datapoints.erase(std::remove_if(s->datapoints.begin(), s->datapoints.end(), [start_time, start, stop](XDataPoint *xdp){
-                    return xdp && (xdp->secs >= (stop - start_time) || xdp->secs < (start - start_time));
-                }), s->datapoints.end());
+                QVector<int> rows;
+                for (int i=0; i<s->count(); i++) {
+                    if (s->secs(i) < (stop - start_time) && s->secs(i) >= (start - start_time)) rows << i;
+                }
+                s->select(rows);
                 // adjust their timing
-                if (!s->datapoints.empty()) {
-                    auto first_time = s->datapoints.first()->secs;
-                    foreach (XDataPoint *p, s->datapoints) {
-                        p->secs -= first_time;
-                    }
+                if (!s->isEmpty()) {
+                    s->offset(-s->secs(0), 0);
                     // and append
                     rf->addXData(it.key(), s);
+                } else {
+                    delete s;
                 }
             }
 
@@ -1847,7 +1848,7 @@ struct FitFileParser
         // with values appended as we go through the data below
         // and ultimately the secs value is derived at the end
         // before being added to the XDATA
-        XDataPoint *add= new XDataPoint();
+        XDataPoint add;
 
         foreach(const FitField &field, def.fields) {
 
@@ -1919,7 +1920,7 @@ struct FitFileParser
                     xdseries->valuetype.append(RideFile::SeriesType::none); // makes no sense, if it was a series type it wouldn't be xdata
                     seriesindex=xdseries->valuename.indexOf(metadata.name.c_str());
                 }
-                add->number[seriesindex] = scaledvalue;
+                add.number[seriesindex] = scaledvalue;
                 count++;
             }
 
@@ -1946,9 +1947,9 @@ genericnext:
         // update the xdata series with the timestamp and add for our record
         // if we managed to extract any data from the file successfully
         if (count > 0) {
-            add->secs = (float)(time.toUTC().toMSecsSinceEpoch() -  start.toUTC().toMSecsSinceEpoch()) / 1000.00;
-            add->km = 0;
-            xdseries->datapoints.append(add);
+            add.secs = (float)(time.toUTC().toMSecsSinceEpoch() -  start.toUTC().toMSecsSinceEpoch()) / 1000.00;
+            add.km = 0;
+            xdseries->append(add);
         }
     }
 
@@ -2449,17 +2450,17 @@ genericnext:
             case 43: /* rear_gear_change */
                 {
                     int secs = (start_time==0?0:time-start_time);
-                    XDataPoint *p = new XDataPoint();
+                    XDataPoint p;
 
                     switch (event_type) {
                         case 3:
-                            p->secs = secs;
-                            p->km = last_distance;
-                            p->number[0] = ((data32 >> 24) & 255);
-                            p->number[1] = ((data32 >> 8) & 255);
-                            p->number[2] = ((data32 >> 16) & 255);
-                            p->number[3] = (data32 & 255);
-                            gearsXdata->datapoints.append(p);
+                            p.secs = secs;
+                            p.km = last_distance;
+                            p.number[0] = ((data32 >> 24) & 255);
+                            p.number[1] = ((data32 >> 8) & 255);
+                            p.number[2] = ((data32 >> 16) & 255);
+                            p.number[3] = (data32 & 255);
+                            gearsXdata->append(p);
                             break;
                         default:
                             errors << QString("Unknown gear change event %1 type %2 data %3").arg(event).arg(event_type).arg(data32);
@@ -2511,10 +2512,10 @@ genericnext:
         int rrvalue;
         int i=0;
         double hrv_time=0.0;
-        int n=hrvXdata->datapoints.count();
+        int n=hrvXdata->count();
 
         if (n>0)
-            hrv_time = hrvXdata->datapoints[n-1]->secs;
+            hrv_time = hrvXdata->secs(n-1);
 
         foreach(const FitField &field, def.fields) {
             FitValue value = values[i++];
@@ -2527,20 +2528,20 @@ genericnext:
                     if (rrvalue == -1){
                         break;
                     }
-                    XDataPoint *p = new XDataPoint();
-                    p->secs = hrv_time;
-                    p->number[0] = rrvalue;
-                    hrvXdata->datapoints.append(p);
+                    XDataPoint p;
+                    p.secs = hrv_time;
+                    p.number[0] = rrvalue;
+                    hrvXdata->append(p);
                 }
             } else if (value.type == SingleValue)
             {
                 rrvalue = int(value.v);
                 hrv_time += rrvalue/1000.0;
 
-                XDataPoint *p = new XDataPoint();
-                p->secs = hrv_time;
-                p->number[0] = rrvalue;
-                hrvXdata->datapoints.append(p);
+                XDataPoint p;
+                p.secs = hrv_time;
+                p.number[0] = rrvalue;
+                hrvXdata->append(p);
             }
         }
     }
@@ -2651,13 +2652,13 @@ genericnext:
             double secs = time - start_time;
             if ((total_distance == 0.0) && (secs > last_length + 1)) {
 
-                XDataPoint *p = new XDataPoint();
-                p->secs = secs;
-                p->km = last_distance;
-                p->number[0] = 0;
-                p->number[1] = secs-last_length;
-                p->number[2] = 0;
-                swimXdata->datapoints.append(p);
+                XDataPoint p;
+                p.secs = secs;
+                p.km = last_distance;
+                p.number[0] = 0;
+                p.number[1] = secs-last_length;
+                p.number[2] = 0;
+                swimXdata->append(p);
 
                 last_length = secs;
             }
@@ -3221,11 +3222,13 @@ genericnext:
 
         if (p_deve != NULL) {
             p_deve->secs = secs;
-            deveXdata->datapoints.append(p_deve);
+            deveXdata->append(*p_deve);
+            delete p_deve;
         }
         if (p_extra != NULL) {
             p_extra->secs = secs;
-            extraXdata->datapoints.append(p_extra);
+            extraXdata->append(*p_extra);
+            delete p_extra;
         }
     }
 
@@ -3300,14 +3303,14 @@ genericnext:
         }
 
         if (length_duration > 0) {
-            XDataPoint *p = new XDataPoint();
-            p->secs = last_length;
-            p->km = last_distance;
-            p->number[0] = length_type + swim_stroke;
-            p->number[1] = length_duration;
-            p->number[2] = total_strokes;
-
-            swimXdata->datapoints.append(p);
+            XDataPoint p;
+            p.secs = last_length;
+            p.km = last_distance;
+            p.number[0] = length_type + swim_stroke;
+            p.number[1] = length_duration;
+            p.number[2] = total_strokes;
+
+            swimXdata->append(p);
         }
 
         if (last_length == 0) {
@@ -3373,15 +3376,15 @@ genericnext:
         }
 
         double secs = time - start_time;
-        XDataPoint *p = new XDataPoint();
-        p->secs = secs;
-        p->km = last_distance;
-        p->number[0] = windSpeed;
-        p->number[1] = windHeading;
-        p->number[2] = temp;
-        p->number[3] = humidity;
-
-        weatherXdata->datapoints.append(p);
+        XDataPoint p;
+        p.secs = secs;
+        p.km = last_distance;
+        p.number[0] = windSpeed;
+        p.number[1] = windHeading;
+        p.number[2] = temp;
+        p.number[3] = humidity;
+
+        weatherXdata->append(p);
     }
 
     void decodeHr(const FitMessage &def, int time_offset,
@@ -3466,10 +3469,10 @@ genericnext:
             for (int i=1;i<timestamps.count(); i++) {
                 double secs = timestamps.at(i) + start_timestamp - start_time;
                 if (secs>=0 && rr.at(i)!=0) {
-                    XDataPoint *p = new XDataPoint();
-                    p->secs = secs;
-                    p->number[0] = rr.at(i);
-                    hrvXdata->datapoints.append(p);
+                    XDataPoint p;
+                    p.secs = secs;
+                    p.number[0] = rr.at(i);
+                    hrvXdata->append(p);
                 }
             }
         }
@@ -131,14 +131,14 @@ FixDeriveHeadwind::postProcess(RideFile *ride, DataProcessorConfig *config=0, QS
         RideFilePoint *point = ride->dataPoints()[i];
         RideFilePoint *prevPoint = ride->dataPoints()[i-1];
 
-        for (int j=b; j<series->datapoints.count(); j++) {
-           if (series->datapoints.at(j)->secs>point->secs)
+        for (int j=b; j<series->count(); j++) {
+           if (series->secs(j)>point->secs)
                break;
            b=j;
            // Wind speed (mm/s)
-           windspeed = series->datapoints.at(j)->number[winspeedIdx];
+           windspeed = series->value(j, winspeedIdx);
            // Wind heading (0deg=North)
-           windheading = series->datapoints.at(j)->number[windheadingIdx];
+           windheading = series->value(j, windheadingIdx);
         }
 
         // ensure a movement occurred and valid lat/lon in order to compute cyclist direction
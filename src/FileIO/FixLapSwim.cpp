@@ -135,7 +135,7 @@ FixLapSwim::postProcess(RideFile *ride, DataProcessorConfig *config=0, QString o
 
     // get SWIM XData indices and check for SWIM XData
     XDataSeries *series = ride->xdata("SWIM");
-    if (!series || series->datapoints.isEmpty()) return false;
+    if (!series || series->isEmpty()) return false;
 
     int typeIdx = -1, durationIdx = -1, strokesIdx = -1, restIdx = -1;
     for (int a=0; a<series->valuename.count(); a++) {
@@ -171,26 +171,29 @@ FixLapSwim::postProcess(RideFile *ride, DataProcessorConfig *config=0, QString o
     int interval = 1;
     double kph, cad;
 
-    for (int i=0; i< series->datapoints.count(); i++) {
+    for (int i=0; i< series->count(); i++) {
 
         // update accumulated time and distance for each length
         ride->command->setXDataPointValue("SWIM", i, 0, last_time);
         ride->command->setXDataPointValue("SWIM", i, 1, last_distance);
 
         // use length data to recreate sample records and lap markers
-        XDataPoint *p = series->datapoints.at(i);
+        double type = series->value(i, typeIdx);
+        double duration = series->value(i, durationIdx);
+        double strokes = series->value(i, strokesIdx);
+        double rest = series->value(i, restIdx);
 
         // another pool length or pause
-        double length_distance = (p->number[typeIdx] ? pl / 1000.0 : 0.0);
+        double length_distance = (type ? pl / 1000.0 : 0.0);
 
         // Adjust truncated length duration using fractional carry
-        double length_duration = p->number[durationIdx] + frac_time;
+        double length_duration = duration + frac_time;
         frac_time = modf(length_duration, &length_duration);
 
         // Cadence from Strokes and Duration, if Strokes available
-        if (p->number[typeIdx] > 0.0 && p->number[durationIdx] > 0.0) {
+        if (type > 0.0 && duration > 0.0) {
             cad = (strokesIdx == -1) ? 0.0 :
-                  60.0 * p->number[strokesIdx] / p->number[durationIdx];
+                  60.0 * strokes / duration;
         } else { // pause length
             cad = 0.0;
         }
@@ -200,7 +203,7 @@ FixLapSwim::postProcess(RideFile *ride, DataProcessorConfig *config=0, QString o
        // or corrupt files
        if (length_duration > 0 && length_duration < 100*GarminHWM.toInt()) {
            QVector<struct RideFilePoint> newRows;
-           kph = 3600.0 * length_distance / p->number[durationIdx];
+           kph = 3600.0 * length_distance / duration;
            double deltaDist = length_duration > 1 ? length_distance / (length_duration - 1) : 0.0;
            if (length_distance == 0.0) interval++; // pauses mark laps
            for (int i = 0; i < length_duration; i++) {
@@ -220,10 +223,10 @@ FixLapSwim::postProcess(RideFile *ride, DataProcessorConfig *config=0, QString o
             if (length_distance == 0.0) interval++; // pauses mark laps
        }
        // Alternative way to mark pauses: Rest seconds after each length
-       if (restIdx>0 && p->number[restIdx]>0) {
+       if (restIdx>0 && rest>0) {
            QVector<struct RideFilePoint> newRows;
            interval++; // pauses mark laps
-           for (int i=0; i<p->number[restIdx] && i<100*GarminHWM.toInt(); i++) {
+           for (int i=0; i<rest && i<100*GarminHWM.toInt(); i++) {
                // recover previous data or create a new sample point,
                // and fix time/speed/distance/cadence/interval
                RideFilePoint pt = ptHash.value(last_time + i);
@@ -235,7 +238,7 @@ FixLapSwim::postProcess(RideFile *ride, DataProcessorConfig *config=0, QString o
                newRows << pt;
            }
            ride->command->appendPoints(newRows);
-           last_time += p->number[restIdx];
+           last_time += rest;
            interval++; // pauses mark laps
        }
 
@@ -252,6 +255,7 @@ FixLapSwim::postProcess(RideFile *ride, DataProcessorConfig *config=0, QString o
         // rebuild intervals and force metric update
         ride->fillInIntervals();
         ride->context->rideItem()->isstale = true;
+        ride->context->rideItem()->staleconfig = 0;
         ride->context->rideItem()->refresh();
     }
 
@@ -0,0 +1,264 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "HrvSeries.h"
+
+#include <cmath>
+#include <limits>
+
+HrvSeries::HrvSeries(const XDataSeries *series) : computed(false)
+{
+    if (series == NULL) return;
+
+    // R-R is the first value, the flag the second once filtered,
+    // the columns are shared with the series until we change them
+    secs = series->secsColumn();
+    rr = series->column(0);
+    flag = series->column(1);
+}
+
+void
+HrvSeries::writeFlags(XDataSeries *series) const
+{
+    series->setColumn(1, flag);
+}
+
+// Values outside min/max are flagged -1 and are *NOT* included when
+// calculating the window average. This deviates from the filtering
+// methodology used by https://physionet.org/tutorials/hrv-toolkit/
+// where all are included.
+void
+HrvSeries::filter(double rrmin, double rrmax, double filt, int hwin)
+{
+    const int n = rr.count();
+    const double *r = rr.constData();
+    double *f = flag.data();
+
+    for (int i=0; i<n; i++) f[i] = (rrmin < r[i] && rrmax > r[i]) ? 1 : -1;
+    computed = false;
+
+    if (n <= 2*hwin) return;
+
+    // R-R sum for the values in the window around the current value
+    double sum = 0;
+    int win = 0;
+    for (int i=0; i<hwin; i++) {
+        if (f[i] == 1) {
+            sum += r[i];
+            win++;
+        }
+    }
+    win--;
+
+    for (int i=0, lead=hwin, lag=-hwin; i<n; i++, lead++, lag++) {
+
+        // slide the window
+        if (lead < n && f[lead] == 1) {
+            sum += r[lead];
+            win++;
+        }
+        if (lag >= 0 && f[lag] >= 0) {
+            sum -= r[lag];
+            win--;
+        }
+
+        // flag values outside +- (filt * 100) percent of the average
+        // of the others in the window with 0
+        if (f[i] == 1) {
+            sum -= r[i];
+            double average = sum / win;
+            double filtlim = filt * average;
+            f[i] = (r[i] <= average + filtlim && r[i] >= average - filtlim) ? 1 : 0;
+            sum += r[i];
+        }
+    }
+}
+
+const HrvSeries::Stats &
+HrvSeries::stats() const
+{
+    if (computed) return stats_;
+
+    Stats &s = stats_;
+    s.beats = rr.count();
+    s.nn = s.diffs = s.segments = 0;
+    s.nnsum = s.nnsum2 = s.diffsum2 = 0;
+    s.sdann = s.sdnnidx = s.segmean = 0;
+    for (int k=0; k<HRV_PNN_COUNT; k++) s.pnn[k] = 0;
+
+    // per segment, and across the segments for SDANN and SDNNIDX
+    double tlim = HRV_SEGMENT;
+    double segsum = 0, segsum2 = 0;
+    int segn = 0;
+    double meansum = 0, meansum2 = 0, sdtotal = 0;
+
+    const double *r = rr.constData();
+    for (int i=0; i<s.beats; i++) {
+
+        if (secs[i] >= tlim) {
+            tlim += HRV_SEGMENT;
+            if (segn > 0) {
+                double mean = segsum / segn;
+                meansum += mean;
+                meansum2 += mean * mean;
+                sdtotal += sqrt((segsum2 - segsum*segsum/segn)/(segn-1));
+                s.segments++;
+                segsum = segsum2 = 0;
+                segn = 0;
+            }
+        }
+
+        if (isNN(i)) {
+            s.nn++;
+            s.nnsum += r[i];
+            s.nnsum2 += r[i] * r[i];
+            segsum += r[i];
+            segsum2 += r[i] * r[i];
+            segn++;
+        }
+
+        if (isDiff(i)) {
+            double d = r[i] - r[i-1];
+            s.diffs++;
+            s.diffsum2 += d * d;
+            for (int k=0; k<HRV_PNN_COUNT; k++) s.pnn[k] += fabs(d) > k * HRV_PNN_STEP;
+        }
+    }
+
+    if (segn > 0) {
+        double mean = segsum / segn;
+        meansum += mean;
+        meansum2 += mean * mean;
+        sdtotal += sqrt((segsum2 - segsum*segsum/segn)/(segn-1));
+        s.segments++;
+    }
+
+    if (s.segments > 0) s.segmean = meansum / s.segments;
+    if (s.segments > 1) s.sdann = sqrt((meansum2 - meansum*(meansum/s.segments))/(s.segments - 1));
+    s.sdnnidx = s.segments > 0 ? sdtotal / s.segments : sdtotal;
+
+    computed = true;
+    return stats_;
+}
+
+XDataSeries *
+HrvSeries::windows(double window, double step) const
+{
+    const int n = rr.count();
+    if (n < 3 || window <= 0 || step <= 0) return NULL;
+
+    XDataSeries *returning = new XDataSeries;
+    returning->name = HRV_WINDOWS;
+    returning->valuename << "AVNN" << "SDNN" << "rMSSD" << "pNN50" << "DFA a1";
+    returning->unitname << "msec" << "msec" << "msec" << "pct" << "";
+    for (int i=0; i<returning->valuename.count(); i++) returning->valuetype << RideFile::none;
+
+    // running sums over the beats in the window, [tail, head)
+    int head = 0, tail = 0;
+    int nn = 0, diffs = 0, nn50 = 0;
+    double nnsum = 0, nnsum2 = 0, diffsum2 = 0;
+
+    const double *r = rr.constData();
+    QVector<double> values, scratch;
+    XDataPoint add;
+
+    for (double end = secs[0] + window;; end += step) {
+
+        for (; head < n && secs[head] <= end; head++) {
+            if (isNN(head)) { nn++; nnsum += r[head]; nnsum2 += r[head] * r[head]; }
+            if (isDiff(head)) { double d = r[head] - r[head-1]; diffs++; diffsum2 += d * d; nn50 += fabs(d) > 50; }
+        }
+        for (; tail < head && secs[tail] <= end - window; tail++) {
+            if (isNN(tail)) { nn--; nnsum -= r[tail]; nnsum2 -= r[tail] * r[tail]; }
+            if (isDiff(tail)) { double d = r[tail] - r[tail-1]; diffs--; diffsum2 -= d * d; nn50 -= fabs(d) > 50; }
+        }
+
+        // gaps in the recording don't get a point
+        if (nn > 1) {
+
+            values.resize(0);
+            for (int i=tail; i<head; i++) if (isNN(i)) values << r[i];
+
+            add.secs = end;
+            add.number[0] = nnsum / nn;
+            add.number[1] = sqrt(qMax(0.0, (nnsum2 - nnsum*(nnsum/nn))/(nn - 1)));
+            add.number[2] = diffs > 1 ? sqrt(qMax(0.0, diffsum2/diffs)) : 0;
+            add.number[3] = diffs > 0 ? 100.0 * nn50 / diffs : 0;
+            add.number[4] = dfaAlpha1(values.constData(), values.count(), scratch);
+            returning->append(add);
+        }
+
+        if (head >= n) break;
+    }
+    return returning;
+}
+
+double
+HrvSeries::dfaAlpha1(const double *nn, int n, QVector<double> &scratch)
+{
+    const int minbox = 4, maxbox = 16;
+    if (n < 2 * maxbox) return 0;
+
+    double mean = 0;
+    for (int i=0; i<n; i++) mean += nn[i];
+    mean /= n;
+
+    // prefix sums of the integrated series y, y^2 and k.y so the
+    // linear trend of any box is removed without visiting it again
+    scratch.resize(3 * (n+1));
+    double *py = scratch.data(), *pyy = py + (n+1), *pky = pyy + (n+1);
+    double y = 0;
+    py[0] = pyy[0] = pky[0] = 0;
+    for (int k=0; k<n; k++) {
+        y += nn[k] - mean;
+        py[k+1] = py[k] + y;
+        pyy[k+1] = pyy[k] + y * y;
+        pky[k+1] = pky[k] + k * y;
+    }
+
+    // log F(box) against log box, alpha1 is the slope
+    double sx = 0, sy = 0, sxx = 0, sxy = 0;
+    int points = 0;
+
+    for (int box=minbox; box<=maxbox; box++) {
+
+        int boxes = n / box;
+        double st = box * (box - 1) / 2.0;
+        double dtt = (box - 1) * box * (2.0 * box - 1) / 6.0 - st * st / box;
+
+        double ss = 0;
+        for (int b=0; b<boxes; b++) {
+            int start = b * box, stop = start + box;
+            double sumy = py[stop] - py[start];
+            double sumyy = pyy[stop] - pyy[start];
+            double sumty = (pky[stop] - pky[start]) - start * sumy;
+            double dty = sumty - st * sumy / box;
+            ss += (sumyy - sumy * sumy / box) - dty * dty / dtt;
+        }
+
+        double F = sqrt(qMax(0.0, ss) / (boxes * box));
+        if (F <= 0) continue;
+
+        double lx = log(double(box)), ly = log(F);
+        sx += lx; sy += ly; sxx += lx * lx; sxy += lx * ly;
+        points++;
+    }
+
+    double denominator = points * sxx - sx * sx;
+    return points > 1 && denominator > 0 ? (points * sxy - sx * sy) / denominator : 0;
+}
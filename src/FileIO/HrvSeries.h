@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef _GC_HrvSeries_h
+#define _GC_HrvSeries_h 1
+
+#include "RideFile.h"
+
+#include <QVector>
+
+//
+// R-R intervals from the HRV xdata series as plain arrays, they share
+// the xdata columns until changed and overnight recordings can hold
+// hundreds of thousands of beats.
+//
+// The outlier filter (see FilterHRV.cpp) works on the arrays and the
+// flags are written back to the xdata. The HRV metrics share one pass
+// over the arrays for the whole activity, and windows() computes them
+// over a window sliding along the recording, along with DFA alpha1,
+// as a derived xdata series for the charts.
+//
+// A beat is NN when it and the one before it are flagged normal, the
+// successive differences used for rMSSD and pNNx need three in a row.
+//
+#define HRV_PNN_STEP 5       // pNNx thresholds, msecs
+#define HRV_PNN_COUNT 11     // 0 to 50
+#define HRV_SEGMENT 300.0    // secs, for SDANN and SDNNIDX
+#define HRV_WINDOW 120.0     // secs, the sliding window
+#define HRV_WINDOW_STEP 5.0  // secs, between windows
+#define HRV_WINDOWS "HRV Windows"
+
+class HrvSeries
+{
+    public:
+        struct Stats {
+            int beats, nn, diffs;
+            double nnsum, nnsum2, diffsum2;
+            int pnn[HRV_PNN_COUNT]; // successive differences > i * HRV_PNN_STEP
+            double sdann, sdnnidx, segmean; // segmean is the mean of the segment averages
+            int segments;
+        };
+
+        HrvSeries(const XDataSeries *series);
+
+        int count() const { return rr.count(); }
+
+        // flag outliers, -1 outside min/max, 0 outside filt of the window average
+        void filter(double rrmin, double rrmax, double filt, int hwin);
+        void writeFlags(XDataSeries *series) const;
+
+        // whole activity, computed on first use
+        const Stats &stats() const;
+
+        // sliding window metrics, NULL if there are too few beats
+        XDataSeries *windows(double window=HRV_WINDOW, double step=HRV_WINDOW_STEP) const;
+
+        // detrended fluctuation analysis, box sizes 4 to 16 beats
+        static double dfaAlpha1(const double *nn, int n, QVector<double> &scratch);
+
+        QVector<double> secs, rr;
+        QVector<double> flag; // as in the xdata, 1 normal, 0 or -1 outlier
+
+    private:
+        bool isNN(int i) const { return i > 0 && flag[i] > 0 && flag[i-1] > 0; }
+        bool isDiff(int i) const { return i > 1 && flag[i] > 0 && flag[i-1] > 0 && flag[i-2] > 0; }
+
+        mutable bool computed;
+        mutable Stats stats_;
+};
+
+#endif // _GC_HrvSeries_h
@@ -287,7 +287,7 @@ xdata_item: NAME ':' string                     { jc->xdataseries.name = $3; }
 xdata_samples: xdata_sample
          | xdata_samples ',' xdata_sample
          ;
-xdata_sample: '{' xdata_value_list '}'          { jc->xdataseries.datapoints.append(new XDataPoint(jc->xdatapoint));
+xdata_sample: '{' xdata_value_list '}'          { jc->xdataseries.append(jc->xdatapoint);
                                                   jc->xdatapoint = XDataPoint();
                                                 }
           ;
@@ -734,33 +734,33 @@ JsonFileReader::toByteArray(Context *, const RideFile *ride, bool withAlt, bool
             }
 
             // samples
-            if (series->datapoints.count()) {
+            if (series->count()) {
                 out += ",\n\t\t\t\"SAMPLES\" : [\n";
 
                 bool firsts=true;
-                foreach(XDataPoint *p, series->datapoints) {
+                for(int row=0; row<series->count(); row++) {
                     if (!firsts) out += ",\n";
 
                     // multi value sample
                     if (series->valuename.count()>1) {
 
-                        out += "\t\t\t\t{ \"SECS\":"+QString("%1").arg(p->secs) +", "
-                            + "\"KM\":"+QString("%1").arg(p->km) + ", "
+                        out += "\t\t\t\t{ \"SECS\":"+QString("%1").arg(series->secs(row)) +", "
+                            + "\"KM\":"+QString("%1").arg(series->km(row)) + ", "
                             + "\"VALUES\":[ ";
 
                         bool firstvv=true;
                         for(int i=0; i<series->valuename.count(); i++) {
                             if (!firstvv) out += ", ";
-                            out += QString("%1").arg(p->number[i]);
+                            out += QString("%1").arg(series->value(row, i));
                             firstvv=false;
                          }
                          out += " ] }";
 
                     } else {
 
-                        out += "\t\t\t\t{ \"SECS\":"+QString("%1").arg(p->secs) + ", "
-                            + "\"KM\":"+QString("%1").arg(p->km) + ", "
-                            + "\"VALUE\":" + QString("%1").arg(p->number[0]) + " }";
+                        out += "\t\t\t\t{ \"SECS\":"+QString("%1").arg(series->secs(row)) + ", "
+                            + "\"KM\":"+QString("%1").arg(series->km(row)) + ", "
+                            + "\"VALUE\":" + QString("%1").arg(series->value(row, 0)) + " }";
                     }
                     firsts = false;
                 }
@@ -428,11 +428,11 @@ void HrmRideFile(RideFile *rideFile, RideFile*gpxresult, bool haveGPX, XDataSeri
 	}
 
 	if (recInterval==238){
-	  XDataPoint *p_hrv = new XDataPoint();
+	  XDataPoint p_hrv;
 	  hrv_time += hrm/1000.0;
-	  p_hrv->secs = hrv_time;
-	  p_hrv->number[0] = hrm;
-	  hrvXdata->datapoints.append(p_hrv);
+	  p_hrv.secs = hrv_time;
+	  p_hrv.number[0] = hrm;
+	  hrvXdata->append(p_hrv);
 	  hr = 60000.0/hrm;
 	} else {
 	  hr = hrm;
@@ -664,7 +664,7 @@ RideFile *PolarFileReader::openRideFile(QFile &file, QStringList &errors, QList<
       return NULL;
     }
 
-  if (hrvXdata->datapoints.count()>0)
+  if (hrvXdata->count()>0)
     {
       rideFile->addXData("HRV", hrvXdata);
     }
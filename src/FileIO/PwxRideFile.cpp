@@ -339,13 +339,13 @@ PwxFileReader::PwxFromDomDoc(QDomDocument doc, QStringList&) const
                 }
                 // length-by-length Swim XData
                 if (lapSwim == true) {
-                    XDataPoint *p = new XDataPoint();
-                    p->secs = rtime;
-                    p->km = rdist;
-                    p->number[0] = (add.km > rdist) ? 1 : 0;
-                    p->number[1] = deltaSecs;
-                    p->number[2] = round(add.cad * deltaSecs / 60.0);
-                    swimXdata->datapoints.append(p);
+                    XDataPoint p;
+                    p.secs = rtime;
+                    p.km = rdist;
+                    p.number[0] = (add.km > rdist) ? 1 : 0;
+                    p.number[1] = deltaSecs;
+                    p.number[2] = round(add.cad * deltaSecs / 60.0);
+                    swimXdata->append(p);
                 }
 
                 // only smooth the maximal smart recording gap defined in
@@ -589,7 +589,7 @@ PwxFileReader::PwxFromDomDoc(QDomDocument doc, QStringList&) const
     }
 
     // Add length-by-length Swim XData, if present
-    if (swimXdata->datapoints.count()>0)
+    if (swimXdata->count()>0)
         rideFile->addXData("SWIM", swimXdata);
     else
         delete swimXdata;
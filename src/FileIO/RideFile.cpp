@@ -29,6 +29,7 @@
 #include "Colors.h"
 #include "Units.h"
 #include "SplineLookup.h"
+#include "Profiler.h"
 
 #include <QtXml/QtXml>
 #include <algorithm> // for std::lower_bound
@@ -52,6 +53,9 @@
 #include <zlib.h>
 #endif
 
+// every derived series producer, see recalculateDerivedSeries()
+#define DERIVED_ALL (~quint32(0))
+
 #define mark() \
 { \
     addInterval(RideFileInterval::USER, start, previous->secs, \
@@ -65,7 +69,7 @@ const QChar deltaChar(0x0394);
 RideFile::RideFile(const QDateTime &startTime, double recIntSecs) :
             wstale(true), startTime_(startTime), recIntSecs_(recIntSecs),
             data(NULL), wprime_(NULL),
-            weight_(0), totalCount(0), totalTemp(0), dstale(true)
+            weight_(0), totalCount(0), totalTemp(0), dstale(DERIVED_ALL)
 {
     command = new RideFileCommand(this);
 
@@ -80,7 +84,7 @@ RideFile::RideFile(const QDateTime &startTime, double recIntSecs) :
 // and we want to get special fields and ESPECIALLY "CP" and "Weight"
 RideFile::RideFile(RideFile *p) :
     wstale(true), recIntSecs_(p->recIntSecs_), data(NULL), wprime_(NULL),
-    weight_(p->weight_), totalCount(0), totalTemp(0), dstale(true)
+    weight_(p->weight_), totalCount(0), totalTemp(0), dstale(DERIVED_ALL)
 {
     startTime_ = p->startTime_;
     tags_ = p->tags_;
@@ -101,7 +105,7 @@ RideFile::RideFile(RideFile *p) :
 
 RideFile::RideFile() : 
     wstale(true), recIntSecs_(0.0), data(NULL), wprime_(NULL),
-    weight_(0), totalCount(0), totalTemp(0), dstale(true)
+    weight_(0), totalCount(0), totalTemp(0), dstale(DERIVED_ALL)
 {
     command = new RideFileCommand(this);
 
@@ -896,11 +900,15 @@ RideFile *RideFileFactory::openRideFile(Context *context, QFile &file,
     RideFileReader *reader = readFuncs_.value(suffix.toLower());
     if (!reader) return NULL;
 
+    PROFILE(Profiler::Reader, suffix.toLower());
+
     // if we uncompressed a ride, we need to save to a temporary ride for import
     if (uncompressed) {
 
         // create a temporary ride
-        QString tmp = context->athlete->home->temp().absolutePath() + "/" + QFileInfo(file.fileName()).baseName() + "." + suffix;
+        // standalone (e.g. batch export from the command line) there is no athlete
+        QString tmpdir = context ? context->athlete->home->temp().absolutePath() : QDir::tempPath();
+        QString tmp = tmpdir + "/" + QFileInfo(file.fileName()).baseName() + "." + suffix;
 
         QFile ufile(tmp); // look at uncompressed version mot the source
         ufile.open(QFile::ReadWrite);
@@ -1023,13 +1031,13 @@ RideFile *RideFileFactory::openRideFile(Context *context, QFile &file,
         // Update presens and filter HRV
         XDataSeries *series = result->xdata("HRV");
 
-        if (series && series->datapoints.count() > 0) {
+        if (series && series->count() > 0) {
             double rrMax = appsettings->value(NULL, GC_RR_MAX, "2000.0").toDouble();
             double rrMin = appsettings->value(NULL, GC_RR_MIN, "270.0").toDouble();
             double rrFilt = appsettings->value(NULL, GC_RR_FILT, "0.2").toDouble();
             int rrWindow = appsettings->value(NULL, GC_RR_WINDOW, "20").toInt();
 
-            FilterHrv(series, rrMin, rrMax, rrFilt, rrWindow);
+            FilterHrv(result, rrMin, rrMax, rrFilt, rrWindow);
         }
 
         // calculate derived data series -- after data fixers applied above
@@ -1051,11 +1059,11 @@ RideFile *RideFileFactory::openRideFile(Context *context, QFile &file,
         // xdata->name = "SPEED";
         // xdata->valuename << "SPEED";
         // for(int i=0; i<100; i++) {
-        // XDataPoint *p = new XDataPoint();
-        // p->km = i;
-        // p->secs = i;
-        // p->number[0] = i;
-        // xdata->datapoints.append(p);
+        // XDataPoint p;
+        // p.km = i;
+        // p.secs = i;
+        // p.number[0] = i;
+        // xdata->append(p);
         // }
         // result->addXData("SPEED", xdata);
 
@@ -1080,14 +1088,12 @@ RideFile *RideFileFactory::openRideFile(Context *context, QFile &file,
                     qDebug()<<"empty xdata"<<series->name;
                     continue;
                 } else {
-                    qDebug()<<"xdata" <<series->name<<series->valuename<<series->datapoints.count();
+                    qDebug()<<"xdata" <<series->name<<series->valuename<<series->count();
                 }
 
                 // samples
-                if (series->datapoints.count()) {
-                    foreach(XDataPoint *p, series->datapoints)
-                        qDebug()<<"sample:"<<p->secs<<p->km<<p->number[0]<<p->number[1];
-                }
+                for (int i=0; i<series->count(); i++)
+                    qDebug()<<"sample:"<<series->secs(i)<<series->km(i)<<series->value(i,0)<<series->value(i,1);
             }
         }
 #endif
@@ -1125,7 +1131,7 @@ RideFile::xdataValue(RideFilePoint *p, int &idx, QString sxdata, QString series,
     XDataSeries *s = xdata(sxdata);
 
     // if not there or no values return NA
-    if (s == NULL || !s->valuename.contains(series) || s->datapoints.count()==0)
+    if (s == NULL || !s->valuename.contains(series) || s->isEmpty())
         return RideFile::NA;
 
     // get index of series we care about
@@ -1135,13 +1141,14 @@ RideFile::xdataValue(RideFilePoint *p, int &idx, QString sxdata, QString series,
     double secs = p->secs;
 
     // do we need to move on?
-    while (idx < s->datapoints.count() && s->datapoints[idx]->secs < secs)
+    const QVector<double> &xsecs = s->secsColumn();
+    while (idx < xsecs.count() && xsecs[idx] < secs)
         idx++;
 
     // so at this point we are looking at a point that is either
     // the same point as us or is ahead of us
 
-    if (idx >= s->datapoints.count()) {
+    if (idx >= xsecs.count()) {
         //
         // PAST LAST XDATA
         //
@@ -1155,17 +1162,17 @@ RideFile::xdataValue(RideFilePoint *p, int &idx, QString sxdata, QString series,
             break;
 
         case REPEAT:
-            if (idx) returning = s->datapoints[idx-1]->number[vindex];
+            if (idx) returning = s->value(idx-1, vindex);
             else  returning = RideFile::NIL;
             break;
         }
 
-    } else if (fabs(s->datapoints[idx]->secs - secs) < recIntSecs()) {
+    } else if (fabs(xsecs[idx] - secs) < recIntSecs()) {
         //
         // ITS THE SAME AS US!
         //
         // if its a match we always take the value
-        returning = s->datapoints[idx]->number[vindex];
+        returning = s->value(idx, vindex);
     } else {
         //
         // ITS IN THE FUTURE
@@ -1175,11 +1182,11 @@ RideFile::xdataValue(RideFilePoint *p, int &idx, QString sxdata, QString series,
         case INTERPOLATE:
             if (idx) {
                 // interpolate then
-                double gap = s->datapoints[idx]->secs - s->datapoints[idx-1]->secs;
-                double diff = secs - s->datapoints[idx-1]->secs;
+                double gap = xsecs[idx] - xsecs[idx-1];
+                double diff = secs - xsecs[idx-1];
                 double ratio = diff/gap;
-                double vgap = s->datapoints[idx]->number[vindex] - s->datapoints[idx-1]->number[vindex];
-                returning = s->datapoints[idx-1]->number[vindex] + (vgap * ratio);
+                double vgap = s->value(idx, vindex) - s->value(idx-1, vindex);
+                returning = s->value(idx-1, vindex) + (vgap * ratio);
             }
             break;
 
@@ -1193,7 +1200,7 @@ RideFile::xdataValue(RideFilePoint *p, int &idx, QString sxdata, QString series,
 
         case REPEAT:
             // for now, just return the last value we saw
-            if (idx) returning = s->datapoints[idx-1]->number[vindex];
+            if (idx) returning = s->value(idx-1, vindex);
             else  returning = RideFile::NA;
             break;
         }
@@ -1867,6 +1874,9 @@ RideFile::setPointValue(int index, SeriesType series, double value)
         default:
         case none : break;
     }
+
+    // derived series that read it are now out of date
+    dstale |= derivedMask(series, true);
 }
 
 double
@@ -2218,17 +2228,17 @@ RideFile::insertPoint(int index, RideFilePoint *point)
 }
 
 void
-RideFile::insertXDataPoint(QString _xdata, int index, XDataPoint *point)
+RideFile::insertXDataPoint(QString _xdata, int index, const XDataPoint &point)
 {
     XDataSeries *series = xdata(_xdata);
-    if (series)  series->datapoints.insert(index, point);
+    if (series)  series->insert(index, point);
 }
 
 void
 RideFile::deleteXDataPoints(QString _xdata, int index, int count)
 {
     XDataSeries *series = xdata(_xdata);
-    if (series) series->datapoints.remove(index, count);
+    if (series) series->remove(index, count);
 }
 
 void
@@ -2238,17 +2248,18 @@ RideFile::appendPoints(QVector <struct RideFilePoint *> newRows)
 }
 
 void
-RideFile::appendXDataPoints(QString _xdata, QVector<XDataPoint *> points)
+RideFile::appendXDataPoints(QString _xdata, QVector<XDataPoint> points)
 {
     XDataSeries *series = xdata(_xdata);
-    if (series) series->datapoints << points;
+    if (series) foreach(const XDataPoint &p, points) series->append(p);
 }
 
 void
 RideFile::emitSaved()
 {
     weight_ = 0;
-    wstale = dstale = true;
+    wstale = true;
+    dstale = DERIVED_ALL;
     emit saved();
 }
 
@@ -2256,15 +2267,17 @@ void
 RideFile::emitReverted()
 {
     weight_ = 0;
-    wstale = dstale = true;
+    wstale = true;
+    dstale = DERIVED_ALL;
     emit reverted();
 }
 
 void
-RideFile::emitModified()
+RideFile::emitModified(bool valuesOnly)
 {
     weight_ = 0;
-    wstale = dstale = true;
+    wstale = true;
+    if (!valuesOnly) dstale = DERIVED_ALL; // else setPointValue() marked what's stale
     emit modified();
 }
 
@@ -2367,76 +2380,73 @@ RideFile::arePresent()
 //          * Iso Power (Coggan)
 //
 
+// Each producer fills in its outputs from its inputs. They are run on
+// demand and only when stale; editing a point value only marks stale
+// the producers that read that series, see setPointValue().
+const RideFile::DerivedSeries RideFile::derivedSeries[] = {
+    { &RideFile::deriveDeltas,  { cadd, hrd, kphd, nmd, wattsd, none }, { secs, cad, hr, kph, nm, watts, none } },
+    { &RideFile::deriveIsoPower, { IsoPower, none }, { watts, none } },
+    { &RideFile::deriveXPower, { xPower, none }, { secs, watts, none } },
+    { &RideFile::deriveAPower, { aPower, aPowerKg, none }, { watts, alt, none } },
+    { &RideFile::deriveTISS, { aTISS, anTISS, none }, { watts, none } },
+    { &RideFile::deriveSlope, { slope, none }, { km, alt, none } },
+    { &RideFile::deriveGear, { gear, none }, { cad, kph, watts, none } },
+    { &RideFile::deriveHb, { o2hb, hhb, none }, { smo2, thb, none } },
+    { &RideFile::deriveCycleLength, { clength, none }, { cad, rcad, kph, none } },
+    { &RideFile::deriveCoreTemp, { tcore, none }, { secs, hr, none } },
+};
+const int RideFile::derivedSeriesCount = sizeof(derivedSeries) / sizeof(derivedSeries[0]);
+
+// producers reading or writing each series, a bit per producer
+quint32
+RideFile::derivedMask(SeriesType series, bool input)
+{
+    // inputs then outputs, built once
+    static const QVector<quint32> masks = []() {
+        QVector<quint32> returning(2 * (none+1), 0);
+        for (int i=0; i<derivedSeriesCount; i++) {
+            for (int j=0; derivedSeries[i].inputs[j] != none; j++)
+                returning[derivedSeries[i].inputs[j]] |= (1u << i);
+            for (int j=0; derivedSeries[i].outputs[j] != none; j++)
+                returning[none + 1 + derivedSeries[i].outputs[j]] |= (1u << i);
+        }
+        return returning;
+    }();
+
+    return masks.at(series + (input ? 0 : none+1));
+}
+
 void
 RideFile::recalculateDerivedSeries(bool force)
 {
     // derived data is calculated from the data that is present
     // we should set to 0 where we cannot derive since we may
     // be called after data is deleted or added
-    if (!force && dstale == false) return; // we're already up to date
-
-    //
-    // IsoPower Initialisation -- working variables
-    //
-    QVector<double> NProlling;
-    int NProllingwindowsize = 30 / (recIntSecs_ ? recIntSecs_ : 1);
-    if (NProllingwindowsize > 1) NProlling.resize(NProllingwindowsize);
-    double NPtotal = 0;
-    int NPcount = 0;
-    int NPindex = 0;
-    double NPsum = 0;
-
-    //
-    // XPower Initialisation -- working variables
-    //
-    static const double EPSILON = 0.1;
-    static const double NEGLIGIBLE = 0.1;
-    double XPsecsDelta = recIntSecs_ ? recIntSecs_ : 1;
-    double XPsampsPerWindow = 25.0 / XPsecsDelta;
-    double XPattenuation = XPsampsPerWindow / (XPsampsPerWindow + XPsecsDelta);
-    double XPsampleWeight = XPsecsDelta / (XPsampsPerWindow + XPsecsDelta);
-    double XPlastSecs = 0.0;
-    double XPweighted = 0.0;
-    double XPtotal = 0.0;
-    int XPcount = 0;
-
-    //
-    // APower Initialisation -- working variables
-    double APtotal=0;
-    double APcount=0;
+    if (force) dstale = DERIVED_ALL;
+    if (dstale == 0) return; // we're already up to date
 
-    // aTISS - Aerobic Training Impact Scoring System
-    static const double a = 0.663788683661645f;
-    static const double b = -7.5095428451195f;
-    static const double c = -0.86118031563782f;
-    //static const double t = 2;
-    // anTISS
-    static const double an = 0.238923886004611f;
-    //static const double bn = -12.2066385296127f;
-    static const double bn = -61.849f;
-    static const double cn = -1.73549567522521f;
+    for (int i=0; i<derivedSeriesCount; i++)
+        if (dstale & (1u << i)) (this->*derivedSeries[i].derive)();
 
-    int CP = 0;
-    //int WPRIME = 0;
-    double aTISS = 0.0f;
-    double anTISS = 0.0f;
+    dstale = 0;
+}
 
-    // set WPrime and CP
-    if (context->athlete->zones(sport())) {
-        int zoneRange = context->athlete->zones(sport())->whichRange(startTime().date());
-        CP = zoneRange >= 0 ? context->athlete->zones(sport())->getCP(zoneRange) : 0;
-        //WPRIME = zoneRange >= 0 ? context->athlete->zones(sport())->getWprime(zoneRange) : 0;
+void
+RideFile::recalculateDerivedSeries(SeriesType series)
+{
+    // just the producer for this series, if it needs it
+    quint32 which = dstale & derivedMask(series, false);
+    if (which == 0) return;
 
-        // did we override CP in metadata / metrics ?
-        int oCP = getTag("CP","0").toInt();
-        if (oCP) CP=oCP;
-    }
+    for (int i=0; i<derivedSeriesCount; i++)
+        if (which & (1u << i)) (this->*derivedSeries[i].derive)();
 
-    // wheelsize - use meta, then config then drop to 2100
-    double wheelsize = getTag(tr("Wheelsize"), "0.0").toDouble();
-    if (wheelsize == 0) wheelsize = appsettings->cvalue(context->athlete->cyclist, GC_WHEELSIZE, 2100).toInt();
-    wheelsize /= 1000.00f; // need it in meters
+    dstale &= ~which;
+}
 
+void
+RideFile::deriveDeltas()
+{
     // last point looked at
     RideFilePoint *lastP = NULL;
 
@@ -2470,6 +2480,27 @@ RideFile::recalculateDerivedSeries(bool force)
             }
         }
 
+        // last point
+        lastP = p;
+    }
+}
+
+void
+RideFile::deriveIsoPower()
+{
+    //
+    // IsoPower Initialisation -- working variables
+    //
+    QVector<double> NProlling;
+    int NProllingwindowsize = 30 / (recIntSecs_ ? recIntSecs_ : 1);
+    if (NProllingwindowsize > 1) NProlling.resize(NProllingwindowsize);
+    double NPtotal = 0;
+    int NPcount = 0;
+    int NPindex = 0;
+    double NPsum = 0;
+
+    foreach(RideFilePoint *p, dataPoints_) {
+
         //
         // IsoPower
         //
@@ -2504,6 +2535,31 @@ RideFile::recalculateDerivedSeries(bool force)
         // now the min and max values for IsoPower
         if (p->np > maxPoint->np) maxPoint->np = p->np;
         if (p->np < minPoint->np) minPoint->np = p->np;
+    }
+
+    // Averages and Totals
+    avgPoint->np = NPcount ? (NPtotal / NPcount) : 0;
+    totalPoint->np = NPtotal;
+}
+
+void
+RideFile::deriveXPower()
+{
+    //
+    // XPower Initialisation -- working variables
+    //
+    static const double EPSILON = 0.1;
+    static const double NEGLIGIBLE = 0.1;
+    double XPsecsDelta = recIntSecs_ ? recIntSecs_ : 1;
+    double XPsampsPerWindow = 25.0 / XPsecsDelta;
+    double XPattenuation = XPsampsPerWindow / (XPsampsPerWindow + XPsecsDelta);
+    double XPsampleWeight = XPsecsDelta / (XPsampsPerWindow + XPsecsDelta);
+    double XPlastSecs = 0.0;
+    double XPweighted = 0.0;
+    double XPtotal = 0.0;
+    int XPcount = 0;
+
+    foreach(RideFilePoint *p, dataPoints_) {
 
         //
         // xPower
@@ -2531,6 +2587,22 @@ RideFile::recalculateDerivedSeries(bool force)
         // now the min and max values for IsoPower
         if (p->xp > maxPoint->xp) maxPoint->xp = p->xp;
         if (p->xp < minPoint->xp) minPoint->xp = p->xp;
+    }
+
+    // Averages and Totals
+    avgPoint->xp = XPcount ? (XPtotal / XPcount) : 0;
+    totalPoint->xp = XPtotal;
+}
+
+void
+RideFile::deriveAPower()
+{
+    //
+    // APower Initialisation -- working variables
+    double APtotal=0;
+    double APcount=0;
+
+    foreach(RideFilePoint *p, dataPoints_) {
 
         // aPower
         if (dataPresent.watts == true && dataPresent.alt == true) {
@@ -2568,9 +2640,46 @@ RideFile::recalculateDerivedSeries(bool force)
 
         APtotal += p->apower;
         APcount++;
+    }
 
-        // Anaerobic and Aerobic TISS
-        if (CP && dataPresent.watts) {
+    // Averages and Totals
+    avgPoint->apower = APcount ? (APtotal / APcount) : 0;
+    totalPoint->apower = APtotal;
+}
+
+void
+RideFile::deriveTISS()
+{
+    // aTISS - Aerobic Training Impact Scoring System
+    static const double a = 0.663788683661645f;
+    static const double b = -7.5095428451195f;
+    static const double c = -0.86118031563782f;
+    //static const double t = 2;
+    // anTISS
+    static const double an = 0.238923886004611f;
+    //static const double bn = -12.2066385296127f;
+    static const double bn = -61.849f;
+    static const double cn = -1.73549567522521f;
+
+    int CP = 0;
+    //int WPRIME = 0;
+    double aTISS = 0.0f;
+    double anTISS = 0.0f;
+
+    // set WPrime and CP
+    if (context->athlete->zones(sport())) {
+        int zoneRange = context->athlete->zones(sport())->whichRange(startTime().date());
+        CP = zoneRange >= 0 ? context->athlete->zones(sport())->getCP(zoneRange) : 0;
+        //WPRIME = zoneRange >= 0 ? context->athlete->zones(sport())->getWprime(zoneRange) : 0;
+
+        // did we override CP in metadata / metrics ?
+        int oCP = getTag("CP","0").toInt();
+        if (oCP) CP=oCP;
+    }
+
+    // Anaerobic and Aerobic TISS
+    if (CP && dataPresent.watts) {
+        foreach(RideFilePoint *p, dataPoints_) {
 
             // a * exp (b * exp (c * fraction of cp) ) 
             aTISS += recIntSecs_ * (a * exp(b * exp(c * (double(p->watts) / double(CP)))));
@@ -2578,34 +2687,82 @@ RideFile::recalculateDerivedSeries(bool force)
             p->atiss = aTISS;
             p->antiss = anTISS;
         }
+    }
+}
 
-        if (!dataPresent.slope && dataPresent.alt && dataPresent.km) {
-            if (lastP) {
-                double deltaDistance = p->km - lastP->km;
-                double deltaAltitude = p->alt - lastP->alt;
-                if (deltaDistance>0) {
-                    p->slope = deltaAltitude / (deltaDistance * 10); // * 100 for gradient, / 1000 to convert to meters
-                } else {
-                    // Repeat previous slope if distance hasn't changed.
-                    p->slope = lastP->slope;
-                }
-                if (p->slope > 40 || p->slope < -40) {
-                    p->slope = lastP->slope;
-                }
+void
+RideFile::deriveSlope()
+{
+    // only when it wasn't recorded
+    if (dataPresent.slope || !dataPresent.alt || !dataPresent.km) return;
+
+    // last point looked at
+    RideFilePoint *lastP = NULL;
+
+    foreach(RideFilePoint *p, dataPoints_) {
+
+        if (lastP) {
+            double deltaDistance = p->km - lastP->km;
+            double deltaAltitude = p->alt - lastP->alt;
+            if (deltaDistance>0) {
+                p->slope = deltaAltitude / (deltaDistance * 10); // * 100 for gradient, / 1000 to convert to meters
+            } else {
+                // Repeat previous slope if distance hasn't changed.
+                p->slope = lastP->slope;
+            }
+            if (p->slope > 40 || p->slope < -40) {
+                p->slope = lastP->slope;
             }
         }
 
-        // derive or calculate gear ratio either from XDATA (if "GEARS" XData data exists)
-        // or from speed and cadence
-        double front = RideFile::NA;
-        double rear = RideFile::NA;
+        // last point
+        lastP = p;
+    }
+
+    // Smooth the slope now it has been derived
+    int smoothPoints = 10;
+    // initialise rolling average
+    double rtot = 0;
+    for (int i=smoothPoints; i>0 && dataPoints_.count()-i >=0; i--) {
+        rtot += dataPoints_[dataPoints_.count()-i]->slope;
+    }
 
-        XDataSeries *series = xdata("GEARS");
-        if (series && series->datapoints.count() > 0)  {
-            int idx=0;
-            front = xdataValue(p, idx, "GEARS", "FRONT", RideFile::REPEAT);
-            rear = xdataValue(p, idx, "GEARS", "REAR", RideFile::REPEAT);
+    // now run backwards setting the rolling average
+    for (int i=dataPoints_.count()-1; i>=smoothPoints; i--) {
+        double here = dataPoints_[i]->slope;
+        dataPoints_[i]->slope = rtot / smoothPoints;
+        // remove rounding effect 0.01% is flat ;)
+        if (dataPoints_[i]->slope < 0.01f && dataPoints_[i]->slope > -0.01f) {
+            dataPoints_[i]->slope = 0;
         }
+        rtot -= here;
+        rtot += dataPoints_[i-smoothPoints]->slope;
+    }
+    setDataPresent(RideFile::slope, true);
+}
+
+void
+RideFile::deriveGear()
+{
+    // wheelsize - use meta, then config then drop to 2100
+    double wheelsize = getTag(tr("Wheelsize"), "0.0").toDouble();
+    if (wheelsize == 0) wheelsize = appsettings->cvalue(context->athlete->cyclist, GC_WHEELSIZE, 2100).toInt();
+    wheelsize /= 1000.00f; // need it in meters
+
+    // gears from XDATA (if "GEARS" XData data exists) joined to the samples
+    QVector<double> fronts, rears;
+    XDataSeries *gears = xdata("GEARS");
+    if (gears && gears->count() > 0 && gears->valuename.contains("FRONT") && gears->valuename.contains("REAR")) {
+        fronts = gears->join(this, gears->valuename.indexOf("FRONT"), RideFile::REPEAT);
+        rears = gears->join(this, gears->valuename.indexOf("REAR"), RideFile::REPEAT);
+    }
+
+    for (int i=0; i<dataPoints_.count(); i++) {
+        RideFilePoint *p = dataPoints_.at(i);
+
+        // derive or calculate gear ratio either from XDATA or from speed and cadence
+        double front = fronts.isEmpty() ? RideFile::NA : fronts.at(i);
+        double rear = rears.isEmpty() ? RideFile::NA : rears.at(i);
 
         if (front != RideFile::NA && rear != RideFile::NA) {
             // gear data were part of XDATA series, use it
@@ -2640,50 +2797,6 @@ RideFile::recalculateDerivedSeries(bool force)
                 p->gear = 0.0f;
             }
         }
-
-        // split out O2Hb and HHb when we have SmO2 and tHb
-        // O2Hb is oxygenated haemoglobin and HHb is deoxygenated haemoglobin
-        if (dataPresent.smo2 && dataPresent.thb) {
-
-            if (p->smo2 > 0 && p->thb > 0) {
-                setDataPresent(RideFile::o2hb, true);
-                setDataPresent(RideFile::hhb, true);
-
-                p->o2hb = (p->thb * p->smo2) / 100.00f;
-                p->hhb = p->thb - p->o2hb;
-            } else {
-
-                p->o2hb = p->hhb = 0;
-            }
-        }
-
-        // can we derive cycle length ?
-        // needs speed and cadence
-        if (p->kph && (p->cad || p->rcad)) {
-            // need to say we got it
-            setDataPresent(RideFile::clength, true);
-
-            //  only if ride point has cadence and speed > 0
-            if ((p->cad > 0.0f  || p->rcad > 0.0f ) && p->kph > 0.0f) {
-                double cad = p->rcad;
-                if (cad == 0)
-                    cad = p->cad;
-
-                p->clength = (1000.00f * p->kph) / (cad * 60.00f);
-
-                // rounding to 2 decimals
-                p->clength = round(p->clength * 100.00f) / 100.00f;
-            }
-            else {
-                p->clength = 0.0f; // to be filled up with previous gear later
-            }
-
-        } else {
-            p->clength = 0.0f;
-        }
-
-        // last point
-        lastP = p;
     }
 
     // remove gear outlier (for single outlier values = 1 second) and
@@ -2713,30 +2826,65 @@ RideFile::recalculateDerivedSeries(bool force)
 
         }
     }
+}
 
-    // Smooth the slope if it has been derived
-    if (!dataPresent.slope && dataPresent.alt && dataPresent.km) {
-        int smoothPoints = 10;
-        // initialise rolling average
-        double rtot = 0;
-        for (int i=smoothPoints; i>0 && dataPoints_.count()-i >=0; i--) {
-            rtot += dataPoints_[dataPoints_.count()-i]->slope;
+void
+RideFile::deriveHb()
+{
+    // split out O2Hb and HHb when we have SmO2 and tHb
+    // O2Hb is oxygenated haemoglobin and HHb is deoxygenated haemoglobin
+    if (!dataPresent.smo2 || !dataPresent.thb) return;
+
+    foreach(RideFilePoint *p, dataPoints_) {
+
+        if (p->smo2 > 0 && p->thb > 0) {
+            setDataPresent(RideFile::o2hb, true);
+            setDataPresent(RideFile::hhb, true);
+
+            p->o2hb = (p->thb * p->smo2) / 100.00f;
+            p->hhb = p->thb - p->o2hb;
+        } else {
+
+            p->o2hb = p->hhb = 0;
         }
+    }
+}
+
+void
+RideFile::deriveCycleLength()
+{
+    foreach(RideFilePoint *p, dataPoints_) {
+
+        // can we derive cycle length ?
+        // needs speed and cadence
+        if (p->kph && (p->cad || p->rcad)) {
+            // need to say we got it
+            setDataPresent(RideFile::clength, true);
 
-        // now run backwards setting the rolling average
-        for (int i=dataPoints_.count()-1; i>=smoothPoints; i--) {
-            double here = dataPoints_[i]->slope;
-            dataPoints_[i]->slope = rtot / smoothPoints;
-            // remove rounding effect 0.01% is flat ;)
-            if (dataPoints_[i]->slope < 0.01f && dataPoints_[i]->slope > -0.01f) {
-                dataPoints_[i]->slope = 0;
+            //  only if ride point has cadence and speed > 0
+            if ((p->cad > 0.0f  || p->rcad > 0.0f ) && p->kph > 0.0f) {
+                double cad = p->rcad;
+                if (cad == 0)
+                    cad = p->cad;
+
+                p->clength = (1000.00f * p->kph) / (cad * 60.00f);
+
+                // rounding to 2 decimals
+                p->clength = round(p->clength * 100.00f) / 100.00f;
+            }
+            else {
+                p->clength = 0.0f; // to be filled up with previous gear later
             }
-            rtot -= here;
-            rtot += dataPoints_[i-smoothPoints]->slope;
+
+        } else {
+            p->clength = 0.0f;
         }
-        setDataPresent(RideFile::slope, true);
     }
+}
 
+void
+RideFile::deriveCoreTemp()
+{
     //
     // Core Temperature
     //
@@ -2892,19 +3040,6 @@ RideFile::recalculateDerivedSeries(bool force)
             foreach(RideFilePoint *p, dataPoints_) p->tcore = CTStart;
         }
     }
-
-    // Averages and Totals
-    avgPoint->np = NPcount ? (NPtotal / NPcount) : 0;
-    totalPoint->np = NPtotal;
-
-    avgPoint->xp = XPcount ? (XPtotal / XPcount) : 0;
-    totalPoint->xp = XPtotal;
-
-    avgPoint->apower = APcount ? (APtotal / APcount) : 0;
-    totalPoint->apower = APtotal;
-
-    // and we're done
-    dstale=false;
 }
 
 #ifdef GC_HAVE_SAMPLERATE
@@ -3468,22 +3603,239 @@ RideFileIterator::previous()
     else return NULL;
 }
 
-struct CompareXDataPointSecs {
-    bool operator()(const XDataPoint *p1, const XDataPoint *p2) {
-        return p1->secs < p2->secs;
-    }
-};
-
 int
 XDataSeries::timeIndex(double secs) const
 {
     // return index offset for specified time
-    XDataPoint p;
-    p.secs = secs;
+    QVector<double>::const_iterator i = std::lower_bound(d->secs.begin(), d->secs.end(), secs);
+    if (i == d->secs.end())
+        return d->secs.size()-1;
+    return i - d->secs.begin();
+}
+
+XDataPoint
+XDataSeries::point(int row) const
+{
+    XDataPoint returning;
+    returning.secs = d->secs.at(row);
+    returning.km = d->km.at(row);
+    for (int c=0; c<d->number.count(); c++) returning.number[c] = d->number.at(c).at(row);
+    for (int c=0; c<d->string.count(); c++) if (!d->string.at(c).isEmpty()) returning.string[c] = d->string.at(c).at(row);
+    return returning;
+}
+
+void
+XDataSeries::ensureColumns(int columns)
+{
+    if (columns > XDATA_MAXVALUES) columns = XDATA_MAXVALUES;
+    while (d->number.count() < columns) d->number << QVector<double>(count(), 0);
+}
+
+void
+XDataSeries::setValue(int row, int column, double value)
+{
+    if (column < 0 || column >= XDATA_MAXVALUES) return;
+    if (column >= d->number.count()) {
+        if (value == 0) return; // thats what it reads anyway
+        ensureColumns(column+1);
+    }
+    d->number[column][row] = value;
+}
+
+void
+XDataSeries::setString(int row, int column, QString value)
+{
+    if (column < 0 || column >= XDATA_MAXVALUES) return;
+    if (column >= d->string.count() || d->string.at(column).isEmpty()) {
+        if (value.isEmpty()) return;
+        while (d->string.count() <= column) d->string << QVector<QString>();
+        d->string[column].resize(count());
+    }
+    d->string[column][row] = value;
+}
+
+void
+XDataSeries::append(const XDataPoint &point)
+{
+    insert(count(), point);
+}
+
+void
+XDataSeries::insert(int row, const XDataPoint &point)
+{
+    // values are added as rows set them, readers often add
+    // valuenames after the first samples were appended
+    int columns = XDATA_MAXVALUES;
+    while (columns > d->number.count() && point.number[columns-1] == 0) columns--;
+    ensureColumns(qMax(columns, valuename.count()));
+
+    XDataColumns *c = d.data();
+    c->secs.insert(row, point.secs);
+    c->km.insert(row, point.km);
+    for (int i=0; i<c->number.count(); i++) c->number[i].insert(row, point.number[i]);
+
+    for (int i=0; i<XDATA_MAXVALUES; i++) {
+        if (i < c->string.count() && !c->string.at(i).isEmpty()) {
+            c->string[i].insert(row, point.string[i]);
+        } else if (!point.string[i].isEmpty()) {
+            while (c->string.count() <= i) c->string << QVector<QString>();
+            c->string[i].resize(count());
+            c->string[i][row] = point.string[i];
+        }
+    }
+}
+
+void
+XDataSeries::remove(int row, int n)
+{
+    XDataColumns *c = d.data();
+    c->secs.remove(row, n);
+    c->km.remove(row, n);
+    for (int i=0; i<c->number.count(); i++) c->number[i].remove(row, n);
+    for (int i=0; i<c->string.count(); i++) if (!c->string.at(i).isEmpty()) c->string[i].remove(row, n);
+}
+
+void
+XDataSeries::clear()
+{
+    XDataColumns *c = d.data();
+    c->secs.clear();
+    c->km.clear();
+    c->number.clear();
+    c->string.clear();
+}
+
+void
+XDataSeries::reserve(int rows)
+{
+    XDataColumns *c = d.data();
+    c->secs.reserve(rows);
+    c->km.reserve(rows);
+    for (int i=0; i<c->number.count(); i++) c->number[i].reserve(rows);
+}
 
-    QVector<XDataPoint*>::const_iterator i = std::lower_bound(
-        datapoints.begin(), datapoints.end(), &p, CompareXDataPointSecs());
-    if (i == datapoints.end())
-        return datapoints.size()-1;
-    return i - datapoints.begin();
+template <class T>
+static QVector<T> selectRows(const QVector<T> &from, const QVector<int> &rows)
+{
+    QVector<T> returning(rows.count());
+    for (int i=0; i<rows.count(); i++) returning[i] = from.at(rows.at(i));
+    return returning;
+}
+
+void
+XDataSeries::select(const QVector<int> &rows)
+{
+    XDataColumns *c = d.data();
+    c->secs = selectRows(c->secs, rows);
+    c->km = selectRows(c->km, rows);
+    for (int i=0; i<c->number.count(); i++) c->number[i] = selectRows(c->number.at(i), rows);
+    for (int i=0; i<c->string.count(); i++) if (!c->string.at(i).isEmpty()) c->string[i] = selectRows(c->string.at(i), rows);
+}
+
+void
+XDataSeries::offset(double secs, double km)
+{
+    XDataColumns *c = d.data();
+    double *s = c->secs.data();
+    double *k = c->km.data();
+    for (int i=0; i<c->secs.count(); i++) {
+        s[i] += secs;
+        k[i] += km;
+    }
+}
+
+QVector<double>
+XDataSeries::column(int column) const
+{
+    if (column >= 0 && column < d->number.count()) return d->number.at(column);
+    return QVector<double>(count(), 0);
+}
+
+void
+XDataSeries::setColumn(int column, const QVector<double> &values)
+{
+    if (column < 0 || column >= XDATA_MAXVALUES || values.count() != count()) return;
+    ensureColumns(column+1);
+    d->number[column] = values;
+}
+
+void
+XDataSeries::removeColumn(int column)
+{
+    XDataColumns *c = d.data();
+    if (column >= 0 && column < c->number.count()) c->number.remove(column);
+    if (column >= 0 && column < c->string.count()) c->string.remove(column);
+}
+
+void
+XDataSeries::insertColumn(int column)
+{
+    XDataColumns *c = d.data();
+    if (column >= 0 && column < c->number.count()) {
+        c->number.insert(column, QVector<double>(count(), 0));
+        if (c->number.count() > XDATA_MAXVALUES) c->number.resize(XDATA_MAXVALUES);
+    }
+    if (column >= 0 && column < c->string.count()) {
+        c->string.insert(column, QVector<QString>());
+        if (c->string.count() > XDATA_MAXVALUES) c->string.resize(XDATA_MAXVALUES);
+    }
+}
+
+QVector<double>
+XDataSeries::join(const RideFile *ride, int column, RideFile::XDataJoin xjoin) const
+{
+    const QVector<RideFilePoint*> &points = ride->dataPoints();
+    QVector<double> returning(points.count(), RideFile::NA);
+
+    if (isEmpty() || column < 0) return returning;
+
+    const double *secs = d->secs.constData();
+    const QVector<double> values = this->column(column);
+    const double *value = values.constData();
+    const int n = count();
+    const double recint = ride->recIntSecs();
+
+    // both are in time order so we merge rather than search
+    int idx = 0;
+    for (int i=0; i<points.count(); i++) {
+
+        double t = points.at(i)->secs;
+        while (idx < n && secs[idx] < t) idx++;
+
+        double &out = returning[i];
+        if (idx >= n) {
+
+            // past the last xdata
+            if (xjoin == RideFile::REPEAT && idx) out = value[idx-1];
+            else out = RideFile::NIL;
+
+        } else if (fabs(secs[idx] - t) < recint) {
+
+            // a match, we always take the value
+            out = value[idx];
+
+        } else {
+
+            // its in the future
+            switch(xjoin) {
+            case RideFile::INTERPOLATE:
+                if (idx) {
+                    double gap = secs[idx] - secs[idx-1];
+                    double ratio = (t - secs[idx-1]) / gap;
+                    out = value[idx-1] + ((value[idx] - value[idx-1]) * ratio);
+                }
+                break;
+
+            case RideFile::SPARSE:
+            case RideFile::RESAMPLE:
+                out = RideFile::NIL;
+                break;
+
+            case RideFile::REPEAT:
+                if (idx) out = value[idx-1];
+                break;
+            }
+        }
+    }
+    return returning;
 }
@@ -27,6 +27,7 @@
 #include <QMap>
 #include <QVector>
 #include <QObject>
+#include <QSharedData>
 #include <QRegExp>
 
 class RideItem;
@@ -298,16 +299,18 @@ class RideFile : public QObject // QObject to emit signals
 
         const QVector<RideFilePoint*> &dataPoints() const { return dataPoints_; }
 
-        // recalculate all the derived data series
-        // might want to move to a factory for these
-        // at some point, but for now hard coded
+        // recalculate the derived data series, each is
+        // computed by a producer from its inputs, see
+        // derivedSeries in RideFile.cpp
         //
         // YOU MUST ALWAYS CALL THIS BEFORE ACESSING
         // THE DERIVED DATA. IT IS REFRESHED ON DEMAND.
-        // STATE IS MAINTAINED IN 'bool dstale' BELOW
-        // TO ENSURE IT IS ONLY REFRESHED IF NEEDED
+        // STATE IS MAINTAINED IN 'dstale' BELOW, A BIT
+        // PER PRODUCER, TO ENSURE IT IS ONLY REFRESHED
+        // IF NEEDED. PASS A SERIES TO JUST REFRESH THAT.
         //
         void recalculateDerivedSeries(bool force=false);
+        void recalculateDerivedSeries(SeriesType series);
 
         // Working with DATAPRESENT flags
         inline const RideFileDataPresent *areDataPresent() const { return &dataPresent; }
@@ -399,9 +402,9 @@ class RideFile : public QObject // QObject to emit signals
         void insertPoint(int index, RideFilePoint *point);
         void appendPoints(QVector <struct RideFilePoint *> newRows);
         void setDataPresent(SeriesType, bool);
-        void insertXDataPoint(QString xdata, int index, XDataPoint *point);
+        void insertXDataPoint(QString xdata, int index, const XDataPoint &point);
         void deleteXDataPoints(QString xdata, int index, int count);
-        void appendXDataPoints(QString xdata, QVector<XDataPoint *> points);
+        void appendXDataPoints(QString xdata, QVector<XDataPoint> points);
         // ************************************************************
 
     signals:
@@ -423,7 +426,7 @@ class RideFile : public QObject // QObject to emit signals
 
         void emitSaved();
         void emitReverted();
-        void emitModified();
+        void emitModified(bool valuesOnly=false); // only point values changed
 
         bool wstale;
 
@@ -453,7 +456,27 @@ class RideFile : public QObject // QObject to emit signals
         void updateMax(RideFilePoint* point);
         void updateAvg(RideFilePoint* point);
 
-        bool dstale; // is derived data up to date?
+        // derived series producers
+        struct DerivedSeries {
+            void (RideFile::*derive)();
+            SeriesType outputs[6], inputs[7]; // terminated by none
+        };
+        static const DerivedSeries derivedSeries[];
+        static const int derivedSeriesCount;
+        static quint32 derivedMask(SeriesType series, bool input);
+
+        void deriveDeltas();
+        void deriveIsoPower();
+        void deriveXPower();
+        void deriveAPower();
+        void deriveTISS();
+        void deriveSlope();
+        void deriveGear();
+        void deriveHb();
+        void deriveCycleLength();
+        void deriveCoreTemp();
+
+        quint32 dstale; // producers whose series are out of date
 
         // data required to compute headwind based on weather broadcast
         double windSpeed_, windHeading_;
@@ -563,6 +586,8 @@ class RideFileIterator {
 
 #define XDATA_MAXVALUES 64
 
+// a single row of xdata, used when building a series or passing
+// rows to and from the editor, it is not how a series is stored
 class XDataPoint {
 public:
     XDataPoint() {
@@ -590,35 +615,82 @@ public:
     QString string[XDATA_MAXVALUES];
 };
 
+// the columns are shared between copies of a series until
+// one of them is modified (see QSharedDataPointer)
+class XDataColumns : public QSharedData {
+public:
+    QVector<double> secs, km;
+    QVector<QVector<double> > number;   // one per value, all count() long
+    QVector<QVector<QString> > string;  // empty unless the value has strings
+};
+
+//
+// An xdata series is stored a column per value with shared secs and km
+// columns, a row of 64 doubles and 64 strings per sample costs more than
+// most files hold in the samples themselves.
+//
+// Values are columns 0 to XDATA_MAXVALUES-1, reading a column that was
+// never set returns zero, setting one adds it.
+//
 class XDataSeries {
 public:
-    XDataSeries() {}
-    XDataSeries(const XDataSeries& other) { *this = other; }
-    XDataSeries& operator=(const XDataSeries &other) {
-        name = other.name;
-        valuename = other.valuename;
-        unitname = other.unitname;
-        valuetype = other.valuetype;
-        // we need to delete objects pointed by the assignment target
-        foreach(XDataPoint *p, datapoints) delete p;
-        datapoints.clear();
-        // we need to create new objects since we are holding pointers to objects
-        // otherwise we would end up w/ multiple frees or dangling ptrs!
-        foreach (XDataPoint *p, other.datapoints) {
-            datapoints.push_back(new XDataPoint(*p));
-        }
-        return *this;
+    XDataSeries() : d(new XDataColumns) {}
+
+    // rows
+    int count() const { return d->secs.count(); }
+    bool isEmpty() const { return d->secs.isEmpty(); }
+    double secs(int row) const { return d->secs.at(row); }
+    double km(int row) const { return d->km.at(row); }
+    double value(int row, int column) const {
+        return column >= 0 && column < d->number.count() ? d->number.at(column).at(row) : 0;
+    }
+    QString string(int row, int column) const {
+        return column >= 0 && column < d->string.count() && !d->string.at(column).isEmpty() ? d->string.at(column).at(row) : QString();
     }
+    XDataPoint point(int row) const;
 
-    ~XDataSeries() { foreach(XDataPoint *p, datapoints) delete p; }
+    void setSecs(int row, double value) { d->secs[row] = value; }
+    void setKm(int row, double value) { d->km[row] = value; }
+    void setValue(int row, int column, double value);
+    void setString(int row, int column, QString value);
+
+    void append(const XDataPoint &point);
+    void insert(int row, const XDataPoint &point);
+    void remove(int row, int count=1);
+    void clear();
+    void reserve(int rows);
+
+    // whole columns, for working over the series
+    const QVector<double> &secsColumn() const { return d->secs; }
+    const QVector<double> &kmColumn() const { return d->km; }
+    QVector<double> column(int column) const;
+    void setColumn(int column, const QVector<double> &values); // count() values
+
+    // keep just these rows, in this order
+    void select(const QVector<int> &rows);
+
+    // add to every secs and km, e.g. when splitting or merging activities
+    void offset(double secs, double km);
+
+    // shift the values right of column, as valuenames are removed or inserted
+    void removeColumn(int column);
+    void insertColumn(int column);
 
     int timeIndex(double) const;          // get index offset for time in secs
 
+    // the value of column for every sample in ride, joined in a single
+    // pass, the same values xdataValue returns sample by sample
+    QVector<double> join(const RideFile *ride, int column, RideFile::XDataJoin xjoin) const;
+
     QString name;
     QStringList valuename;
     QStringList unitname;
     QList<RideFile::SeriesType> valuetype;
-    QVector<XDataPoint*> datapoints;
+
+private:
+    void ensureColumns(int columns);
+
+    QSharedDataPointer<XDataColumns> d;
 };
 
 struct RideFileReader {
@@ -26,12 +26,19 @@
 #include "PaceZones.h"
 #include "WPrime.h" // for wbal zones
 #include "LTMSettings.h" // getAllBestsFor needs this
+#include "Profiler.h"
 
 #include <cmath> // for pow()
 #include <QDebug>
 #include <QFileInfo>
 #include <QMessageBox>
 #include <QtAlgorithms> // for qStableSort
+#include <QMutexLocker>
+#include <QScopedPointer>
+#include <QSaveFile>
+#include <QMap>
+#include <QtConcurrent>
+#include <string.h>
 
 static const int maxcache = 25; // lets max out at 25 caches
 
@@ -160,7 +167,7 @@ RideFileCache::RideFileCache(Context *context, QString fileName, double weight,
 }
 
 bool 
-RideFileCache::checkStale(Context *context, RideItem*item)
+RideFileCache::checkStale(Context *context, RideItem*item, double weight)
 {
     // check if we're stale ?
     // Get info for ride file and cache file
@@ -198,7 +205,7 @@ RideFileCache::checkStale(Context *context, RideItem*item)
                 head.crc == RideFile::computeFileCRC(rideFileName)) {
 
                 // it is the same ?
-                if (head.version == RideFileCacheVersion && head.WEIGHT == item->getWeight()) {
+                if (head.version == RideFileCacheVersion && head.WEIGHT == (weight > 0 ? weight : item->getWeight())) {
 
                     // WE'RE GOOD
                     return false;
@@ -383,6 +390,15 @@ QVector<float> RideFileCache::meanMaxPowerFor(Context *context, QVector<float>&w
 
     // Get info for ride file and cache file
     QFileInfo rideFileInfo(fileName);
+
+    // from the pack if we can
+    CpxPack *pack = CpxPack::instance(context->athlete->home->cache().canonicalPath());
+    if (pack->meanMax(rideFileInfo.baseName(), RideFile::watts, returning)) {
+        if (returning.count() && pack->meanMax(rideFileInfo.baseName(), RideFile::wattsKg, wpk))
+            for(int i=0; i<wpk.size(); i++) wpk[i] = wpk[i] / 100.00f;
+        return returning;
+    }
+
     QString cacheFilename = context->athlete->home->cache().canonicalPath() + "/" + rideFileInfo.baseName() + ".cpx";
     QFileInfo cacheFileInfo(cacheFilename);
 
@@ -491,14 +507,14 @@ QVector<float> RideFileCache::meanMaxFor(QString cacheDir, RideFile::SeriesType
     bool first = true;
     QVector<float> returning;
 
+    // stream the series for all the packed rides in one pass
+    QHash<QString, QVector<float> > packed = CpxPack::instance(cacheDir)->meanMaxAll(series);
+
     // loop through all CPX files
     foreach(QString cacheFilename, QDir(cacheDir).entryList(QDir::Files)) {
 
         // is it a cpx file ?
         if (!cacheFilename.endsWith(".cpx")) continue;
-   
-        // is it big enough ? 
-        if (QFileInfo(cacheDir + "/" + cacheFilename).size() < (int)sizeof(struct RideFileCacheHeader)) continue;
 
         // lets check it parses ok ?
         QDateTime dt;
@@ -508,7 +524,14 @@ QVector<float> RideFileCache::meanMaxFor(QString cacheDir, RideFile::SeriesType
         if (dt.date() < from || dt.date() > to) continue;
 
         // get data
-        QVector<float> current = RideFileCache::meanMaxFor(cacheDir + "/" + cacheFilename, series);
+        QVector<float> current;
+        QHash<QString, QVector<float> >::const_iterator it = packed.constFind(QFileInfo(cacheFilename).completeBaseName());
+        if (it != packed.constEnd()) current = it.value();
+        else {
+            // is it big enough ?
+            if (QFileInfo(cacheDir + "/" + cacheFilename).size() < (int)sizeof(struct RideFileCacheHeader)) continue;
+            current = RideFileCache::meanMaxFor(cacheDir + "/" + cacheFilename, series);
+        }
 
         // first ?
         if (first) {
@@ -525,6 +548,21 @@ QVector<float> RideFileCache::meanMaxFor(QString cacheDir, RideFile::SeriesType
 
 }
 
+// from a packed cpx, the time in zone arrays are fixed size
+RideFileCache::RideFileCache(Context *context, const QByteArray &cpx) :
+               incomplete(false), context(context), rideFileName(""), ride(0)
+{
+    wattsTimeInZone.resize(10);
+    wattsCPTimeInZone.resize(4);
+    hrTimeInZone.resize(10);
+    hrCPTimeInZone.resize(4);
+    paceTimeInZone.resize(10);
+    paceCPTimeInZone.resize(4);
+    wbalTimeInZone.resize(4);
+
+    readCache(cpx);
+}
+
 RideFileCache::RideFileCache(RideFile *ride) :
                incomplete(false), context(ride->context), rideFileName(""), ride(ride)
 {
@@ -853,6 +891,7 @@ RideFileCache::createCacheFor(RideFile*rideFile)
 void
 RideFileCache::refreshCache()
 {
+    PROFILE(Profiler::Cache, QStringLiteral("RideFileCache::refreshCache"));
     static bool writeerror=false;
 
     // set head crc
@@ -867,14 +906,18 @@ RideFileCache::refreshCache()
         // so lets go recalculate it all
         compute();
 
-        QDataStream outFile(&cacheFile);
-
-        // go write it out
+        // go write it out, and to the pack too
+        QByteArray cpx;
+        QDataStream outFile(&cpx, QIODevice::WriteOnly);
         serialize(&outFile);
+        cacheFile.write(cpx);
 
         // all done now, phew
         cacheFile.close();
 
+        QFileInfo cacheFileInfo(cacheFileName);
+        CpxPack::instance(cacheFileInfo.absolutePath())->store(cacheFileInfo.completeBaseName(), cpx);
+
         // invalidate any incore cache of aggregate
         // that contains this ride in its date range
         QDate date = ride->startTime().date();
@@ -1729,6 +1772,7 @@ static void distAggregate(QVector<double> &into, QVector<double> &other)
 RideFileCache::RideFileCache(Context *context, QDate start, QDate end, bool filter, QStringList files, bool onhome, RideItem *rideItem)
                : start(start), end(end), incomplete(false), context(context), rideFileName(""), ride(0)
 {
+    PROFILE(Profiler::Cache, QStringLiteral("RideFileCache (date range)"));
 
     // remember parameters for getting heat
     this->filter = filter;
@@ -1794,6 +1838,9 @@ RideFileCache::RideFileCache(Context *context, QDate start, QDate end, bool filt
     // and less intrusive than a popup box
     context->mainWindow->setCursor(Qt::WaitCursor);
 
+    // rides that are up to date are read from the pack
+    CpxPack *pack = CpxPack::instance(context->athlete->home->cache().canonicalPath());
+
     // Iterate over the ride files (not the cpx files since they /might/ not
     // exist, or /might/ be out of date.
     foreach (RideItem *item, context->athlete->rideCache->rides()) {
@@ -1809,9 +1856,21 @@ RideFileCache::RideFileCache(Context *context, QDate start, QDate end, bool filt
             // skip other sports if rideItem is given
             if (rideItem && (rideItem->sport != item->sport)) continue;
 
+            // packed copy is current unless the ride is stale
+            QScopedPointer<RideFileCache> cached;
+            if (!item->isstale) {
+                QByteArray cpx = pack->cpx(QFileInfo(item->fileName).baseName());
+                if (cpx.size() >= int(sizeof(RideFileCacheHeader)) &&
+                    reinterpret_cast<const RideFileCacheHeader*>(cpx.constData())->WEIGHT == item->getWeight())
+                    cached.reset(new RideFileCache(context, cpx));
+            }
+
             // get its cached values (will NOT! refresh if needed...)
             // the true means it will check only
-            RideFileCache rideCache(context, context->athlete->home->activities().canonicalPath() + "/" + item->fileName, item->getWeight(), NULL, false, false);
+            if (cached.isNull())
+                cached.reset(new RideFileCache(context, context->athlete->home->activities().canonicalPath() + "/" + item->fileName, item->getWeight(), NULL, false, false));
+            RideFileCache &rideCache = *cached;
+
             if (rideCache.incomplete == true) {
                 // ack, data not available !
                 incomplete = true;
@@ -2011,13 +2070,35 @@ RideFileCache::serialize(QDataStream *out)
 void
 RideFileCache::readCache()
 {
-    RideFileCacheHeader head;
+    PROFILE(Profiler::Cache, QStringLiteral("RideFileCache::readCache"));
     QFile cacheFile(cacheFileName);
 
     if (cacheFile.open(QIODevice::ReadOnly) == true) {
-        QDataStream inFile(&cacheFile);
+        QByteArray cpx = cacheFile.readAll();
+        cacheFile.close();
+
+        readCache(cpx);
+
+        // rides cached before the pack existed get added as they're read
+        if (cpx.size() >= int(sizeof(RideFileCacheHeader))) {
+            QFileInfo cacheFileInfo(cacheFileName);
+            CpxPack *pack = CpxPack::instance(cacheFileInfo.absolutePath());
+            if (!pack->contains(cacheFileInfo.completeBaseName(), crc))
+                pack->store(cacheFileInfo.completeBaseName(), cpx);
+        }
+    }
+}
+
+void
+RideFileCache::readCache(const QByteArray &cpx)
+{
+    RideFileCacheHeader head;
+
+    if (cpx.size() >= int(sizeof(head))) {
+        QDataStream inFile(cpx);
 
         inFile.readRawData((char *) &head, sizeof(head));
+        crc = head.crc;
 
         // resize all the arrays to fit
         wattsMeanMax.resize(head.wattsMeanMaxCount);
@@ -2122,8 +2203,6 @@ RideFileCache::readCache()
         doubleArrayForDistribution(aPowerDistributionDouble, aPowerDistribution);
         doubleArrayForDistribution(smo2DistributionDouble, smo2Distribution);
         doubleArrayForDistribution(wbalDistributionDouble, wbalDistribution);
-
-        cacheFile.close();
     }
 }
 
@@ -2182,6 +2261,11 @@ RideFileCache::best(Context *context, QString filename, RideFile::SeriesType ser
     QString cacheFileName(context->athlete->home->cache().canonicalPath() + "/" + rideFileInfo.baseName() + ".cpx");
     QFileInfo cacheFileInfo(cacheFileName);
 
+    // from the pack if we can
+    float packed = 0;
+    if (CpxPack::instance(context->athlete->home->cache().canonicalPath())->meanMaxAt(rideFileInfo.baseName(), series, duration, packed))
+        return packed / pow(10, decimalsFor(series));
+
     // head
     RideFileCacheHeader head;
     QFile cacheFile(cacheFileName);
@@ -2455,3 +2539,315 @@ RideFileCache::binsize(RideFile::SeriesType type)
     case RideFile::wbal: return wbalDelta;
     }
 }
+
+//
+// CPX PACK
+//
+static const int cpxPackHeaderSize = 12;
+static const qint64 cpxPackCompactSize = 4 * 1024 * 1024; // don't bother when small
+
+static void compactPack(CpxPack *pack) { pack->compact(); }
+
+CpxPack *
+CpxPack::instance(QString cacheDir)
+{
+    static QMutex registry;
+    static QHash<QString, CpxPack*> packs;
+
+    // the same directory may be named differently by callers
+    QString canonical = QDir(cacheDir).canonicalPath();
+    if (!canonical.isEmpty()) cacheDir = canonical;
+
+    // they live as long as the application does
+    QMutexLocker locker(&registry);
+    CpxPack *pack = packs.value(cacheDir, NULL);
+    if (pack == NULL) {
+        pack = new CpxPack(cacheDir + "/cpx.pack");
+        packs.insert(cacheDir, pack);
+    }
+    return pack;
+}
+
+CpxPack::CpxPack(QString filename) : map(NULL), mapsize(0), size(0), garbage(0), compacting(false)
+{
+    file.setFileName(filename);
+
+    QMutexLocker locker(&lock);
+    load();
+}
+
+void
+CpxPack::load()
+{
+    entries.clear();
+    size = garbage = 0;
+    if (!file.open(QIODevice::ReadWrite)) return;
+
+    // a different version starts again, the cpx files will refill it
+    char head[cpxPackHeaderSize] = { 0 };
+    quint32 packversion = 0, cpxversion = 0;
+    if (file.read(head, cpxPackHeaderSize) == cpxPackHeaderSize) {
+        memcpy(&packversion, head+4, 4);
+        memcpy(&cpxversion, head+8, 4);
+    }
+    if (memcmp(head, "GCPK", 4) || packversion != CPXPACK_VERSION || cpxversion != RideFileCacheVersion) {
+        file.resize(0);
+        file.seek(0);
+        packversion = CPXPACK_VERSION;
+        cpxversion = RideFileCacheVersion;
+        memcpy(head, "GCPK", 4);
+        memcpy(head+4, &packversion, 4);
+        memcpy(head+8, &cpxversion, 4);
+        file.write(head, cpxPackHeaderSize);
+        file.flush();
+    }
+    qint64 fsize = file.size();
+    size = fsize;
+    if (!mapped()) {
+        size = cpxPackHeaderSize;
+        return;
+    }
+
+    // index the entries, a torn entry at the end is dropped
+    qint64 at = cpxPackHeaderSize;
+    while (at + 4 <= fsize) {
+
+        quint32 namelength, length;
+        memcpy(&namelength, map + at, 4);
+        if (at + 8 + namelength > fsize) break;
+        memcpy(&length, map + at + 4 + namelength, 4);
+        if (at + 8 + namelength + length > fsize) break;
+
+        QString name = QString::fromUtf8(reinterpret_cast<const char*>(map + at + 4), namelength);
+        Entry entry;
+        entry.offset = at + 8 + namelength;
+        entry.length = length;
+
+        // superseded or deleted
+        QHash<QString, Entry>::iterator it = entries.find(name);
+        if (it != entries.end()) {
+            garbage += it.value().length + 8 + namelength;
+            entries.erase(it);
+        }
+        if (length) entries.insert(name, entry);
+        else garbage += 8 + namelength;
+
+        at = entry.offset + length;
+    }
+    size = at;
+
+    if (size < fsize) {
+        file.unmap(map);
+        map = NULL;
+        mapsize = 0;
+        file.resize(size);
+    }
+}
+
+bool
+CpxPack::mapped()
+{
+    // appended since we last mapped it
+    if (map && mapsize == size) return true;
+
+    if (map) file.unmap(map);
+    map = NULL;
+    mapsize = 0;
+
+    if (!file.isOpen() || size <= cpxPackHeaderSize) return false;
+
+    map = file.map(0, size);
+    if (map) mapsize = size;
+    return map != NULL;
+}
+
+const RideFileCacheHeader *
+CpxPack::header(const Entry &entry) const
+{
+    if (entry.length < sizeof(RideFileCacheHeader)) return NULL;
+    return reinterpret_cast<const RideFileCacheHeader*>(map + entry.offset);
+}
+
+void
+CpxPack::store(QString name, const QByteArray &cpx)
+{
+    QMutexLocker locker(&lock);
+    if (!file.isOpen()) return;
+
+    QByteArray utf8 = name.toUtf8();
+    quint32 namelength = utf8.size();
+    quint32 length = cpx.size();
+
+    file.seek(size);
+    file.write(reinterpret_cast<const char*>(&namelength), 4);
+    file.write(utf8);
+    file.write(reinterpret_cast<const char*>(&length), 4);
+    file.write(cpx);
+    file.flush();
+
+    QHash<QString, Entry>::iterator it = entries.find(name);
+    if (it != entries.end()) {
+        garbage += it.value().length + 8 + namelength;
+        entries.erase(it);
+    }
+
+    Entry entry;
+    entry.offset = size + 8 + namelength;
+    entry.length = length;
+    size = entry.offset + length;
+    if (length) entries.insert(name, entry);
+    else garbage += 8 + namelength;
+
+    // mostly superseded, so rewrite it in the background
+    if (!compacting && size > cpxPackCompactSize && garbage > size/2) {
+        compacting = true;
+        QFuture<void> f = QtConcurrent::run(compactPack, this);
+        Q_UNUSED(f)
+    }
+}
+
+void
+CpxPack::remove(QString name)
+{
+    {
+        QMutexLocker locker(&lock);
+        if (!entries.contains(name)) return;
+    }
+    store(name, QByteArray());
+}
+
+QByteArray
+CpxPack::cpx(QString name)
+{
+    QMutexLocker locker(&lock);
+
+    QHash<QString, Entry>::const_iterator it = entries.constFind(name);
+    if (it == entries.constEnd() || !mapped()) return QByteArray();
+
+    return QByteArray(reinterpret_cast<const char*>(map + it.value().offset), it.value().length);
+}
+
+bool
+CpxPack::contains(QString name, unsigned int crc)
+{
+    QMutexLocker locker(&lock);
+
+    QHash<QString, Entry>::const_iterator it = entries.constFind(name);
+    if (it == entries.constEnd() || !mapped()) return false;
+
+    const RideFileCacheHeader *head = header(it.value());
+    return head && head->crc == crc;
+}
+
+bool
+CpxPack::meanMax(QString name, RideFile::SeriesType series, QVector<float> &values)
+{
+    QMutexLocker locker(&lock);
+
+    QHash<QString, Entry>::const_iterator it = entries.constFind(name);
+    if (it == entries.constEnd() || !mapped()) return false;
+
+    const RideFileCacheHeader *head = header(it.value());
+    if (head == NULL) return false;
+
+    long count = countForMeanMax(*head, series);
+    long offset = sizeof(RideFileCacheHeader) + offsetForMeanMax(*head, series);
+    if (offset + count * long(sizeof(float)) > long(it.value().length)) return false;
+
+    values.resize(count);
+    if (count) memcpy(values.data(), map + it.value().offset + offset, count * sizeof(float));
+    return true;
+}
+
+bool
+CpxPack::meanMaxAt(QString name, RideFile::SeriesType series, int duration, float &value)
+{
+    QMutexLocker locker(&lock);
+
+    QHash<QString, Entry>::const_iterator it = entries.constFind(name);
+    if (it == entries.constEnd() || !mapped()) return false;
+
+    const RideFileCacheHeader *head = header(it.value());
+    if (head == NULL) return false;
+
+    // not enough samples, which is the same as no best
+    value = 0;
+    if (duration < 0 || duration >= countForMeanMax(*head, series)) return true;
+
+    long offset = sizeof(RideFileCacheHeader) + offsetForMeanMax(*head, series) + duration * sizeof(float);
+    if (offset + long(sizeof(float)) > long(it.value().length)) return false;
+
+    memcpy(&value, map + it.value().offset + offset, sizeof(float));
+    return true;
+}
+
+QHash<QString, QVector<float> >
+CpxPack::meanMaxAll(RideFile::SeriesType series)
+{
+    QHash<QString, QVector<float> > returning;
+
+    QMutexLocker locker(&lock);
+    if (!mapped()) return returning;
+
+    // visit in file order so the reads are sequential
+    QMap<qint64, QString> order;
+    for (QHash<QString, Entry>::const_iterator it = entries.constBegin(); it != entries.constEnd(); ++it)
+        order.insert(it.value().offset, it.key());
+
+    for (QMap<qint64, QString>::const_iterator it = order.constBegin(); it != order.constEnd(); ++it) {
+
+        const Entry &entry = entries[it.value()];
+        const RideFileCacheHeader *head = header(entry);
+        if (head == NULL) continue;
+
+        long count = countForMeanMax(*head, series);
+        long offset = sizeof(RideFileCacheHeader) + offsetForMeanMax(*head, series);
+        if (count == 0 || offset + count * long(sizeof(float)) > long(entry.length)) continue;
+
+        QVector<float> values(count);
+        memcpy(values.data(), map + entry.offset + offset, count * sizeof(float));
+        returning.insert(it.value(), values);
+    }
+    return returning;
+}
+
+void
+CpxPack::compact()
+{
+    QMutexLocker locker(&lock);
+
+    if (mapped()) {
+
+        // write the newest copy of each ride, in file order
+        QSaveFile out(file.fileName());
+        if (out.open(QIODevice::WriteOnly)) {
+
+            out.write(reinterpret_cast<const char*>(map), cpxPackHeaderSize);
+
+            QMap<qint64, QString> order;
+            for (QHash<QString, Entry>::const_iterator it = entries.constBegin(); it != entries.constEnd(); ++it)
+                order.insert(it.value().offset, it.key());
+
+            for (QMap<qint64, QString>::const_iterator it = order.constBegin(); it != order.constEnd(); ++it) {
+                QByteArray utf8 = it.value().toUtf8();
+                quint32 namelength = utf8.size();
+                const Entry &entry = entries[it.value()];
+
+                out.write(reinterpret_cast<const char*>(&namelength), 4);
+                out.write(utf8);
+                out.write(reinterpret_cast<const char*>(&entry.length), 4);
+                out.write(reinterpret_cast<const char*>(map + entry.offset), entry.length);
+            }
+
+            // the old one must be closed before it can be replaced
+            file.unmap(map);
+            map = NULL;
+            mapsize = 0;
+            file.close();
+
+            if (!out.commit()) qDebug()<<"cannot compact cpx pack"<<file.fileName();
+            load();
+        }
+    }
+    compacting = false;
+}
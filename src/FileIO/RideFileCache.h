@@ -23,6 +23,9 @@
 #include <QDataStream>
 #include <QVector>
 #include <QThread>
+#include <QMutex>
+#include <QHash>
+#include <QFile>
 
 class Context;
 class RideFile;
@@ -166,8 +169,9 @@ class RideFileCache
         // once a cache is loaded we can refresh from in-memory if needed
         void refresh(RideFile*ride = NULL);
 
-        // are we stale ?
-        static bool checkStale(Context *context, RideItem*item);
+        // are we stale ? against the given weight if it is set, otherwise
+        // the weight that applies to the ride now
+        static bool checkStale(Context *context, RideItem*item, double weight=0);
 
         // Just get mean max values for power & wpk for a ride
         static QVector<float> meanMaxPowerFor(Context *context, QVector<float>&wpk, QDate from, QDate to, QVector<QDate> *dates, QString sport="Bike");
@@ -231,8 +235,12 @@ class RideFileCache
 
     protected:
 
+        // from a packed copy of a cpx file, see CpxPack below
+        RideFileCache(Context *context, const QByteArray &cpx);
+
         void refreshCache();              // compute arrays and update cache
         void readCache();                 // just read from saved file and setup arrays
+        void readCache(const QByteArray &cpx); // setup arrays from the contents of a cpx file
         void serialize(QDataStream *out); // write to file
 
         void compute();             // compute all arrays
@@ -362,6 +370,70 @@ class RideFileCache
         QVector<float> wbalTimeInZone;      // time in zone in seconds
 };
 
+// The cpx pack holds a copy of every .cpx file in a cache directory in
+// a single append only file. Aggregating across rides then walks one
+// memory mapped file instead of opening, reading a header from and
+// seeking within thousands of small files.
+//
+// The .cpx files are still written and remain the master copy, each is
+// appended to the pack when it is written and rides cached before the
+// pack existed are added the first time their .cpx is read.
+//
+//   header  "GCPK", u32 pack version, u32 RideFileCacheVersion
+//   entry   u32 name length, name (utf8), u32 cpx length, cpx contents
+//
+// The cpx contents start with a RideFileCacheHeader whose counts are
+// the offset table for the series that follow it. A ride that is written
+// again is appended and the newest copy wins, a zero length entry marks
+// it as deleted. Once more than half of the pack is superseded it is
+// compacted in the background. Local caches, so native endianness.
+//
+#define CPXPACK_VERSION 1
+
+class CpxPack
+{
+    public:
+        // there is one pack per cache directory
+        static CpxPack *instance(QString cacheDir);
+
+        // name is the base name of the ride / cpx file
+        void store(QString name, const QByteArray &cpx);
+        void remove(QString name);
+
+        // a copy of the cpx contents, empty if the ride isn't packed
+        QByteArray cpx(QString name);
+
+        // is the ride packed with the same ride file crc
+        bool contains(QString name, unsigned int crc);
+
+        // one mean max series for a ride, false if the ride isn't packed
+        bool meanMax(QString name, RideFile::SeriesType series, QVector<float> &values);
+        bool meanMaxAt(QString name, RideFile::SeriesType series, int duration, float &value);
+
+        // one mean max series for every packed ride, read in file order
+        QHash<QString, QVector<float> > meanMaxAll(RideFile::SeriesType series);
+
+        // rewrite with just the newest copy of each ride
+        void compact();
+
+    private:
+        CpxPack(QString filename);
+
+        struct Entry { qint64 offset; quint32 length; };
+
+        // all called holding the lock
+        void load();
+        bool mapped();
+        const RideFileCacheHeader *header(const Entry &entry) const;
+
+        QMutex lock;
+        QFile file;
+        uchar *map;
+        qint64 mapsize, size, garbage;
+        QHash<QString, Entry> entries;
+        bool compacting;
+};
+
 // Ride Bests in an associative array
 // used to plot peak x seconds on LTM
 
@@ -31,7 +31,7 @@ static bool doubles_equal(double a, double b)
 //----------------------------------------------------------------------
 // The public interface to the commands
 //----------------------------------------------------------------------
-RideFileCommand::RideFileCommand(RideFile *ride) : ride(ride), stackptr(0), inLUW(false), luw(NULL)
+RideFileCommand::RideFileCommand(RideFile *ride) : ride(ride), stackptr(0), inLUW(false), luw(NULL), run(NULL), historybytes(0)
 {
     connect(ride, SIGNAL(saved()), this, SLOT(clearHistory()));
     connect(ride, SIGNAL(reverted()), this, SLOT(clearHistory()));
@@ -45,8 +45,19 @@ RideFileCommand::~RideFileCommand()
 void
 RideFileCommand::setPointValue(int index, RideFile::SeriesType series, double value)
 {
-    SetPointValueCommand *cmd = new SetPointValueCommand(ride, index, series,
-                                    ride->getPointValue(index, series), value);
+    double current = ride->getPointValue(index, series);
+
+    // bulk edits are packed into runs, not a command per cell
+    if (inLUW) {
+        if (run && run->extend(index, series, current, value)) {
+            if (!doubles_equal(current, value)) ride->setPointValue(index, series, value);
+        } else {
+            doCommand(new SetPointValuesCommand(ride, index, series, current, value));
+        }
+        return;
+    }
+
+    SetPointValueCommand *cmd = new SetPointValueCommand(ride, index, series, current, value);
     doCommand(cmd);
 }
 
@@ -73,10 +84,9 @@ RideFileCommand::deletePoints(int index, int count)
 void
 RideFileCommand::deleteXDataPoints(QString xdata, int index, int count)
 {
-    QVector<XDataPoint*> current;
+    QVector<XDataPoint> current;
     for(int i=0; i< count; i++) {
-        XDataPoint *point = ride->xdata(xdata)->datapoints[index+i];
-        current.append(point);
+        current.append(ride->xdata(xdata)->point(index+i));
     }
     DeleteXDataPointsCommand *cmd = new DeleteXDataPointsCommand(ride, xdata , index, count, current);
     doCommand(cmd);
@@ -90,7 +100,7 @@ RideFileCommand::insertPoint(int index, RideFilePoint *points)
 }
 
 void
-RideFileCommand::insertXDataPoint(QString xdata, int index, XDataPoint *points)
+RideFileCommand::insertXDataPoint(QString xdata, int index, const XDataPoint &points)
 {
     InsertXDataPointCommand *cmd = new InsertXDataPointCommand(ride, xdata, index, points);
     doCommand(cmd);
@@ -114,7 +124,7 @@ RideFileCommand::setDataPresent(RideFile::SeriesType type, bool newvalue)
 QString
 RideFileCommand::changeLog()
 {
-    QString log;
+    QString log = trimmedlog;
     for (int i=0; i<stackptr; i++) {
         if (stack[i]->type != RideCommand::NoOp)
             log += stack[i]->description + '\n';
@@ -159,9 +169,9 @@ RideFileCommand::setXDataPointValue(QString xdata, int row, int column, double v
 
     double ovalue = 0;
     switch(column) {
-        case 0: ovalue = series->datapoints[row]->secs; break;
-        case 1: ovalue = series->datapoints[row]->km; break;
-        default: ovalue = series->datapoints[row]->number[column-2]; break;
+        case 0: ovalue = series->secs(row); break;
+        case 1: ovalue = series->km(row); break;
+        default: ovalue = series->value(row, column-2); break;
     }
 
     SetXDataPointValueCommand *cmd = new  SetXDataPointValueCommand(ride, xdata, row, column, ovalue, value);
@@ -169,12 +179,12 @@ RideFileCommand::setXDataPointValue(QString xdata, int row, int column, double v
 }
 
 void
-RideFileCommand::appendXDataPoints(QString _xdata, QVector <XDataPoint *> newRows)
+RideFileCommand::appendXDataPoints(QString _xdata, QVector <XDataPoint> newRows)
 {
     XDataSeries *series = ride->xdata(_xdata);
     if (!series) return;
 
-    AppendXDataPointsCommand *cmd = new AppendXDataPointsCommand(ride, _xdata, series->datapoints.count(), newRows);
+    AppendXDataPointsCommand *cmd = new AppendXDataPointsCommand(ride, _xdata, series->count(), newRows);
     doCommand(cmd);
 }
 
@@ -187,6 +197,26 @@ RideFileCommand::clearHistory()
     foreach (RideCommand *cmd, stack) delete cmd;
     stack.clear();
     stackptr = 0;
+    historybytes = 0;
+    trimmedlog.clear();
+}
+
+void
+RideFileCommand::trimHistory()
+{
+    // drop the oldest commands, but always keep the last one
+    // so a single huge edit can still be undone
+    int trim = 0;
+    while (historybytes > RIDEFILECOMMAND_HISTORY && trim < stackptr-1) {
+        RideCommand *cmd = stack[trim++];
+        if (cmd->type != RideCommand::NoOp) trimmedlog += cmd->description + '\n';
+        historybytes -= cmd->bytes();
+        delete cmd;
+    }
+    if (trim) {
+        stack.remove(0, trim);
+        stackptr -= trim;
+    }
 }
 
 void
@@ -194,19 +224,45 @@ RideFileCommand::startLUW(QString name)
 {
     luw = new LUWCommand(this, name, ride);
     inLUW = true;
+    run = NULL;
     beginCommand(false, luw);
 }
 
+void
+RideFileCommand::closeRun()
+{
+    // the end of a run is only signalled once it is complete
+    if (run) {
+        RideCommand *cmd = run;
+        run = NULL;
+        endCommand(false, cmd);
+    }
+}
+
 void
 RideFileCommand::endLUW()
 {
     if (inLUW == false) return; // huh?
+    closeRun();
     inLUW = false;
 
     // add to the stack if it isn't empty
     if (luw->worklist.count()) doCommand(luw, true);
 }
 
+// only point values were set, so RideFile::setPointValue() has
+// already marked the derived series that read them as out of date
+static bool
+valuesOnly(RideCommand *cmd)
+{
+    if (cmd->type == RideCommand::SetPointValue || cmd->type == RideCommand::SetPointValues) return true;
+    if (cmd->type != RideCommand::LUW) return false;
+
+    foreach(RideCommand *c, static_cast<LUWCommand*>(cmd)->worklist)
+        if (!valuesOnly(c)) return false;
+    return true;
+}
+
 void
 RideFileCommand::doCommand(RideCommand *cmd, bool noexec)
 {
@@ -216,22 +272,30 @@ RideFileCommand::doCommand(RideCommand *cmd, bool noexec)
     // is collected by each command as it is
     // created.
     if (inLUW) {
+        closeRun();
         luw->addCommand(cmd);
         beginCommand(false, cmd);
         cmd->doCommand(); // luw must be executed as added!!!
         cmd->docount++;
-        endCommand(false, cmd);
+
+        // a run stays open to be extended, see setPointValue
+        if (cmd->type == RideCommand::SetPointValues) run = (SetPointValuesCommand*)cmd;
+        else endCommand(false, cmd);
         return;
     }
 
     // place onto stack
     if (stack.count()) {
         // wipe away commands we can no longer redo
-        for (int i=stackptr; i<stack.count(); i++) delete stack.at(i);
+        for (int i=stackptr; i<stack.count(); i++) {
+            historybytes -= stack.at(i)->bytes();
+            delete stack.at(i);
+        }
         stack.remove(stackptr, stack.count() - stackptr);
     }
     stack.append(cmd);
     stackptr++;
+    historybytes += cmd->bytes();
 
     if (noexec == false) {
         beginCommand(false, cmd); // signal
@@ -240,8 +304,10 @@ RideFileCommand::doCommand(RideCommand *cmd, bool noexec)
     cmd->docount++;
     endCommand(false, cmd); // signal - even if LUW
 
+    trimHistory();
+
     // we changed it!
-    ride->emitModified();
+    ride->emitModified(valuesOnly(cmd));
 }
 
 void
@@ -334,6 +400,14 @@ LUWCommand::undoCommand()
     return true;
 }
 
+qint64
+LUWCommand::bytes() const
+{
+    qint64 total = sizeof(*this);
+    foreach(RideCommand *cmd, worklist) total += cmd->bytes();
+    return total;
+}
+
 // Set point value
 SetPointValueCommand::SetPointValueCommand(RideFile *ride, int row,
             RideFile::SeriesType series, double oldvalue, double newvalue) :
@@ -363,6 +437,76 @@ SetPointValueCommand::undoCommand()
     return true;
 }
 
+// Set runs of point values
+SetPointValuesCommand::SetPointValuesCommand(RideFile *ride, int row,
+            RideFile::SeriesType series, double oldvalue, double newvalue) :
+            RideCommand(ride) // base class looks after these
+{
+    type = RideCommand::SetPointValues;
+    description = tr("Set Values");
+    extend(row, series, oldvalue, newvalue);
+}
+
+bool
+SetPointValuesCommand::extend(int row, RideFile::SeriesType series, double oldvalue, double newvalue)
+{
+    // one run per series, so no cell can be set twice and
+    // the order runs are undone in doesn't matter
+    for (int i=0; i<columns.count(); i++) {
+        Column &c = columns[i];
+        if (c.series != series) continue;
+        if (row <= c.rows.last()) return false;
+
+        c.rows.append(row);
+        c.oldvalues.append(oldvalue);
+        c.newvalues.append(newvalue);
+        return true;
+    }
+    if (columns.count() >= SETPOINTVALUES_MAXCOLUMNS) return false;
+
+    Column add;
+    add.series = series;
+    add.rows.append(row);
+    add.oldvalues.append(oldvalue);
+    add.newvalues.append(newvalue);
+    columns.append(add);
+    return true;
+}
+
+bool
+SetPointValuesCommand::doCommand()
+{
+    foreach(const Column &c, columns) {
+        const int *r = c.rows.constData();
+        const double *o = c.oldvalues.constData();
+        const double *n = c.newvalues.constData();
+        for (int i=0; i<c.rows.count(); i++)
+            if (!doubles_equal(o[i], n[i])) ride->setPointValue(r[i], c.series, n[i]);
+    }
+    return true;
+}
+
+bool
+SetPointValuesCommand::undoCommand()
+{
+    foreach(const Column &c, columns) {
+        const int *r = c.rows.constData();
+        const double *o = c.oldvalues.constData();
+        const double *n = c.newvalues.constData();
+        for (int i=0; i<c.rows.count(); i++)
+            if (!doubles_equal(o[i], n[i])) ride->setPointValue(r[i], c.series, o[i]);
+    }
+    return true;
+}
+
+qint64
+SetPointValuesCommand::bytes() const
+{
+    qint64 total = sizeof(*this);
+    foreach(const Column &c, columns) total += sizeof(Column) + c.rows.count() * (sizeof(int) + 2 * sizeof(double));
+    return total;
+}
+
 // Remove a point
 DeletePointCommand::DeletePointCommand(RideFile *ride, int row, RideFilePoint point) :
         RideCommand(ride), // base class looks after these
@@ -541,18 +685,9 @@ RemoveXDataSeriesCommand::doCommand()
     index = series->valuename.indexOf(name);
     if (index == -1) return false;
 
-    // snaffle away the data and clear
-    values.resize(series->datapoints.count());
-    for(int i=0; i<series->datapoints.count(); i++) {
-        values[i] = series->datapoints[i]->number[index];
-        series->datapoints[i]->number[index] = 0;
-
-        // shift the values down
-        for(int j=index+1; j<8; j++) {
-            series->datapoints[i]->number[j-1] =
-            series->datapoints[i]->number[j];
-        }
-    }
+    // snaffle away the data and shift the values down
+    values = series->column(index);
+    series->removeColumn(index);
 
     // remove the name
     series->valuename.removeAt(index);
@@ -571,15 +706,9 @@ RemoveXDataSeriesCommand::undoCommand()
 
     series->valuename.insert(index, name);
 
-    // put data back
-    for(int i=0; i<series->datapoints.count(); i++) {
-        // shift the values right
-        for(int j=index; j<7; j++) {
-            series->datapoints[i]->number[j+1] =
-            series->datapoints[i]->number[j];
-        }
-        series->datapoints[i]->number[index] = values[i];
-    }
+    // shift the values right and put data back
+    series->insertColumn(index);
+    series->setColumn(index, values);
     return true;
 }
 
@@ -603,9 +732,7 @@ AddXDataSeriesCommand::doCommand()
     if (index == -1) return false;
 
     // Clear the value
-    for(int i=0; i<series->datapoints.count(); i++) {
-        series->datapoints[i]->number[index] = 0;
-    }
+    series->setColumn(index, QVector<double>(series->count(), 0));
 
     return true;
 }
@@ -638,13 +765,13 @@ SetXDataPointValueCommand::doCommand()
     if (series && !doubles_equal(oldvalue, newvalue)) {
         switch(col){
         case 0:
-            series->datapoints[row]->secs = newvalue;
+            series->setSecs(row, newvalue);
             break;
         case 1:
-            series->datapoints[row]->km = newvalue;
+            series->setKm(row, newvalue);
             break;
         default:
-            series->datapoints[row]->number[col-2] = newvalue;
+            series->setValue(row, col-2, newvalue);
         }
     }
     return true;
@@ -656,13 +783,13 @@ SetXDataPointValueCommand::undoCommand()
     if (series && !doubles_equal(oldvalue, newvalue)) {
         switch(col){
         case 0:
-            series->datapoints[row]->secs = oldvalue;
+            series->setSecs(row, oldvalue);
             break;
         case 1:
-            series->datapoints[row]->km = oldvalue;
+            series->setKm(row, oldvalue);
             break;
         default:
-            series->datapoints[row]->number[col-2] = oldvalue;
+            series->setValue(row, col-2, oldvalue);
         }
     }
     return true;
@@ -670,7 +797,7 @@ SetXDataPointValueCommand::undoCommand()
 
 // Remove points
 DeleteXDataPointsCommand::DeleteXDataPointsCommand(RideFile *ride, QString xdata, int row, int count,
-                     QVector<XDataPoint *> current) :
+                     QVector<XDataPoint> current) :
         RideCommand(ride), // base class looks after these
         xdata(xdata), row(row), count(count), points(current)
 {
@@ -693,7 +820,7 @@ DeleteXDataPointsCommand::undoCommand()
 }
 
 // Insert a point
-InsertXDataPointCommand::InsertXDataPointCommand(RideFile *ride, QString xdata, int row, XDataPoint *point) :
+InsertXDataPointCommand::InsertXDataPointCommand(RideFile *ride, QString xdata, int row, const XDataPoint &point) :
         RideCommand(ride), // base class looks after these
         xdata(xdata), row(row), point(point)
 {
@@ -716,7 +843,7 @@ InsertXDataPointCommand::undoCommand()
 }
 
 // Append points
-AppendXDataPointsCommand::AppendXDataPointsCommand(RideFile *ride, QString xdata, int row, QVector<XDataPoint*> points) :
+AppendXDataPointsCommand::AppendXDataPointsCommand(RideFile *ride, QString xdata, int row, QVector<XDataPoint> points) :
         RideCommand(ride), // base class looks after these
         xdata(xdata), row(row), count(points.count()), points(points)
 {
@@ -35,6 +35,11 @@
 //                           for undo/redo functionality
 class RideCommand;
 class LUWCommand;
+class SetPointValuesCommand;
+
+// the undo history is trimmed from the oldest command
+// once the commands on it hold more than this many bytes
+#define RIDEFILECOMMAND_HISTORY (64*1024*1024)
 
 class RideFileCommand : public QObject
 {
@@ -62,8 +67,8 @@ class RideFileCommand : public QObject
         void addXDataSeries(QString xdata, QString name, QString unit);
         void setXDataPointValue(QString xdata, int row, int column, double value);
         void deleteXDataPoints(QString xdata, int index, int count);
-        void insertXDataPoint(QString xdata, int index, XDataPoint *point);
-        void appendXDataPoints(QString xdata, QVector<XDataPoint*> rows);
+        void insertXDataPoint(QString xdata, int index, const XDataPoint &point);
+        void appendXDataPoints(QString xdata, QVector<XDataPoint> rows);
 
         // execute atomic actions
         void doCommand(RideCommand*, bool noexec=false);
@@ -91,11 +96,17 @@ class RideFileCommand : public QObject
         void emitEndCommand(bool, RideCommand *cmd);
 
     private:
+        void closeRun();
+        void trimHistory();
+
         RideFile *ride;
         QVector<RideCommand *> stack;
         int stackptr;
         bool inLUW;
         LUWCommand *luw;
+        SetPointValuesCommand *run; // open run of values in the LUW
+        qint64 historybytes;
+        QString trimmedlog; // changelog of commands trimmed from history
 };
 
 // The Command itself, as a base class with
@@ -104,7 +115,7 @@ class RideCommand
 {
     public:
         // supported command types
-        enum commandtype { NoOp, LUW, SetPointValue, DeletePoint, DeletePoints, InsertPoint, AppendPoints, SetDataPresent,
+        enum commandtype { NoOp, LUW, SetPointValue, SetPointValues, DeletePoint, DeletePoints, InsertPoint, AppendPoints, SetDataPresent,
                            removeXData, addXData, RemoveXDataSeries, AddXDataSeries,
                            SetXDataPointValue, DeleteXDataPoints, InsertXDataPoint, AppendXDataPoints };
         typedef enum commandtype CommandType;
@@ -115,6 +126,9 @@ class RideCommand
         virtual bool doCommand() { return true; }
         virtual bool undoCommand() { return true; }
 
+        // roughly how much memory the command holds
+        virtual qint64 bytes() const { return sizeof(*this); }
+
         // state of selection model -- if passed at all
         CommandType type;
         QString description;
@@ -134,6 +148,7 @@ class LUWCommand : public RideCommand
         void addCommand(RideCommand *cmd) { worklist.append(cmd); }
         bool doCommand();
         bool undoCommand();
+        qint64 bytes() const;
 
         QVector<RideCommand*> worklist;
         RideFileCommand *commander;
@@ -174,6 +189,7 @@ class RemoveXDataSeriesCommand : public RideCommand
         RemoveXDataSeriesCommand(RideFile *ride, QString xdata, QString name);
         bool doCommand();
         bool undoCommand();
+        qint64 bytes() const { return sizeof(*this) + values.count() * sizeof(double); }
 
         // state
         QString xdata, name;
@@ -202,6 +218,7 @@ class SetPointValueCommand : public RideCommand
         SetPointValueCommand(RideFile *ride, int row, RideFile::SeriesType series, double oldvalue, double newvalue);
         bool doCommand();
         bool undoCommand();
+        qint64 bytes() const { return sizeof(*this); }
 
         // state
         int row;
@@ -209,6 +226,38 @@ class SetPointValueCommand : public RideCommand
         double oldvalue, newvalue;
 };
 
+// Bulk edits within a LUW (fix tools, python, paste) set values
+// a row at a time, rather than a command per cell they are packed
+// into runs for each series, with the rows and the old and new
+// values held in flat arrays. Rows need not be consecutive, fixes
+// often only touch the odd sample, but must ascend; a run is
+// extended until a cell comes before the end of the run for its
+// series, then a new command is started.
+#define SETPOINTVALUES_MAXCOLUMNS 16
+
+class SetPointValuesCommand : public RideCommand
+{
+    Q_DECLARE_TR_FUNCTIONS(SetPointValuesCommand)
+
+    public:
+        SetPointValuesCommand(RideFile *ride, int row, RideFile::SeriesType series, double oldvalue, double newvalue);
+        bool doCommand();
+        bool undoCommand();
+        qint64 bytes() const;
+
+        // add the next cell to a run, false if it doesn't come after
+        // the run and needs a new command. does not change the ride.
+        bool extend(int row, RideFile::SeriesType series, double oldvalue, double newvalue);
+
+        // state
+        struct Column {
+            RideFile::SeriesType series;
+            QVector<int> rows; // ascending
+            QVector<double> oldvalues, newvalues;
+        };
+        QVector<Column> columns;
+};
+
 class SetXDataPointValueCommand : public RideCommand
 {
     Q_DECLARE_TR_FUNCTIONS(SetXDataPointValueCommand)
@@ -229,15 +278,16 @@ class DeleteXDataPointsCommand : public RideCommand
     Q_DECLARE_TR_FUNCTIONS(DeletePointsCommand)
 
     public:
-        DeleteXDataPointsCommand(RideFile *ride, QString xdata, int row, int count, QVector<XDataPoint*> current);
+        DeleteXDataPointsCommand(RideFile *ride, QString xdata, int row, int count, QVector<XDataPoint> current);
         bool doCommand();
         bool undoCommand();
+        qint64 bytes() const { return sizeof(*this) + points.count() * sizeof(XDataPoint); }
 
         // state
         QString xdata;
         int row;
         int count;
-        QVector<XDataPoint*> points;
+        QVector<XDataPoint> points;
 };
 class DeletePointCommand : public RideCommand
 {
@@ -247,6 +297,7 @@ class DeletePointCommand : public RideCommand
         DeletePointCommand(RideFile *ride, int row, RideFilePoint point);
         bool doCommand();
         bool undoCommand();
+        qint64 bytes() const { return sizeof(*this); }
 
         // state
         int row;
@@ -262,6 +313,7 @@ class DeletePointsCommand : public RideCommand
             QVector<RideFilePoint> current);
         bool doCommand();
         bool undoCommand();
+        qint64 bytes() const { return sizeof(*this) + points.count() * sizeof(RideFilePoint); }
 
         // state
         int row;
@@ -287,14 +339,14 @@ class InsertXDataPointCommand : public RideCommand
     Q_DECLARE_TR_FUNCTIONS(InsertXDataPointCommand)
 
     public:
-        InsertXDataPointCommand(RideFile *ride, QString xdata, int row, XDataPoint *point);
+        InsertXDataPointCommand(RideFile *ride, QString xdata, int row, const XDataPoint &point);
         bool doCommand();
         bool undoCommand();
 
         // state
         QString xdata;
         int row;
-        XDataPoint *point;
+        XDataPoint point;
 };
 class AppendPointsCommand : public RideCommand
 {
@@ -304,6 +356,7 @@ class AppendPointsCommand : public RideCommand
         AppendPointsCommand(RideFile *ride, int row, QVector<RideFilePoint> points);
         bool doCommand();
         bool undoCommand();
+        qint64 bytes() const { return sizeof(*this) + points.count() * sizeof(RideFilePoint); }
 
         int row, count;
         QVector<RideFilePoint> points;
@@ -313,13 +366,14 @@ class AppendXDataPointsCommand : public RideCommand
     Q_DECLARE_TR_FUNCTIONS(AppendXDataPointsCommand)
 
     public:
-        AppendXDataPointsCommand(RideFile *ride, QString xdata, int row, QVector<XDataPoint*> points);
+        AppendXDataPointsCommand(RideFile *ride, QString xdata, int row, QVector<XDataPoint> points);
         bool doCommand();
         bool undoCommand();
+        qint64 bytes() const { return sizeof(*this) + points.count() * sizeof(XDataPoint); }
 
         QString xdata;
         int row, count;
-        QVector<XDataPoint *> points;
+        QVector<XDataPoint> points;
 };
 class SetDataPresentCommand : public RideCommand
 {
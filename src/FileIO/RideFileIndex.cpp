@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "RideFileIndex.h"
+
+#include <limits>
+
+RideFileIndex::RideFileIndex(const RideFile *ride) : ride(ride), points(ride->dataPoints().count())
+{
+}
+
+RideFileIndex::~RideFileIndex()
+{
+    qDeleteAll(series);
+}
+
+RideFileIndex::Series *
+RideFileIndex::index(RideFile::SeriesType type, bool tables)
+{
+    Series *s = series.value(type, NULL);
+
+    if (s == NULL) {
+
+        s = new Series;
+        s->sum.resize(points+1);
+        s->positive.resize(points+1);
+        s->zero.resize(points+1);
+
+        s->sum[0] = 0;
+        s->positive[0] = s->zero[0] = 0;
+        for (int i=0; i<points; i++) {
+            double v = ride->dataPoints()[i]->value(type);
+            s->sum[i+1] = s->sum[i] + (v > 0 ? v : 0);
+            s->positive[i+1] = s->positive[i] + (v > 0 ? 1 : 0);
+            s->zero[i+1] = s->zero[i] + (v == 0 ? 1 : 0);
+        }
+        series.insert(type, s);
+    }
+
+    if (tables && !s->tables && points) {
+
+        // level 0 is the samples themselves, non-positive values
+        // are never the minimum we're after
+        const double none = std::numeric_limits<double>::max();
+        s->max.resize(1);
+        s->min.resize(1);
+        s->max[0].resize(points);
+        s->min[0].resize(points);
+        for (int i=0; i<points; i++) {
+            double v = ride->dataPoints()[i]->value(type);
+            s->max[0][i] = v;
+            s->min[0][i] = v > 0 ? v : none;
+        }
+
+        // level k covers runs of 2^k samples, from two runs of 2^(k-1)
+        for (int k=1, len=2; len <= points; k++, len *= 2) {
+            const QVector<double> &pmax = s->max[k-1];
+            const QVector<double> &pmin = s->min[k-1];
+            QVector<double> kmax(points-len+1), kmin(points-len+1);
+            for (int i=0; i+len <= points; i++) {
+                kmax[i] = qMax(pmax[i], pmax[i+len/2]);
+                kmin[i] = qMin(pmin[i], pmin[i+len/2]);
+            }
+            s->max << kmax;
+            s->min << kmin;
+        }
+        s->tables = true;
+    }
+    return s;
+}
+
+// the largest k where 2^k <= len
+static int level(int len)
+{
+    int k = 0;
+    while ((2 << k) <= len) k++;
+    return k;
+}
+
+// build the tables once they'd cost less than carrying on scanning
+bool
+RideFileIndex::useTables(RideFile::SeriesType type, Series *s)
+{
+    if (s->tables) return true;
+    if (s->scans++ < level(points) + 1) return false;
+
+    index(type, true);
+    return true;
+}
+
+int
+RideFileIndex::count(RideFile::SeriesType type, int start, int stop, bool zeroes)
+{
+    if (start < 0 || stop < start || stop >= points) return 0;
+
+    Series *s = index(type, false);
+    int returning = s->positive[stop+1] - s->positive[start];
+    if (zeroes) returning += s->zero[stop+1] - s->zero[start];
+    return returning;
+}
+
+double
+RideFileIndex::sum(RideFile::SeriesType type, int start, int stop)
+{
+    if (start < 0 || stop < start || stop >= points) return 0;
+
+    Series *s = index(type, false);
+    return s->sum[stop+1] - s->sum[start];
+}
+
+double
+RideFileIndex::max(RideFile::SeriesType type, int start, int stop)
+{
+    if (start < 0 || stop < start || stop >= points) return 0;
+
+    Series *s = index(type, false);
+    if (!useTables(type, s)) {
+        double returning = ride->dataPoints()[start]->value(type);
+        for (int i=start+1; i<=stop; i++) returning = qMax(returning, ride->dataPoints()[i]->value(type));
+        return returning;
+    }
+
+    int k = level(stop - start + 1);
+    return qMax(s->max[k][start], s->max[k][stop - (1<<k) + 1]);
+}
+
+double
+RideFileIndex::minPositive(RideFile::SeriesType type, int start, int stop)
+{
+    if (start < 0 || stop < start || stop >= points) return 0;
+
+    Series *s = index(type, false);
+    if (!useTables(type, s)) {
+        double returning = 0;
+        for (int i=start; i<=stop; i++) {
+            double v = ride->dataPoints()[i]->value(type);
+            if (v > 0 && (returning == 0 || v < returning)) returning = v;
+        }
+        return returning;
+    }
+
+    int k = level(stop - start + 1);
+    double returning = qMin(s->min[k][start], s->min[k][stop - (1<<k) + 1]);
+    return returning == std::numeric_limits<double>::max() ? 0 : returning;
+}
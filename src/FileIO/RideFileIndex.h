@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef _GC_RideFileIndex_h
+#define _GC_RideFileIndex_h 1
+
+#include "RideFile.h"
+
+#include <QVector>
+#include <QHash>
+
+//
+// Answers queries over a range of samples without iterating them, used
+// when computing metrics for the intervals of a ride, of which there can
+// easily be a hundred or more.
+//
+// For each series that is asked about we keep prefix sums and counts of
+// the positive values and of the zeroes, so sums, counts and averages for
+// any range come from a couple of lookups. Maximum and minimum come from
+// sparse tables; a table per power of two length holding the max or min
+// of the run of that length starting at each sample, any range is covered
+// by two (overlapping) runs.
+//
+// The tables take n log n memory and about as long to build as log n
+// scans of the whole ride, so the first few max/min queries on a series
+// just scan their range and the tables are only built for rides with
+// enough intervals to pay for them.
+//
+// Ranges are sample indexes, inclusive, as RideFileIterator firstIndex()
+// and lastIndex(). Series are indexed when first asked about, the ride
+// must not change whilst the index is in use.
+//
+class RideFileIndex
+{
+    public:
+        RideFileIndex(const RideFile *ride);
+        ~RideFileIndex();
+
+        const RideFile *rideFile() const { return ride; }
+        int count() const { return points; }
+
+        // how many samples have a value > 0, or >= 0 if zeroes is true
+        int count(RideFile::SeriesType series, int start, int stop, bool zeroes=false);
+
+        // sum of the values > 0
+        double sum(RideFile::SeriesType series, int start, int stop);
+
+        // largest value, and the smallest value > 0, or 0 if there isn't one
+        double max(RideFile::SeriesType series, int start, int stop);
+        double minPositive(RideFile::SeriesType series, int start, int stop);
+
+    private:
+        struct Series {
+            Series() : tables(false), scans(0) {}
+
+            // prefix, element i covers samples [0, i)
+            QVector<double> sum;
+            QVector<int> positive, zero;
+
+            // sparse tables, built once scans max/min queries
+            // have been answered by scanning the samples
+            bool tables;
+            int scans;
+            QVector<QVector<double> > max, min;
+        };
+
+        Series *index(RideFile::SeriesType series, bool tables);
+        bool useTables(RideFile::SeriesType series, Series *s);
+
+        const RideFile *ride;
+        int points;
+        QHash<int, Series*> series;
+};
+
+#endif // _GC_RideFileIndex_h
@@ -428,6 +428,16 @@ RideFileTableModel::endCommand(bool undo, RideCommand *cmd)
             dataChanged(cell, cell);
             break;
         }
+        case RideCommand::SetPointValues:
+        {
+            SetPointValuesCommand *spv = (SetPointValuesCommand*)cmd;
+            foreach(const SetPointValuesCommand::Column &c, spv->columns) {
+                int column = headingsType.indexOf(c.series);
+                if (column < 0) continue;
+                dataChanged(index(c.rows.first(), column), index(c.rows.last(), column));
+            }
+            break;
+        }
         case RideCommand::InsertPoint:
             if (!undo) endInsertRows();
             else endRemoveRows();
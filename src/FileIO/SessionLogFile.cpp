@@ -0,0 +1,327 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "SessionLogFile.h"
+#include "CsvRideFile.h" // for vo2 and r-r companion files
+
+#include <QtEndian>
+#include <QFileInfo>
+#include <cmath>
+#include <string.h>
+
+static int sessionLogFileReaderRegistered =
+    RideFileFactory::instance().registerReader(
+        "gcsl", "GoldenCheetah Session Log", new SessionLogFileReader());
+
+// 2 x u32, 14 x float and 4 x double
+#define SAMPLE_PAYLOAD_SIZE (2*4 + 14*4 + 4*8)
+
+//
+// little endian helpers
+//
+static inline void putU32(char *&p, quint32 v) { qToLittleEndian<quint32>(v, p); p += 4; }
+static inline void putU64(char *&p, quint64 v) { qToLittleEndian<quint64>(v, p); p += 8; }
+static inline void putFloat(char *&p, float v) { quint32 b; memcpy(&b, &v, 4); putU32(p, b); }
+static inline void putDouble(char *&p, double v) { quint64 b; memcpy(&b, &v, 8); putU64(p, b); }
+
+static inline quint32 getU32(const char *&p) { quint32 v = qFromLittleEndian<quint32>(p); p += 4; return v; }
+static inline quint64 getU64(const char *&p) { quint64 v = qFromLittleEndian<quint64>(p); p += 8; return v; }
+static inline float getFloat(const char *&p) { quint32 b = getU32(p); float v; memcpy(&v, &b, 4); return v; }
+static inline double getDouble(const char *&p) { quint64 b = getU64(p); double v; memcpy(&v, &b, 8); return v; }
+
+//
+// SessionLog
+//
+quint16
+SessionLog::checksum(const char *data, int length)
+{
+#if QT_VERSION < 0x060000
+    return qChecksum(data, length);
+#else
+    return qChecksum(QByteArrayView(data, length));
+#endif
+}
+
+QByteArray
+SessionLog::header(QDateTime start, int interval)
+{
+    QByteArray returning(SESSIONLOG_HEADER_SIZE, 0);
+    char *p = returning.data();
+
+    memcpy(p, "GCSL", 4);
+    qToLittleEndian<quint16>(SESSIONLOG_VERSION, p+4);
+    qToLittleEndian<quint16>(interval, p+6);
+    qToLittleEndian<qint64>(start.toMSecsSinceEpoch(), p+8);
+
+    return returning;
+}
+
+void
+SessionLog::appendRecord(QByteArray &buffer, char type, const QByteArray &payload)
+{
+    int from = buffer.size();
+
+    char frame[3];
+    frame[0] = type;
+    qToLittleEndian<quint16>(payload.size(), frame+1);
+    buffer.append(frame, 3);
+    buffer.append(payload);
+
+    char crc[2];
+    qToLittleEndian<quint16>(checksum(buffer.constData() + from, buffer.size() - from), crc);
+    buffer.append(crc, 2);
+}
+
+QByteArray
+SessionLog::encode(const SessionLogSample &sample)
+{
+    QByteArray returning(SAMPLE_PAYLOAD_SIZE, 0);
+    char *p = returning.data();
+
+    putU32(p, sample.msecs);
+    putU32(p, sample.lap);
+
+    putFloat(p, sample.cad);
+    putFloat(p, sample.hr);
+    putFloat(p, sample.kph);
+    putFloat(p, sample.watts);
+    putFloat(p, sample.load);
+    putFloat(p, sample.lrbalance);
+    putFloat(p, sample.lte);
+    putFloat(p, sample.rte);
+    putFloat(p, sample.lps);
+    putFloat(p, sample.rps);
+    putFloat(p, sample.smo2);
+    putFloat(p, sample.thb);
+    putFloat(p, sample.o2hb);
+    putFloat(p, sample.hhb);
+
+    // distance and location need full precision
+    putDouble(p, sample.km);
+    putDouble(p, sample.alt);
+    putDouble(p, sample.lon);
+    putDouble(p, sample.lat);
+
+    return returning;
+}
+
+bool
+SessionLog::decode(const char *p, int length, SessionLogSample &sample)
+{
+    if (length < SAMPLE_PAYLOAD_SIZE) return false;
+
+    sample.msecs = getU32(p);
+    sample.lap = getU32(p);
+
+    sample.cad = getFloat(p);
+    sample.hr = getFloat(p);
+    sample.kph = getFloat(p);
+    sample.watts = getFloat(p);
+    sample.load = getFloat(p);
+    sample.lrbalance = getFloat(p);
+    sample.lte = getFloat(p);
+    sample.rte = getFloat(p);
+    sample.lps = getFloat(p);
+    sample.rps = getFloat(p);
+    sample.smo2 = getFloat(p);
+    sample.thb = getFloat(p);
+    sample.o2hb = getFloat(p);
+    sample.hhb = getFloat(p);
+
+    sample.km = getDouble(p);
+    sample.alt = getDouble(p);
+    sample.lon = getDouble(p);
+    sample.lat = getDouble(p);
+
+    return true;
+}
+
+int
+SessionLog::validLength(const QByteArray &data, bool &ended)
+{
+    ended = false;
+
+    const char *base = data.constData();
+    if (data.size() < SESSIONLOG_HEADER_SIZE || memcmp(base, "GCSL", 4)) return 0;
+
+    int offset = SESSIONLOG_HEADER_SIZE;
+    while (offset + 5 <= data.size()) {
+
+        int length = qFromLittleEndian<quint16>(base + offset + 1);
+        if (offset + 5 + length > data.size()) break;
+
+        quint16 crc = qFromLittleEndian<quint16>(base + offset + 3 + length);
+        if (crc != checksum(base + offset, 3 + length)) break;
+
+        char type = base[offset];
+        offset += 5 + length;
+
+        if (type == End) {
+            ended = true;
+            break;
+        }
+    }
+    return offset;
+}
+
+bool
+SessionLog::isComplete(QString filename)
+{
+    QFile file(filename);
+    if (!file.open(QFile::ReadOnly)) return false;
+
+    bool ended;
+    validLength(file.readAll(), ended);
+    return ended;
+}
+
+bool
+SessionLog::finish(QString filename)
+{
+    QFile file(filename);
+    if (!file.open(QFile::ReadWrite)) return false;
+
+    bool ended;
+    int length = validLength(file.readAll(), ended);
+    if (length == 0) return false;
+    if (ended) return true;
+
+    QByteArray end;
+    appendRecord(end, End, QByteArray());
+
+    file.resize(length);
+    file.seek(length);
+    return file.write(end) == end.size();
+}
+
+//
+// SessionLogFileReader
+//
+RideFile *
+SessionLogFileReader::openRideFile(QFile &file, QStringList &errors, QList<RideFile*>*) const
+{
+    if (!file.open(QFile::ReadOnly)) {
+        errors << ("Could not open ride file: \"" + file.fileName() + "\"");
+        return NULL;
+    }
+    QByteArray data = file.readAll();
+    file.close();
+
+    const char *base = data.constData();
+    if (data.size() < SESSIONLOG_HEADER_SIZE || memcmp(base, "GCSL", 4)) {
+        errors << ("Not a session log: \"" + file.fileName() + "\"");
+        return NULL;
+    }
+    int version = qFromLittleEndian<quint16>(base+4);
+    int interval = qFromLittleEndian<quint16>(base+6);
+    qint64 start = qFromLittleEndian<qint64>(base+8);
+    if (version > SESSIONLOG_VERSION || interval <= 0) {
+        errors << ("Unsupported session log version: \"" + file.fileName() + "\"");
+        return NULL;
+    }
+
+    RideFile *rideFile = new RideFile();
+    rideFile->setDeviceType("GoldenCheetah");
+    rideFile->setFileFormat("GoldenCheetah Session Log (gcsl)");
+    rideFile->setStartTime(QDateTime::fromMSecsSinceEpoch(start));
+    rideFile->setRecIntSecs(interval / 1000.0);
+
+    XDataSeries *trainSeries = NULL;
+
+    // walk the records, after a crash the last one may be incomplete
+    // so we stop at the first record that is truncated or corrupt
+    int offset = SESSIONLOG_HEADER_SIZE;
+    qint64 last = -1;  // last grid slot used
+    while (offset + 5 <= data.size()) {
+
+        char type = base[offset];
+        int length = qFromLittleEndian<quint16>(base + offset + 1);
+        if (offset + 5 + length > data.size()) break;
+
+        quint16 crc = qFromLittleEndian<quint16>(base + offset + 3 + length);
+        if (crc != SessionLog::checksum(base + offset, 3 + length)) break;
+
+        const char *payload = base + offset + 3;
+        offset += 5 + length;
+
+        if (type == SessionLog::End) break;
+
+        if (type == SessionLog::Name) {
+            rideFile->setTag("Route", QString::fromUtf8(payload, length));
+            continue;
+        }
+
+        SessionLogSample s;
+        if (type != SessionLog::Sample || !SessionLog::decode(payload, length, s)) continue;
+
+        // the refresh timer is never exact so samples are snapped onto
+        // the recording interval the ride declares. A sample that lands
+        // in a slot already taken moves on to the next one, unless that
+        // would put it more than an interval ahead of when it was recorded
+        qint64 slot = qRound64(double(s.msecs) / interval);
+        if (slot <= last) {
+            if ((last + 1) * interval - qint64(s.msecs) >= interval) continue;
+            slot = last + 1;
+        }
+        last = slot;
+        double secs = slot * interval / 1000.0;
+
+        rideFile->appendPoint(secs, s.cad, s.hr, s.km,
+                              s.kph, 0.0, s.watts, s.alt, s.lon, s.lat,
+                              0.0, 0.0, RideFile::NA, s.lrbalance,
+                              s.lte, s.rte, s.lps, s.rps,
+                              0.0, 0.0,
+                              0.0, 0.0, 0.0, 0.0,
+                              0.0, 0.0, 0.0, 0.0,
+                              s.smo2, s.thb,
+                              0.0, 0.0, 0.0, 0.0, s.lap);
+
+        // the target, as the gc csv format has always done
+        if (s.load > 0.0) {
+            if (trainSeries == NULL)  {
+                trainSeries = new XDataSeries();
+                trainSeries->name = "TRAIN";
+                trainSeries->valuename << "TARGET";
+                trainSeries->unitname << "Watts";
+            }
+
+            XDataPoint p;
+            p.secs = secs;
+            p.km = s.km;
+            p.number[0] = s.load;
+
+            trainSeries->append(p);
+        }
+    }
+
+    if (trainSeries) rideFile->addXData("TRAIN", trainSeries);
+
+    // less than 2 data points is not a valid ride file
+    if (rideFile->dataPoints().count() < 2) {
+        errors << "Insufficient valid data in file \"" + file.fileName() + "\". ";
+        delete rideFile;
+        return NULL;
+    }
+
+    // vo2 and r-r data are still recorded alongside as csv
+    QFileInfo info(file.fileName());
+    QString name = info.absolutePath() + "/" + info.completeBaseName();
+    CsvFileReader::readCompanionXData(rideFile, name + ".vo2", name + ".rr");
+
+    return rideFile;
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef _SessionLogFile_h
+#define _SessionLogFile_h
+#include "GoldenCheetah.h"
+
+#include "RideFile.h"
+
+#include <QByteArray>
+#include <QDateTime>
+
+//
+// The session log is what train view records to whilst a session
+// is running. It is append only and every record carries a checksum,
+// so after a crash or power cut everything up to the last complete
+// record can still be imported.
+//
+// All values are little endian:
+//
+//   header  "GCSL" u16 version, u16 sample interval in ms,
+//           s64 start time in ms since the epoch
+//
+//   record  u8 type, u16 payload length, payload,
+//           u16 checksum of type, length and payload
+//
+// Records are a sample, the workout name, a checkpoint (written
+// each time the log is synced to disk) and an end marker written
+// when the session is stopped cleanly.
+//
+#define SESSIONLOG_VERSION      1
+#define SESSIONLOG_HEADER_SIZE  16
+
+// one merged telemetry sample
+struct SessionLogSample {
+    quint32 msecs;      // session time, pauses excluded
+    qint32 lap;
+    float cad, hr, kph, watts, load;
+    float lrbalance, lte, rte, lps, rps;
+    float smo2, thb, o2hb, hhb;
+    double km, alt, lon, lat;
+};
+
+class SessionLog
+{
+    public:
+        enum recordtype { Sample='S', Name='N', Checkpoint='C', End='E' };
+
+        // the file header
+        static QByteArray header(QDateTime start, int interval);
+
+        // append a framed record to a buffer
+        static void appendRecord(QByteArray &buffer, char type, const QByteArray &payload);
+
+        // samples to and from their payload
+        static QByteArray encode(const SessionLogSample &sample);
+        static bool decode(const char *payload, int length, SessionLogSample &sample);
+
+        // checksum used to frame records
+        static quint16 checksum(const char *data, int length);
+
+        // length of the log up to the last complete record, ended
+        // is set when that record is the end marker
+        static int validLength(const QByteArray &data, bool &ended);
+
+        // a log without an end marker was left behind by a crash,
+        // finish() drops any partial record and appends the marker
+        static bool isComplete(QString filename);
+        static bool finish(QString filename);
+};
+
+struct SessionLogFileReader : public RideFileReader {
+    virtual RideFile *openRideFile(QFile &file, QStringList &errors, QList<RideFile*>* = 0) const;
+    bool hasWrite() const { return false; }
+};
+
+#endif // _SessionLogFile_h
@@ -269,13 +269,13 @@ SmlParser::endElement(const QString&, const QString&, const QString& qName)
         if (swimming && distance > 0.0 && round(time) > lastLength) {
             if (SMLdebug) qDebug() << "Time" << time << "Distance" << distance << "lastLength" << lastLength << "lastDistance" << lastDistance;
             // length-by-length Swim XData
-            XDataPoint *p = new XDataPoint();
-            p->secs = lastLength;
-            p->km = lastDistance;
-            p->number[0] = (distance > lastDistance) ? 1 + style : 0;
-            p->number[1] = time - lastLength;
-            p->number[2] = (distance > lastDistance) ? strokes : 0;
-            swimXdata->datapoints.append(p);
+            XDataPoint p;
+            p.secs = lastLength;
+            p.km = lastDistance;
+            p.number[0] = (distance > lastDistance) ? 1 + style : 0;
+            p.number[1] = time - lastLength;
+            p.number[2] = (distance > lastDistance) ? strokes : 0;
+            swimXdata->append(p);
 
             if (distance > lastDistance) {
                 double deltaSecs = round(time) - lastLength;
@@ -321,15 +321,15 @@ SmlParser::endElement(const QString&, const QString&, const QString& qName)
                 }
             }
             secs += rr;
-            XDataPoint *p = new XDataPoint();
-            p->secs = secs;
-            p->km = 0;
-            p->number[0] = rr * 1000.0;
-            hrvXdata->datapoints.append(p);
+            XDataPoint p;
+            p.secs = secs;
+            p.km = 0;
+            p.number[0] = rr * 1000.0;
+            hrvXdata->append(p);
         }
         if (ewmaRR >= 0.0 && !rideFile->isDataPresent(rideFile->hr))
             rideFile->setDataPresent(rideFile->hr, true);
-        if (hrvXdata->datapoints.count()>0)
+        if (hrvXdata->count()>0)
             rideFile->addXData("HRV", hrvXdata);
         else
             delete hrvXdata;
@@ -337,9 +337,9 @@ SmlParser::endElement(const QString&, const QString&, const QString& qName)
 
     else if (qName == "Samples")
     {
-        if (SMLdebug) qDebug()<<"Swim XData records"<<swimXdata->datapoints.count();
+        if (SMLdebug) qDebug()<<"Swim XData records"<<swimXdata->count();
         // Add length-by-length Swim XData, if present
-        if (swimXdata->datapoints.count()>0)
+        if (swimXdata->count()>0)
             rideFile->addXData("SWIM", swimXdata);
         else
             delete swimXdata;
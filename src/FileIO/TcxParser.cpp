@@ -277,12 +277,12 @@ TcxParser::endElement( const QString&, const QString&, const QString& qName)
                     double deltaDist = (distance - last_distance) / deltaSecs;
                     double kph = 3600.0 * deltaDist;
                     // length-by-length Swim XData
-                    XDataPoint *p = new XDataPoint();
-                    p->secs = lastLength;
-                    p->km = last_distance;
-                    p->number[0] = deltaDist > 0 ? 1 : 0;
-                    p->number[1] = deltaSecs;
-                    if (swimXdata) swimXdata->datapoints.append(p);
+                    XDataPoint p;
+                    p.secs = lastLength;
+                    p.km = last_distance;
+                    p.number[0] = deltaDist > 0 ? 1 : 0;
+                    p.number[1] = deltaSecs;
+                    if (swimXdata) swimXdata->append(p);
 
                     for (int i = rideFile->timeIndex(lastLength);
                          i>= 0 && i < rideFile->dataPoints().size() &&
@@ -302,13 +302,13 @@ TcxParser::endElement( const QString&, const QString&, const QString& qName)
                 // smart recording is on and delta is less than GarminHWM seconds
                 // length-by-length Swim XData
                 if (swim == Swim && deltaSecs > 0) {
-                    XDataPoint *p = new XDataPoint();
-                    p->secs = prevPoint->secs;
-                    p->km = last_distance;
-                    p->number[0] = deltaDist > 0 ? 1 : 0;
-                    p->number[1] = deltaSecs;
-                    if (swimXdata) swimXdata->datapoints.append(p);
-                    lastLength = p->secs + deltaSecs;
+                    XDataPoint p;
+                    p.secs = prevPoint->secs;
+                    p.km = last_distance;
+                    p.number[0] = deltaDist > 0 ? 1 : 0;
+                    p.number[1] = deltaSecs;
+                    if (swimXdata) swimXdata->append(p);
+                    lastLength = p.secs + deltaSecs;
                 }
                 // or it is pool swimming and we limit expansion for safety
                 for(int i = 1; i <= deltaSecs && i <= 300*GarminHWM.toInt(); i++) {
@@ -366,12 +366,12 @@ TcxParser::endElement( const QString&, const QString&, const QString& qName)
         // for pool swimming, laps with distance 0 are pauses, without trackpoints
         // length-by-length Swim XData
         if (swim == Swim && distance == 0.0) {
-            XDataPoint *p = new XDataPoint();
-            p->secs = secs;
-            p->km = last_distance;
-            p->number[0] = 0;
-            p->number[1] = round(lapSecs);
-            if (swimXdata) swimXdata->datapoints.append(p);
+            XDataPoint p;
+            p.secs = secs;
+            p.km = last_distance;
+            p.number[0] = 0;
+            p.number[1] = round(lapSecs);
+            if (swimXdata) swimXdata->append(p);
             lastLength = secs + round(lapSecs);
         }
         // expand only if Smart Recording is enabled
@@ -426,7 +426,7 @@ TcxParser::endElement( const QString&, const QString&, const QString& qName)
         rideFile->addInterval(RideFileInterval::DEVICE, start, start + lapSecs, name);
     } else if (qName == "Activity") {
         // Add length-by-length Swim XData, if present
-        if (swimXdata && swimXdata->datapoints.count()>0) {
+        if (swimXdata && swimXdata->count()>0) {
             rideFile->addXData("SWIM", swimXdata);
         } else if (swimXdata) {
             delete swimXdata;
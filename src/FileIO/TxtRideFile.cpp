@@ -574,16 +574,16 @@ RideFile *TxtFileReader::openRideFile(QFile &file, QStringList &errors, QList<Ri
                 rideFile->appendPoint(iSecs, 0.0, bpm, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, RideFile::NA, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0, 0);
             }
 
-            XDataPoint *p = new XDataPoint();
-            p->secs = secs;
-            p->km = 0;
-            p->number[0] = rr * 1000.0;
-            hrvXdata->datapoints.append(p);
+            XDataPoint p;
+            p.secs = secs;
+            p.km = 0;
+            p.number[0] = rr * 1000.0;
+            hrvXdata->append(p);
 
             secs += rr;
         }
 
-        if (hrvXdata->datapoints.count()>0)
+        if (hrvXdata->count()>0)
             rideFile->addXData("HRV", hrvXdata);
         else
             delete hrvXdata;
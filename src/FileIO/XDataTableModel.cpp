@@ -81,16 +81,16 @@ XDataTableModel::data(const QModelIndex & index, int role) const
 {
     if (role != Qt::DisplayRole) return QVariant();
 
-    if (index.row() >= series->datapoints.count() || index.column() >= (series->valuename.count()+2))
+    if (index.row() >= series->count() || index.column() >= (series->valuename.count()+2))
         return QVariant();
     else {
         switch(index.column()) {
         case 0: // time
-           return series->datapoints[index.row()]->secs;
+           return series->secs(index.row());
         case 1: // distance
-           return series->datapoints[index.row()]->km;
+           return series->km(index.row());
         default:
-        return series->datapoints[index.row()]->number[index.column()-2];
+        return series->value(index.row(), index.column()-2);
         }
     }
 }
@@ -119,7 +119,7 @@ XDataTableModel::headerData(int section, Qt::Orientation orient, int role) const
 int
 XDataTableModel::rowCount(const QModelIndex &) const
 {
-    if (series) return series->datapoints.count();
+    if (series) return series->count();
     else return 0;
 }
 
@@ -133,7 +133,7 @@ XDataTableModel::columnCount(const QModelIndex &) const
 bool
 XDataTableModel::setData(const QModelIndex & index, const QVariant &value, int role)
 {
-    if (index.row() >= series->datapoints.count() || index.column() >= (series->valuename.count()+2))
+    if (index.row() >= series->count() || index.column() >= (series->valuename.count()+2))
         return false;
     else if (role == Qt::EditRole) {
         ride->command->setXDataPointValue(xdata, index.row(), index.column(), value.toDouble());
@@ -156,11 +156,10 @@ XDataTableModel::insertRow(int row, const QModelIndex &parent)
 bool
 XDataTableModel::insertRows(int row, int count, const QModelIndex &)
 {
-    if (row >= series->datapoints.count()) return false;
+    if (row >= series->count()) return false;
     else {
         while (count--) {
-            XDataPoint *p = new XDataPoint;
-            ride->command->insertXDataPoint(xdata, row, p);
+            ride->command->insertXDataPoint(xdata, row, XDataPoint());
         }
         return true;
     }
@@ -168,7 +167,7 @@ XDataTableModel::insertRows(int row, int count, const QModelIndex &)
 }
 
 bool
-XDataTableModel::appendRows(QVector<XDataPoint*>newRows)
+XDataTableModel::appendRows(QVector<XDataPoint>newRows)
 {
     ride->command->appendXDataPoints(xdata, newRows);
     return true;
@@ -177,7 +176,7 @@ XDataTableModel::appendRows(QVector<XDataPoint*>newRows)
 bool
 XDataTableModel::removeRows(int row, int count, const QModelIndex &)
 {
-    if ((row + count) > series->datapoints.count()) return false;
+    if ((row + count) > series->count()) return false;
     ride->command->deleteXDataPoints(xdata, row, count);
     return true;
 }
@@ -222,7 +221,7 @@ XDataTableModel::setValue(int row, int column, double value)
 double
 XDataTableModel::getValue(int row, int column)
 {
-    return series->datapoints[row]->number[column];
+    return series->value(row, column);
 }
 
 void
@@ -230,7 +229,7 @@ XDataTableModel::forceRedraw()
 {
     // tell the view to redraw everything
     if (ride)
-        dataChanged(createIndex(0,0), createIndex(series->datapoints.count(), series->valuename.count()+2));
+        dataChanged(createIndex(0,0), createIndex(series->count(), series->valuename.count()+2));
 }
 
 //
@@ -59,7 +59,7 @@ class XDataTableModel : public QAbstractTableModel
         bool insertRow(int row, const QModelIndex & parent = QModelIndex());
         bool insertRows(int row, int count, const QModelIndex & parent = QModelIndex());
         bool removeRows(int row, int count, const QModelIndex & parent = QModelIndex());
-        bool appendRows(QVector<XDataPoint*>newRows);
+        bool appendRows(QVector<XDataPoint>newRows);
 
         // DO NOT USE THESE -- THEY ARE NULL --
         bool insertColumns (int column, int count, const QModelIndex & parent = QModelIndex());
@@ -529,6 +529,17 @@ BackupPage::BackupPage(Context *context) : context(context)
     //backupInput->addStretch();
     backupInput->addWidget(autoBackupUnitLabel);
 
+    autoBackupKeep = new QSpinBox(this);
+    autoBackupKeep->setMinimum(0);
+    autoBackupKeep->setMaximum(9999);
+    autoBackupKeep->setSingleStep(1);
+    QLabel *autoBackupKeepLabel = new QLabel(tr("Auto Backup keeps the last"));
+    autoBackupKeep->setValue(appsettings->cvalue(context->athlete->cyclist, GC_AUTOBACKUP_KEEP, 30).toInt());
+    QLabel *autoBackupKeepUnitLabel = new QLabel(tr("backups - 0 means all of them"));
+    QHBoxLayout *keepInput = new QHBoxLayout();
+    keepInput->addWidget(autoBackupKeep);
+    keepInput->addWidget(autoBackupKeepUnitLabel);
+
     Qt::Alignment alignment = Qt::AlignLeft|Qt::AlignVCenter;
 
     grid->addWidget(autoBackupFolderLabel, 7,0, alignment);
@@ -536,6 +547,8 @@ BackupPage::BackupPage(Context *context) : context(context)
     grid->addWidget(autoBackupFolderBrowse, 7, 2, alignment);
     grid->addWidget(autoBackupPeriodLabel, 8, 0,alignment);
     grid->addLayout(backupInput, 8, 1, alignment);
+    grid->addWidget(autoBackupKeepLabel, 9, 0,alignment);
+    grid->addLayout(keepInput, 9, 1, alignment);
 
     all->addLayout(grid);
     all->addStretch();
@@ -558,6 +571,7 @@ BackupPage::saveClicked()
     // Auto Backup
     appsettings->setCValue(context->athlete->cyclist, GC_AUTOBACKUP_FOLDER, autoBackupFolder->text());
     appsettings->setCValue(context->athlete->cyclist, GC_AUTOBACKUP_PERIOD, autoBackupPeriod->value());
+    appsettings->setCValue(context->athlete->cyclist, GC_AUTOBACKUP_KEEP, autoBackupKeep->value());
     return 0;
 }
 
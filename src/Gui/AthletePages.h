@@ -183,6 +183,7 @@ class BackupPage : public QWidget
         Context *context;
 
         QSpinBox *autoBackupPeriod;
+        QSpinBox *autoBackupKeep;
         QLineEdit *autoBackupFolder;
         QPushButton *autoBackupFolderBrowse;
 
@@ -27,6 +27,7 @@
 #include "HelpWhatsThis.h"
 #include "CsvRideFile.h"
 #include "DataProcessor.h"
+#include "BatchExport.h"
 #ifdef GC_WANT_PYTHON
 #include "FixPyScriptsDialog.h"
 #endif
@@ -34,9 +35,10 @@
 #include <QFormLayout>
 #include <QButtonGroup>
 #include <QMessageBox>
+#include <QEventLoop>
 
 BatchProcessingDialog::BatchProcessingDialog(Context* context) : QDialog(context->mainWindow), context(context),
-processed(0), fails(0), numFilesToProcess(0) {
+exporter(NULL), processed(0), fails(0), numFilesToProcess(0) {
     setAttribute(Qt::WA_DeleteOnClose);
     setWindowTitle(tr("Activity Batch Processing"));
 
@@ -414,6 +416,7 @@ BatchProcessingDialog::okClicked()
         }
     } else if (ok->text() == "Abort" || ok->text() == tr("Abort")) {
         aborted = true;
+        if (exporter) exporter->abort();
         ok->setText(tr("Finish"));
     } else if (ok->text() == "Finish" || ok->text() == tr("Finish")) {
         accept(); // our work is done!
@@ -475,82 +478,57 @@ BatchProcessingDialog::exportFiles()
     // what file format to export as?
     QString type = fileFormat->currentIndex() > 0 ? RideFileFactory::instance().writeSuffixes().at(fileFormat->currentIndex()-1) : "csv";
 
-    // loop through the table and export all selected
-    for(int i=0; i<files->invisibleRootItem()->childCount(); i++) {
-
-        // give user a chance to abort..
-        QApplication::processEvents();
+    // the export runs on the thread pool, we just show progress
+    exporter = new BatchExport(context, type, QDir(dirName->text()), overwrite->isChecked());
+    connect(exporter, SIGNAL(jobStarted(int)), this, SLOT(exportStarted(int)));
+    connect(exporter, SIGNAL(jobFinished(int,bool,QString)), this, SLOT(exportFinished(int,bool,QString)));
 
-        // did they?
-        if (aborted == true) return BatchProcessingDialog::userF; // user aborted!
+    // queue all selected, the tag is the row in the table
+    QString activities = context->athlete->home->activities().absolutePath();
+    for(int i=0; i<files->invisibleRootItem()->childCount(); i++) {
 
         QTreeWidgetItem *current = files->invisibleRootItem()->child(i);
 
         // is it selected
         if (static_cast<QCheckBox*>(files->itemWidget(current,0))->isChecked()) {
+            current->setText(4, tr("Queued"));
+            exporter->add(activities + "/" + current->text(1), i);
+        }
+    }
 
-            files->setCurrentItem(current); QApplication::processEvents();
+    // wait for it, aborting via the ok button stops it
+    QEventLoop loop;
+    connect(exporter, SIGNAL(finished(int,int)), &loop, SLOT(quit()));
+    exporter->start();
+    if (exporter->isRunning()) loop.exec();
 
-            QString filename = dirName->text() + "/" + QFileInfo(current->text(1)).baseName() + "." + type;
+    delete exporter;
+    exporter = NULL;
 
-            if (QFile(filename).exists()) {
-                if (overwrite->isChecked() == false) {
-                    // skip existing files
-                    current->setText(4, tr("Exists - not exported")); QApplication::processEvents();
-                    fails++;
-                    continue;
+    return aborted ? BatchProcessingDialog::userF : BatchProcessingDialog::finishedF;
+}
 
-                } else {
+void
+BatchProcessingDialog::exportStarted(int row)
+{
+    QTreeWidgetItem *current = files->invisibleRootItem()->child(row);
+    if (current == NULL) return;
 
-                    // remove existing
-                    QFile(filename).remove();
-                    current->setText(4, tr("Removing...")); QApplication::processEvents();
-                }
-            }
-            // this one then
-            current->setText(4, tr("Reading...")); QApplication::processEvents();
-
-            // open it..
-            QStringList errors;
-            QList<RideFile*> rides;
-            QFile thisfile(QString(context->athlete->home->activities().absolutePath()+"/"+current->text(1)));
-            RideFile *rideF = RideFileFactory::instance().openRideFile(context, thisfile, errors, &rides);
-
-            // open success?
-            if (rideF) {
-
-                current->setText(4, tr("Writing...")); QApplication::processEvents();
-                QFile out(filename);
-
-                bool success = false;
-                if (fileFormat->currentIndex() > 0)
-                    success = RideFileFactory::instance().writeRideFile(context, rideF, out, type);
-                else {
-                    CsvFileReader writer;
-                    success = writer.writeRideFile(context, rideF, out, CsvFileReader::gc);
-                }
-
-                // update the Action info column
-                if (success) {
-                    processed++;
-                    current->setText(4, tr("Exported")); QApplication::processEvents();
-                } else {
-                    fails++;
-                    current->setText(4, tr("Write failed")); QApplication::processEvents();
-                }
-
-                delete rideF; // free memory!
-
-            // open failed
-            } else {
+    files->setCurrentItem(current);
+    current->setText(4, tr("Exporting..."));
+}
 
-                current->setText(4, tr("Read error")); QApplication::processEvents();
+void
+BatchProcessingDialog::exportFinished(int row, bool success, QString message)
+{
+    QTreeWidgetItem *current = files->invisibleRootItem()->child(row);
+    if (current == NULL) return;
 
-            }
-        }
-    }
+    if (success) processed++;
+    else fails++;
 
-    return BatchProcessingDialog::finishedF;
+    // update the Action info column
+    current->setText(4, message);
 }
 
 BatchProcessingDialog::bpFailureType
@@ -39,6 +39,8 @@
 #include <QListIterator>
 #include <QDebug>
 
+class BatchExport;
+
 // Dialog class to allow batch processing of activities
 class BatchProcessingDialog : public QDialog
 {
@@ -61,6 +63,10 @@ private slots:
     void radioClicked(int);
     void comboSelected();
 
+    // progress from the export engine
+    void exportStarted(int);
+    void exportFinished(int, bool, QString);
+
 private:
 
     typedef enum {
@@ -77,6 +83,7 @@ private:
 
     Context *context;
     bool aborted;
+    BatchExport *exporter; // when exporting
 
     int processed, fails, numFilesToProcess;
     batchRadioBType outputMode;
@@ -730,44 +730,18 @@ ComparePane::dropEvent(QDropEvent *event)
             while(xi.hasNext()) {
                 xi.next();
 
-                XDataSeries *x = new XDataSeries();
-                x->name = xi.value()->name;
-                x->valuename = xi.value()->valuename;
-                x->unitname = xi.value()->unitname;
-                x->valuetype = xi.value()->valuetype;
+                // shares the columns until we select our points
+                XDataSeries *x = new XDataSeries(*xi.value());
 
-                // add our xdata, with not points yet...
-                add.data->addXData(xi.key(), x);
-
-                // manage offsets
-                bool first = true;
-                double offset = 0.0f, offsetKM = 0.0f;
-
-                foreach(XDataPoint *p, xi.value()->datapoints) {
-
-                    if (p->secs >= stop) break;
-
-                    if (p->secs >= start) {
-
-                        // intervals always start from zero when comparing
-                        if (first) {
-                            first = false;
-                            offset = p->secs;
-                            offsetKM = p->km;
-                        }
-
-                        XDataPoint *addp = new XDataPoint();
-                        addp->km = p->km - offsetKM;
-                        addp->secs = p->secs - offset;
+                QVector<int> rows;
+                for (int k=0; k<x->count() && x->secs(k) < stop; k++)
+                    if (x->secs(k) >= start) rows << k;
+                x->select(rows);
 
-                        for(int i=0; i< XDATA_MAXVALUES; i++) {
-                            addp->number[i] = p->number[i];
-                            addp->string[i] = p->string[i];
-                        }
+                // intervals always start from zero when comparing
+                if (!x->isEmpty()) x->offset(-x->secs(0), -x->km(0));
 
-                        x->datapoints.append(addp);
-                    }
-                }
+                add.data->addXData(xi.key(), x);
             }
 
             add.data->recalculateDerivedSeries();
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "DiagnosticsDialog.h"
+#include "Profiler.h"
+#include "Colors.h"
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+
+DiagnosticsDialog::DiagnosticsDialog(QWidget *parent) : QDialog(parent)
+{
+    setWindowTitle(tr("Diagnostics"));
+    setAttribute(Qt::WA_DeleteOnClose);
+    setMinimumSize(700 *dpiXFactor, 500 *dpiYFactor);
+
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+
+    enable = new QCheckBox(tr("Profile metrics, formulas, file readers and caches"), this);
+    enable->setChecked(Profiler::isEnabled());
+    mainLayout->addWidget(enable);
+
+    table = new QTreeWidget(this);
+    table->setColumnCount(6);
+    table->setHeaderLabels(QStringList() << tr("Kind") << tr("Name") << tr("Count")
+                                         << tr("Total ms") << tr("Mean ms") << tr("Max ms"));
+    table->setRootIsDecorated(false);
+    table->setUniformRowHeights(true);
+    table->setSortingEnabled(true);
+    table->sortByColumn(3, Qt::DescendingOrder);
+    table->header()->setSectionResizeMode(1, QHeaderView::Stretch);
+    table->header()->setStretchLastSection(false);
+    mainLayout->addWidget(table);
+
+    QHBoxLayout *buttons = new QHBoxLayout;
+    reset = new QPushButton(tr("Reset"), this);
+    close = new QPushButton(tr("Close"), this);
+    buttons->addWidget(reset);
+    buttons->addStretch();
+    buttons->addWidget(close);
+    mainLayout->addLayout(buttons);
+
+    timer = new QTimer(this);
+    timer->start(1000);
+
+    connect(enable, SIGNAL(clicked(bool)), this, SLOT(enableClicked(bool)));
+    connect(reset, SIGNAL(clicked()), this, SLOT(resetClicked()));
+    connect(close, SIGNAL(clicked()), this, SLOT(accept()));
+    connect(timer, SIGNAL(timeout()), this, SLOT(refresh()));
+
+    refresh();
+}
+
+void
+DiagnosticsDialog::enableClicked(bool checked)
+{
+    Profiler::setEnabled(checked);
+}
+
+void
+DiagnosticsDialog::resetClicked()
+{
+    Profiler::reset();
+    refresh();
+}
+
+void
+DiagnosticsDialog::refresh()
+{
+    // keep the user's choice of sort
+    int column = table->header()->sortIndicatorSection();
+    Qt::SortOrder order = table->header()->sortIndicatorOrder();
+    table->setSortingEnabled(false);
+    table->clear();
+
+    foreach(const Profiler::Entry &entry, Profiler::snapshot()) {
+        QTreeWidgetItem *add = new QTreeWidgetItem(table);
+        add->setText(0, Profiler::kindName(entry.kind));
+        add->setText(1, entry.name);
+        add->setData(2, Qt::DisplayRole, entry.count);
+        add->setData(3, Qt::DisplayRole, qRound64(entry.nsecs / 1000.0) / 1000.0);
+        add->setData(4, Qt::DisplayRole, qRound64(entry.nsecs / 1000.0 / entry.count) / 1000.0);
+        add->setData(5, Qt::DisplayRole, qRound64(entry.max / 1000.0) / 1000.0);
+        for (int i=2; i<6; i++) add->setTextAlignment(i, Qt::AlignRight);
+    }
+
+    table->setSortingEnabled(true);
+    table->sortByColumn(column, order);
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef _GC_DiagnosticsDialog_h
+#define _GC_DiagnosticsDialog_h 1
+#include "GoldenCheetah.h"
+
+#include <QDialog>
+#include <QTreeWidget>
+#include <QCheckBox>
+#include <QPushButton>
+#include <QTimer>
+
+// shows the profiler counters (see Profiler.h), updated every second
+class DiagnosticsDialog : public QDialog
+{
+        Q_OBJECT
+        G_OBJECT
+
+
+    public:
+        DiagnosticsDialog(QWidget *parent = 0);
+
+    private slots:
+        void enableClicked(bool);
+        void resetClicked();
+        void refresh();
+
+    private:
+        QCheckBox *enable;
+        QTreeWidget *table;
+        QPushButton *reset, *close;
+        QTimer *timer;
+};
+
+#endif // _GC_DiagnosticsDialog_h
@@ -52,6 +52,7 @@
 
 // DIALOGS / DOWNLOADS / UPLOADS
 #include "AboutDialog.h"
+#include "DiagnosticsDialog.h"
 #include "ChooseCyclistDialog.h"
 #include "ConfigDialog.h"
 #include "AthleteConfigDialog.h"
@@ -485,6 +486,7 @@ MainWindow::MainWindow(const QDir &home)
     connect(backupAthleteMenu, SIGNAL(aboutToShow()), this, SLOT(setBackupAthleteMenu()));
     backupMapper = new QSignalMapper(this); // maps each option
     connect(backupMapper, &QSignalMapper::mappedString, this, &MainWindow::backupAthlete);
+    fileMenu->addAction(tr("Restore Backup..."), this, SLOT(restoreAthlete()));
 
     fileMenu->addSeparator();
     deleteAthleteMenu = fileMenu->addMenu(tr("Delete..."));
@@ -693,6 +695,7 @@ MainWindow::MainWindow(const QDir &home)
     helpMenu->addAction(tr("&User Guide"), this, SLOT(helpView()));
     helpMenu->addAction(tr("&Log a bug or feature request"), this, SLOT(logBug()));
     helpMenu->addAction(tr("&Discussion and Support Forum"), this, SLOT(support()));
+    helpMenu->addAction(tr("Diagnostics..."), this, SLOT(diagnosticsDialog()));
     helpMenu->addSeparator();
     helpMenu->addAction(tr("&About GoldenCheetah"), this, SLOT(aboutDialog()));
 
@@ -1184,6 +1187,13 @@ MainWindow::aboutDialog()
     ad->exec();
 }
 
+void
+MainWindow::diagnosticsDialog()
+{
+    DiagnosticsDialog *dd = new DiagnosticsDialog(this);
+    dd->show();
+}
+
 void MainWindow::showSolveCP()
 {
    SolveCPDialog *td = new SolveCPDialog(this, currentAthleteTab->context);
@@ -2238,6 +2248,14 @@ MainWindow::backupAthlete(QString name)
     delete backup;
 }
 
+void
+MainWindow::restoreAthlete()
+{
+    AthleteBackup *backup = new AthleteBackup(currentAthleteTab->context->athlete->home->root());
+    backup->restoreImmediate();
+    delete backup;
+}
+
 void
 MainWindow::setDeleteAthleteMenu()
 {
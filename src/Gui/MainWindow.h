@@ -138,6 +138,7 @@ class MainWindow : public QMainWindow
         // GUI
         void toggleFullScreen();
         void aboutDialog();
+        void diagnosticsDialog();
         void helpWindow();
         void helpView();
         void logBug();
@@ -183,6 +184,7 @@ class MainWindow : public QMainWindow
         // Athlete Backup
         void setBackupAthleteMenu();
         void backupAthlete(QString name);
+        void restoreAthlete();
 
         // Athlete Delete
         void setDeleteAthleteMenu();
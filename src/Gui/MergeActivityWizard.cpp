@@ -460,26 +460,22 @@ MergeActivityWizard::combine()
                     }
 
                 // finally copy the data
-                foreach (XDataPoint *point, xdata->datapoints) {
-                    XDataPoint *pt = new XDataPoint();
-                    pt->secs = point->secs + timeOffset;
-                    pt->km = point->km + distanceOffset;
+                XDataSeries *to = combined->xdata(xdata->name);
+                to->reserve(to->count() + xdata->count());
+                for (int row=0; row<xdata->count(); row++) {
+                    XDataPoint pt;
+                    pt.secs = xdata->secs(row) + timeOffset;
+                    pt.km = xdata->km(row) + distanceOffset;
                     for (int i=0; i<indexMap.count(); i++) {
-                        pt->number[i] = point->number[indexMap[i]];
-                        pt->string[i] = point->string[indexMap[i]];
+                        pt.number[i] = xdata->value(row, indexMap[i]);
+                        pt.string[i] = xdata->string(row, indexMap[i]);
                     }
-                    combined->xdata(xdata->name)->datapoints.append(pt);
+                    to->append(pt);
                 }
 
             } else {
                 XDataSeries *xd = new XDataSeries(*xdata);
-                xd->datapoints.clear();
-                foreach (XDataPoint *point, xdata->datapoints) {
-                    XDataPoint *pt = new XDataPoint(*point);
-                    pt->secs = point->secs + timeOffset;
-                    pt->km = point->km + distanceOffset;
-                    xd->datapoints.append(pt);
-                }
+                xd->offset(timeOffset, distanceOffset);
                 combined->addXData(xd->name, xd);
             }
         }
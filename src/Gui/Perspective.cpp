@@ -1698,9 +1698,8 @@ Perspective::relevant(RideItem *item)
     else if (df == NULL) return false;
     else if (df == NULL || item == NULL) return false;
 
-    // validate
-    Result ret = df->evaluate(item, NULL);
-    return ret.number();
+    // validate, usually already known from filterlist
+    return df->passes(item);
 
 }
 
@@ -1714,11 +1713,17 @@ Perspective::filterlist(DateRange dr, bool isfiltered, QStringList files)
     spec.setDateRange(dr);
     spec.setFilterSet(FilterSet(isfiltered, files)); // typically chart level filter
 
-    foreach(RideItem *item, context->athlete->rideCache->rides()) {
+    // only rides changed since last time are evaluated
+    const QVector<RideItem*> &rides = context->athlete->rideCache->rides();
+    QBitArray pass;
+    if (isFiltered()) pass = df->results(rides, spec);
+
+    for(int i=0; i<rides.count(); i++) {
+        RideItem *item = rides.at(i);
         if (!spec.pass(item)) continue;
 
         // if no filter, or the filter passes add to count
-        if (!isFiltered() || df->evaluate(item, NULL).number() != 0)
+        if (!isFiltered() || pass.testBit(i))
             returning << item->fileName;
     }
 
@@ -1388,26 +1388,25 @@ RideTreeView::RideTreeView(QWidget *parent) : QTreeView(parent)
 
 RideNavigatorSortProxyModel::RideNavigatorSortProxyModel(QObject *parent) : QSortFilterProxyModel (parent)
 {
+    // sort keys are worked out once by the ride cache model
+    setSortRole(RideCacheModel::SortRole);
 }
 
 bool RideNavigatorSortProxyModel::lessThan(const QModelIndex &left,
                                            const QModelIndex &right) const
 {
-    QVariant leftData = sourceModel()->data(left);
-    QVariant rightData = sourceModel()->data(right);
+    QVariant leftData = sourceModel()->data(left, sortRole());
+    QVariant rightData = sourceModel()->data(right, sortRole());
 
     if (leftData.type() == QVariant::DateTime) {
         return leftData.toDateTime() < rightData.toDateTime();
     }
-    QString leftString = leftData.toString();
-    QString rightString = rightData.toString();
 
-    if (leftString.contains(QRegularExpression("[^0-9.,]")) ||
-            rightString.contains(QRegularExpression("[^0-9.,]"))) { // alpha
-        return QString::localeAwareCompare(leftString, rightString) < 0;
+    // numeric
+    if (leftData.type() == QVariant::Double && rightData.type() == QVariant::Double) {
+        return leftData.toDouble() < rightData.toDouble();
     }
-    // assume numeric
-    return leftString.toDouble() < rightString.toDouble();
 
+    // alpha
+    return QString::localeAwareCompare(leftData.toString(), rightData.toString()) < 0;
 }
-
@@ -40,6 +40,7 @@
 #include "RideNavigator.h"
 #include "RideItem.h"
 #include "RideFile.h"
+#include "RideCacheModel.h"
 
 // Proxy model for doing groupBy
 class GroupByModel : public QAbstractProxyModel
@@ -78,7 +79,9 @@ private:
     QList<QModelIndex> groupIndexes;
 
     QMap<QString, QVector<int>*> groupToSourceRow;
+    QVector<QVector<int>*> groupRows;   // by group number, same as groupToSourceRow
     QVector<int> sourceRowToGroupRow;
+    QVector<int> sourceRowToGroup;      // group number for each source row
     QList<rankx> rankedRows;
 
     void clearGroups() {
@@ -91,10 +94,33 @@ private:
         groups.clear();
         groupIndexes.clear();
         groupToSourceRow.clear();
+        groupRows.clear();
         sourceRowToGroupRow.clear();
+        sourceRowToGroup.clear();
         rankedRows.clear();
     }
 
+    // rank all the values in the group by column
+    void rankRows(QList<rankx> &ranked) const {
+
+        ranked.clear();
+        for (int i=0; i<sourceModel()->rowCount(QModelIndex()); i++) {
+            rankx rank;
+            rank.value = sourceModel()->data(sourceModel()->index(i,groupBy)).toDouble();
+            rank.row = i;
+            ranked << rank;
+        }
+
+        // rank the entries
+        std::sort(ranked.begin(), ranked.end()); // sort by value
+        for (int i=0; i<ranked.count(); i++) {
+            ranked[i].value = i;
+        }
+
+        // sort by row again
+        std::stable_sort(ranked.begin(), ranked.end(), rankx::sortByRow);
+    }
+
     static bool initGroupRanges();
 
 public:
@@ -148,7 +174,7 @@ public:
         setIndexes();
 
         connect(model, SIGNAL(modelReset()), this, SLOT(sourceModelChanged()));
-        connect(model, SIGNAL(dataChanged(QModelIndex, QModelIndex)), this, SIGNAL(dataChanged(QModelIndex, QModelIndex)));
+        connect(model, SIGNAL(dataChanged(QModelIndex, QModelIndex)), this, SLOT(sourceDataChanged(QModelIndex, QModelIndex)));
         connect(model, SIGNAL(rowsInserted(QModelIndex,int,int)), this, SLOT(sourceModelChanged()));
         connect(model, SIGNAL(rowsMoved(QModelIndex,int,int,QModelIndex,int)), this, SLOT(sourceModelChanged()));
         connect(model, SIGNAL(rowsRemoved(QModelIndex,int,int)), this, SLOT(sourceModelChanged()));
@@ -187,7 +213,7 @@ public:
                 return QModelIndex();
             }
 
-            return sourceModel()->index(groupToSourceRow.value(groups[groupNo])->at(proxyIndex.row()),
+            return sourceModel()->index(groupRows[groupNo]->at(proxyIndex.row()),
                                         proxyIndex.column()-2, // accommodate virtual columns
                                         QModelIndex());
         }
@@ -197,17 +223,14 @@ public:
     QModelIndex mapFromSource(const QModelIndex &sourceIndex) const {
 
         // which group did we put this row into?
-        QString group = whichGroup(sourceIndex.row());
-        int groupNo = groups.indexOf(group);
+        int groupNo = sourceRowToGroup.value(sourceIndex.row(), -1);
 
-        if (groupNo < 0) {
+        if (groupNo < 0 || groupNo >= groupIndexes.count()) {
             return QModelIndex();
         } else {
-            QModelIndex *p = new QModelIndex(createIndex(groupNo, 0, (void*)NULL));
-            if (sourceIndex.row() > 0 && sourceIndex.row() < sourceRowToGroupRow.size())
-                return createIndex(sourceRowToGroupRow[sourceIndex.row()], sourceIndex.column()+2, &p); // accommodate virtual columns
-            else
-                return QModelIndex();
+            // same as index() for a row in the group
+            return createIndex(sourceRowToGroupRow[sourceIndex.row()], sourceIndex.column()+2, // accommodate virtual columns
+                               (void*)&groupIndexes[groupNo]);
         }
     }
 
@@ -291,7 +314,7 @@ public:
                     // hideous code, sorry
                     int groupNo = ((QModelIndex*)proxyIndex.internalPointer())->row();
                     if (groupNo < 0 || groupNo >= groups.count() || proxyIndex.column() == 0) returning="";
-                    else string = sourceModel()->data(sourceModel()->index(groupToSourceRow.value(groups[groupNo])->at(proxyIndex.row()), calendarText)).toString();
+                    else string = sourceModel()->data(sourceModel()->index(groupRows[groupNo]->at(proxyIndex.row()), calendarText)).toString();
                     // get rid of cr, lf and tab chars
                     string.replace("\n", " ");
                     string.replace("\t", " ");
@@ -316,7 +339,7 @@ public:
                     int groupNo = ((QModelIndex*)proxyIndex.internalPointer())->row();
                     if (groupNo < 0 || groupNo >= groups.count() || proxyIndex.column() == 0)
                         colorstring= GColor(CPLOTMARKER).name();
-                    else colorstring = sourceModel()->data(sourceModel()->index(groupToSourceRow.value(groups[groupNo])->at(proxyIndex.row()), colorColumn)).toString();
+                    else colorstring = sourceModel()->data(sourceModel()->index(groupRows[groupNo]->at(proxyIndex.row()), colorColumn)).toString();
 
                     returning = QColor(colorstring);
                 } else {
@@ -333,7 +356,7 @@ public:
                     int groupNo = ((QModelIndex*)proxyIndex.internalPointer())->row();
                     if (groupNo < 0 || groupNo >= groups.count() || proxyIndex.column() == 0)
                         filename="";
-                    else filename = sourceModel()->data(sourceModel()->index(groupToSourceRow.value(groups[groupNo])->at(proxyIndex.row()), fileIndex)).toString();
+                    else filename = sourceModel()->data(sourceModel()->index(groupRows[groupNo]->at(proxyIndex.row()), fileIndex)).toString();
 
                     returning = filename;
                 } else {
@@ -350,7 +373,7 @@ public:
                     int groupNo = ((QModelIndex*)proxyIndex.internalPointer())->row();
                     if (groupNo < 0 || groupNo >= groups.count() || proxyIndex.column() == 0)
                         returning = false;
-                    else isRun = sourceModel()->data(sourceModel()->index(groupToSourceRow.value(groups[groupNo])->at(proxyIndex.row()), isRunIndex)).toBool();
+                    else isRun = sourceModel()->data(sourceModel()->index(groupRows[groupNo]->at(proxyIndex.row()), isRunIndex)).toBool();
 
                     returning = isRun;
                 } else {
@@ -367,7 +390,9 @@ public:
                     int groupNo = ((QModelIndex*)proxyIndex.internalPointer())->row();
                     if (groupNo < 0 || groupNo >= groups.count() || proxyIndex.column() == 0)
                         date="";
-                    else date = sourceModel()->data(sourceModel()->index(groupToSourceRow.value(groups[groupNo])->at(proxyIndex.row()), dateColumn)).toString();
+                    else if (role == RideCacheModel::SortRole) // sort by the date itself
+                        return sourceModel()->data(sourceModel()->index(groupRows[groupNo]->at(proxyIndex.row()), dateColumn), role);
+                    else date = sourceModel()->data(sourceModel()->index(groupRows[groupNo]->at(proxyIndex.row()), dateColumn)).toString();
 
                     returning = date;//sourceModel()->data(sourceModel()->index(proxyIndex.row(),dateColumn)).toString();
 
@@ -397,11 +422,11 @@ public:
                     QString returnString = QString(tr("%1: %2 (%3 activities)"))
                                            .arg(sourceModel()->headerData(groupBy, Qt::Horizontal).toString())
                                            .arg(group)
-                                           .arg(groupToSourceRow.value(groups[proxyIndex.row()])->count());
+                                           .arg(groupRows[proxyIndex.row()]->count());
                     returning = QVariant(returnString);
                 } else {
                     QString returnString = QString(tr("%1 activities"))
-                                           .arg(groupToSourceRow.value(groups[proxyIndex.row()])->count());
+                                           .arg(groupRows[proxyIndex.row()]->count());
                     returning = QVariant(returnString);
                 }
             }
@@ -443,7 +468,7 @@ public:
         } else if (parent.column() == 0 && parent.internalPointer() == NULL) {
 
             // second level return count of rows for group
-            return groupToSourceRow.value(groups[parent.row()])->count();
+            return groupRows[parent.row()]->count();
 
         } else {
 
@@ -463,7 +488,7 @@ public:
         } else if (index.column() == 0 && index.internalPointer() == NULL) {
 
             // first column - the group bys
-            return (groupToSourceRow.value(groups[index.row()])->count() > 0);
+            return (groupRows[index.row()]->count() > 0);
 
         } else {
 
@@ -489,13 +514,17 @@ public:
     }
 
     QString whichGroup(int row) const {
+        return whichGroup(row, rankedRows);
+    }
+
+    QString whichGroup(int row, const QList<rankx> &ranked) const {
 
-        if (row < 0 || row >= rankedRows.count()) return ("");
+        if (row < 0 || row >= ranked.count()) return ("");
         if (groupBy == -1) return tr("All Activities");
         else return groupFromValue(headerData(groupBy+2, // accommodate virtual column
                                     Qt::Horizontal).toString(),
                                     sourceModel()->data(sourceModel()->index(row,groupBy)).toString(),
-                                    rankedRows[row].value, rankedRows.count());
+                                    ranked[row].value, ranked.count());
 
     }
 
@@ -519,21 +548,7 @@ public:
         if (groupBy >= 0) {
 
             // rank all the values
-            for (int i=0; i<sourceModel()->rowCount(QModelIndex()); i++) {
-                rankx rank;
-                rank.value = sourceModel()->data(sourceModel()->index(i,groupBy)).toDouble();
-                rank.row = i;
-                rankedRows << rank;
-            }
-
-            // rank the entries
-            std::sort(rankedRows.begin(), rankedRows.end()); // sort by value
-            for (int i=0; i<rankedRows.count(); i++) {
-                rankedRows[i].value = i;
-            }
-
-            // sort by row again
-            std::stable_sort(rankedRows.begin(), rankedRows.end(), rankx::sortByRow);
+            rankRows(rankedRows);
 
 
             // create a QMap from 'group' string to list of rows in that group
@@ -572,9 +587,12 @@ public:
         // Update list of groups
         int group=0;
         QMapIterator<QString, QVector<int>*> j(groupToSourceRow);
+        sourceRowToGroup.fill(-1, sourceRowToGroupRow.count());
         while (j.hasNext()) {
             j.next();
             groups << j.key();
+            groupRows << j.value();
+            foreach(int row, *j.value()) sourceRowToGroup[row] = group;
             groupIndexes << createIndex(group++,0,(void*)NULL);
         }
 
@@ -584,6 +602,56 @@ public:
 
 public slots:
 
+    // rows changed, only regroup if one moved to another group
+    // otherwise let the sort model just re-sort the rows that changed
+    void sourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight) {
+
+        // the source model passes on its source's indexes, the
+        // rows are mapped but it doesn't move columns around
+        QAbstractProxyModel *proxy = qobject_cast<QAbstractProxyModel*>(sourceModel());
+
+        QVector<int> rows;
+        for (int row=topLeft.row(); row <= bottomRight.row(); row++) {
+
+            QModelIndex source = topLeft.sibling(row, 0);
+            if (source.model() != sourceModel() && proxy) source = proxy->mapFromSource(source);
+            if (source.isValid()) rows << source.row();
+        }
+
+        // only when the group by values changed can rows change group
+        if (groupBy >= 0 && topLeft.column() <= groupBy && groupBy <= bottomRight.column()) {
+
+            QList<rankx> ranked;
+            rankRows(ranked);
+            if (ranked.count() != rankedRows.count()) {
+                sourceModelChanged();
+                return;
+            }
+
+            // the rows that changed, and any others whose rank moved
+            QVector<bool> check(ranked.count(), false);
+            foreach(int row, rows) if (row < check.count()) check[row] = true;
+
+            for (int i=0; i<ranked.count(); i++) {
+                if (!check[i] && ranked[i].value == rankedRows[i].value) continue;
+                if (whichGroup(i, ranked) != groups.value(sourceRowToGroup.value(i, -1))) {
+                    sourceModelChanged();
+                    return;
+                }
+            }
+            rankedRows = ranked;
+        }
+
+        foreach(int row, rows) {
+
+            int groupNo = sourceRowToGroup.value(row, -1);
+            if (groupNo < 0 || groupNo >= groupIndexes.count()) continue;
+
+            int groupRow = sourceRowToGroupRow[row];
+            emit dataChanged(index(groupRow, 1, groupIndexes[groupNo]), index(groupRow, columnCount()-1, groupIndexes[groupNo]));
+        }
+    }
+
     void sourceModelChanged() {
 
         // notify everyone we're changing
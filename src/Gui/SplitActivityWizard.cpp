@@ -799,17 +799,13 @@ SplitConfirm::createRideFile(long start, long stop)
     // and the XData Series, check in bounds too!
     foreach (XDataSeries *xdata, ride->xdata()) {
         XDataSeries* xd = new XDataSeries(*xdata);
-        foreach (XDataPoint *xdp, xd->datapoints) delete xdp;
-        xd->datapoints.clear();
-        foreach (XDataPoint *point, xdata->datapoints) {
-            if (point->secs >= startTime && point->secs <= stopTime) {
-                XDataPoint *pt = new XDataPoint(*point);
-                pt->secs = point->secs - offset;
-                pt->km = point->km - distanceoffset;
-                xd->datapoints.append(pt);
-            }
+        QVector<int> rows;
+        for (int i=0; i<xdata->count(); i++) {
+            if (xdata->secs(i) >= startTime && xdata->secs(i) <= stopTime) rows << i;
         }
-        if (xd->datapoints.count() > 0)
+        xd->select(rows);
+        xd->offset(-offset, -distanceoffset);
+        if (xd->count() > 0)
             returning->addXData(xd->name, xd);
         else
             delete xd;
@@ -829,24 +825,14 @@ SplitConfirm::createRideFile(long start, long stop)
 
     // and the XData Series, check in bounds too!
     foreach (XDataSeries *xdata, ride->xdata()) {
-        XDataSeries* xd = new XDataSeries;
-        xd->name = xdata->name;
-        xd->valuename = xdata->valuename;
-        xd->unitname = xdata->unitname;
-        xd->valuetype = xdata->valuetype;
-        foreach (XDataPoint *point, xdata->datapoints) {
-            if (point->secs >= startTime && point->secs <= stopTime) {
-                XDataPoint *p = new XDataPoint;
-                p->secs = point->secs - offset;
-                p->km = point->km - distanceoffset;
-                for(int i=0; i<XDATA_MAXVALUES; i++) {
-                    p->number[i] = point->number[i];
-                    p->string[i] = point->string[i];
-                }
-                xd->datapoints.append(p);
-            }
+        XDataSeries* xd = new XDataSeries(*xdata);
+        QVector<int> rows;
+        for (int i=0; i<xdata->count(); i++) {
+            if (xdata->secs(i) >= startTime && xdata->secs(i) <= stopTime) rows << i;
         }
-        if (xd->datapoints.count() > 0)
+        xd->select(rows);
+        xd->offset(-offset, -distanceoffset);
+        if (xd->count() > 0)
             returning->addXData(xd->name, xd);
         else
             delete xd;
@@ -138,6 +138,7 @@ class AerobicDecoupling : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new AerobicDecoupling(*this); }
 };
 
@@ -0,0 +1,433 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "AerolabSolver.h"
+#include "RideFile.h"
+#include "Units.h"
+
+#include <QtConcurrent>
+#include <QThread>
+
+#include <cmath>
+#include <limits>
+#include <random>
+
+AerolabData::AerolabData() : n(0)
+{
+    for (int j=0; j<AEROLAB_PARMS; j++) {
+        mean[j] = 0;
+        for (int k=0; k<AEROLAB_PARMS; k++) comoment[j][k] = 0;
+    }
+}
+
+AerolabData::AerolabData(const RideFile *ride, QString name, double start, double stop, bool constantAlt) : AerolabData()
+{
+    this->name = name;
+    if (ride == NULL) return;
+
+    // same model as Aerolab::setData
+    const double vfactor = 3.600;
+    const double g = KG_FORCE_PER_METER;
+    const double small_number = 0.00001;
+    const bool headwind = ride->areDataPresent()->headwind;
+    const double dt = ride->recIntSecs();
+
+    double vlast = 0;
+    double P=0, D=0, W=0, A=0;
+
+    foreach(const RideFilePoint *p, ride->dataPoints()) {
+
+        double v = p->kph/vfactor;
+        double hw = headwind ? p->headwind/vfactor : v;
+        double a = v > small_number ? (v*v - vlast*vlast) / (2.0 * dt * v) : (v - vlast) / dt;
+        vlast = v;
+
+        if (stop > start && (p->secs < start || p->secs > stop)) continue;
+
+        // cumulate the columns, with ve = e0 + (eta/mass)P - crr D - (cda rho/mass)W - A
+        if (v > small_number) P += std::max(0.0, p->watts) * dt / g;
+        D += v * dt;
+        W += hw * hw * v * dt / (2.0 * g);
+        A += a * v * dt / g;
+
+        // residual is the dot product of (eta/mass, crr, cda rho/mass, 1) with x
+        double x[AEROLAB_PARMS] = { P, -D, -W, -(A + (constantAlt ? 0 : p->alt)) };
+
+        // co-moments updated as we go, cumulative values get large
+        // so summing products and subtracting would lose precision
+        n++;
+        double delta[AEROLAB_PARMS];
+        for (int j=0; j<AEROLAB_PARMS; j++) {
+            delta[j] = x[j] - mean[j];
+            mean[j] += delta[j] / n;
+        }
+        for (int j=0; j<AEROLAB_PARMS; j++)
+            for (int k=0; k<AEROLAB_PARMS; k++)
+                comoment[j][k] += delta[j] * (x[k] - mean[k]);
+    }
+}
+
+AerolabFit::AerolabFit() : ok(false), ssr(0), rmse(0), n(0), laps(0)
+{
+    for (int i=0; i<AEROLAB_PARMS; i++) parms[i] = ci[i] = std::numeric_limits<double>::quiet_NaN();
+}
+
+AerolabSolver::AerolabSolver(QObject *parent) : QObject(parent), rho(1.236), chains(0), iterations(20000), n(0), laps(0), halt(0)
+{
+    // aerolab's slider ranges, eta and mass fixed
+    setRange(CdA, 0.15, 0.5, 351);
+    setRange(Crr, 0.001, 0.01, 91);
+    setRange(Eta, 1.0, 1.0, 1);
+    setRange(Mass, 85, 85, 1);
+
+    for (int j=0; j<AEROLAB_PARMS; j++)
+        for (int k=0; k<AEROLAB_PARMS; k++)
+            gram[j][k] = 0;
+
+    connect(&watcher, SIGNAL(finished()), this, SLOT(completed()));
+}
+
+AerolabSolver::~AerolabSolver()
+{
+    stop();
+    watcher.waitForFinished();
+}
+
+void
+AerolabSolver::setData(QList<AerolabData> data)
+{
+    n = laps = 0;
+    for (int j=0; j<AEROLAB_PARMS; j++)
+        for (int k=0; k<AEROLAB_PARMS; k++)
+            gram[j][k] = 0;
+
+    // each lap has its own elevation offset, so co-moments just add up
+    foreach(const AerolabData &lap, data) {
+        if (lap.n < 3) continue;
+        n += lap.n;
+        laps++;
+        for (int j=0; j<AEROLAB_PARMS; j++)
+            for (int k=0; k<AEROLAB_PARMS; k++)
+                gram[j][k] += lap.comoment[j][k];
+    }
+}
+
+void
+AerolabSolver::setRange(int parm, double from, double to, int steps)
+{
+    if (from > to) std::swap(from, to);
+    if (steps < 1 || from == to) steps = 1;
+    this->from[parm] = from;
+    this->to[parm] = to;
+    this->steps[parm] = steps;
+}
+
+double
+AerolabSolver::cost(const double *parms) const
+{
+    if (parms[Mass] <= 0) return std::numeric_limits<double>::max();
+
+    const double theta[AEROLAB_PARMS] = { parms[Eta] / parms[Mass], parms[Crr], parms[CdA] * rho / parms[Mass], 1.0 };
+
+    double ssr = 0;
+    for (int j=0; j<AEROLAB_PARMS; j++)
+        for (int k=0; k<AEROLAB_PARMS; k++)
+            ssr += theta[j] * theta[k] * gram[j][k];
+    return ssr;
+}
+
+// a slice of the grid or an annealing chain
+struct AerolabWork {
+    const AerolabSolver *solver;
+    int method;
+    qint64 first, last; // grid candidates
+    unsigned int seed;  // annealing
+    double best[AEROLAB_PARMS];
+    double cost;
+
+    static void run(AerolabWork &work);
+};
+
+void
+AerolabWork::run(AerolabWork &work)
+{
+    const AerolabSolver *s = work.solver;
+    work.cost = std::numeric_limits<double>::max();
+
+    double parms[AEROLAB_PARMS];
+
+    if (work.method == AerolabSolver::Grid) {
+
+        for (qint64 candidate=work.first; candidate < work.last; candidate++) {
+
+            if ((candidate & 0xffff) == 0 && s->halt.loadAcquire()) return;
+
+            qint64 index = candidate;
+            for (int i=0; i<AEROLAB_PARMS; i++) {
+                int k = index % s->steps[i];
+                index /= s->steps[i];
+                parms[i] = s->steps[i] > 1 ? s->from[i] + (s->to[i] - s->from[i]) * k / (s->steps[i] - 1) : s->from[i];
+            }
+
+            double c = s->cost(parms);
+            if (c < work.cost) {
+                work.cost = c;
+                for (int i=0; i<AEROLAB_PARMS; i++) work.best[i] = parms[i];
+            }
+        }
+
+    } else {
+
+        std::mt19937 random(work.seed);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        std::normal_distribution<double> normal(0.0, 1.0);
+
+        QVector<int> unfixed;
+        for (int i=0; i<AEROLAB_PARMS; i++) {
+            if (s->steps[i] > 1) unfixed << i;
+            parms[i] = s->steps[i] > 1 ? s->from[i] + (s->to[i] - s->from[i]) * unit(random) : s->from[i];
+        }
+
+        double current = s->cost(parms);
+        work.cost = current;
+        for (int i=0; i<AEROLAB_PARMS; i++) work.best[i] = parms[i];
+        if (unfixed.isEmpty()) return;
+
+        // geometric cooling, steps shrink as it cools
+        double t0 = qMax(current, 1e-9) * 0.1;
+        for (int k=0; k<s->iterations; k++) {
+
+            if ((k & 0x3ff) == 0 && s->halt.loadAcquire()) return;
+
+            double temperature = t0 * pow(1e-6, double(k) / s->iterations);
+            double scale = qMax(0.001, 0.1 * sqrt(temperature / t0));
+
+            int i = unfixed[random() % unfixed.count()];
+            double was = parms[i];
+            parms[i] = qBound(s->from[i], was + normal(random) * scale * (s->to[i] - s->from[i]), s->to[i]);
+
+            double c = s->cost(parms);
+            if (c <= current || unit(random) < exp((current - c) / temperature)) {
+                current = c;
+                if (c < work.cost) {
+                    work.cost = c;
+                    for (int j=0; j<AEROLAB_PARMS; j++) work.best[j] = parms[j];
+                }
+            } else {
+                parms[i] = was;
+            }
+        }
+    }
+}
+
+AerolabFit
+AerolabSolver::solve(int method)
+{
+    halt.storeRelease(0);
+
+    if (laps == 0) {
+        AerolabFit fail;
+        fail.error = tr("No laps with enough data to fit");
+        return fail;
+    }
+
+    // no need to search
+    double exact[AEROLAB_PARMS];
+    if (quadratic(exact)) return fitted(exact);
+
+    QVector<AerolabWork> work;
+    AerolabWork add;
+    add.solver = this;
+    add.method = method;
+
+    if (method == Grid) {
+
+        qint64 candidates = 1;
+        for (int i=0; i<AEROLAB_PARMS; i++) candidates *= steps[i];
+
+        // a few slices per thread to balance the load
+        int slices = qMax(1, QThread::idealThreadCount() * 4);
+        qint64 size = qMax(qint64(1), (candidates + slices - 1) / slices);
+        for (qint64 first=0; first < candidates; first += size) {
+            add.first = first;
+            add.last = qMin(candidates, first + size);
+            work << add;
+        }
+
+    } else {
+
+        int count = chains > 0 ? chains : qMax(1, QThread::idealThreadCount());
+        for (int i=0; i<count; i++) {
+            add.seed = 2026 + i;
+            work << add;
+        }
+    }
+
+    QtConcurrent::blockingMap(work, AerolabWork::run);
+
+    int best = 0;
+    for (int i=1; i<work.count(); i++) if (work[i].cost < work[best].cost) best = i;
+
+    if (halt.loadAcquire()) {
+        AerolabFit fail;
+        fail.error = tr("Stopped");
+        return fail;
+    }
+    return fitted(work[best].best);
+}
+
+bool
+AerolabSolver::quadratic(double *best) const
+{
+    if (steps[Eta] > 1 || steps[Mass] > 1 || from[Mass] <= 0 || rho <= 0) return false;
+
+    // theta = (eta/mass, crr, cda rho/mass, 1), the first and last are
+    // fixed so the cost is a quadratic in x = (crr, cda rho/mass)
+    const double mass = from[Mass];
+    const double theta0 = from[Eta] / mass;
+    const double lo[2] = { from[Crr], from[CdA] * rho / mass };
+    const double hi[2] = { to[Crr], to[CdA] * rho / mass };
+    const bool free[2] = { steps[Crr] > 1, steps[CdA] > 1 };
+
+    // cost = x'Hx + 2b'x + c
+    const double h[2][2] = { { gram[1][1], gram[1][2] }, { gram[2][1], gram[2][2] } };
+    const double b[2] = { gram[1][0] * theta0 + gram[1][3], gram[2][0] * theta0 + gram[2][3] };
+
+    // x[i] minimising with the other held, within its range
+    auto along = [&](int i, const double *x) {
+        if (!free[i] || h[i][i] <= 0) return lo[i];
+        return qBound(lo[i], -(b[i] + h[i][1-i] * x[1-i]) / h[i][i], hi[i]);
+    };
+    auto value = [&](const double *x) {
+        return h[0][0]*x[0]*x[0] + 2*h[0][1]*x[0]*x[1] + h[1][1]*x[1]*x[1] + 2*b[0]*x[0] + 2*b[1]*x[1];
+    };
+
+    double x[2] = { lo[0], lo[1] };
+    double det = h[0][0] * h[1][1] - h[0][1] * h[1][0];
+    bool inside = false;
+
+    if (free[0] && free[1] && det > 1e-12 * qMax(1.0, h[0][0] * h[1][1])) {
+
+        // unconstrained minimum
+        x[0] = (-b[0] * h[1][1] + b[1] * h[0][1]) / det;
+        x[1] = (-b[1] * h[0][0] + b[0] * h[1][0]) / det;
+        inside = x[0] >= lo[0] && x[0] <= hi[0] && x[1] >= lo[1] && x[1] <= hi[1];
+    }
+
+    if (!inside) {
+
+        // the cost is convex, so otherwise the minimum is on an edge
+        double cost = std::numeric_limits<double>::max();
+        for (int i=0; i<2; i++) {
+            for (int edge=0; edge<2; edge++) {
+                double e[2];
+                e[1-i] = edge ? hi[1-i] : lo[1-i];
+                if (!free[1-i] && edge) continue;
+                e[i] = along(i, e);
+                double c = value(e);
+                if (c < cost) {
+                    cost = c;
+                    x[0] = e[0];
+                    x[1] = e[1];
+                }
+            }
+        }
+    }
+
+    best[Crr] = x[0];
+    best[CdA] = x[1] * mass / rho;
+    best[Eta] = from[Eta];
+    best[Mass] = mass;
+    return true;
+}
+
+AerolabFit
+AerolabSolver::fitted(const double *best) const
+{
+    AerolabFit returning;
+    returning.ok = true;
+    returning.n = n;
+    returning.laps = laps;
+    for (int i=0; i<AEROLAB_PARMS; i++) returning.parms[i] = best[i];
+    returning.ssr = cost(best);
+    returning.rmse = sqrt(returning.ssr / n);
+
+    // how theta = (eta/mass, crr, cda rho/mass) moves with each parameter
+    const double cda = best[CdA], eta = best[Eta], mass = best[Mass];
+    double dtheta[3][AEROLAB_PARMS] = {
+        { 0, 0, 1.0/mass, -eta/(mass*mass) },
+        { 0, 1.0, 0, 0 },
+        { rho/mass, 0, 0, -cda*rho/(mass*mass) }
+    };
+
+    QVector<int> unfixed;
+    for (int i=0; i<AEROLAB_PARMS; i++) if (steps[i] > 1) unfixed << i;
+    int m = unfixed.count();
+    int dof = n - laps - m;
+    if (m == 0 || dof <= 0) return returning;
+
+    // J'J = T' G T, augmented with the identity to invert it
+    QVector<QVector<double> > a(m, QVector<double>(2*m, 0));
+    for (int p=0; p<m; p++) {
+        for (int q=0; q<m; q++) {
+            double sum = 0;
+            for (int j=0; j<3; j++)
+                for (int k=0; k<3; k++)
+                    sum += dtheta[j][unfixed[p]] * gram[j][k] * dtheta[k][unfixed[q]];
+            a[p][q] = sum;
+        }
+        a[p][m+p] = 1;
+    }
+
+    double scale = 0;
+    for (int p=0; p<m; p++) scale = qMax(scale, fabs(a[p][p]));
+
+    // gauss-jordan, parameters that can't be told apart leave it singular
+    for (int c=0; c<m; c++) {
+        int pivot = c;
+        for (int r=c+1; r<m; r++) if (fabs(a[r][c]) > fabs(a[pivot][c])) pivot = r;
+        if (fabs(a[pivot][c]) <= 1e-12 * scale) return returning;
+        std::swap(a[c], a[pivot]);
+        double d = a[c][c];
+        for (int k=0; k<2*m; k++) a[c][k] /= d;
+        for (int r=0; r<m; r++) {
+            if (r == c || a[r][c] == 0) continue;
+            double f = a[r][c];
+            for (int k=0; k<2*m; k++) a[r][k] -= f * a[c][k];
+        }
+    }
+
+    double variance = returning.ssr / dof;
+    for (int p=0; p<m; p++)
+        if (a[p][m+p] > 0) returning.ci[unfixed[p]] = 1.96 * sqrt(variance * a[p][m+p]);
+
+    return returning;
+}
+
+void
+AerolabSolver::start(int method)
+{
+    if (watcher.isRunning()) return;
+    watcher.setFuture(QtConcurrent::run([this, method]() { fit = solve(method); }));
+}
+
+void
+AerolabSolver::completed()
+{
+    emit finished();
+}
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef _GC_AerolabSolver_h
+#define _GC_AerolabSolver_h 1
+#include "GoldenCheetah.h"
+
+#include <QObject>
+#include <QList>
+#include <QString>
+#include <QAtomicInt>
+#include <QFutureWatcher>
+
+class RideFile;
+
+//
+// Fits CdA, Crr, drivetrain efficiency and total mass to one or more
+// files or laps jointly, by minimising the difference between the
+// virtual elevation (see Aerolab.cpp) and the recorded elevation.
+//
+// Virtual elevation is linear in the columns P (work), D (distance),
+// W (headwind squared x distance) and A (kinetic energy) cumulated
+// over the samples:
+//
+//   ve = e0 + (eta/mass) P - crr D - (cda rho/mass) W - A
+//
+// so each file or lap is reduced once to the co-moments of those
+// columns and the elevation. The sum of squared residuals for any
+// candidate, with the best elevation offset for each lap, is then
+// a 4x4 quadratic form regardless of how many samples there are.
+//
+// With eta and mass fixed the residual is an exact quadratic in crr
+// and cda, so it is minimised in closed form within the ranges and
+// neither the grid or annealing are needed.
+//
+// Grids are split across the thread pool, annealing runs independent
+// chains on each thread. Confidence intervals come from the curvature
+// of the residual at the best fit, they are NaN for parameters that
+// were fixed or can't be told apart (e.g. eta and mass both free).
+//
+#define AEROLAB_PARMS 4
+
+class AerolabData
+{
+    public:
+        AerolabData();
+
+        // samples between start and stop secs, or the whole ride if stop <= start
+        // constantAlt is for velodromes and the like, the elevation is flat
+        AerolabData(const RideFile *ride, QString name, double start=0, double stop=0, bool constantAlt=false);
+
+        QString name;
+        int n;
+        double mean[AEROLAB_PARMS];
+        double comoment[AEROLAB_PARMS][AEROLAB_PARMS];
+};
+
+class AerolabFit
+{
+    public:
+        AerolabFit();
+
+        bool ok;
+        QString error;
+        double parms[AEROLAB_PARMS];
+        double ci[AEROLAB_PARMS]; // +/- at 95%
+        double ssr, rmse; // elevation, metres
+        int n, laps;
+};
+
+class AerolabSolver : public QObject
+{
+    Q_OBJECT
+
+    public:
+        enum { CdA=0, Crr, Eta, Mass };
+        enum { Grid, Anneal };
+
+        AerolabSolver(QObject *parent=NULL);
+        ~AerolabSolver();
+
+        void setData(QList<AerolabData> data);
+        void setRho(double x) { rho = x; }
+
+        // steps 1 fixes the parameter at from
+        void setRange(int parm, double from, double to, int steps);
+        void setAnneal(int chains, int iterations) { this->chains = chains; this->iterations = iterations; }
+
+        // sum of squared residuals for a candidate
+        double cost(const double *parms) const;
+
+        // blocks until done, uses the thread pool
+        AerolabFit solve(int method);
+
+        // without blocking, finished() is emitted when done
+        void start(int method);
+        void stop() { halt.storeRelease(1); }
+        bool isRunning() const { return watcher.isRunning(); }
+        AerolabFit result() const { return fit; }
+
+    signals:
+        void finished();
+
+    private slots:
+        void completed();
+
+    private:
+        friend struct AerolabWork;
+
+        AerolabFit fitted(const double *best) const;
+
+        // closed form when eta and mass are fixed, false if they aren't
+        bool quadratic(double *best) const;
+
+        double rho;
+        double from[AEROLAB_PARMS], to[AEROLAB_PARMS];
+        int steps[AEROLAB_PARMS];
+        int chains, iterations;
+
+        // all the laps summed
+        int n, laps;
+        double gram[AEROLAB_PARMS][AEROLAB_PARMS];
+
+        QAtomicInt halt;
+        QFutureWatcher<void> watcher;
+        AerolabFit fit;
+};
+
+#endif // _GC_AerolabSolver_h
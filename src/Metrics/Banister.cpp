@@ -648,6 +648,7 @@ class PowerIndex : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new PowerIndex(*this); }
 };
 
@@ -705,6 +706,7 @@ class PeakPowerIndex : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new PeakPowerIndex(*this); }
 };
 
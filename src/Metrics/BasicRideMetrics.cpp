@@ -22,6 +22,7 @@
 #include "Settings.h"
 #include "RideItem.h"
 #include "IntervalItem.h"
+#include "RideFileIndex.h"
 #include "LTMOutliers.h"
 #include "Units.h"
 #include "Zones.h"
@@ -54,6 +55,7 @@ class RideDate : public RideMetric {
     }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new RideDate(*this); }
 };
 
@@ -83,6 +85,7 @@ class RideCount : public RideMetric {
     }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new RideCount(*this); }
 };
 
@@ -119,6 +122,7 @@ class ToExhaustion : public RideMetric {
     }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new ToExhaustion(*this); }
 };
 
@@ -152,6 +156,7 @@ class ElapsedTime : public RideMetric {
     }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new ElapsedTime(*this); }
 };
 
@@ -202,6 +207,7 @@ class WorkoutTime : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new WorkoutTime(*this); }
 };
 
@@ -250,6 +256,7 @@ class TimeRecording : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new TimeRecording(*this); }
 };
 
@@ -306,6 +313,7 @@ class TimeRiding : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new TimeRiding(*this); }
 };
 
@@ -387,6 +395,7 @@ class TimeCarrying : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return !ride->isSwim && !ride->isRun; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new TimeCarrying(*this); }
 };
 
@@ -461,6 +470,7 @@ class ElevationGainCarrying : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new ElevationGainCarrying(*this); }
 };
 
@@ -526,6 +536,7 @@ class TotalDistance : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new TotalDistance(*this); }
 };
 
@@ -578,6 +589,7 @@ class ClimbRating : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return !ride->isSwim; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new ClimbRating(*this); }
 };
 
@@ -628,6 +640,7 @@ class AthleteWeight : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::WeightConfig; }
     RideMetric *clone() const { return new AthleteWeight(*this); }
 };
 
@@ -670,6 +683,7 @@ class AthleteFat : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::WeightConfig; }
     RideMetric *clone() const { return new AthleteFat(*this); }
 };
 
@@ -707,6 +721,7 @@ class AthleteBones : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::WeightConfig; }
     RideMetric *clone() const { return new AthleteBones(*this); }
 };
 
@@ -744,6 +759,7 @@ class AthleteMuscles : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::WeightConfig; }
     RideMetric *clone() const { return new AthleteMuscles(*this); }
 };
 
@@ -781,6 +797,7 @@ class AthleteLean : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::WeightConfig; }
     RideMetric *clone() const { return new AthleteLean(*this); }
 };
 
@@ -822,6 +839,7 @@ class AthleteFatP : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::WeightConfig; }
     RideMetric *clone() const { return new AthleteFatP(*this); }
 };
 
@@ -889,6 +907,7 @@ class ElevationGain : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return !ride->isSwim; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new ElevationGain(*this); }
 };
 
@@ -956,6 +975,7 @@ class ElevationLoss : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return !ride->isSwim; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new ElevationLoss(*this); }
 };
 
@@ -1008,6 +1028,7 @@ class TotalWork : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return ride->present.contains("P") || (!ride->isSwim && !ride->isRun); }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new TotalWork(*this); }
 };
 
@@ -1070,6 +1091,7 @@ class AvgSpeed : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new AvgSpeed(*this); }
 };
 
@@ -1100,26 +1122,39 @@ struct AvgPower : public RideMetric {
         setDescription(tr("Average Power from all samples with power greater than or equal to zero"));
     }
 
-    void compute(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &) {
+    void compute(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &deps) {
+        accumulate(item, spec, deps);
+    }
+
+    bool accumulates() const { return true; }
+
+    bool begin(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &) {
 
         // no ride or no samples
         if (item->ride() == NULL || !item->ride()->areDataPresent()->watts || item->ride()->dataPoints().count() == 0) {
             setValue(RideFile::NIL);
             setCount(0);
-            return;
+            return false;
         }
 
         total = count = 0;
-    
-        RideFileIterator it(item->ride(), spec);
-        while (it.hasNext()) {
-            struct RideFilePoint *point = it.next();
+        return true;
+    }
 
-            if (point->watts >= 0.0) {
-                total += point->watts;
-                ++count;
-            }
+    bool range(RideFileIndex &index, int start, int stop) {
+        total = index.sum(RideFile::watts, start, stop);
+        count = index.count(RideFile::watts, start, stop, true);
+        return true;
+    }
+
+    void update(const RideFilePoint *point) {
+        if (point->watts >= 0.0) {
+            total += point->watts;
+            ++count;
         }
+    }
+
+    void end() {
         setValue(count > 0 ? total / count : 0);
         setCount(count);
     }
@@ -1127,6 +1162,7 @@ struct AvgPower : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return ride->present.contains("P") || (!ride->isSwim && !ride->isRun); }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new AvgPower(*this); }
 };
 
@@ -1156,26 +1192,39 @@ struct AvgSmO2 : public RideMetric {
         setDescription(tr("Average Muscle Oxygen Saturation, the percentage of hemoglobin that is carrying oxygen."));
     }
 
-    void compute(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &) {
+    void compute(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &deps) {
+        accumulate(item, spec, deps);
+    }
+
+    bool accumulates() const { return true; }
+
+    bool begin(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &) {
 
         // no ride or no samples
         if (item->ride() == NULL || !item->ride()->areDataPresent()->smo2 || item->ride()->dataPoints().count() == 0) {
             setValue(RideFile::NIL);
             setCount(0);
-            return;
+            return false;
         }
 
         total = count = 0;
+        return true;
+    }
 
-        RideFileIterator it(item->ride(), spec);
-        while (it.hasNext()) {
-            struct RideFilePoint *point = it.next();
+    bool range(RideFileIndex &index, int start, int stop) {
+        total = index.sum(RideFile::smo2, start, stop);
+        count = index.count(RideFile::smo2, start, stop);
+        return true;
+    }
 
-            if (point->smo2 > 0.0f) {  // SmO2 should always be > 0.0f
-                total += point->smo2;
-                ++count;
-            }
+    void update(const RideFilePoint *point) {
+        if (point->smo2 > 0.0f) {  // SmO2 should always be > 0.0f
+            total += point->smo2;
+            ++count;
         }
+    }
+
+    void end() {
         setValue(count > 0 ? total / count : 0);
         setCount(count);
     }
@@ -1184,6 +1233,7 @@ struct AvgSmO2 : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new AvgSmO2(*this); }
 };
 
@@ -1212,25 +1262,39 @@ struct AvgtHb : public RideMetric {
         setDescription(tr("Average total hemoglobin concentration. The total grams of hemoglobin per deciliter."));
     }
 
-    void compute(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &) {
+    void compute(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &deps) {
+        accumulate(item, spec, deps);
+    }
+
+    bool accumulates() const { return true; }
+
+    bool begin(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &) {
 
         // no ride or no samples
         if (item->ride() == NULL || !item->ride()->areDataPresent()->thb || item->ride()->dataPoints().count() == 0) {
             setValue(RideFile::NIL);
             setCount(0);
-            return;
+            return false;
         }
 
         total = count = 0.0f;
+        return true;
+    }
 
-        RideFileIterator it(item->ride(), spec);
-        while (it.hasNext()) {
-            struct RideFilePoint *point = it.next();
-            if (point->thb > 0.0f) {
-                total += point->thb;
-                ++count;
-            }
+    bool range(RideFileIndex &index, int start, int stop) {
+        total = index.sum(RideFile::thb, start, stop);
+        count = index.count(RideFile::thb, start, stop);
+        return true;
+    }
+
+    void update(const RideFilePoint *point) {
+        if (point->thb > 0.0f) {
+            total += point->thb;
+            ++count;
         }
+    }
+
+    void end() {
         setValue(count > 0.0f ? total / count : 0.0f);
         setCount(count);
     }
@@ -1239,6 +1303,7 @@ struct AvgtHb : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new AvgtHb(*this); }
 };
 
@@ -1293,6 +1358,7 @@ struct AAvgPower : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return ride->present.contains("P") || (!ride->isSwim && !ride->isRun); }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new AAvgPower(*this); }
 };
 
@@ -1322,25 +1388,39 @@ struct NonZeroPower : public RideMetric {
         setDescription(tr("Average Power without zero values, it gives inflated values when frecuent coasting is present"));
     }
 
-    void compute(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &) {
+    void compute(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &deps) {
+        accumulate(item, spec, deps);
+    }
+
+    bool accumulates() const { return true; }
+
+    bool begin(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &) {
 
         // no ride or no samples
         if (item->ride() == NULL || !item->ride()->areDataPresent()->watts || item->ride()->dataPoints().count() == 0) {
             setValue(RideFile::NIL);
             setCount(0);
-            return;
+            return false;
         }
 
         total = count = 0;
+        return true;
+    }
 
-        RideFileIterator it(item->ride(), spec);
-        while (it.hasNext()) {
-            struct RideFilePoint *point = it.next();
-            if (point->watts > 0.0) {
-                total += point->watts;
-                ++count;
-            }
+    bool range(RideFileIndex &index, int start, int stop) {
+        total = index.sum(RideFile::watts, start, stop);
+        count = index.count(RideFile::watts, start, stop);
+        return true;
+    }
+
+    void update(const RideFilePoint *point) {
+        if (point->watts > 0.0) {
+            total += point->watts;
+            ++count;
         }
+    }
+
+    void end() {
         setValue(count > 0 ? total / count : 0);
         setCount(count);
     }
@@ -1348,6 +1428,7 @@ struct NonZeroPower : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return ride->present.contains("P") || (!ride->isSwim && !ride->isRun); }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new NonZeroPower(*this); }
 };
 
@@ -1377,24 +1458,39 @@ struct AvgHeartRate : public RideMetric {
         setDescription(tr("Average Heart Rate computed for samples when hr is greater than zero"));
     }
 
-    void compute(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &) {
+    void compute(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &deps) {
+        accumulate(item, spec, deps);
+    }
+
+    bool accumulates() const { return true; }
+
+    bool begin(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &) {
 
         // no ride or no samples
         if (item->ride() == NULL || !item->ride()->areDataPresent()->hr || item->ride()->dataPoints().count() == 0) {
             setValue(RideFile::NIL);
             setCount(0);
-            return;
+            return false;
         }
 
         total = count = 0;
-        RideFileIterator it(item->ride(), spec);
-        while (it.hasNext()) {
-            struct RideFilePoint *point = it.next();
-            if (point->hr > 0) {
-                total += point->hr;
-                ++count;
-            }
+        return true;
+    }
+
+    bool range(RideFileIndex &index, int start, int stop) {
+        total = index.sum(RideFile::hr, start, stop);
+        count = index.count(RideFile::hr, start, stop);
+        return true;
+    }
+
+    void update(const RideFilePoint *point) {
+        if (point->hr > 0) {
+            total += point->hr;
+            ++count;
         }
+    }
+
+    void end() {
         setValue(count > 0 ? total / count : 0);
         setCount(count);
     }
@@ -1403,6 +1499,7 @@ struct AvgHeartRate : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new AvgHeartRate(*this); }
 };
 
@@ -1459,6 +1556,7 @@ struct AvgCoreTemp : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new AvgCoreTemp(*this); }
 };
 
@@ -1510,6 +1608,7 @@ struct HeartBeats : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new HeartBeats(*this); }
 };
 
@@ -1551,6 +1650,7 @@ class HrPw : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return ride->present.contains("P") || (!ride->isSwim && !ride->isRun); }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new HrPw(*this); }
 };
 
@@ -1598,6 +1698,7 @@ class Workbeat : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return ride->present.contains("P") || (!ride->isSwim && !ride->isRun); }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new Workbeat(*this); }
 };
 
@@ -1647,6 +1748,7 @@ class WattsRPE : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return ride->present.contains("P") || (!ride->isSwim && !ride->isRun); }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new WattsRPE(*this); }
 };
 
@@ -1698,6 +1800,7 @@ class APPercent : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return ride->present.contains("P") || (!ride->isSwim && !ride->isRun); }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::PowerZonesConfig; }
     RideMetric *clone() const { return new APPercent(*this); }
 };
 
@@ -1748,6 +1851,7 @@ class HrNp : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return ride->present.contains("P") || (!ride->isSwim && !ride->isRun); }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new HrNp(*this); }
 };
 
@@ -1812,6 +1916,7 @@ struct AvgCadence : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new AvgCadence(*this); }
 };
 
@@ -1880,6 +1985,7 @@ struct AvgTemp : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new AvgTemp(*this); }
 };
 
@@ -1906,26 +2012,42 @@ class MaxPower : public RideMetric {
         setDescription(tr("Maximum Power"));
     }
 
-    void compute(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &) {
+    void compute(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &deps) {
+        accumulate(item, spec, deps);
+    }
+
+    bool accumulates() const { return true; }
+
+    bool begin(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &) {
 
         // no ride or no samples
         if (spec.isEmpty(item->ride())) {
             setValue(RideFile::NIL);
             setCount(0);
-            return;
+            return false;
         }
 
-        RideFileIterator it(item->ride(), spec);
-        while (it.hasNext()) {
-            struct RideFilePoint *point = it.next();
-            if (point->watts >= max)
-                max = point->watts;
-        }
+        max = 0;
+        return true;
+    }
+
+    bool range(RideFileIndex &index, int start, int stop) {
+        max = qMax(0.0, index.max(RideFile::watts, start, stop));
+        return true;
+    }
+
+    void update(const RideFilePoint *point) {
+        if (point->watts >= max)
+            max = point->watts;
+    }
+
+    void end() {
         setValue(max);
     }
     bool isRelevantForRide(const RideItem *ride) const { return ride->present.contains("P") || (!ride->isSwim && !ride->isRun); }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new MaxPower(*this); }
 };
 
@@ -1952,21 +2074,36 @@ class MaxSmO2 : public RideMetric {
         setDescription(tr("Maximum Muscle Oxygen Saturation, the percentage of hemoglobin that is carrying oxygen."));
     }
 
-    void compute(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &) {
+    void compute(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &deps) {
+        accumulate(item, spec, deps);
+    }
+
+    bool accumulates() const { return true; }
+
+    bool begin(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &) {
 
         // no ride or no samples
         if (spec.isEmpty(item->ride())) {
             setValue(RideFile::NIL);
             setCount(0);
-            return;
+            return false;
         }
 
-        RideFileIterator it(item->ride(), spec);
-        while (it.hasNext()) {
-            struct RideFilePoint *point = it.next();
-            if (point->smo2 >= max)
-                max = point->smo2;
-        }
+        max = 0;
+        return true;
+    }
+
+    bool range(RideFileIndex &index, int start, int stop) {
+        max = qMax(0.0, index.max(RideFile::smo2, start, stop));
+        return true;
+    }
+
+    void update(const RideFilePoint *point) {
+        if (point->smo2 >= max)
+            max = point->smo2;
+    }
+
+    void end() {
         setValue(max);
     }
 
@@ -1974,6 +2111,7 @@ class MaxSmO2 : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new MaxSmO2(*this); }
 };
 
@@ -1999,22 +2137,36 @@ class MaxtHb : public RideMetric {
         setDescription(tr("Maximum total hemoglobin concentration. The total grams of hemoglobin per deciliter."));
     }
 
-    void compute(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &) {
+    void compute(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &deps) {
+        accumulate(item, spec, deps);
+    }
+
+    bool accumulates() const { return true; }
+
+    bool begin(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &) {
 
         // no ride or no samples
         if (spec.isEmpty(item->ride())) {
             setValue(RideFile::NIL);
             setCount(0);
-            return;
+            return false;
         }
 
-        RideFileIterator it(item->ride(), spec);
-        while (it.hasNext()) {
-            struct RideFilePoint *point = it.next();
+        max = 0;
+        return true;
+    }
 
-            if (point->thb >= max)
-                max = point->thb;
-        }
+    bool range(RideFileIndex &index, int start, int stop) {
+        max = qMax(0.0, index.max(RideFile::thb, start, stop));
+        return true;
+    }
+
+    void update(const RideFilePoint *point) {
+        if (point->thb >= max)
+            max = point->thb;
+    }
+
+    void end() {
         setValue(max);
     }
 
@@ -2022,6 +2174,7 @@ class MaxtHb : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new MaxtHb(*this); }
 };
 
@@ -2033,6 +2186,7 @@ static bool maxtHbAdded =
 class MinSmO2 : public RideMetric {
     Q_DECLARE_TR_FUNCTIONS(MinSmO2)
     double min;
+    bool notset;
     public:
     MinSmO2() : min(0.0)
     {
@@ -2047,32 +2201,41 @@ class MinSmO2 : public RideMetric {
         setDescription(tr("Minimum Muscle Oxygen Saturation, the percentage of hemoglobin that is carrying oxygen."));
     }
 
-    void compute(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &) {
+    void compute(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &deps) {
+        accumulate(item, spec, deps);
+    }
+
+    bool accumulates() const { return true; }
+
+    bool begin(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &) {
 
         // no ride or no samples
         if (spec.isEmpty(item->ride())) {
             setValue(RideFile::NIL);
             setCount(0);
-            return;
+            return false;
         }
 
-        bool notset = true;
-
-        RideFileIterator it(item->ride(), spec);
-        while (it.hasNext()) {
-            struct RideFilePoint *point = it.next();
+        notset = true;
+        min = 0;
+        return true;
+    }
 
-            if (point->smo2 >= 0.0f && (notset || point->smo2 < min)) {
-                min = point->smo2;
-                if (point->smo2 > 0.0f && notset)
-                  notset = false;
-            }
+    void update(const RideFilePoint *point) {
+        if (point->smo2 >= 0.0f && (notset || point->smo2 < min)) {
+            min = point->smo2;
+            if (point->smo2 > 0.0f && notset)
+              notset = false;
         }
+    }
+
+    void end() {
         setValue(min);
     }
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new MinSmO2(*this); }
 };
 
@@ -2082,6 +2245,7 @@ static bool minSmO2Added =
 class MintHb : public RideMetric {
     Q_DECLARE_TR_FUNCTIONS(MintHb)
     double min;
+    bool notset;
     public:
     MintHb() : min(0.0)
     {
@@ -2098,29 +2262,44 @@ class MintHb : public RideMetric {
         setDescription(tr("Minimum total hemoglobin concentration. The total grams of hemoglobin per deciliter."));
     }
 
-    void compute(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &) {
+    void compute(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &deps) {
+        accumulate(item, spec, deps);
+    }
+
+    bool accumulates() const { return true; }
+
+    bool begin(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &) {
 
         // no ride or no samples
         if (spec.isEmpty(item->ride())) {
             setValue(RideFile::NIL);
             setCount(0);
-            return;
+            return false;
         }
 
-        bool notset = true;
+        notset = true;
+        min = 0;
+        return true;
+    }
 
-        RideFileIterator it(item->ride(), spec);
-        while (it.hasNext()) {
-            struct RideFilePoint *point = it.next();
-            if (point->thb > 0.0f && (notset || point->thb < min)) {
-                min = point->thb;
-                notset = false;
-            }
+    bool range(RideFileIndex &index, int start, int stop) {
+        min = index.minPositive(RideFile::thb, start, stop);
+        return true;
+    }
+
+    void update(const RideFilePoint *point) {
+        if (point->thb > 0.0f && (notset || point->thb < min)) {
+            min = point->thb;
+            notset = false;
         }
+    }
+
+    void end() {
         setValue(min);
     }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new MintHb(*this); }
 };
 
@@ -2147,21 +2326,36 @@ class MaxHr : public RideMetric {
         setDescription(tr("Maximum Heart Rate."));
     }
 
-    void compute(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &) {
+    void compute(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &deps) {
+        accumulate(item, spec, deps);
+    }
+
+    bool accumulates() const { return true; }
+
+    bool begin(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &) {
 
         // no ride or no samples
         if (spec.isEmpty(item->ride())) {
             setValue(RideFile::NIL);
             setCount(0);
-            return;
+            return false;
         }
 
-        RideFileIterator it(item->ride(), spec);
-        while (it.hasNext()) {
-            struct RideFilePoint *point = it.next();
-            if (point->hr >= max)
-                max = point->hr;
-        }
+        max = 0;
+        return true;
+    }
+
+    bool range(RideFileIndex &index, int start, int stop) {
+        max = qMax(0.0, index.max(RideFile::hr, start, stop));
+        return true;
+    }
+
+    void update(const RideFilePoint *point) {
+        if (point->hr >= max)
+            max = point->hr;
+    }
+
+    void end() {
         setValue(max);
     }
 
@@ -2169,6 +2363,7 @@ class MaxHr : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new MaxHr(*this); }
 };
 
@@ -2180,6 +2375,7 @@ static bool maxHrAdded =
 class MinHr : public RideMetric {
     Q_DECLARE_TR_FUNCTIONS(MinHr)
     double min;
+    bool notset;
     public:
     MinHr() : min(0.0)
     {
@@ -2195,27 +2391,39 @@ class MinHr : public RideMetric {
         setDescription(tr("Minimum Heart Rate."));
     }
 
-    void compute(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &) {
+    void compute(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &deps) {
+        accumulate(item, spec, deps);
+    }
+
+    bool accumulates() const { return true; }
+
+    bool begin(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &) {
 
         // no ride or no samples
         if (spec.isEmpty(item->ride())) {
             setValue(RideFile::NIL);
             setCount(0);
-            return;
+            return false;
         }
 
-        bool notset = true;
+        notset = true;
         min = 0;
+        return true;
+    }
 
-        RideFileIterator it(item->ride(), spec);
-        while (it.hasNext()) {
-            struct RideFilePoint *point = it.next();
+    bool range(RideFileIndex &index, int start, int stop) {
+        min = index.minPositive(RideFile::hr, start, stop);
+        return true;
+    }
 
-            if (point->hr > 0 && (notset || point->hr < min)) {
-                min = point->hr;
-                notset = false;
-            }
+    void update(const RideFilePoint *point) {
+        if (point->hr > 0 && (notset || point->hr < min)) {
+            min = point->hr;
+            notset = false;
         }
+    }
+
+    void end() {
         setValue(min);
     }
 
@@ -2223,6 +2431,7 @@ class MinHr : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new MinHr(*this); }
 };
 
@@ -2250,22 +2459,36 @@ class MaxCT : public RideMetric {
         setDescription(tr("Maximum Core Temperature. The core body temperature estimate is based on HR data"));
     }
 
-    void compute(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &) {
+    void compute(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &deps) {
+        accumulate(item, spec, deps);
+    }
+
+    bool accumulates() const { return true; }
+
+    bool begin(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &) {
 
         // no ride or no samples
         if (spec.isEmpty(item->ride())) {
             setValue(RideFile::NIL);
             setCount(0);
-            return;
+            return false;
         }
 
-        RideFileIterator it(item->ride(), spec);
-        while (it.hasNext()) {
-            struct RideFilePoint *point = it.next();
+        max = 0;
+        return true;
+    }
 
-            if (point->tcore >= max)
-                max = point->tcore;
-        }
+    bool range(RideFileIndex &index, int start, int stop) {
+        max = qMax(0.0, index.max(RideFile::tcore, start, stop));
+        return true;
+    }
+
+    void update(const RideFilePoint *point) {
+        if (point->tcore >= max)
+            max = point->tcore;
+    }
+
+    void end() {
         setValue(max);
     }
 
@@ -2273,6 +2496,7 @@ class MaxCT : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new MaxCT(*this); }
 };
 
@@ -2326,6 +2550,7 @@ class MaxSpeed : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new MaxSpeed(*this); }
 };
 
@@ -2376,6 +2601,7 @@ class MaxCadence : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new MaxCadence(*this); }
 };
 
@@ -2432,6 +2658,7 @@ class MaxTemp : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new MaxTemp(*this); }
 };
 
@@ -2488,6 +2715,7 @@ class MinTemp : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new MinTemp(*this); }
 };
 
@@ -2539,6 +2767,7 @@ class NinetyFivePercentHeartRate : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return ride->present.contains("H"); }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new NinetyFivePercentHeartRate(*this); }
 };
 
@@ -2574,6 +2803,7 @@ class VAM : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return !ride->isSwim; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new VAM(*this); }
 };
 
@@ -2619,6 +2849,7 @@ class EOA : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return ride->present.contains("P") || (!ride->isSwim && !ride->isRun); }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new EOA(*this); }
 };
 
@@ -2667,6 +2898,7 @@ class Gradient : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return !ride->isSwim; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new Gradient(*this); }
 };
 
@@ -2742,6 +2974,7 @@ class MeanPowerVariance : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new MeanPowerVariance(*this); }
 };
 
@@ -2800,6 +3033,7 @@ class MaxPowerVariance : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new MaxPowerVariance(*this); }
 };
 
@@ -2865,6 +3099,7 @@ class AvgLTE : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return !ride->isSwim && !ride->isRun; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new AvgLTE(*this); }
 };
 
@@ -2919,6 +3154,7 @@ class AvgRTE : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return !ride->isSwim && !ride->isRun; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new AvgRTE(*this); }
 };
 
@@ -2973,6 +3209,7 @@ class AvgLPS : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return !ride->isSwim && !ride->isRun; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new AvgLPS(*this); }
 };
 
@@ -3026,6 +3263,7 @@ class AvgRPS : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return !ride->isSwim && !ride->isRun; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new AvgRPS(*this); }
 };
 
@@ -3081,6 +3319,7 @@ class AvgLPCO : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return !ride->isSwim && !ride->isRun; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new AvgLPCO(*this); }
 };
 
@@ -3135,6 +3374,7 @@ class AvgRPCO : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return !ride->isSwim && !ride->isRun; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new AvgRPCO(*this); }
 };
 
@@ -3187,6 +3427,7 @@ class AvgLPPB : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return !ride->isSwim && !ride->isRun; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new AvgLPPB(*this); }
 };
 
@@ -3240,6 +3481,7 @@ class AvgRPPB : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return !ride->isSwim && !ride->isRun; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new AvgRPPB(*this); }
 };
 
@@ -3293,6 +3535,7 @@ class AvgLPPE : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return !ride->isSwim && !ride->isRun; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new AvgLPPE(*this); }
 };
 
@@ -3346,6 +3589,7 @@ class AvgRPPE : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return !ride->isSwim && !ride->isRun; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new AvgRPPE(*this); }
 };
 
@@ -3399,6 +3643,7 @@ class AvgLPPPB : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return !ride->isSwim && !ride->isRun; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new AvgLPPPB(*this); }
 };
 
@@ -3452,6 +3697,7 @@ class AvgRPPPB : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return !ride->isSwim && !ride->isRun; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new AvgRPPPB(*this); }
 };
 
@@ -3505,6 +3751,7 @@ class AvgLPPPE : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return !ride->isSwim && !ride->isRun; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new AvgLPPPE(*this); }
 };
 
@@ -3558,6 +3805,7 @@ class AvgRPPPE : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return !ride->isSwim && !ride->isRun; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new AvgRPPPE(*this); }
 };
 
@@ -3603,6 +3851,7 @@ class AvgLPP : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return !ride->isSwim && !ride->isRun; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new AvgLPP(*this); }
 };
 
@@ -3648,6 +3897,7 @@ class AvgRPP : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return !ride->isSwim && !ride->isRun; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new AvgRPP(*this); }
 };
 
@@ -3693,6 +3943,7 @@ class AvgLPPP : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return !ride->isSwim && !ride->isRun; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new AvgLPPP(*this); }
 };
 
@@ -3738,6 +3989,7 @@ class AvgRPPP : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return !ride->isSwim && !ride->isRun; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new AvgRPPP(*this); }
 };
 
@@ -3826,6 +4078,7 @@ struct TotalCalories : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new TotalCalories(*this); }
 };
 
@@ -3877,6 +4130,7 @@ struct ActivityCRC : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new ActivityCRC(*this); }
 };
 
@@ -106,6 +106,7 @@ class XPower : public RideMetric {
     bool isRelevantForRide(const RideItem*ride) const { return ride->present.contains("P") || (!ride->isRun && !ride->isSwim); }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new XPower(*this); }
 };
 
@@ -147,6 +148,7 @@ class VariabilityIndex : public RideMetric {
     bool isRelevantForRide(const RideItem*ride) const { return ride->present.contains("P") || (!ride->isRun && !ride->isSwim); }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new VariabilityIndex(*this); }
 };
 
@@ -189,6 +191,7 @@ class RelativeIntensity : public RideMetric {
     bool isRelevantForRide(const RideItem*ride) const { return ride->present.contains("P") || (!ride->isRun && !ride->isSwim); }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::PowerZonesConfig; }
     RideMetric *clone() const { return new RelativeIntensity(*this); }
 };
 
@@ -228,6 +231,7 @@ class CriticalPower : public RideMetric {
     bool isRelevantForRide(const RideItem*ride) const { return ride->present.contains("P") || (!ride->isRun && !ride->isSwim); }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::PowerZonesConfig; }
     RideMetric *clone() const { return new CriticalPower(*this); }
 };
 
@@ -285,6 +289,7 @@ class aTISS : public RideMetric {
     bool isRelevantForRide(const RideItem*ride) const { return ride->present.contains("P") || (!ride->isRun && !ride->isSwim); }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::PowerZonesConfig; }
     RideMetric *clone() const { return new aTISS(*this); }
 };
 
@@ -343,6 +348,7 @@ class anTISS : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::PowerZonesConfig; }
     RideMetric *clone() const { return new anTISS(*this); }
 };
 
@@ -382,6 +388,7 @@ class dTISS : public RideMetric {
     bool isRelevantForRide(const RideItem*ride) const { return ride->present.contains("P") || (!ride->isRun && !ride->isSwim); }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::PowerZonesConfig; }
     RideMetric *clone() const { return new dTISS(*this); }
 };
 
@@ -431,6 +438,7 @@ class BikeScore : public RideMetric {
     bool isRelevantForRide(const RideItem*ride) const { return (!ride->isRun && !ride->isSwim); }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::PowerZonesConfig; }
     RideMetric *clone() const { return new BikeScore(*this); }
 };
 
@@ -470,6 +478,7 @@ class ResponseIndex : public RideMetric {
     bool isRelevantForRide(const RideItem*ride) const { return ride->present.contains("P") || (!ride->isRun && !ride->isSwim); }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new ResponseIndex(*this); }
 };
 
@@ -18,6 +18,7 @@
 
 
 #include "CPSolver.h"
+#include "AthleteTimeline.h"
 #include <ctime>
 
 CPSolver::CPSolver(Context *context)
@@ -302,7 +303,7 @@ class BestR : public RideMetric {
 
                     // set from the ride
                     if (item->context->athlete->zones(item->sport)) {
-                        int zoneRange = item->context->athlete->zones(item->sport)->whichRange(item->dateTime.date());
+                        int zoneRange = item->context->athlete->timeline->zoneRange(item->context->athlete->zones(item->sport), item->dateTime.date());
                         CP = zoneRange >= 0 ? item->context->athlete->zones(item->sport)->getCP(zoneRange) : 0;
                         W = zoneRange >= 0 ? item->context->athlete->zones(item->sport)->getWprime(zoneRange) : 0;
 
@@ -359,6 +360,7 @@ class BestR : public RideMetric {
     }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::PowerZonesConfig; }
     RideMetric *clone() const { return new BestR(*this); }
 };
 
@@ -105,6 +105,7 @@ class IsoPower : public RideMetric {
     bool isRelevantForRide(const RideItem*ride) const { return ride->present.contains("P") || (!ride->isRun && !ride->isSwim); }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new IsoPower(*this); }
 };
 
@@ -146,6 +147,7 @@ class VI : public RideMetric {
     bool isRelevantForRide(const RideItem*ride) const { return ride->present.contains("P") || (!ride->isRun && !ride->isSwim); }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new VI(*this); }
 };
 
@@ -204,6 +206,7 @@ class IntensityFactor : public RideMetric {
     bool isRelevantForRide(const RideItem*ride) const { return ride->present.contains("P") || (!ride->isRun && !ride->isSwim); }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::PowerZonesConfig; }
     RideMetric *clone() const { return new IntensityFactor(*this); }
 };
 
@@ -264,6 +267,7 @@ class BikeStress : public RideMetric {
     bool isRelevantForRide(const RideItem*ride) const { return (!ride->isRun && !ride->isSwim); }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::PowerZonesConfig; }
     RideMetric *clone() const { return new BikeStress(*this); }
 };
 
@@ -318,6 +322,7 @@ class TSSPerHour : public RideMetric {
     bool isRelevantForRide(const RideItem*ride) const { return (!ride->isRun && !ride->isSwim); }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new TSSPerHour(*this); }
 };
 
@@ -366,6 +371,7 @@ class EfficiencyFactor : public RideMetric {
     bool isRelevantForRide(const RideItem*ride) const { return ride->present.contains("H") && (ride->present.contains("P") || (ride->isRun && ride->present.contains("S"))); }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new EfficiencyFactor(*this); }
 };
 
@@ -158,6 +158,7 @@ public:
     bool isRelevantForRide(const RideItem *ride) const { return (ride->present.contains("P") || ride->isRun || ride->isSwim); }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::PowerZonesConfig | RideMetric::PaceZonesConfig; }
     RideMetric *clone() const { return new DanielsPoints(*this); }
 
 private:
@@ -308,6 +309,7 @@ class DanielsEquivalentPower : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return (ride->present.contains("P")); }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::PowerZonesConfig; }
     RideMetric *clone() const { return new DanielsEquivalentPower(*this); }
 };
 
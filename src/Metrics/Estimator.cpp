@@ -340,6 +340,7 @@ Estimator::run()
         estimates.append(est);
         performances.append(perfs);
     }
+    generation.ref();
     lock.unlock();
 
     // debug dump peak performances
@@ -26,6 +26,7 @@
 
 #include <QThread>
 #include <QMutex>
+#include <QAtomicInt>
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QScrollArea>
@@ -46,6 +47,7 @@ class Performance {
 };
 
 class Banister;
+class AthleteTimeline;
 class Estimator : public QThread {
 
     Q_OBJECT
@@ -80,10 +82,12 @@ class Estimator : public QThread {
 
         friend class ::Athlete;
         friend class ::Banister;
+        friend class ::AthleteTimeline;
 
         Context *context;
         QMutex lock;
         QList<PDEstimate> estimates;
+        QAtomicInt generation; // bumped whenever estimates change
         QList<Performance> performances;
         QVector<RideItem*> rides; // worklist
         QTimer singleshot;
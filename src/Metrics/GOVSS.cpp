@@ -161,6 +161,7 @@ class LNP : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return ride->isRun; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::WeightConfig; }
     RideMetric *clone() const { return new LNP(*this); }
 };
 
@@ -255,6 +256,7 @@ class XPace : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return ride->isRun; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::WeightConfig; }
     RideMetric *clone() const { return new XPace(*this); }
 };
 
@@ -310,6 +312,7 @@ class RTP : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return ride->isRun; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::PaceZonesConfig | RideMetric::WeightConfig; }
     RideMetric *clone() const { return new RTP(*this); }
 };
 
@@ -360,6 +363,7 @@ class IWF : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return ride->isRun; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new IWF(*this); }
 };
 
@@ -421,6 +425,7 @@ class GOVSS : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return ride->isRun; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::WeightConfig; }
     RideMetric *clone() const { return new GOVSS(*this); }
 };
 
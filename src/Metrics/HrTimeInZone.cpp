@@ -32,9 +32,14 @@ class HrZoneTime : public RideMetric {
     int level;
     double seconds;
 
+    // whilst accumulating
+    const HrZones *zones;
+    int range;
+    double secs, totalSecs;
+
 public:
 
-    HrZoneTime() : level(0), seconds(0.0)
+    HrZoneTime() : level(0), seconds(0.0), zones(NULL), range(-1), secs(0.0), totalSecs(0.0)
     {
         setType(RideMetric::Total);
         setMetricUnits(tr("seconds"));
@@ -47,29 +52,41 @@ public:
 
     void setLevel(int level) { this->level=level-1; } // zones start from zero not 1
 
-    void compute(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &) {
+    void compute(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &deps) {
+        accumulate(item, spec, deps);
+    }
+
+    bool accumulates() const { return true; }
+
+    bool begin(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &) {
 
         // no ride or no samples
         if (spec.isEmpty(item->ride())) {
             setValue(RideFile::NIL);
             setCount(0);
-            return;
+            return false;
         }
 
-        double totalSecs = 0.0;
-        seconds = 0;
+        totalSecs = seconds = 0;
 
         // get zone ranges
         if (item->context->athlete->hrZones(item->sport) && item->hrZoneRange >= 0 && item->ride()->areDataPresent()->hr) {
-            // iterate and compute
-            RideFileIterator it(item->ride(), spec);
-            while (it.hasNext()) {
-                struct RideFilePoint *point = it.next();
-                totalSecs += item->ride()->recIntSecs();
-                if (item->context->athlete->hrZones(item->sport)->whichZone(item->hrZoneRange, point->hr) == level)
-                    seconds += item->ride()->recIntSecs();
-            }
+            zones = item->context->athlete->hrZones(item->sport);
+            range = item->hrZoneRange;
+            secs = item->ride()->recIntSecs();
+            return true;
         }
+        end();
+        return false;
+    }
+
+    void update(const RideFilePoint *point) {
+        totalSecs += secs;
+        if (zones->whichZone(range, point->hr) == level)
+            seconds += secs;
+    }
+
+    void end() {
         setValue(seconds);
         setCount(totalSecs);
     }
@@ -78,6 +95,7 @@ public:
     void aggregateWith(const RideMetric &) {}
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::HrZonesConfig; }
     RideMetric *clone() const { return new HrZoneTime(*this); }
 };
 
@@ -342,6 +360,7 @@ class HrZonePTime1 : public RideMetric {
         void aggregateWith(const RideMetric &) {}
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+        int configDependencies() const { return RideMetric::NoConfig; }
         RideMetric *clone() const { return new HrZonePTime1(*this); }
 };
 
@@ -386,6 +405,7 @@ class HrZonePTime2 : public RideMetric {
         void aggregateWith(const RideMetric &) {}
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+        int configDependencies() const { return RideMetric::NoConfig; }
         RideMetric *clone() const { return new HrZonePTime2(*this); }
 };
 
@@ -430,6 +450,7 @@ class HrZonePTime3 : public RideMetric {
         void aggregateWith(const RideMetric &) {}
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+        int configDependencies() const { return RideMetric::NoConfig; }
         RideMetric *clone() const { return new HrZonePTime3(*this); }
 };
 
@@ -474,6 +495,7 @@ class HrZonePTime4 : public RideMetric {
         void aggregateWith(const RideMetric &) {}
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+        int configDependencies() const { return RideMetric::NoConfig; }
         RideMetric *clone() const { return new HrZonePTime4(*this); }
 };
 
@@ -518,6 +540,7 @@ class HrZonePTime5 : public RideMetric {
         void aggregateWith(const RideMetric &) {}
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+        int configDependencies() const { return RideMetric::NoConfig; }
         RideMetric *clone() const { return new HrZonePTime5(*this); }
 };
 
@@ -562,6 +585,7 @@ class HrZonePTime6 : public RideMetric {
         void aggregateWith(const RideMetric &) {}
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+        int configDependencies() const { return RideMetric::NoConfig; }
         RideMetric *clone() const { return new HrZonePTime6(*this); }
 };
 
@@ -606,6 +630,7 @@ class HrZonePTime7 : public RideMetric {
         void aggregateWith(const RideMetric &) {}
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+        int configDependencies() const { return RideMetric::NoConfig; }
         RideMetric *clone() const { return new HrZonePTime7(*this); }
 };
 
@@ -650,6 +675,7 @@ class HrZonePTime8 : public RideMetric {
         void aggregateWith(const RideMetric &) {}
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+        int configDependencies() const { return RideMetric::NoConfig; }
         RideMetric *clone() const { return new HrZonePTime8(*this); }
 };
 class HrZonePTime9 : public RideMetric {
@@ -693,6 +719,7 @@ class HrZonePTime9 : public RideMetric {
         void aggregateWith(const RideMetric &) {}
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+        int configDependencies() const { return RideMetric::NoConfig; }
         RideMetric *clone() const { return new HrZonePTime9(*this); }
 };
 class HrZonePTime10 : public RideMetric {
@@ -736,6 +763,7 @@ class HrZonePTime10 : public RideMetric {
         void aggregateWith(const RideMetric &) {}
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+        int configDependencies() const { return RideMetric::NoConfig; }
         RideMetric *clone() const { return new HrZonePTime10(*this); }
 };
 
@@ -801,6 +829,7 @@ public:
     void aggregateWith(const RideMetric &) {}
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::HrZonesConfig; }
     RideMetric *clone() const { return new HrZoneTimeI(*this); }
 };
 
@@ -866,6 +895,7 @@ public:
     void aggregateWith(const RideMetric &) {}
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::HrZonesConfig; }
     RideMetric *clone() const { return new HrZoneTimeII(*this); }
 };
 
@@ -930,6 +960,7 @@ public:
     void aggregateWith(const RideMetric &) {}
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::HrZonesConfig; }
     RideMetric *clone() const { return new HrZoneTimeIII(*this); }
 };
 
@@ -975,6 +1006,7 @@ class HrZonePTimeI : public RideMetric {
     void aggregateWith(const RideMetric &) {}
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new HrZonePTimeI(*this); }
 };
 
@@ -1019,6 +1051,7 @@ class HrZonePTimeII : public RideMetric {
     void aggregateWith(const RideMetric &) {}
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new HrZonePTimeII(*this); }
 };
 
@@ -1063,6 +1096,7 @@ class HrZonePTimeIII : public RideMetric {
     void aggregateWith(const RideMetric &) {}
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new HrZonePTimeIII(*this); }
 };
 
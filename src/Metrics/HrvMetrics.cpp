@@ -20,8 +20,23 @@
 #include "Context.h"
 #include "RideItem.h"
 #include "RideFile.h"
+#include "HrvSeries.h"
 
-#define ABS(x) ((x) >= 0 ? (x) : -(x))
+// the R-R arrays unpacked by RideItem::refresh, or here if we're called
+// from elsewhere (e.g. testing a user metric), NULL if there is no HRV
+class HrvData {
+public:
+    HrvData(RideItem *item) : series(item->hrvSeries()), local(NULL) {
+        if (series == NULL && item->ride() && item->ride()->xdata("HRV"))
+            series = local = new HrvSeries(item->ride()->xdata("HRV"));
+    }
+    ~HrvData() { delete local; }
+
+    const HrvSeries *series;
+
+private:
+    HrvSeries *local;
+};
 
 class RRNormalFraction : public RideMetric {
     Q_DECLARE_TR_FUNCTIONS(RRNormalFraction)
@@ -47,27 +62,13 @@ public:
     }
 
     void compute(RideItem *item, Specification, const QHash<QString,RideMetric*> &) {
-        double total, count;
-
-        bool this_state;
-        bool last_state = false;
 
-        XDataSeries *series = item->ride()->xdata("HRV");
+        HrvData hrv(item);
 
-        if (series) {
+        if (hrv.series) {
 
-            total = count = 0;
-
-            foreach(XDataPoint *p, series->datapoints)
-                {
-                    this_state = p->number[1] > 0;
-                    if (this_state && last_state)
-                        {
-                            total++;
-                        }
-                    last_state = this_state;
-                    count++;
-                }
+            double total = hrv.series->stats().nn;
+            double count = hrv.series->stats().beats;
 
             setValue(count > 0 ? total/count*100.0: 100.0);
             setCount(count);
@@ -82,6 +83,7 @@ public:
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new RRNormalFraction(*this); }
 };
 
@@ -111,26 +113,13 @@ public:
 
     void compute(RideItem *item, Specification, const QHash<QString,RideMetric*> &) {
 
-        double total, count;
-        bool last_state = false;
-        bool this_state;
-
-        XDataSeries *series = item->ride()->xdata("HRV");
+        HrvData hrv(item);
 
-        if (series) {
+        if (hrv.series) {
 
-            total = count = 0;
+            double total = hrv.series->stats().nnsum;
+            double count = hrv.series->stats().nn;
 
-            foreach(XDataPoint *p, series->datapoints)
-                {
-                    this_state = p->number[1]>0;
-                    if (this_state && last_state)
-                        {
-                            total += p->number[0];
-                            count++;
-                        }
-                    last_state = this_state;
-                }
             setValue(count > 0 ? total/count: total);
             setCount(count);
         }
@@ -144,6 +133,7 @@ public:
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new avnn(*this); }
 };
 
@@ -177,27 +167,14 @@ public:
     }
 
     void compute(RideItem *item, Specification, const QHash<QString,RideMetric*> &) {
-        double sum, sum2, count;
-        bool last_state = false;
-        bool this_state;
 
-        XDataSeries *series = item->ride()->xdata("HRV");
+        HrvData hrv(item);
 
-        if (series) {
+        if (hrv.series) {
 
-            sum = sum2 = count = 0;
-
-            foreach(XDataPoint *p, series->datapoints)
-                {
-                    this_state = p->number[1] > 0;
-                    if (this_state && last_state)
-                        {
-                            sum += p->number[0];
-                            sum2 += pow(p->number[0], 2);
-                            count++;
-                        }
-                    last_state = this_state;
-                }
+            double sum = hrv.series->stats().nnsum;
+            double sum2 = hrv.series->stats().nnsum2;
+            double count = hrv.series->stats().nn;
 
             if (count>1)
                 {
@@ -222,6 +199,7 @@ public:
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new sdnn(*this); }
 };
 
@@ -255,53 +233,17 @@ public:
     }
 
     void compute(RideItem *item, Specification, const QHash<QString,RideMetric*> &) {
-        double sum, sum2, total, count, n;
-        bool last_state = false;
-        bool this_state;
-
-        XDataSeries *series = item->ride()->xdata("HRV");
-        double tlim = 300.0;
 
-        if (series) {
+        HrvData hrv(item);
 
-            sum = sum2 = total = count = n = 0;
+        if (hrv.series) {
 
-            foreach(XDataPoint *p, series->datapoints)
-                {
-                    if (p->secs >= tlim)
-                        {
-                            tlim += 300.0;
-                            if (n>0)
-                                {
-                                    total /= n;
-                                    sum += total;
-                                    sum2 += pow(total, 2);
-                                    count++;
-                                    total = 0.0;
-                                    n = 0;
-                                }
-                        }
-
-                    this_state = p->number[1] > 0;
-                    if (this_state && last_state)
-                        {
-                            total += p->number[0];
-                            n++;
-                        }
-                    last_state = this_state;
-                }
-
-            if (n>0)
-                {
-                    total /= n;
-                    sum += total;
-                    sum2 += pow(total, 2);
-                    count++;
-                }
+            // standard deviation of the 5 minute segment averages
+            double count = hrv.series->stats().segments;
             if (count>1)
                 {
-                    stdmean_ = sum/count;
-                    setValue(count > 1 ? sqrt((sum2 - sum*stdmean_)/(count - 1)): 0.0f);
+                    stdmean_ = hrv.series->stats().segmean;
+                    setValue(hrv.series->stats().sdann);
                 }
             else
                 {
@@ -321,6 +263,7 @@ public:
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new sdann(*this); }
 };
 
@@ -350,48 +293,12 @@ public:
 
     void compute(RideItem *item, Specification, const QHash<QString,RideMetric*> &) {
 
-        double sum, sum2, total, count, n;
-        bool last_state = false;
-        bool this_state;
-        double tlim = 300.0;
-
-        XDataSeries *series = item->ride()->xdata("HRV");
-
-        if (series) {
+        HrvData hrv(item);
 
-            sum = sum2 = total = count = n = 0;
+        if (hrv.series) {
 
-            foreach(XDataPoint *p, series->datapoints)
-                {
-                    if (p->secs >= tlim)
-                        {
-                            tlim += 300.0;
-                            if (n>0)
-                                {
-                                    total += sqrt((sum2 - sum*sum/n)/(n-1));
-                                    count++;
-                                    // Reset
-                                    sum = sum2 = 0.0;
-                                    n = 0;
-                                }
-                        }
-
-                    this_state = p->number[1]>0;
-                    if (this_state && last_state)
-                        {
-                            sum += p->number[0];
-                            sum2 += pow(p->number[0], 2);
-                            n++;
-                        }
-                    last_state = this_state;
-                }
-            if (n>0)
-                {
-                    total += sqrt((sum2 - sum*sum/n)/(n-1));
-                    count++;
-                }
-            setValue(count > 0 ? total/count: total);
-            setCount(count);
+            setValue(hrv.series->stats().sdnnidx);
+            setCount(hrv.series->stats().segments);
         }
         else {
             setValue(RideFile::NIL);
@@ -403,6 +310,7 @@ public:
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new sdnnidx(*this); }
 };
 
@@ -431,24 +339,14 @@ public:
     }
 
     void compute(RideItem *item, Specification, const QHash<QString,RideMetric*> &) {
-        double sum, count;
 
-        XDataSeries *series = item->ride()->xdata("HRV");
+        HrvData hrv(item);
 
-        if (series && series->datapoints.count() > 2 )
+        if (hrv.series && hrv.series->count() > 2)
             {
-                sum = count = 0;
-
-                for (int i=2; i < series->datapoints.count(); i++)
-                    if (
-                        series->datapoints[i]->number[1] > 0 &&
-                        series->datapoints[i-1]->number[1] > 0 &&
-                        series->datapoints[i-2]->number[1] > 0
-                        )
-                        {
-                            sum += pow(series->datapoints[i]->number[0] - series->datapoints[i-1]->number[0], 2);
-                            count++;
-                        }
+                double sum = hrv.series->stats().diffsum2;
+                double count = hrv.series->stats().diffs;
+
                 setValue(count > 1 ? sqrt(sum/count): 0);
                 setCount(count);
             }
@@ -462,6 +360,7 @@ public:
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new rmssd(*this); }
 };
 
@@ -483,28 +382,14 @@ public:
     };
 
     void compute(RideItem *item, Specification, const QHash<QString,RideMetric*> &) {
-        int nnx, count;
-        XDataSeries *series = item->ride()->xdata("HRV");
 
-        if (series && series->datapoints.count() > 2 )
+        HrvData hrv(item);
+
+        if (hrv.series && hrv.series->count() > 2 )
             {
-                nnx = count = 0;
-
-                for (int i=2; i < series->datapoints.count(); i++)
-                    {
-                        if (
-                            series->datapoints[i]->number[1] > 0 &&
-                            series->datapoints[i-1]->number[1] > 0 &&
-                            series->datapoints[i-2]->number[1] > 0
-                            )
-                            {
-                                if (ABS(series->datapoints[i]->number[0] - series->datapoints[i-1]->number[0]) > msec)
-                                    {
-                                        nnx++;
-                                    }
-                                count++;
-                            }
-                    }
+                int index = int(msec) / HRV_PNN_STEP;
+                int nnx = hrv.series->stats().pnn[qBound(0, index, HRV_PNN_COUNT-1)];
+                int count = hrv.series->stats().diffs;
 
                 setValue(count > 0 ? 100.0*(double)nnx/(double)count : 0.0);
                 setCount(count);
@@ -526,6 +411,7 @@ public:
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new pnnx(*this); }
     bool isRelevantForRide(const RideItem *) const { return true; }
 };
@@ -571,6 +457,7 @@ public:
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::HrvConfig; }
     RideMetric *clone() const { return new rest_hr(*this); }
 };
 
@@ -607,6 +494,7 @@ public:
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::HrvConfig; }
     RideMetric *clone() const { return new rest_avnn(*this); }
 };
 
@@ -644,6 +532,7 @@ public:
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::HrvConfig; }
     RideMetric *clone() const { return new rest_sdnn(*this); }
 };
 
@@ -681,6 +570,7 @@ public:
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::HrvConfig; }
     RideMetric *clone() const { return new rest_rmssd(*this); }
 };
 
@@ -718,6 +608,7 @@ public:
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::HrvConfig; }
     RideMetric *clone() const { return new rest_pNN50(*this); }
 };
 
@@ -756,6 +647,7 @@ public:
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::HrvConfig; }
     RideMetric *clone() const { return new rest_lf(*this); }
 };
 
@@ -794,6 +686,7 @@ public:
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::HrvConfig; }
     RideMetric *clone() const { return new rest_hf(*this); }
 };
 
@@ -837,6 +730,7 @@ public:
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::HrvConfig; }
     RideMetric *clone() const { return new hrv_recovery_points(*this); }
 };
 
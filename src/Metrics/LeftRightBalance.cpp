@@ -80,6 +80,7 @@ class LeftRightBalance : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new LeftRightBalance(*this); }
 };
 
@@ -33,9 +33,14 @@ class PaceZoneTime : public RideMetric {
     int level;
     double seconds;
 
+    // whilst accumulating
+    const PaceZones *zones;
+    int range;
+    double secs, totalSecs;
+
     public:
 
-    PaceZoneTime() : level(0), seconds(0.0)
+    PaceZoneTime() : level(0), seconds(0.0), zones(NULL), range(-1), secs(0.0), totalSecs(0.0)
     {
         setType(RideMetric::Total);
         setMetricUnits(tr("seconds"));
@@ -47,7 +52,13 @@ class PaceZoneTime : public RideMetric {
     bool isTime() const { return true; }
     void setLevel(int level) { this->level=level-1; } // zones start from zero not 1
 
-    void compute(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &) {
+    void compute(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &deps) {
+        accumulate(item, spec, deps);
+    }
+
+    bool accumulates() const { return true; }
+
+    bool begin(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &) {
 
         // no ride or no samples
         if (spec.isEmpty(item->ride()) || 
@@ -55,26 +66,30 @@ class PaceZoneTime : public RideMetric {
             (!item->isRun && !item->isSwim)) {
             setValue(RideFile::NIL);
             setCount(0);
-            return;
+            return false;
         }
 
-        double totalSecs = 0.0;
-        seconds = 0;
+        totalSecs = seconds = 0;
 
-        const PaceZones *zone = item->context->athlete->paceZones(item->isSwim);
-        int zoneRange = item->paceZoneRange;
+        zones = item->context->athlete->paceZones(item->isSwim);
+        range = item->paceZoneRange;
 
         // get zone ranges
-        if (zone && zoneRange >= 0) {
-            // iterate and compute
-            RideFileIterator it(item->ride(), spec);
-            while (it.hasNext()) {
-                struct RideFilePoint *point = it.next();
-                totalSecs += item->ride()->recIntSecs();
-                if (zone->whichZone(zoneRange, point->kph) == level)
-                    seconds += item->ride()->recIntSecs();
-            }
+        if (zones && range >= 0) {
+            secs = item->ride()->recIntSecs();
+            return true;
         }
+        end();
+        return false;
+    }
+
+    void update(const RideFilePoint *point) {
+        totalSecs += secs;
+        if (zones->whichZone(range, point->kph) == level)
+            seconds += secs;
+    }
+
+    void end() {
         setValue(seconds);
         setCount(totalSecs);
     }
@@ -83,6 +98,7 @@ class PaceZoneTime : public RideMetric {
     void aggregateWith(const RideMetric &) {}
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::PaceZonesConfig; }
     RideMetric *clone() const { return new PaceZoneTime(*this); }
 };
 
@@ -350,6 +366,7 @@ class PaceZonePTime1 : public RideMetric {
         void aggregateWith(const RideMetric &) {}
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+        int configDependencies() const { return RideMetric::NoConfig; }
         RideMetric *clone() const { return new PaceZonePTime1(*this); }
 };
 
@@ -394,6 +411,7 @@ class PaceZonePTime2 : public RideMetric {
         void aggregateWith(const RideMetric &) {}
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+        int configDependencies() const { return RideMetric::NoConfig; }
         RideMetric *clone() const { return new PaceZonePTime2(*this); }
 };
 
@@ -438,6 +456,7 @@ class PaceZonePTime3 : public RideMetric {
         void aggregateWith(const RideMetric &) {}
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+        int configDependencies() const { return RideMetric::NoConfig; }
         RideMetric *clone() const { return new PaceZonePTime3(*this); }
 };
 
@@ -482,6 +501,7 @@ class PaceZonePTime4 : public RideMetric {
         void aggregateWith(const RideMetric &) {}
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+        int configDependencies() const { return RideMetric::NoConfig; }
         RideMetric *clone() const { return new PaceZonePTime4(*this); }
 };
 
@@ -526,6 +546,7 @@ class PaceZonePTime5 : public RideMetric {
         void aggregateWith(const RideMetric &) {}
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+        int configDependencies() const { return RideMetric::NoConfig; }
         RideMetric *clone() const { return new PaceZonePTime5(*this); }
 };
 
@@ -570,6 +591,7 @@ class PaceZonePTime6 : public RideMetric {
         void aggregateWith(const RideMetric &) {}
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+        int configDependencies() const { return RideMetric::NoConfig; }
         RideMetric *clone() const { return new PaceZonePTime6(*this); }
 };
 
@@ -614,6 +636,7 @@ class PaceZonePTime7 : public RideMetric {
         void aggregateWith(const RideMetric &) {}
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+        int configDependencies() const { return RideMetric::NoConfig; }
         RideMetric *clone() const { return new PaceZonePTime7(*this); }
 };
 
@@ -658,6 +681,7 @@ class PaceZonePTime8 : public RideMetric {
         void aggregateWith(const RideMetric &) {}
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+        int configDependencies() const { return RideMetric::NoConfig; }
         RideMetric *clone() const { return new PaceZonePTime8(*this); }
 };
 
@@ -702,6 +726,7 @@ class PaceZonePTime9 : public RideMetric {
         void aggregateWith(const RideMetric &) {}
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+        int configDependencies() const { return RideMetric::NoConfig; }
         RideMetric *clone() const { return new PaceZonePTime9(*this); }
 };
 
@@ -746,6 +771,7 @@ class PaceZonePTime10 : public RideMetric {
         void aggregateWith(const RideMetric &) {}
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+        int configDependencies() const { return RideMetric::NoConfig; }
         RideMetric *clone() const { return new PaceZonePTime10(*this); }
 };
 
@@ -816,6 +842,7 @@ class PaceZoneTimeI : public RideMetric {
     void aggregateWith(const RideMetric &) {}
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::PaceZonesConfig; }
     RideMetric *clone() const { return new PaceZoneTimeI(*this); }
 };
 
@@ -886,6 +913,7 @@ class PaceZoneTimeII : public RideMetric {
     void aggregateWith(const RideMetric &) {}
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::PaceZonesConfig; }
     RideMetric *clone() const { return new PaceZoneTimeII(*this); }
 };
 
@@ -955,6 +983,7 @@ class PaceZoneTimeIII : public RideMetric {
     void aggregateWith(const RideMetric &) {}
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::PaceZonesConfig; }
     RideMetric *clone() const { return new PaceZoneTimeIII(*this); }
 };
 
@@ -999,6 +1028,7 @@ class PaceZonePTimeI : public RideMetric {
     void aggregateWith(const RideMetric &) {}
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new PaceZonePTimeI(*this); }
 };
 
@@ -1042,6 +1072,7 @@ class PaceZonePTimeII : public RideMetric {
     void aggregateWith(const RideMetric &) {}
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new PaceZonePTimeII(*this); }
 };
 
@@ -1085,6 +1116,7 @@ class PaceZonePTimeIII : public RideMetric {
     void aggregateWith(const RideMetric &) {}
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new PaceZonePTimeIII(*this); }
 };
 
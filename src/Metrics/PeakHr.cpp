@@ -96,6 +96,7 @@ class HrZone : public RideMetric {
     }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::HrZonesConfig; }
     RideMetric *clone() const { return new HrZone(*this); }
 };
 
@@ -134,6 +135,7 @@ class PeakHr : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new PeakHr(*this); }
 };
 
@@ -81,6 +81,7 @@ class PeakPace : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return ride->isRun; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new PeakPace(*this); }
 };
 
@@ -430,6 +431,7 @@ class PeakPaceSwim : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return ride->isSwim; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new PeakPaceSwim(*this); }
 };
 
@@ -767,6 +769,7 @@ class BestTime : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return ride->present.contains("S"); }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new BestTime(*this); }
 };
 
@@ -1181,6 +1184,7 @@ class PeakPaceHr : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return ride->isRun || ride->isSwim; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new PeakPaceHr(*this); }
 };
 
@@ -93,6 +93,7 @@ class PeakPercent : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::PowerZonesConfig; }
     RideMetric *clone() const { return new PeakPercent(*this); }
 };
 
@@ -165,6 +166,7 @@ class PowerZone : public RideMetric {
     }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::PowerZonesConfig; }
     RideMetric *clone() const { return new PowerZone(*this); }
 };
 
@@ -220,6 +222,7 @@ class FatigueIndex : public RideMetric {
     }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new FatigueIndex(*this); }
 };
 
@@ -270,6 +273,7 @@ class PacingIndex : public RideMetric {
     }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new PacingIndex(*this); }
 };
 
@@ -304,6 +308,7 @@ class PeakPower : public RideMetric {
     }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new PeakPower(*this); }
 };
 
@@ -660,6 +665,7 @@ class PeakPowerHr : public RideMetric {
     }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new PeakPowerHr(*this); }
 };
 
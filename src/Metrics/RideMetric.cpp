@@ -18,12 +18,14 @@
 
 #include "RideMetric.h"
 #include "RideItem.h"
+#include "RideFileIndex.h"
 #include "IntervalItem.h"
 #include "Specification.h"
 #include "UserMetricSettings.h"
 #include "TimeUtils.h"
 #include "Zones.h"
 #include "HrZones.h"
+#include "Profiler.h"
 
 // DB Schema Version - YOU MUST UPDATE THIS IF THE SCHEMA VERSION CHANGES!!!
 // Schema version will change if a) the default metadata.xml is updated
@@ -174,6 +176,28 @@ RideMetricFactory *RideMetricFactory::_instance;
 QVector<QString> RideMetricFactory::noDeps;
 QList<QString> RideMetricFactory::compatibilitymetrics;
 
+int
+RideMetricFactory::configDependencies(const QString &symbol) const
+{
+    const RideMetric *m = metrics.value(symbol, NULL);
+    if (m == NULL) return RideMetric::NoConfig;
+
+    int returning = m->configDependencies();
+    foreach(const QString &dep, dependencies(symbol))
+        if (returning != RideMetric::AnyConfig) returning |= configDependencies(dep);
+
+    return returning;
+}
+
+QStringList
+RideMetricFactory::affectedBy(int what) const
+{
+    QStringList returning;
+    foreach(const QString &symbol, metricNames)
+        if (configDependencies(symbol) & what) returning << symbol;
+    return returning;
+}
+
 // user defined metrics are loaded by the ridecache on startup
 // and then reloaded by ridecache if they change
 QList<UserMetricSettings> _userMetrics;
@@ -194,6 +218,37 @@ RideMetric::userMetricFingerprint(QList<UserMetricSettings> these)
 #endif
 }
 
+// a metric has been computed
+static void completed(RideItem *item, Specification &spec, QString symbol, RideMetric *m, QHash<QString,RideMetric*> &done, bool user)
+{
+    // override the computed value if set by user, but not for intervals
+    if (!spec.interval() && item->ride() && item->ride()->metricOverrides.contains(symbol))
+        m->override(item->ride()->metricOverrides.value(symbol));
+
+    // all computed add to the return list
+    done.insert(symbol, m);
+
+    // put into value array too. user metrics will interrogate
+    // this for symbol values, rather than the metric pointer
+    // this is crucial, even though RideItem and IntervalItem both
+    // update their values directly. But only need to bother if the
+    // user has defined any local metrics.
+    if (user) {
+        if (spec.interval()) spec.interval()->metrics()[m->index()] = m->value();
+        else item->metrics()[m->index()] = m->value();
+    }
+}
+
+void
+RideMetric::accumulate(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &deps)
+{
+    if (!begin(item, spec, deps)) return;
+
+    RideFileIterator it(item->ride(), spec);
+    while (it.hasNext()) update(it.next());
+    end();
+}
+
 QHash<QString,RideMetricPtr>
 RideMetric::computeMetrics(RideItem *item, Specification spec, const QStringList &metrics)
 {
@@ -225,6 +280,60 @@ RideMetric::computeMetrics(RideItem *item, Specification spec, const QStringList
     if (!spec.interval() && item->metrics().size() < factory.metricCount())
         item->metrics().resize(factory.metricCount());
 
+    // metrics that accumulate are computed together in one pass
+    // over the samples, there's no need to order them as they
+    // don't have any dependencies
+    QVector<RideMetric*> accumulating;
+    QList<QPair<QString, RideMetric*> > accumulated;
+
+    // when refreshing intervals the ride is indexed, so some
+    // can be answered without looking at the samples at all
+    RideFileIndex *index = NULL;
+    int start = -1, stop = -1;
+    if (spec.interval() && item->rideFileIndex() && item->rideFileIndex()->rideFile() == item->ride()) {
+        RideFileIterator it(item->ride(), spec);
+        start = it.firstIndex();
+        stop = it.lastIndex();
+        if (start >= 0 && stop >= start) index = item->rideFileIndex();
+    }
+
+    for (int i=0; i<builtin.count();) {
+
+        QString symbol = builtin[i];
+        if (!factory.haveMetric(symbol) || !factory.rideMetric(symbol)->accumulates() ||
+            !factory.dependencies(symbol).isEmpty()) {
+            i++;
+            continue;
+        }
+
+        RideMetric *m = factory.newMetric(symbol);
+        m->setValue(0.0);
+        m->setCount(0);
+        if (m->begin(item, spec, done)) {
+            if (index && m->range(*index, start, stop)) m->end();
+            else accumulating << m;
+        }
+        accumulated << QPair<QString, RideMetric*>(symbol, m);
+        builtin.removeAt(i);
+    }
+
+    if (accumulating.count()) {
+
+        PROFILE(Profiler::Metric, QStringLiteral("(single pass)"));
+        RideMetric **first = accumulating.data();
+        RideMetric **last = first + accumulating.count();
+
+        RideFileIterator it(item->ride(), spec);
+        while (it.hasNext()) {
+            const RideFilePoint *point = it.next();
+            for (RideMetric **m = first; m != last; m++) (*m)->update(point);
+        }
+        for (RideMetric **m = first; m != last; m++) (*m)->end();
+    }
+
+    for (int i=0; i<accumulated.count(); i++)
+        completed(item, spec, accumulated[i].first, accumulated[i].second, done, user.count() > 0);
+
     // working through the todo list...
     while (!builtin.isEmpty() || !user.isEmpty()) {
 
@@ -257,25 +366,13 @@ RideMetric::computeMetrics(RideItem *item, Specification spec, const QStringList
             RideMetric *m = factory.newMetric(symbol);
             m->setValue(0.0);
             m->setCount(0);
-            m->compute(item, spec, done);
-
-            // override the computed value if set by user, but not for intervals
-            if (!spec.interval() && item->ride() && item->ride()->metricOverrides.contains(symbol))
-                m->override(item->ride()->metricOverrides.value(symbol));
-
-            // all computed add to the return list
-            done.insert(symbol, m);
-
-            // put into value array too. user metrics will interrogate
-            // this for symbol values, rather than the metric pointer
-            // this is crucial, even though RideItem and IntervalItem both
-            // update their values directly. But only need to bother if the
-            // user has defined any local metrics.
-            if (user.count()) {
-                if (spec.interval()) spec.interval()->metrics()[m->index()] = m->value();
-                else item->metrics()[m->index()] = m->value();
+            {
+                PROFILE(Profiler::Metric, symbol);
+                m->compute(item, spec, done);
             }
 
+            completed(item, spec, symbol, m, done, user.count() > 0);
+
         } else {
 
             // we need to wait for our dependencies so add
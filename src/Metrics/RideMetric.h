@@ -37,6 +37,7 @@ class HrZones;
 class Context;
 class RideMetric;
 class RideFile;
+class RideFileIndex;
 class RideItem;
 class DataFilter;
 class DataFilterRuntime;
@@ -77,6 +78,14 @@ public:
     enum metricvalidity { Unreliable, Unknown, Unclear, Useful, Reliable, High };
     typedef enum metricvalidity MetricValidity;
 
+    // Athlete configuration a metric reads when it is computed, when any of
+    // it changes for the date of a ride only the metrics that read it (or
+    // depend on one that does) need to be recomputed. Settings that are not
+    // tracked here don't trigger a recompute at all.
+    enum configdependency { NoConfig=0x00, PowerZonesConfig=0x01, HrZonesConfig=0x02, PaceZonesConfig=0x04,
+                            WeightConfig=0x08, HrvConfig=0x10, AnyConfig=0xff };
+    typedef enum configdependency ConfigDependency;
+
     int index_;
 
     RideMetric() {
@@ -165,6 +174,31 @@ public:
     // Compute the ride metric from a file.
     virtual void compute(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &deps) = 0;
 
+    // Metrics that just need to see each sample once can accumulate, and
+    // computeMetrics() will then feed all of them from a single pass over
+    // the samples instead of each iterating the ride in compute().
+    //
+    // begin() returns false if there is nothing to accumulate, having set
+    // the value (usually to RideFile::NIL), otherwise update() is called
+    // for every sample in the specification, and then end(). compute()
+    // should just call accumulate(), for when the metric is computed on
+    // its own, e.g. as a dependency. Metrics that accumulate can't have
+    // dependencies.
+    virtual bool accumulates() const { return false; }
+    virtual bool begin(RideItem *, Specification, const QHash<QString,RideMetric*> &) { return false; }
+    virtual void update(const RideFilePoint *) {}
+    virtual void end() {}
+
+    // When computing interval metrics an index of the ride may be available
+    // (see RideFileIndex.h), metrics that can be worked out from sums, counts
+    // or min/max of a series can use it instead of update() for the samples
+    // from start to stop. Called after begin(), returns false to fall back
+    // to update(), otherwise end() is called straight away.
+    virtual bool range(RideFileIndex &, int /*start*/, int /*stop*/) { return false; }
+
+    // what athlete configuration it reads, not including dependencies
+    virtual int configDependencies() const { return AnyConfig; }
+
     // is a time value, ie. render as hh:mm:ss
     virtual bool isTime() const { return false; }
 
@@ -245,6 +279,9 @@ public:
     void setType(MetricType x) { type_ = x; }
 
     protected:
+        // begin, update and end on our own, see accumulates()
+        void accumulate(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &deps);
+
         double  value_,
                 count_, // used when averaging
                 conversion_,
@@ -317,9 +354,19 @@ public:
     // Compute the ride metric from a file.
     void compute(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &deps);
 
+    // metrics that call python() are computed for a block of rides
+    // at once after a refresh, so the scripts run together, see RideCache.
+    // pending are the metrics each ride has still to compute
+    bool usesPython() const { return python_; }
+    void computeBatch(QVector<RideItem*> items, const QHash<RideItem*, QStringList> &pending);
+
     // is a time value, ie. render as hh:mm:ss
     bool isTime() const;
 
+    // what athlete configuration the program reads, worked out from
+    // the functions it calls and the metrics it refers to
+    int configDependencies() const;
+
     RideMetric *clone() const; 
 
     // WE DO NOT REIMPLEMENT THE STANDARD toString() METHOD
@@ -350,6 +397,12 @@ public:
         // true if we are a clone
         bool clone_;
 
+        // program calls python()
+        bool python_;
+
+        // see configDependencies(), -1 until worked out
+        mutable int configscope_;
+
 };
 
 class RideMetricFactory {
@@ -455,6 +508,12 @@ private:
         return true;
     }
 
+    // the configuration a metric reads, including through its dependencies
+    int configDependencies(const QString &symbol) const;
+
+    // all the metrics that read any of the configuration in what
+    QStringList affectedBy(int what) const;
+
     const QVector<QString> &dependencies(const QString &symbol) const {
         if(!metrics.contains(symbol)) return noDeps;
         QVector<QString> *result = dependencyMap.value(symbol);
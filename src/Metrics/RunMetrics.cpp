@@ -83,6 +83,7 @@ struct AvgRunCadence : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new AvgRunCadence(*this); }
 };
 
@@ -134,6 +135,7 @@ class MaxRunCadence : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new MaxRunCadence(*this); }
 };
 
@@ -191,6 +193,7 @@ struct AvgRunGroundContactTime : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new AvgRunGroundContactTime(*this); }
 };
 
@@ -323,6 +326,7 @@ class Pace : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new Pace(*this); }
 };
 
@@ -376,6 +380,7 @@ class EfficiencyIndex : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new EfficiencyIndex(*this); }
 };
 
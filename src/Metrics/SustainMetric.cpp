@@ -58,6 +58,7 @@ class L1Sustain : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new L1Sustain(*this); }
 };
 
@@ -87,6 +88,7 @@ class L2Sustain : public RideMetric {
     }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new L2Sustain(*this); }
 };
 
@@ -115,6 +117,7 @@ class L3Sustain : public RideMetric {
     }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new L3Sustain(*this); }
 };
 
@@ -143,6 +146,7 @@ class L4Sustain : public RideMetric {
     }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new L4Sustain(*this); }
 };
 
@@ -171,6 +175,7 @@ class L5Sustain : public RideMetric {
     }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new L5Sustain(*this); }
 };
 
@@ -199,6 +204,7 @@ class L6Sustain : public RideMetric {
     }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new L6Sustain(*this); }
 };
 
@@ -227,6 +233,7 @@ class L7Sustain : public RideMetric {
     }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new L7Sustain(*this); }
 };
 
@@ -255,6 +262,7 @@ class L8Sustain : public RideMetric {
     }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new L8Sustain(*this); }
 };
 
@@ -283,6 +291,7 @@ class L9Sustain : public RideMetric {
     }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new L9Sustain(*this); }
 };
 
@@ -311,6 +320,7 @@ class L10Sustain : public RideMetric {
     }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new L10Sustain(*this); }
 };
 
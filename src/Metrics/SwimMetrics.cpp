@@ -77,6 +77,7 @@ class DistanceSwim : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new DistanceSwim(*this); }
 };
 
@@ -161,6 +162,7 @@ class PaceSwim : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new PaceSwim(*this); }
 };
 
@@ -251,6 +253,7 @@ class SwimPace : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new SwimPace(*this); }
 };
 
@@ -310,6 +313,7 @@ class StrokeRate : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new StrokeRate(*this); }
 };
 
@@ -379,6 +383,7 @@ class StrokesPerLength : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new StrokesPerLength(*this); }
 };
 
@@ -449,6 +454,7 @@ class SWolf : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new SWolf(*this); }
 };
 
@@ -540,12 +546,12 @@ class SwimPaceStroke : public RideMetric {
         while (it.hasNext()) {
             struct RideFilePoint *point = it.next();
 
-            for (int j=b; j<series->datapoints.count(); j++) {
-                if (series->datapoints.at(j)->secs > point->secs)
+            for (int j=b; j<series->count(); j++) {
+                if (series->secs(j) > point->secs)
                     break;
                 b=j;
                 // Stroke Type
-                type = series->datapoints.at(j)->number[typeIdx];
+                type = series->value(j, typeIdx);
             }
             if (type == strokeType) {
                 total += point->kph;
@@ -560,6 +566,7 @@ class SwimPaceStroke : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new SwimPaceStroke(*this); }
 
     private:
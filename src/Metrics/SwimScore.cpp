@@ -125,6 +125,7 @@ class XPowerSwim : public RideMetric {
     bool isRelevantForRide(const RideItem*ride) const { return ride->isSwim; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::WeightConfig; }
     RideMetric *clone() const { return new XPowerSwim(*this); }
 };
 
@@ -198,6 +199,7 @@ class XPaceSwim : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return ride->isSwim; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::WeightConfig; }
     RideMetric *clone() const { return new XPaceSwim(*this); }
 };
 
@@ -251,6 +253,7 @@ class STP : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return ride->isSwim; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::PaceZonesConfig | RideMetric::WeightConfig; }
     RideMetric *clone() const { return new STP(*this); }
 };
 
@@ -300,6 +303,7 @@ class SRI : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return ride->isSwim; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new SRI(*this); }
 };
 
@@ -359,6 +363,7 @@ class SwimScore : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return ride->isSwim; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::WeightConfig; }
     RideMetric *clone() const { return new SwimScore(*this); }
 };
 
@@ -419,6 +424,7 @@ class TriScore : public RideMetric {
     }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new TriScore(*this); }
 };
 
@@ -100,6 +100,7 @@ class TRIMPPoints : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::HrZonesConfig; }
     RideMetric *clone() const { return new TRIMPPoints(*this); }
 };
 
@@ -161,6 +162,7 @@ public:
     }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::HrZonesConfig; }
     RideMetric *clone() const { return new TRIMP100Points(*this); }
 };
 
@@ -302,6 +304,7 @@ public:
     }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::HrZonesConfig; }
     RideMetric *clone() const { return new TRIMPZonalPoints(*this); }
 };
 
@@ -357,6 +360,7 @@ class SessionRPE : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new SessionRPE(*this); }
 };
 
@@ -32,9 +32,14 @@ class ZoneTime : public RideMetric {
     int level;
     double seconds;
 
+    // whilst accumulating
+    const Zones *zones;
+    int range;
+    double secs, totalSecs;
+
     public:
 
-    ZoneTime() : level(0), seconds(0.0)
+    ZoneTime() : level(0), seconds(0.0), zones(NULL), range(-1), secs(0.0), totalSecs(0.0)
     {
         setType(RideMetric::Total);
         setMetricUnits(tr("seconds"));
@@ -46,7 +51,13 @@ class ZoneTime : public RideMetric {
     bool isTime() const { return true; }
     void setLevel(int level) { this->level=level-1; } // zones start from zero not 1
 
-    void compute(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &) {
+    void compute(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &deps) {
+        accumulate(item, spec, deps);
+    }
+
+    bool accumulates() const { return true; }
+
+    bool begin(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &) {
 
         // no ride or no samples
         if (spec.isEmpty(item->ride()) ||
@@ -54,26 +65,30 @@ class ZoneTime : public RideMetric {
             !item->ride()->areDataPresent()->watts) {
             setValue(RideFile::NIL);
             setCount(0);
-            return;
+            return false;
         }
 
-        double totalSecs = 0.0;
-        seconds = 0;
+        zones = item->context->athlete->zones(item->sport);
+        range = item->zoneRange;
+        secs = item->ride()->recIntSecs();
+        totalSecs = seconds = 0;
+        return true;
+    }
 
-        // iterate and compute
-        RideFileIterator it(item->ride(), spec);
-        while (it.hasNext()) {
-            struct RideFilePoint *point = it.next();
-            totalSecs += item->ride()->recIntSecs();
-            if (item->context->athlete->zones(item->sport)->whichZone(item->zoneRange, point->watts) == level)
-                seconds += item->ride()->recIntSecs();
-        }
+    void update(const RideFilePoint *point) {
+        totalSecs += secs;
+        if (zones->whichZone(range, point->watts) == level)
+            seconds += secs;
+    }
+
+    void end() {
         setValue(seconds);
         setCount(totalSecs);
     }
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::PowerZonesConfig; }
     RideMetric *clone() const { return new ZoneTime(*this); }
 };
 
@@ -339,6 +354,7 @@ class ZonePTime1 : public RideMetric {
         bool aggregateZero() const { return true; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+        int configDependencies() const { return RideMetric::NoConfig; }
         RideMetric *clone() const { return new ZonePTime1(*this); }
 };
 
@@ -381,6 +397,7 @@ class ZonePTime2 : public RideMetric {
         bool aggregateZero() const { return true; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+        int configDependencies() const { return RideMetric::NoConfig; }
         RideMetric *clone() const { return new ZonePTime2(*this); }
 };
 
@@ -423,6 +440,7 @@ class ZonePTime3 : public RideMetric {
         bool aggregateZero() const { return true; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+        int configDependencies() const { return RideMetric::NoConfig; }
         RideMetric *clone() const { return new ZonePTime3(*this); }
 };
 
@@ -465,6 +483,7 @@ class ZonePTime4 : public RideMetric {
         bool aggregateZero() const { return true; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+        int configDependencies() const { return RideMetric::NoConfig; }
         RideMetric *clone() const { return new ZonePTime4(*this); }
 };
 
@@ -507,6 +526,7 @@ class ZonePTime5 : public RideMetric {
         bool aggregateZero() const { return true; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+        int configDependencies() const { return RideMetric::NoConfig; }
         RideMetric *clone() const { return new ZonePTime5(*this); }
 };
 
@@ -549,6 +569,7 @@ class ZonePTime6 : public RideMetric {
         bool aggregateZero() const { return true; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+        int configDependencies() const { return RideMetric::NoConfig; }
         RideMetric *clone() const { return new ZonePTime6(*this); }
 };
 
@@ -591,6 +612,7 @@ class ZonePTime7 : public RideMetric {
         bool aggregateZero() const { return true; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+        int configDependencies() const { return RideMetric::NoConfig; }
         RideMetric *clone() const { return new ZonePTime7(*this); }
 };
 
@@ -633,6 +655,7 @@ class ZonePTime8 : public RideMetric {
         bool aggregateZero() const { return true; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+        int configDependencies() const { return RideMetric::NoConfig; }
         RideMetric *clone() const { return new ZonePTime8(*this); }
 };
 
@@ -675,6 +698,7 @@ class ZonePTime9 : public RideMetric {
         bool aggregateZero() const { return true; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+        int configDependencies() const { return RideMetric::NoConfig; }
         RideMetric *clone() const { return new ZonePTime9(*this); }
 };
 
@@ -717,6 +741,7 @@ class ZonePTime10 : public RideMetric {
         bool aggregateZero() const { return true; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+        int configDependencies() const { return RideMetric::NoConfig; }
         RideMetric *clone() const { return new ZonePTime10(*this); }
 };
 
@@ -777,6 +802,7 @@ class ZoneTimeI : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::PowerZonesConfig; }
     RideMetric *clone() const { return new ZoneTimeI(*this); }
 };
 
@@ -837,6 +863,7 @@ class ZoneTimeII : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::PowerZonesConfig; }
     RideMetric *clone() const { return new ZoneTimeII(*this); }
 };
 
@@ -896,6 +923,7 @@ class ZoneTimeIII : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::PowerZonesConfig; }
     RideMetric *clone() const { return new ZoneTimeIII(*this); }
 };
 
@@ -938,6 +966,7 @@ class ZonePTimeI : public RideMetric {
     bool aggregateZero() const { return true; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new ZonePTimeI(*this); }
 };
 
@@ -979,6 +1008,7 @@ class ZonePTimeII : public RideMetric {
     bool aggregateZero() const { return true; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new ZonePTimeII(*this); }
 };
 
@@ -1020,6 +1050,7 @@ class ZonePTimeIII : public RideMetric {
     bool aggregateZero() const { return true; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new ZonePTimeIII(*this); }
 };
 
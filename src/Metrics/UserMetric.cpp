@@ -19,6 +19,26 @@
 #include "RideMetric.h"
 #include "UserMetricSettings.h"
 #include "DataFilter.h"
+#include "RideItem.h"
+
+#include <QRegularExpression>
+
+// rides computed together by computeBatch, each block may open them all
+#define USERMETRIC_BATCH 8
+
+// functions that only read their parameters or the ride itself
+static const QStringList rideOnlyFunctions = QStringList()
+    << "cos" << "tan" << "sin" << "acos" << "atan" << "asin" << "cosh" << "tanh" << "sinh"
+    << "acosh" << "atanh" << "asinh" << "exp" << "log" << "ceil" << "floor" << "round" << "fabs"
+    << "isinf" << "isnan" << "sqrt" << "bool" << "random" << "sum" << "mean" << "max" << "min"
+    << "count" << "median" << "mode" << "variance" << "stddev" << "quantile" << "cumsum" << "which"
+    << "c" << "seq" << "rep" << "head" << "tail" << "rev" << "sort" << "argsort" << "multisort"
+    << "rank" << "uniq" << "arguniq" << "multiuniq" << "match" << "nonzero" << "lowerbound" << "bin"
+    << "sapply" << "smooth" << "interpolate" << "resample" << "lr" << "lm" << "mlr" << "exists"
+    << "isNumber" << "isString" << "tolower" << "toupper" << "join" << "split" << "trim" << "replace"
+    << "week" << "month" << "weekdate" << "monthdate" << "print" << "annotate"
+    << "set" << "unset" << "isset" << "metadata" << "filename" << "samples"
+    << "XDATA" << "XDATA_UNITS" << "xdata";
 
 UserMetric::UserMetric(Context *context, UserMetricSettings settings)
     : RideMetric(), settings(settings)
@@ -38,6 +58,13 @@ UserMetric::UserMetric(Context *context, UserMetricSettings settings)
     fvalue = rt->functions.contains("value") ? rt->functions.value("value") : NULL;
     fcount = rt->functions.contains("count") ? rt->functions.value("count") : NULL;
 
+#ifdef GC_WANT_PYTHON
+    python_ = settings.program.contains(QRegularExpression("\\bpython\\s*\\("));
+#else
+    python_ = false;
+#endif
+    configscope_ = -1;
+
     // we're not a clone, we're the original
     clone_ = false;
 }
@@ -57,6 +84,8 @@ UserMetric::UserMetric(const UserMetric *from) : RideMetric()
     this->fafter = from->fafter;
     this->fvalue = from->fvalue;
     this->fcount = from->fcount;
+    this->python_ = from->python_;
+    this->configscope_ = from->configscope_;
 
     this->index_ = from->index_;
 
@@ -204,9 +233,6 @@ UserMetric::isRelevantForRide(const RideItem *item) const
 void
 UserMetric::compute(RideItem *item, Specification spec, const QHash<QString,RideMetric*> &pc)
 {
-    QElapsedTimer timer;
-    timer.start();
-
     //qDebug()<<"CODE";
     if (!root) {
         setValue(RideFile::NIL);
@@ -235,7 +261,7 @@ UserMetric::compute(RideItem *item, Specification spec, const QHash<QString,Ride
     }
 
     //qDebug()<<"BEFORE";
-    if (!spec.isEmpty(item->ride()) && fbefore) {
+    if (fbefore && !spec.isEmpty(item->ride())) {
         RideFileIterator it(item->ride(), spec, RideFileIterator::Before);
 
         while(it.hasNext()) {
@@ -246,7 +272,7 @@ UserMetric::compute(RideItem *item, Specification spec, const QHash<QString,Ride
 
     //qDebug()<<"SAMPLE";
     // process samples, if there are any and a function exists
-    if (!spec.isEmpty(item->ride()) && fsample) {
+    if (fsample && !spec.isEmpty(item->ride())) {
         RideFileIterator it(item->ride(), spec);
 
         while(it.hasNext()) {
@@ -256,7 +282,7 @@ UserMetric::compute(RideItem *item, Specification spec, const QHash<QString,Ride
     }
 
     //qDebug()<<"AFTER";
-    if (!spec.isEmpty(item->ride()) && fafter) {
+    if (fafter && !spec.isEmpty(item->ride())) {
         RideFileIterator it(item->ride(), spec, RideFileIterator::After);
 
         while(it.hasNext()) {
@@ -280,10 +306,112 @@ UserMetric::compute(RideItem *item, Specification spec, const QHash<QString,Ride
         setCount(n.number());
     }
 
-    //qDebug()<<symbol()<<index_<<value_<<"ELAPSED="<<timer.elapsed()<<"ms";
+    //qDebug()<<symbol()<<index_<<value_;
+}
+
+// compute for the rides a block at a time, the first python() evaluated
+// runs the script for the whole block and the rest look up their result.
+// The metrics the program refers to are its dependencies, as they would
+// have been in RideMetric::computeMetrics, less any still pending.
+void
+UserMetric::computeBatch(QVector<RideItem*> items, const QHash<RideItem*, QStringList> &pending)
+{
+    const RideMetricFactory &factory = RideMetricFactory::instance();
+
+    // the metric symbols the program uses
+    QStringList names, symbols;
+    root->findSymbols(names);
+    foreach(Leaf *function, rt->functions) function->findSymbols(names);
+    foreach(QString name, names) {
+        QString symbol = rt->lookupMap.value(name, "");
+        if (symbol != settings.symbol && factory.haveMetric(symbol) && !symbols.contains(symbol)) symbols << symbol;
+    }
+
+    for (int from=0; from < items.count(); from += USERMETRIC_BATCH) {
+
+        QVector<RideItem*> block = items.mid(from, USERMETRIC_BATCH);
+
+        // the scripts may open any of them, close what we opened
+        QVector<bool> open;
+        foreach(RideItem *item, block) open << item->isOpen();
+
+        // dependencies from each ride's freshly computed values
+        QVector<QHash<QString,RideMetric*> > deps(block.count());
+        QHash<RideItem*, const QHash<QString,RideMetric*>*> metrics;
+        for (int i=0; i<block.count(); i++) {
+            RideItem *item = block[i];
+            foreach(QString symbol, symbols) {
+                if (pending.value(item).contains(symbol)) continue;
+                RideMetric *m = factory.newMetric(symbol);
+                int index = m->index();
+                m->setValue(index < item->metrics().count() ? item->metrics()[index] : 0);
+                m->setCount(index < item->counts().count() ? item->counts()[index] : 0);
+                deps[i].insert(symbol, m);
+            }
+            if (deps[i].count()) metrics.insert(item, &deps[i]);
+        }
+
+#ifdef GC_WANT_PYTHON
+        rt->beginPythonBatch(block, metrics);
+#endif
+        for (int i=0; i<block.count(); i++) {
+            setValue(0.0);
+            setCount(0);
+            compute(block[i], Specification(), deps[i]);
+            block[i]->setMetric(index_, value(), count_);
+        }
+#ifdef GC_WANT_PYTHON
+        rt->endPythonBatch();
+#endif
+
+        for (int i=0; i<block.count(); i++) {
+            qDeleteAll(deps[i]);
+            if (!open[i] && block[i]->isOpen()) block[i]->close();
+        }
+    }
 }
 
 
+int
+UserMetric::configDependencies() const
+{
+    if (configscope_ >= 0) return configscope_;
+
+    // scripts can read anything, and if it didn't compile we can't tell
+    // this is also what we say whilst working it out, in case another
+    // user metric refers back to us
+    configscope_ = AnyConfig;
+    if (python_ || !root) return configscope_;
+
+    QStringList symbols, functions;
+    root->findSymbols(symbols);
+    root->findFunctions(functions);
+    foreach(Leaf *function, rt->functions) {
+        function->findSymbols(symbols);
+        function->findFunctions(functions);
+    }
+
+    int returning = NoConfig;
+    foreach(QString function, functions) {
+
+        // our own functions are covered above
+        if (rt->functions.contains(function) || rideOnlyFunctions.contains(function)) continue;
+
+        if (function == "config") returning |= PowerZonesConfig | HrZonesConfig | PaceZonesConfig | WeightConfig;
+        else if (function == "zones") returning |= PowerZonesConfig | HrZonesConfig | PaceZonesConfig;
+        else return configscope_;
+    }
+
+    // and whatever the metrics we refer to read
+    const RideMetricFactory &factory = RideMetricFactory::instance();
+    foreach(QString name, symbols) {
+        QString symbol = rt->lookupMap.value(name, "");
+        if (symbol != settings.symbol && factory.haveMetric(symbol)) returning |= factory.configDependencies(symbol);
+    }
+
+    return configscope_ = returning;
+}
+
 bool
 UserMetric::isTime() const
 {
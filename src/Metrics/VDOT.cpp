@@ -75,6 +75,7 @@ class VDOT : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return ride->isRun; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new VDOT(*this); }
 };
 
@@ -138,6 +139,7 @@ class TPace : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return ride->isRun; }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new TPace(*this); }
 };
 
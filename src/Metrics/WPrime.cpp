@@ -52,6 +52,7 @@
 #include "RideItem.h"
 #include "Units.h" // for MILES_PER_KM
 #include "Settings.h" // for GC_WBALFORM
+#include "AthleteTimeline.h"
 
 #include <qwt_spline_cubic.h> // smoothing
 
@@ -178,7 +179,7 @@ WPrime::setRide(RideFile *input)
     CP = 250; // default
     WPRIME = 20000;
     if (input->context->athlete->zones(input->sport())) {
-        int zoneRange = input->context->athlete->zones(input->sport())->whichRange(input->startTime().date());
+        int zoneRange = input->context->athlete->timeline->zoneRange(input->context->athlete->zones(input->sport()), input->startTime().date());
         CP = zoneRange >= 0 ? input->context->athlete->zones(input->sport())->getCP(zoneRange) : 0;
         WPRIME = zoneRange >= 0 ? input->context->athlete->zones(input->sport())->getWprime(zoneRange) : 0;
 
@@ -769,6 +770,7 @@ class MinWPrime : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return ride->present.contains("P") || (!ride->isSwim && !ride->isRun); }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::PowerZonesConfig; }
     RideMetric *clone() const { return new MinWPrime(*this); }
 };
 
@@ -801,6 +803,7 @@ class MaxWPrime : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return ride->present.contains("P") || (!ride->isSwim && !ride->isRun); }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::PowerZonesConfig; }
     RideMetric *clone() const { return new MaxWPrime(*this); }
 };
 
@@ -833,6 +836,7 @@ class MaxMatch : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return ride->present.contains("P") || (!ride->isSwim && !ride->isRun); }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::PowerZonesConfig; }
     RideMetric *clone() const { return new MaxMatch(*this); }
 };
 
@@ -867,6 +871,7 @@ class Matches : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return ride->present.contains("P") || (!ride->isSwim && !ride->isRun); }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::PowerZonesConfig; }
     RideMetric *clone() const { return new Matches(*this); }
 };
 
@@ -901,6 +906,7 @@ class WPrimeTau : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return ride->present.contains("P") || (!ride->isSwim && !ride->isRun); }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::PowerZonesConfig; }
     RideMetric *clone() const { return new WPrimeTau(*this); }
 };
 
@@ -947,6 +953,7 @@ class WPrimeExp : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return ride->present.contains("P") || (!ride->isSwim && !ride->isRun); }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::PowerZonesConfig; }
     RideMetric *clone() const { return new WPrimeExp(*this); }
 };
 
@@ -993,6 +1000,7 @@ class WPrimeWatts : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return ride->present.contains("P") || (!ride->isSwim && !ride->isRun); }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::PowerZonesConfig; }
     RideMetric *clone() const { return new WPrimeWatts(*this); }
 };
 
@@ -1048,6 +1056,7 @@ class CPExp : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return ride->present.contains("P") || (!ride->isSwim && !ride->isRun); }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::PowerZonesConfig; }
     RideMetric *clone() const { return new CPExp(*this); }
 };
 
@@ -1101,6 +1110,7 @@ class WZoneTime : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return ride->present.contains("P") || (!ride->isSwim && !ride->isRun); }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::PowerZonesConfig; }
     RideMetric *clone() const { return new WZoneTime(*this); }
 };
 
@@ -1251,6 +1261,7 @@ class WCPZoneTime : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return ride->present.contains("P") || (!ride->isSwim && !ride->isRun); }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::PowerZonesConfig; }
     RideMetric *clone() const { return new WCPZoneTime(*this); }
 };
 
@@ -1392,6 +1403,7 @@ class WZoneWork : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const { return ride->present.contains("P") || (!ride->isSwim && !ride->isRun); }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::PowerZonesConfig; }
     RideMetric *clone() const { return new WZoneWork(*this); }
 };
 
@@ -60,6 +60,7 @@ class AverageWPK : public RideMetric {
     }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::WeightConfig; }
     RideMetric *clone() const { return new AverageWPK(*this); }
 };
 
@@ -98,6 +99,7 @@ class PeakWPK : public RideMetric {
     }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::WeightConfig; }
     RideMetric *clone() const { return new PeakWPK(*this); }
 };
 
@@ -351,6 +353,7 @@ class Vo2max : public RideMetric {
     bool isRelevantForRide(const RideItem *ride) const {return ride->present.contains("P"); }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new Vo2max(*this); }
 };
 
@@ -391,6 +394,7 @@ class EtimatedAverageWPK_DrF : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new EtimatedAverageWPK_DrF(*this); }
 };
 
@@ -105,6 +105,7 @@ class aIsoPower : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new aIsoPower(*this); }
 };
 
@@ -147,6 +148,7 @@ class aVI : public RideMetric {
     }
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new aVI(*this); }
 };
 
@@ -195,6 +197,7 @@ class aIntensityFactor : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::PowerZonesConfig; }
     RideMetric *clone() const { return new aIntensityFactor(*this); }
 };
 
@@ -244,6 +247,7 @@ class aBikeStress : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::PowerZonesConfig; }
     RideMetric *clone() const { return new aBikeStress(*this); }
 };
 
@@ -294,6 +298,7 @@ class aTSSPerHour : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new aTSSPerHour(*this); }
 };
 
@@ -336,6 +341,7 @@ class aEfficiencyFactor : public RideMetric {
 
     MetricClass classification() const { return Undefined; }
     MetricValidity validity() const { return Unknown; }
+    int configDependencies() const { return RideMetric::NoConfig; }
     RideMetric *clone() const { return new aEfficiencyFactor(*this); }
 };
 
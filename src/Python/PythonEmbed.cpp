@@ -325,19 +325,70 @@ PythonEmbed::PythonEmbed(const bool verbose, const bool interactive) : verbose(v
     return;
 }
 
+// must be called holding the GIL, the caller owns the reference
+// returned since a script it runs could compile others and evict it
+void *
+PythonEmbed::compile(QString script)
+{
+    PyObject *code = NULL;
+
+    QHash<QString, void*>::const_iterator it = compiled.constFind(script);
+    if (it != compiled.constEnd()) {
+
+        // most recently used
+        code = static_cast<PyObject*>(it.value());
+        recent.removeOne(script);
+        recent.append(script);
+
+    } else {
+
+        // compile as a module, the same as PyRun_SimpleString does
+        code = Py_CompileString(script.toStdString().c_str(), "<script>", Py_file_input);
+        if (code == NULL) return NULL;
+
+        // make room, dropping the least recently used
+        while (recent.count() >= PYTHON_COMPILED) {
+            PyObject *evicted = static_cast<PyObject*>(compiled.take(recent.takeFirst()));
+            Py_XDECREF(evicted);
+        }
+        compiled.insert(script, static_cast<void*>(code));
+        recent.append(script);
+    }
+
+    Py_INCREF(code);
+    return static_cast<void*>(code);
+}
+
+// must be called holding the GIL
+void
+PythonEmbed::captureMessages()
+{
+    PyObject *output = PyObject_GetAttrString(static_cast<PyObject*>(catcher),"value"); //get the stdout and stderr from our catchOutErr object
+    if (output) {
+        // allocated as unicodeA
+        Py_ssize_t size;
+        wchar_t *string = PyUnicode_AsWideCharString(output, &size);
+        if (string) {
+            if (size) messages = QString::fromWCharArray(string).split("\n");
+            PyMem_Free(string);
+            if (messages.count()) messages << "\n"; // always add a newline after anything
+        }
+        Py_DECREF(output);
+
+        // clear results
+        PyObject *cleared = PyObject_CallFunction(static_cast<PyObject*>(clear), NULL);
+        if (cleared) Py_DECREF(cleared);
+    }
+}
+
 // run on called thread
 void PythonEmbed::runline(ScriptContext scriptContext, QString line)
 {
     PyGILState_STATE gstate;
     gstate = PyGILState_Ensure();
 
-    // Get current thread ID via Python thread functions
-    PyObject* thread = PyImport_ImportModule("_thread");
-    PyObject* get_ident = PyObject_GetAttrString(thread, "get_ident");
-    PyObject* ident = PyObject_CallObject(get_ident, 0);
-    Py_DECREF(get_ident);
-    threadid = PyLong_AsLong(ident);
-    Py_DECREF(ident);
+    // current thread ID, same as _thread.get_ident()
+    threadid = PyThread_get_thread_ident();
 
     // add to the thread/context map
     contexts.insert(threadid, scriptContext);
@@ -345,37 +396,73 @@ void PythonEmbed::runline(ScriptContext scriptContext, QString line)
     // run and generate errors etc
     messages.clear();
 
+    PyObject *d = PyModule_GetDict(PyImport_AddModule("__main__"));
     if (scriptContext.interactiveShell) {
-        PyObject *m, *d, *v;
-        m = PyImport_AddModule("__main__");
-        d = PyModule_GetDict(m);
-        v = PyRun_StringFlags(line.toStdString().c_str(), Py_single_input, d, d, 0);
+        PyObject *v = PyRun_StringFlags(line.toStdString().c_str(), Py_single_input, d, d, 0);
         if (v) Py_DECREF(v);
     } else {
-        PyRun_SimpleString(line.toStdString().c_str());
+        PyObject *code = static_cast<PyObject*>(compile(line));
+        if (code) {
+            PyObject *v = PyEval_EvalCode(code, d, d);
+            if (v) Py_DECREF(v);
+            Py_DECREF(code);
+        }
     }
 
     PyErr_Print();
     PyErr_Clear(); //and clear them !
 
     // capture results
-    PyObject *output = PyObject_GetAttrString(static_cast<PyObject*>(catcher),"value"); //get the stdout and stderr from our catchOutErr object
-    if (output) {
-        // allocated as unicodeA
-        Py_ssize_t size;
-        wchar_t *string = PyUnicode_AsWideCharString(output, &size);
-        if (string) {
-            if (size) messages = QString::fromWCharArray(string).split("\n");
-            PyMem_Free(string);
-            if (messages.count()) messages << "\n"; // always add a newline after anything
-        }
+    captureMessages();
 
-        // clear results
-        PyObject_CallFunction(static_cast<PyObject*>(clear), NULL);
+    PyGILState_Release(gstate);
+    threadid=-1;
+}
+
+// run on called thread, the caller holds the python mutex
+QVector<double> PythonEmbed::runBatch(QList<ScriptContext> scriptContexts, QString script)
+{
+    QVector<double> returning(scriptContexts.count(), 0);
+
+    PyGILState_STATE gstate;
+    gstate = PyGILState_Ensure();
+
+    threadid = PyThread_get_thread_ident();
+    messages.clear();
+
+    PyObject *d = PyModule_GetDict(PyImport_AddModule("__main__"));
+    PyObject *code = static_cast<PyObject*>(compile(script));
+
+    if (code == NULL) {
+        PyErr_Print();
+        PyErr_Clear();
+
+    } else {
+
+        for (int i=0; i<scriptContexts.count(); i++) {
+
+            // only the context changes between runs
+            contexts.insert(threadid, scriptContexts.at(i));
+            result = 0;
+
+            PyObject *v = PyEval_EvalCode(code, d, d);
+            if (v) Py_DECREF(v);
+            else {
+                PyErr_Print();
+                PyErr_Clear();
+            }
+            returning[i] = result;
+        }
+        Py_DECREF(code);
     }
 
+    // capture results
+    captureMessages();
+
     PyGILState_Release(gstate);
     threadid=-1;
+
+    return returning;
 }
 
 void
@@ -22,6 +22,8 @@
 #include <QWidget>
 #include <QString>
 #include <QMap>
+#include <QHash>
+#include <QVector>
 #include <QStringList>
 
 #include "RideItem.h"
@@ -30,6 +32,9 @@
 class Context;
 class PythonChart;
 
+// how many compiled scripts are kept, least recently used go first
+#define PYTHON_COMPILED 64
+
 class PythonEmbed;
 extern PythonEmbed *python;
 
@@ -90,6 +95,10 @@ class PythonEmbed {
     // run a single line from console
     void runline(ScriptContext, QString);
 
+    // run a script once for each context, holding the interpreter
+    // throughout and returning the result each run set, in order
+    QVector<double> runBatch(QList<ScriptContext>, QString);
+
     // stop current execution
     void cancel();
 
@@ -112,6 +121,18 @@ class PythonEmbed {
 
     bool loaded;
     long threadid;
+
+    private:
+
+    // compiled code objects (PyObject*) by script source, so
+    // scripts run over and over are only compiled once, returns
+    // a new reference, recent is in order of use, oldest first
+    void *compile(QString);
+    QHash<QString, void*> compiled;
+    QStringList recent;
+
+    // capture and clear anything the scripts printed
+    void captureMessages();
 };
 
 // embed debugging via 'printd' and enable via PYTHON_DEBUG
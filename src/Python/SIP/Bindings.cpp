@@ -22,6 +22,7 @@
 #include <QWebEngineView>
 #include <QUrl>
 #include <datetime.h> // for Python datetime macros
+#include <algorithm>
 
 long Bindings::threadid() const
 {
@@ -590,10 +591,6 @@ Bindings::series(int type, PyObject* activity, int compareindex) const
     RideFile *f = selectRideFile(activity, compareindex);
     if (f == nullptr) return nullptr;
 
-    // count the included points, create data series output and copy data
-    int pCount = 0;
-    RideFileIterator it(f, python->contexts.value(threadid()).spec);
-    while (it.hasNext()) { it.next(); pCount++; }
     RideFile::SeriesType seriesType = static_cast<RideFile::SeriesType>(type);
     bool readOnly = python->contexts.value(threadid()).readOnly;
     QList<RideFile *> *editedRideFiles = python->contexts.value(threadid()).editedRideFiles;
@@ -602,14 +599,16 @@ Bindings::series(int type, PyObject* activity, int compareindex) const
         editedRideFiles->append(f);
     }
 
-    PythonDataSeries* ds = new PythonDataSeries(seriesName(type), pCount, readOnly, seriesType, f);
-    it.toFront();
-    for(int i=0; i<pCount && it.hasNext(); i++) {
-        struct RideFilePoint *point = it.next();
-        ds->data[i] = point->value(seriesType);
-    }
+    // derived series are only computed when asked for
+    f->recalculateDerivedSeries(seriesType);
 
-    return ds;
+    // copy the included points in a single pass
+    QVector<double> values;
+    values.reserve(f->dataPoints().count());
+    RideFileIterator it(f, python->contexts.value(threadid()).spec);
+    while (it.hasNext()) values << it.next()->value(seriesType);
+
+    return new PythonDataSeries(seriesName(type), values, readOnly, seriesType, f);
 }
 
 // get the wbal series for the currently selected ride
@@ -623,21 +622,17 @@ Bindings::activityWbal(PyObject* activity, int compareindex) const
     WPrime *w = f->wprimeData();
     if (w == NULL) return NULL;
 
-    // count the included points, create data series output and copy data
-    int pCount = 0;
-    int idxStart = 0;
+    // find the included points, xdata is in time order
+    const QVector<double> &x = w->xdata(false);
     int secsStart = python->contexts.value(threadid()).spec.secsStart();
     int secsEnd = python->contexts.value(threadid()).spec.secsEnd();
-    for(int i=0; i<w->xdata(false).count(); i++) {
-        if (w->xdata(false)[i] < secsStart) continue;
-        if (secsEnd >= 0 && w->xdata(false)[i] > secsEnd) break;
-        if (pCount == 0) idxStart = i;
-        pCount++;
-    }
-    PythonDataSeries* ds = new PythonDataSeries("WBal", pCount);
-    for(int i=0; i<pCount; i++) ds->data[i] = w->ydata()[i+idxStart];
+    int idxStart = std::lower_bound(x.constBegin(), x.constEnd(), double(secsStart)) - x.constBegin();
+    int idxEnd = secsEnd >= 0 ? std::upper_bound(x.constBegin(), x.constEnd(), double(secsEnd)) - x.constBegin() : x.count();
 
-    return ds;
+    // the whole activity shares the wbal data rather than copying it
+    const QVector<double> &y = w->ydata();
+    if (idxStart == 0 && idxEnd >= y.count()) return new PythonDataSeries("WBal", y);
+    return new PythonDataSeries("WBal", y.mid(idxStart, qMax(0, idxEnd - idxStart)));
 }
 
 // get the xdata series for the currently selected ride
@@ -665,20 +660,16 @@ Bindings::xdata(QString name, QString series, QString join, PyObject* activity,
 
     if (!xds->valuename.contains(series)) return NULL; // No such XData name
 
-    // count the included points, create data series output and copy data
-    int pCount = 0;
+    // join to the samples in a single pass and keep the included points
+    QVector<double> joined = xds->join(f, xds->valuename.indexOf(series), xjoin);
     RideFileIterator it(f, python->contexts.value(threadid()).spec);
-    while (it.hasNext()) { it.next(); pCount++; }
-    PythonDataSeries* ds = new PythonDataSeries(QString("%1_%2").arg(name).arg(series), pCount);
-    it.toFront();
-    int idx = 0;
-    for(int i=0; i<pCount && it.hasNext(); i++) {
-        struct RideFilePoint *point = it.next();
-        double val = f->xdataValue(point, idx, name, series, xjoin);
-        ds->data[i] = (val == RideFile::NA) ? sqrt(-1) : val; // NA => NaN
-    }
+    QVector<double> values;
+    if (it.firstIndex() >= 0 && it.lastIndex() >= it.firstIndex())
+        values = joined.mid(it.firstIndex(), it.lastIndex() - it.firstIndex() + 1);
+    for (int i=0; i<values.count(); i++)
+        if (values[i] == RideFile::NA) values[i] = sqrt(-1); // NA => NaN
 
-    return ds;
+    return new PythonDataSeries(QString("%1_%2").arg(name).arg(series), values);
 }
 
 // get the xdata series for the currently selected ride, without interpolation
@@ -707,9 +698,9 @@ PythonXDataSeries *Bindings::xdataSeries(QString name, QString series, PyObject*
     Specification spec(python->contexts.value(threadid()).spec);
     IntervalItem* it = spec.interval();
     int pCount = 0;
-    foreach(XDataPoint* p, xds->datapoints) {
-        if (it && p->secs < it->start) continue;
-        if (it && p->secs > it->stop) break;
+    for (int i=0; i<xds->count(); i++) {
+        if (it && xds->secs(i) < it->start) continue;
+        if (it && xds->secs(i) > it->stop) break;
         pCount++;
     }
 
@@ -717,13 +708,13 @@ PythonXDataSeries *Bindings::xdataSeries(QString name, QString series, PyObject*
                                                   pCount, readOnly, f);
 
     int idx = 0;
-    foreach(XDataPoint* p, xds->datapoints) {
-        if (it && p->secs < it->start) continue;
-        if (it && p->secs > it->stop) break;
+    for (int i=0; i<xds->count(); i++) {
+        if (it && xds->secs(i) < it->start) continue;
+        if (it && xds->secs(i) > it->stop) break;
         double val = sqrt(-1); // NA => NaN
-        if (valueIdx >= 0) val = p->number[valueIdx];
-        else if (series == "secs") val = p->secs;
-        else if (series == "km") val = p->km;
+        if (valueIdx >= 0) val = xds->value(i, valueIdx);
+        else if (series == "secs") val = xds->secs(i);
+        else if (series == "km") val = xds->km(i);
         ds->set(idx++, val);
     }
 
@@ -772,34 +763,61 @@ Bindings::seriesPresent(int type, PyObject* activity, int compareindex) const
     return f->isDataPresent(static_cast<RideFile::SeriesType>(type));
 }
 
-PythonDataSeries::PythonDataSeries(QString name, Py_ssize_t count, bool readOnly, RideFile::SeriesType seriesType, RideFile *rideFile)
-    : name(name), count(count), data(NULL), readOnly(readOnly), seriesType(seriesType), rideFile(rideFile)
-{
-    if (count > 0) data = new double[count];
-}
-
-PythonDataSeries::PythonDataSeries(QString name, Py_ssize_t count) : name(name), count(count), data(NULL),
-    readOnly(true), seriesType(RideFile::none), rideFile(NULL)
+PythonDataSeries::PythonDataSeries(QString name, QVector<double> values, bool readOnly, RideFile::SeriesType seriesType, RideFile *rideFile)
+    : name(name), count(0), data(NULL), readOnly(readOnly), seriesType(seriesType), rideFile(rideFile), values(values)
 {
-    if (count > 0) data = new double[count];
+    attach();
 }
 
 // default constructor and copy constructor
 PythonDataSeries::PythonDataSeries() : name(QString()), count(0), data(NULL),
     readOnly(true), seriesType(RideFile::none), rideFile(NULL) {}
-PythonDataSeries::PythonDataSeries(PythonDataSeries *clone)
+PythonDataSeries::PythonDataSeries(PythonDataSeries *clone) : name(QString()), count(0), data(NULL),
+    readOnly(true), seriesType(RideFile::none), rideFile(NULL)
 {
     if (clone) *this = *clone;
-    else {
-        name = QString();
-        count = 0;
-        data = NULL;
+}
+
+PythonDataSeries::PythonDataSeries(const PythonDataSeries &other) : count(0), data(NULL)
+{
+    *this = other;
+}
+
+PythonDataSeries &
+PythonDataSeries::operator=(const PythonDataSeries &other)
+{
+    name = other.name;
+    readOnly = other.readOnly;
+    seriesType = other.seriesType;
+    rideFile = other.rideFile;
+    values = other.values;
+    attach();
+    return *this;
+}
+
+void
+PythonDataSeries::attach()
+{
+    // share, no copying until written
+    count = values.count();
+    if (count == 0) data = NULL;
+    else data = values.constData();
+}
+
+double *
+PythonDataSeries::writable()
+{
+    // writing must not change anyone else's copy, and buffers
+    // already exported still point at the shared values
+    if (!values.isDetached()) {
+        shared = values;
+        data = values.data(); // copies
     }
+    return values.data();
 }
 
 PythonDataSeries::~PythonDataSeries()
 {
-    if (data) delete[] data;
     data=NULL;
     rideFile = NULL;
 }
@@ -847,9 +865,8 @@ bool PythonXDataSeries::add(double value)
             return false;
         }
 
-        QVector<XDataPoint *> xDataPoints(1);
-        xDataPoints[0] = new XDataPoint;
-        int i = rideFile->xdata(xdata)->datapoints.count();
+        QVector<XDataPoint> xDataPoints(1);
+        int i = rideFile->xdata(xdata)->count();
 
         rideFile->command->appendXDataPoints(xdata, xDataPoints);
         rideFile->command->setXDataPointValue(xdata, i, colIdx, value);
@@ -1785,13 +1802,6 @@ Bindings::metrics(QString metric, bool all, QString filter) const
 
     specification.setFilterSet(fs);
 
-    // we need to count rides that are in range...
-    int rides = 0;
-    foreach(RideItem *ride, context->athlete->rideCache->rides()) {
-        if (!specification.pass(ride)) continue;
-        if (all || range.pass(ride->dateTime.date())) rides++;
-    }
-
     const RideMetricFactory &factory = RideMetricFactory::instance();
     bool useMetricUnits = GlobalContext::context()->useMetricUnits;
     for(int i=0; i<factory.metricCount();i++) {
@@ -1805,18 +1815,17 @@ Bindings::metrics(QString metric, bool all, QString filter) const
         if (name == metric) {
 
             // found, set an array of metric values
-            PythonDataSeries* pds = new PythonDataSeries(name, rides);
-
-            int idx = 0;
+            QVector<double> values;
+            values.reserve(context->athlete->rideCache->rides().count());
             foreach(RideItem *item, context->athlete->rideCache->rides()) {
                 if (!specification.pass(item)) continue;
                 if (all || range.pass(item->dateTime.date())) {
-                    pds->data[idx++] = item->metrics()[i] * (useMetricUnits ? 1.0f : m->conversion()) + (useMetricUnits ? 0.0f : m->conversionSum());
+                    values << item->metrics()[i] * (useMetricUnits ? 1.0f : m->conversion()) + (useMetricUnits ? 0.0f : m->conversionSum());
                 }
             }
 
             // Done, return the series
-            return pds;
+            return new PythonDataSeries(name, values);
         }
     }
 
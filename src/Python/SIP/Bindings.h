@@ -2,6 +2,7 @@
 #define _Bindings_h
 
 #include <QString>
+#include <QVector>
 #include "RideFile.h"
 #include "RideFileCache.h"
 #include "RideFileCommand.h"
@@ -13,22 +14,41 @@
 #pragma GCC diagnostic ignored "-Wcast-function-type" // shut gcc up
 #endif
 
+//
+// Data series are handed to Python via the buffer protocol, so numpy
+// can wrap them without copying. The values are held in an implicitly
+// shared vector, exported read-only, and only copied the first time
+// they are written (item assignment or a writable buffer request).
+// readOnly stops item assignment writing back to the activity.
+//
 class PythonDataSeries {
 
     public:
-        PythonDataSeries(QString name, Py_ssize_t count, bool readOnly, RideFile::SeriesType seriesType, RideFile *rideFile);
-        PythonDataSeries(QString name, Py_ssize_t count);
+        PythonDataSeries(QString name, QVector<double> values, bool readOnly=true,
+                         RideFile::SeriesType seriesType=RideFile::none, RideFile *rideFile=NULL);
         PythonDataSeries(PythonDataSeries*);
+        PythonDataSeries(const PythonDataSeries &);
         PythonDataSeries();
         ~PythonDataSeries();
 
+        PythonDataSeries &operator=(const PythonDataSeries &);
+
         QString name;
         Py_ssize_t count;
-        double *data;
+        const double *data;     // into values, what the buffer exports
+
+        // for writing, copies the values if they are still shared
+        double *writable();
 
         bool readOnly;
         int seriesType;
         RideFile *rideFile;
+
+    private:
+        void attach();          // point data at values
+
+        QVector<double> values;
+        QVector<double> shared; // what read-only buffers saw before a write
 };
 
 class PythonXDataSeries {
@@ -40,7 +40,7 @@ static int slot_PythonDataSeries___setitem__(PyObject *sipSelf,PyObject *sipArgs
         } else {
             if (a0 < 0) a0 += sipCpp->count;
             if (a0 >= 0 && a0 < sipCpp->count) {
-                sipCpp->data[a0] = a1;
+                sipCpp->writable()[a0] = a1;
                 RideFile *rideFile = sipCpp->rideFile;
                 if (rideFile) {
                     RideFile::SeriesType seriesType = static_cast<RideFile::SeriesType>(sipCpp->seriesType);
@@ -180,16 +180,18 @@ static void release_PythonDataSeries(void *sipCppV, int)
 
 #if PY_MAJOR_VERSION >= 3
 extern "C" {static int getbuffer_PythonDataSeries(PyObject *, void *, Py_buffer *, int);}
-static int getbuffer_PythonDataSeries(PyObject *sipSelf, void *sipCppV, Py_buffer *sipBuffer, int )
+static int getbuffer_PythonDataSeries(PyObject *sipSelf, void *sipCppV, Py_buffer *sipBuffer, int sipFlags)
 {
      ::PythonDataSeries *sipCpp = reinterpret_cast< ::PythonDataSeries *>(sipCppV);
     int sipRes;
 
 #line 63 "goldencheetah.sip"
     sipBuffer->obj = sipSelf;
-    sipBuffer->buf = (void*)sipCpp->data;
+    // shared read-only unless asked for writable, which copies
+    bool writable = (sipFlags & PyBUF_WRITABLE) && sipCpp->count;
+    sipBuffer->buf = writable ? (void*)sipCpp->writable() : (void*)sipCpp->data;
     sipBuffer->len = sipCpp->count * sizeof(double);
-    sipBuffer->readonly = 0;
+    sipBuffer->readonly = writable ? 0 : 1;
     sipBuffer->itemsize = sizeof(double);
     sipBuffer->format = (char*)"d";  // double
     sipBuffer->ndim = 1;
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "RColumnCache.h"
+
+#include "Context.h"
+#include "Athlete.h"
+#include "RideCache.h"
+#include "RideFileCache.h"
+
+RColumnCache::RColumnCache() : columnBytes(0)
+{
+}
+
+RColumnCache::~RColumnCache()
+{
+    qDeleteAll(meanmaxes);
+}
+
+QString
+RColumnCache::key(Context *context, const Specification &spec, bool all, DateRange range, QStringList filters)
+{
+    watch(context);
+
+    QStringList parts;
+    parts << QString::number(quintptr(context))
+          << (all ? "all" : "")
+          << range.from.toString(Qt::ISODate)
+          << range.to.toString(Qt::ISODate)
+          << spec.signature()
+          << filters;
+
+    QString returning;
+    foreach(QString part, parts) returning += QString("%1:%2|").arg(part.length()).arg(part);
+    return returning;
+}
+
+bool
+RColumnCache::rides(QString key, QVector<RideItem*> &rides)
+{
+    QHash<QString, QVector<RideItem*> >::const_iterator it = selections.constFind(key);
+    if (it == selections.constEnd()) return false;
+    rides = it.value();
+    recentSelections.removeOne(key);
+    recentSelections.append(key);
+    return true;
+}
+
+void
+RColumnCache::setRides(QString key, QVector<RideItem*> rides)
+{
+    recentSelections.removeOne(key);
+    while (recentSelections.count() >= RCOLUMNCACHE_SELECTIONS)
+        selections.remove(recentSelections.takeFirst());
+
+    selections.insert(key, rides);
+    recentSelections.append(key);
+}
+
+bool
+RColumnCache::column(QString key, QString name, QVector<double> &values)
+{
+    QString k = key + "|" + name;
+    QHash<QString, QVector<double> >::const_iterator it = columns.constFind(k);
+    if (it == columns.constEnd()) return false;
+    values = it.value();
+    recentColumns.removeOne(k);
+    recentColumns.append(k);
+    return true;
+}
+
+void
+RColumnCache::setColumn(QString key, QString name, QVector<double> values)
+{
+    QString k = key + "|" + name;
+    if (recentColumns.removeOne(k)) columnBytes -= columns.take(k).count() * sizeof(double);
+
+    // make room, but always keep the one being added
+    columnBytes += values.count() * sizeof(double);
+    while (columnBytes > RCOLUMNCACHE_COLUMNS && recentColumns.count())
+        columnBytes -= columns.take(recentColumns.takeFirst()).count() * sizeof(double);
+
+    columns.insert(k, values);
+    recentColumns.append(k);
+}
+
+RideFileCache *
+RColumnCache::meanmax(QString key)
+{
+    RideFileCache *cache = meanmaxes.value(key, NULL);
+    if (cache) {
+        recentMeanmaxes.removeOne(key);
+        recentMeanmaxes.append(key);
+    }
+    return cache;
+}
+
+void
+RColumnCache::setMeanmax(QString key, RideFileCache *cache)
+{
+    recentMeanmaxes.removeOne(key);
+    delete meanmaxes.take(key);
+    while (recentMeanmaxes.count() >= RCOLUMNCACHE_MEANMAXES)
+        delete meanmaxes.take(recentMeanmaxes.takeFirst());
+
+    meanmaxes.insert(key, cache);
+    recentMeanmaxes.append(key);
+}
+
+void
+RColumnCache::invalidate()
+{
+    selections.clear();
+    recentSelections.clear();
+    columns.clear();
+    recentColumns.clear();
+    columnBytes = 0;
+    qDeleteAll(meanmaxes);
+    meanmaxes.clear();
+    recentMeanmaxes.clear();
+}
+
+void
+RColumnCache::contextDestroyed(QObject *object)
+{
+    watching.remove(static_cast<Context*>(object));
+    invalidate();
+}
+
+void
+RColumnCache::watch(Context *context)
+{
+    if (watching.contains(context)) return;
+    watching.insert(context);
+
+    // anything that changes which rides pass or their values
+    connect(context, SIGNAL(rideAdded(RideItem*)), this, SLOT(invalidate()));
+    connect(context, SIGNAL(rideDeleted(RideItem*)), this, SLOT(invalidate()));
+    connect(context, SIGNAL(refreshUpdate(QDate)), this, SLOT(invalidate()));
+    connect(context, SIGNAL(refreshEnd()), this, SLOT(invalidate()));
+    connect(context, SIGNAL(configChanged(qint32)), this, SLOT(configChanged(qint32)));
+    connect(context, SIGNAL(destroyed(QObject*)), this, SLOT(contextDestroyed(QObject*)));
+    connect(context->athlete->rideCache, SIGNAL(itemChanged(RideItem*)), this, SLOT(invalidate()));
+}
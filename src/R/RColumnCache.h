@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef _GC_RColumnCache_h
+#define _GC_RColumnCache_h 1
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include <QString>
+#include <QStringList>
+
+#include "TimeUtils.h" // for DateRange
+#include "Specification.h"
+
+class Context;
+class RideItem;
+class RideFileCache;
+
+// how much is kept, least recently used go first
+#define RCOLUMNCACHE_SELECTIONS 32
+#define RCOLUMNCACHE_COLUMNS (64*1024*1024) // bytes
+#define RCOLUMNCACHE_MEANMAXES 4
+
+//
+// Season data frames are rebuilt every time an R chart is refreshed,
+// which means filtering every ride and looking up every metric again.
+// Selections of rides and the numeric columns built from them are kept
+// here, shared by all R charts, until anything about the rides changes.
+//
+// A selection is keyed by everything that decides which rides pass, the
+// R filter expressions are used as written so they needn't be parsed
+// again when the selection is already known. Each part of the key is
+// prefixed by its length, so different selections never share a key.
+//
+class RColumnCache : public QObject
+{
+    Q_OBJECT
+
+    public:
+        RColumnCache();
+        ~RColumnCache();
+
+        QString key(Context *context, const Specification &spec, bool all, DateRange range, QStringList filters);
+
+        // the rides in a selection
+        bool rides(QString key, QVector<RideItem*> &rides);
+        void setRides(QString key, QVector<RideItem*> rides);
+
+        // numeric columns for a selection
+        bool column(QString key, QString name, QVector<double> &values);
+        void setColumn(QString key, QString name, QVector<double> values);
+
+        // aggregated mean maximals for a selection, owned by the cache
+        RideFileCache *meanmax(QString key);
+        void setMeanmax(QString key, RideFileCache *cache);
+
+    public slots:
+
+        // drop everything, rides have changed
+        void invalidate();
+        void configChanged(qint32) { invalidate(); }
+        void contextDestroyed(QObject *);
+
+    private:
+        void watch(Context *context);
+
+        QSet<Context*> watching;
+
+        // each with its keys in order of use, oldest first
+        QHash<QString, QVector<RideItem*> > selections;
+        QStringList recentSelections;
+        QHash<QString, QVector<double> > columns;
+        QStringList recentColumns;
+        qint64 columnBytes;
+        QHash<QString, RideFileCache*> meanmaxes;
+        QStringList recentMeanmaxes;
+};
+
+#endif // _GC_RColumnCache_h
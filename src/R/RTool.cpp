@@ -39,6 +39,8 @@
 #include "GenericChart.h"
 #include "Perspective.h"
 
+#include <string.h>
+
 #ifdef __GNUC__
 #pragma GCC diagnostic ignored "-Wcast-function-type" // shut gcc up
 #endif
@@ -76,6 +78,7 @@ RTool::RTool()
     perspective = NULL;
     chart = NULL;
     context = NULL;
+    columns = new RColumnCache();
 
     // if we bail we need to explain why, its in here
     QString dialogtext;
@@ -379,6 +382,8 @@ fail:
         appsettings->setValue(GC_EMBED_R, false);
         version = "none";
         R = NULL;
+        delete columns;
+        columns = NULL;
 
         // end embedding
         // Don't bug the user, most of them don't care
@@ -389,6 +394,11 @@ fail:
     starting = false;
 }
 
+RTool::~RTool()
+{
+    delete columns;
+}
+
 void
 RTool::R_ProcessEvents()
 {
@@ -1123,6 +1133,42 @@ RTool::dfForRideItem(const RideItem *ri)
     return ans;
 }
 
+// the rides in range that pass the global and R filters, the selection
+// is cached so the filter expressions are only parsed when it changes
+QVector<RideItem*>
+RTool::dfSelection(bool all, DateRange range, SEXP filter, Specification &specification, FilterSet &fs, QString &key)
+{
+    QStringList filters;
+    PROTECT(filter=Rf_coerceVector(filter, STRSXP));
+    for(int i=0; i<Rf_length(filter); i++) {
+        QString f(CHAR(STRING_ELT(filter,i)));
+        if (f != "") filters << f;
+    }
+    UNPROTECT(1);
+
+    QVector<RideItem*> selected;
+    key = columns->key(context, specification, all, range, filters);
+    if (columns->rides(key, selected)) return selected;
+
+    // did call contain any filters?
+    foreach(QString f, filters) {
+
+        DataFilter dataFilter(canvas, context);
+        QStringList files;
+        dataFilter.parseFilter(context, f, &files);
+        fs.addFilter(true, files);
+    }
+    specification.setFilterSet(fs);
+
+    foreach(RideItem *ride, context->athlete->rideCache->rides()) {
+        if (!specification.pass(ride)) continue;
+        if (all || range.pass(ride->dateTime.date())) selected << ride;
+    }
+    columns->setRides(key, selected);
+
+    return selected;
+}
+
 SEXP
 RTool::dfForDateRange(bool all, DateRange range, SEXP filter)
 {
@@ -1153,29 +1199,10 @@ RTool::dfForDateRange(bool all, DateRange range, SEXP filter)
     fs.addFilter(rtool->perspective->isFiltered(), rtool->perspective->filterlist(range));
     specification.setFilterSet(fs);
 
-    // did call contain any filters?
-    PROTECT(filter=Rf_coerceVector(filter, STRSXP));
-    for(int i=0; i<Rf_length(filter); i++) {
-
-        // if not empty write a filter
-        QString f(CHAR(STRING_ELT(filter,i)));
-        if (f != "") {
-
-            DataFilter dataFilter(rtool->canvas, rtool->context);
-            QStringList files;
-            dataFilter.parseFilter(rtool->context, f, &files);
-            fs.addFilter(true, files);
-        }
-    }
-    specification.setFilterSet(fs);
-    UNPROTECT(1);
-
-    // we need to count rides that are in range...
-    rides = 0;
-    foreach(RideItem *ride, rtool->context->athlete->rideCache->rides()) {
-        if (!specification.pass(ride)) continue;
-        if (all || range.pass(ride->dateTime.date())) rides++;
-    }
+    // which rides are in range and pass the filters
+    QString key;
+    QVector<RideItem*> selected = dfSelection(all, range, filter, specification, fs, key);
+    rides = selected.count();
 
     // get a listAllocated
     SEXP ans;
@@ -1202,11 +1229,8 @@ RTool::dfForDateRange(bool all, DateRange range, SEXP filter)
 
     int k=0;
     QDate d1970(1970,01,01);
-    foreach(RideItem *ride, rtool->context->athlete->rideCache->rides()) {
-        if (!specification.pass(ride)) continue;
-        if (all || range.pass(ride->dateTime.date()))
-            INTEGER(date)[k++] = d1970.daysTo(ride->dateTime.date());
-    }
+    foreach(RideItem *ride, selected)
+        INTEGER(date)[k++] = d1970.daysTo(ride->dateTime.date());
 
     SEXP dclas;
     PROTECT(dclas=Rf_allocVector(STRSXP, 1));
@@ -1223,11 +1247,8 @@ RTool::dfForDateRange(bool all, DateRange range, SEXP filter)
 
     // fill with values for date and class if its one we need to return
     k=0;
-    foreach(RideItem *ride, rtool->context->athlete->rideCache->rides()) {
-        if (!specification.pass(ride)) continue;
-        if (all || range.pass(ride->dateTime.date()))
-            REAL(time)[k++] = ride->dateTime.toUTC().toSecsSinceEpoch();
-    }
+    foreach(RideItem *ride, selected)
+        REAL(time)[k++] = ride->dateTime.toUTC().toSecsSinceEpoch();
 
     // POSIXct class
     SEXP clas;
@@ -1263,14 +1284,18 @@ RTool::dfForDateRange(bool all, DateRange range, SEXP filter)
 
         bool useMetricUnits = GlobalContext::context()->useMetricUnits;
 
-        int index=0;
-        foreach(RideItem *item, rtool->context->athlete->rideCache->rides()) {
-            if (!specification.pass(item)) continue;
-            if (all || range.pass(item->dateTime.date())) {
-                REAL(m)[index++] = item->metrics()[i] * (useMetricUnits ? 1.0f : metric->conversion())
-                                                      + (useMetricUnits ? 0.0f : metric->conversionSum());
+        // unchanged columns are just copied in
+        QVector<double> values;
+        QString column = QString("%1:%2").arg(symbol).arg(useMetricUnits);
+        if (!rtool->columns->column(key, column, values)) {
+            values.resize(rides);
+            for(int index=0; index<rides; index++) {
+                values[index] = selected.at(index)->metrics()[i] * (useMetricUnits ? 1.0f : metric->conversion())
+                                                                 + (useMetricUnits ? 0.0f : metric->conversionSum());
             }
+            rtool->columns->setColumn(key, column, values);
         }
+        if (rides) memcpy(REAL(m), values.constData(), rides * sizeof(double));
 
         // add to the list
         SET_VECTOR_ELT(ans, next, m);
@@ -1298,12 +1323,8 @@ RTool::dfForDateRange(bool all, DateRange range, SEXP filter)
         PROTECT(m=Rf_allocVector(STRSXP, rides));
 
         int index=0;
-        foreach(RideItem *item, rtool->context->athlete->rideCache->rides()) {
-            if (!specification.pass(item)) continue;
-            if (all || range.pass(item->dateTime.date())) {
-                SET_STRING_ELT(m, index++, Rf_mkChar(item->getText(field.name, "").toLatin1().constData()));
-            }
-        }
+        foreach(RideItem *item, selected)
+            SET_STRING_ELT(m, index++, Rf_mkChar(item->getText(field.name, "").toLatin1().constData()));
 
         // add to the list
         SET_VECTOR_ELT(ans, next, m);
@@ -1322,23 +1343,20 @@ RTool::dfForDateRange(bool all, DateRange range, SEXP filter)
     PROTECT(color=Rf_allocVector(STRSXP, rides));
 
     int index=0;
-    foreach(RideItem *item, rtool->context->athlete->rideCache->rides()) {
-        if (!specification.pass(item)) continue;
-        if (all || range.pass(item->dateTime.date())) {
+    foreach(RideItem *item, selected) {
 
-            // apply item color, remembering that 1,1,1 means use default (reverse in this case)
-            if (item->color == QColor(1,1,1,1)) {
+        // apply item color, remembering that 1,1,1 means use default (reverse in this case)
+        if (item->color == QColor(1,1,1,1)) {
 
-                // use the inverted color, not plot marker as that hideous
-                QColor col =GCColor::invertColor(GColor(CPLOTBACKGROUND));
+            // use the inverted color, not plot marker as that hideous
+            QColor col =GCColor::invertColor(GColor(CPLOTBACKGROUND));
 
-                // white is jarring on a dark background!
-                if (col==QColor(Qt::white)) col=QColor(127,127,127);
+            // white is jarring on a dark background!
+            if (col==QColor(Qt::white)) col=QColor(127,127,127);
 
-                SET_STRING_ELT(color, index++, Rf_mkChar(col.name().toLatin1().constData()));
-            } else
-                SET_STRING_ELT(color, index++, Rf_mkChar(item->color.name().toLatin1().constData()));
-        }
+            SET_STRING_ELT(color, index++, Rf_mkChar(col.name().toLatin1().constData()));
+        } else
+            SET_STRING_ELT(color, index++, Rf_mkChar(item->color.name().toLatin1().constData()));
     }
 
     // add to the list and name it
@@ -1379,18 +1397,17 @@ RTool::dfForDateRangeIntervals(DateRange range, QStringList types)
     specification.setFilterSet(fs);
 
     // we need to count intervals that are in range...
-    intervals = 0;
+    QVector<IntervalItem*> selected;
     foreach(RideItem *ride, rtool->context->athlete->rideCache->rides()) {
         if (!specification.pass(ride)) continue;
         if (!range.pass(ride->dateTime.date())) continue;
 
-        if (types.isEmpty()) intervals += ride->intervals().count();
-        else {
-            foreach(IntervalItem *item, ride->intervals())
-                if (types.contains(RideFileInterval::typeDescription(item->type)))
-                    intervals++;
-        }
+        foreach(IntervalItem *item, ride->intervals())
+            if (types.isEmpty() || types.contains(RideFileInterval::typeDescription(item->type)))
+                selected << item;
     }
+    intervals = selected.count();
+    QString key = rtool->columns->key(rtool->context, specification, false, range, types) + "|intervals";
 
     // get a listAllocated
     SEXP ans;
@@ -1519,18 +1536,18 @@ RTool::dfForDateRangeIntervals(DateRange range, QStringList types)
 
         bool useMetricUnits = GlobalContext::context()->useMetricUnits;
 
-        int index=0;
-        foreach(RideItem *item, rtool->context->athlete->rideCache->rides()) {
-            if (!specification.pass(item)) continue;
-            if (range.pass(item->dateTime.date())) {
-
-                foreach(IntervalItem *interval, item->intervals()) {
-                    if (types.isEmpty() || types.contains(RideFileInterval::typeDescription(interval->type)))
-                        REAL(m)[index++] = interval->metrics()[i] * (useMetricUnits ? 1.0f : metric->conversion())
-                                                          + (useMetricUnits ? 0.0f : metric->conversionSum());
-                }
+        // unchanged columns are just copied in
+        QVector<double> values;
+        QString column = QString("%1:%2").arg(symbol).arg(useMetricUnits);
+        if (!rtool->columns->column(key, column, values)) {
+            values.resize(intervals);
+            for(int index=0; index<intervals; index++) {
+                values[index] = selected.at(index)->metrics()[i] * (useMetricUnits ? 1.0f : metric->conversion())
+                                                                 + (useMetricUnits ? 0.0f : metric->conversionSum());
             }
+            rtool->columns->setColumn(key, column, values);
         }
+        if (intervals) memcpy(REAL(m), values.constData(), intervals * sizeof(double));
 
         // add to the list
         SET_VECTOR_ELT(ans, next, m);
@@ -2276,10 +2293,10 @@ RTool::dfForActivity(RideFile *f, int split, QString join)
                 SEXP vector = PROTECT(Rf_allocVector(REALSXP, points));
                 pcount++;
 
-                int idx=0;
+                // joined to the samples in a single pass
+                QVector<double> joined = it.value()->join(f, it.value()->valuename.indexOf(series), xjoin);
                 for(int j=index; j<stop; j++) {
-                    RideFilePoint *p = f->dataPoints()[j];
-                    double val = f->xdataValue(p, idx, it.value()->name, series, xjoin);
+                    double val = joined[j];
                     REAL(vector)[j-index] = (val == RideFile::NA) ? NA_REAL : val;
                 }
 
@@ -2550,14 +2567,27 @@ RTool::dfForDateRangeMeanmax(bool all, DateRange range, SEXP filter)
     if (all) range = DateRange(QDate(1900,01,01), QDate(2100,01,01));
 
     // did call contain any filters?
-    QStringList filelist;
-    bool filt=false;
+    QStringList filters;
     PROTECT(filter=Rf_coerceVector(filter, STRSXP));
     for(int i=0; i<Rf_length(filter); i++) {
-
-        // if not empty write a filter
         QString f(CHAR(STRING_ELT(filter,i)));
-        if (f != "") {
+        if (f != "") filters << f;
+    }
+    UNPROTECT(1);
+
+    // apply perspective filter if trends view and filtered
+    bool trends = rtool->perspective && rtool->perspective->type() == VIEW_TRENDS && rtool->perspective->isFiltered();
+    Specification specification;
+    if (trends) specification.setFilterSet(FilterSet(true, rtool->perspective->filterlist(DateRange(range))));
+
+    // the aggregated cache is kept until rides change
+    QString key = columns->key(rtool->context, specification, false, range, filters) + "|meanmax";
+    RideFileCache *cache = columns->meanmax(key);
+    if (cache == NULL) {
+
+        QStringList filelist;
+        bool filt=false;
+        foreach(QString f, filters) {
 
             DataFilter dataFilter(rtool->canvas, rtool->context);
             QStringList files;
@@ -2565,19 +2595,17 @@ RTool::dfForDateRangeMeanmax(bool all, DateRange range, SEXP filter)
             filelist << files;
             filt=true;
         }
-    }
-    UNPROTECT(1);
+        if (trends) {
+            filt = true;
+            filelist << rtool->perspective->filterlist(DateRange(range));
+        }
 
-    // apply perspective filter if trends view and filtered
-    if (rtool->perspective && rtool->perspective->type() == VIEW_TRENDS && rtool->perspective->isFiltered()) {
-        filt = true;
-        filelist << rtool->perspective->filterlist(DateRange(range));
+        // RideFileCache for a date range with our filters (if any)
+        cache = new RideFileCache(rtool->context, range.from, range.to, filt, filelist, true, NULL);
+        columns->setMeanmax(key, cache);
     }
 
-    // RideFileCache for a date range with our filters (if any)
-    RideFileCache cache(rtool->context, range.from, range.to, filt, filelist, true, NULL);
-
-    return dfForRideFileCache(&cache);
+    return dfForRideFileCache(cache);
 
     // nothing to return
     return Rf_allocVector(INTSXP, 0);
@@ -2869,34 +2897,10 @@ RTool::dfForDateRangePeaks(bool all, DateRange range, SEXP filter, QList<RideFil
     fs.addFilter(rtool->perspective->isFiltered(), rtool->perspective->filterlist(range));
     specification.setFilterSet(fs);
 
-    // did call contain any filters?
-    PROTECT(filter=Rf_coerceVector(filter, STRSXP));
-    for(int i=0; i<Rf_length(filter); i++) {
-
-        // if not empty write a filter
-        QString f(CHAR(STRING_ELT(filter,i)));
-        if (f != "") {
-
-            DataFilter dataFilter(rtool->canvas, rtool->context);
-            QStringList files;
-            dataFilter.parseFilter(rtool->context, f, &files);
-            fs.addFilter(true, files);
-        }
-    }
-    specification.setFilterSet(fs);
-    UNPROTECT(1);
-
     // how many pass?
-    int size=0;
-    foreach(RideItem *item, rtool->context->athlete->rideCache->rides()) {
-
-        // apply filters
-        if (!specification.pass(item)) continue;
-
-        // do we want this one ?
-        if (all || range.pass(item->dateTime.date()))  size++;
-    }
-
+    QString key;
+    QVector<RideItem*> selected = dfSelection(all, range, filter, specification, fs, key);
+    int size=selected.count();
 
     // dates first
     SEXP dates;
@@ -2904,14 +2908,8 @@ RTool::dfForDateRangePeaks(bool all, DateRange range, SEXP filter, QList<RideFil
 
     // fill with values for date and class
     int i=0;
-    foreach(RideItem *item, rtool->context->athlete->rideCache->rides()) {
-        // apply filters
-        if (!specification.pass(item)) continue;
-
-        if (all || range.pass(item->dateTime.date())) {
-            REAL(dates)[i++] = item->dateTime.toUTC().toSecsSinceEpoch();
-        }
-    }
+    foreach(RideItem *item, selected)
+        REAL(dates)[i++] = item->dateTime.toUTC().toSecsSinceEpoch();
 
     // POSIXct class
     SEXP clas;
@@ -2937,20 +2935,19 @@ RTool::dfForDateRangePeaks(bool all, DateRange range, SEXP filter, QList<RideFil
 
             // fill with values
             // get the value for the series and duration requested, although this is called
-            int index=0;
-            foreach(RideItem *item, rtool->context->athlete->rideCache->rides()) {
-
-                // apply filters
-                if (!specification.pass(item)) continue;
-
-                // do we want this one ?
-                if (all || range.pass(item->dateTime.date())) {
+            QVector<double> values;
+            if (!rtool->columns->column(key, name, values)) {
+                values.resize(size);
+                for(int index=0; index<size; index++) {
 
                     // for each series/duration independently its pretty quick since it lseeks to
                     // the actual value, so /should't/ be too expensive.........
-                    REAL(vector)[index++] = RideFileCache::best(item->context, item->fileName, pseries, pduration);
+                    RideItem *item = selected.at(index);
+                    values[index] = RideFileCache::best(item->context, item->fileName, pseries, pduration);
                 }
+                rtool->columns->setColumn(key, name, values);
             }
+            if (size) memcpy(REAL(vector), values.constData(), size * sizeof(double));
 
             // add named vector to the list
             SET_VECTOR_ELT(df, dfindex++, vector);
@@ -3875,7 +3872,7 @@ RTool::dfForActivityXData(RideFile*f, QString name)
     int seriescount = xds->valuename.count();
 
     // how many data points?
-    int points = xds->datapoints.count();
+    int points = xds->count();
 
     // if we have any series we will continue and add 'time' and 'distance' series
     if (seriescount) seriescount += 2;
@@ -3898,7 +3895,7 @@ RTool::dfForActivityXData(RideFile*f, QString name)
     pcount++;
 
     // fill with values for date and class
-    for(int k=0; k<points; k++) REAL(time)[k] = f->startTime().addSecs(xds->datapoints[k]->secs).toUTC().toSecsSinceEpoch();
+    for(int k=0; k<points; k++) REAL(time)[k] = f->startTime().addSecs(xds->secs(k)).toUTC().toSecsSinceEpoch();
 
     // POSIXct class
     SEXP clas = PROTECT(Rf_allocVector(STRSXP, 2));
@@ -3921,7 +3918,7 @@ RTool::dfForActivityXData(RideFile*f, QString name)
     pcount++;
 
     // fill with values
-    for(int k=0; k<points; k++) REAL(distance)[k] = xds->datapoints[k]->km;
+    for(int k=0; k<points; k++) REAL(distance)[k] = xds->km(k);
 
     // add to the data.frame and give it a name
     SET_VECTOR_ELT(ans, next, distance);
@@ -3935,10 +3932,10 @@ RTool::dfForActivityXData(RideFile*f, QString name)
         SEXP vector = PROTECT(Rf_allocVector(REALSXP, points));
         pcount++;
 
-        int idx = 0;
-        foreach(XDataPoint* p, xds->datapoints) {
-            double val = p->number[valueIdx];
-            REAL(vector)[idx++] = (val == RideFile::NA) ? NA_REAL : val;
+        const QVector<double> values = xds->column(valueIdx);
+        for(int k=0; k<points; k++) {
+            double val = values[k];
+            REAL(vector)[k] = (val == RideFile::NA) ? NA_REAL : val;
         }
 
         // add to the list
@@ -18,6 +18,7 @@
 
 #include "RChart.h"
 #include "Context.h"
+#include "RColumnCache.h"
 
 #ifndef _GC_RTool_h
 
@@ -30,6 +31,7 @@ class RTool {
 
     public:
         RTool();
+        ~RTool();
         void  configChanged();
 
         REmbed *R;
@@ -44,6 +46,9 @@ class RTool {
         Context *context;
         QString version;
 
+        // season columns shared by all charts
+        RColumnCache *columns;
+
         // layout and page size
         static SEXP windowSize();
         static SEXP pageSize(SEXP width, SEXP height);
@@ -117,6 +122,7 @@ class RTool {
         SEXP dfForActivityXData(RideFile *f, QString name); // returns XData series by name for an activity
         SEXP dfForActivityMeanmax(const RideItem *i);   // returns mean maximals for an activity
         SEXP dfForRideItem(const RideItem *i);          // returns metrics and meradata for an activity
+        QVector<RideItem*> dfSelection(bool all, DateRange range, SEXP filter, Specification &spec, FilterSet &fs, QString &key);
         SEXP dfForDateRange(bool all, DateRange range, SEXP filter); // returns metrics and metadata for a season
         SEXP dfForDateRangeIntervals(DateRange range, QStringList types); // returns metrics and metadata for a season
         SEXP dfForDateRangeMeanmax(bool all, DateRange range, SEXP filter); // returns the meanmax for a season
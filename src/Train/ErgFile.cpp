@@ -27,6 +27,7 @@
 
 #include <stdint.h>
 #include <cmath>
+#include <algorithm>
 #include "Units.h"
 #include "Utils.h"
 
@@ -2053,6 +2054,39 @@ ErgFile::calculateMetrics()
 }
 
 
+void
+ErgFileQueryAdapter::updateIndex() const
+{
+    if (qi.ergFile == ergFile && qi.points == Points().count() && qi.laps == Laps().count()
+        && (qi.points == 0 || qi.last == Points().last().x)) return;
+
+    qi.ergFile = ergFile;
+    qi.points = Points().count();
+    qi.laps = Laps().count();
+    qi.last = qi.points ? Points().last().x : 0;
+    qi.lap = 0;
+
+    // points, and the slope of each segment for interpolation
+    qi.x.resize(qi.points);
+    qi.valSlope.fill(0, qi.points);
+    qi.ySlope.fill(0, qi.points);
+    for (int i = 0; i < qi.points; i++) {
+        const ErgFilePoint &p = Points().at(i);
+        qi.x[i] = p.x;
+        if (i > 0 && p.x != qi.x[i-1]) {
+            const ErgFilePoint &prev = Points().at(i-1);
+            qi.valSlope[i-1] = (p.val - prev.val) / (p.x - prev.x);
+            qi.ySlope[i-1] = (p.y - prev.y) / (p.x - prev.x);
+        }
+    }
+
+    // laps are kept sorted by the ergfile
+    qi.lapX.resize(qi.laps);
+    for (int i = 0; i < qi.laps; i++) qi.lapX[i] = Laps().at(i).x;
+
+    qs.Reset();
+}
+
 // Update query state to bracket query location.
 // Returns false if bracket cannot be established, otherwise true.
 bool
@@ -2063,32 +2097,64 @@ ErgFileQueryAdapter::updateQueryStateFromDistance(double x, int& lapnum) const
     // is it in bounds?
     if (x < 0 || x > Duration()) return false;
 
-    // do we need to return the Lap marker?
-    if (Laps().count() > 0) {
-        int lap = 0;
-        for (int i = 0; i < Laps().count(); i++) {
-            if (x >= Laps().at(i).x) lap += 1;
-        }
-        lapnum = lap;
+    updateIndex();
+    if (qi.points < 2) return false;
 
-    }
-    else lapnum = 0;
+    // how many laps have started, usually the same as last time
+    int lap = qi.lap;
+    if ((lap > 0 && x < qi.lapX.at(lap-1)) || (lap < qi.laps && x >= qi.lapX.at(lap)))
+        lap = std::upper_bound(qi.lapX.constBegin(), qi.lapX.constEnd(), x) - qi.lapX.constBegin();
+    lapnum = qi.lap = lap;
 
-    // find right section of the file
-    while (x < Points().at(qs.leftPoint).x || x > Points().at(qs.rightPoint).x) {
-        if (x < Points().at(qs.leftPoint).x) {
-            qs.leftPoint--;
-            qs.rightPoint--;
-        }
-        else if (x > Points().at(qs.rightPoint).x) {
-            qs.leftPoint++;
-            qs.rightPoint++;
+    // find right section of the file, usually the one we're
+    // in or the next one, otherwise go look for it
+    if (x < qi.x.at(qs.leftPoint) || x > qi.x.at(qs.rightPoint)) {
+
+        int right = qs.rightPoint + 1;
+        if (right >= qi.points || x < qi.x.at(right - 1) || x > qi.x.at(right)) {
+            right = std::lower_bound(qi.x.constBegin(), qi.x.constEnd(), x) - qi.x.constBegin();
+            right = qBound(1, right, qi.points - 1);
         }
+        qs.leftPoint = right - 1;
+        qs.rightPoint = right;
     }
 
     return true;
 }
 
+double
+ErgFileQueryAdapter::nextLap(double x) const
+{
+    if (!ergFile || !ergFile->isValid()) return -1;
+    updateIndex();
+
+    // first lap starting after x
+    int i = std::upper_bound(qi.lapX.constBegin(), qi.lapX.constEnd(), x) - qi.lapX.constBegin();
+    return i < qi.laps ? qi.lapX.at(i) : -1;
+}
+
+double
+ErgFileQueryAdapter::prevLap(double x) const
+{
+    if (!ergFile || !ergFile->isValid()) return -1;
+    updateIndex();
+
+    // last lap starting before x
+    int i = std::lower_bound(qi.lapX.constBegin(), qi.lapX.constEnd(), x) - qi.lapX.constBegin();
+    return i > 0 ? qi.lapX.at(i-1) : -1;
+}
+
+double
+ErgFileQueryAdapter::currentLap(double x) const
+{
+    if (!ergFile || !ergFile->isValid()) return -1;
+    updateIndex();
+
+    // last lap starting at or before x, so long as there's one after it
+    int i = std::upper_bound(qi.lapX.constBegin(), qi.lapX.constEnd(), x) - qi.lapX.constBegin();
+    return (i > 0 && i < qi.laps) ? qi.lapX.at(i-1) : -1;
+}
+
 double
 ErgFileQueryAdapter::wattsAt(double x, int& lapnum) const
 {
@@ -2116,14 +2182,9 @@ ErgFileQueryAdapter::wattsAt(double x, int& lapnum) const
 
     // so this point in time between two points and
     // we are ramping from one point and another
-    // the steps in the calculation have been explicitly
-    // listed for code clarity
-    double deltaW = Points().at(qs.rightPoint).val - Points().at(qs.leftPoint).val;
-    double deltaT = Points().at(qs.rightPoint).x - Points().at(qs.leftPoint).x;
+    // using the slope we worked out when indexing
     double offT = x - Points().at(qs.leftPoint).x;
-    double factor = offT / deltaT;
-
-    double nowW = Points().at(qs.leftPoint).val + (deltaW * factor);
+    double nowW = Points().at(qs.leftPoint).val + (qi.valSlope.at(qs.leftPoint) * offT);
 
     return nowW;
 }
@@ -2159,10 +2220,8 @@ ErgFileQueryAdapter::altitudeAt(double x, int& lapnum) const
         return -1000;
     }
 
-    ErgFilePoint p1 = Points().at(qs.leftPoint);
-    ErgFilePoint p2 = Points().at(qs.rightPoint);
-    double altitude = p1.y;
-    if(p1.x != p2.x) altitude += (p2.y - p1.y) * (x - p1.x) / (p2.x - p1.x);
+    const ErgFilePoint &p1 = Points().at(qs.leftPoint);
+    double altitude = p1.y + qi.ySlope.at(qs.leftPoint) * (x - p1.x);
 
     return altitude;
 }
@@ -202,6 +202,24 @@ class ErgFileQueryAdapter {
         }
     } qs;
 
+    // Index over the points and laps so queries are a binary search at
+    // worst, and a check of the current bracket when riding along. Rebuilt
+    // when the ergfile is replaced, reloaded or gains laps.
+    mutable struct ErgFileQueryIndex
+    {
+        const ErgFile *ergFile;         // what we indexed
+        int points, laps;               // counts when we indexed it
+        double last;                    // and where it ended
+
+        QVector<double> x;              // point x, never decreases
+        QVector<double> valSlope;       // d(val)/dx for each segment
+        QVector<double> ySlope;         // d(y)/dx for each segment
+        QVector<double> lapX;           // lap starts in order
+        int lap;                        // laps started at the last query
+
+        ErgFileQueryIndex() : ergFile(NULL), points(0), laps(0), last(0), lap(0) {}
+    } qi;
+
     const ErgFile* ergFile;
 
 public:
@@ -210,7 +228,7 @@ public:
 
     const ErgFile* getErgFile() const     { return ergFile; }
     void     setErgFile(const ErgFile* p) { ergFile = p; }
-    void     resetQueryState()            { qs.Reset(); }
+    void     resetQueryState()            { qs.Reset(); qi.ergFile = NULL; }
     int      addNewLap(double loc) const;
 
 private:
@@ -222,15 +240,18 @@ private:
     // Common helper to setup query state for query. Returns false if bracket cannot be established.
     bool   updateQueryStateFromDistance(double x, int& lapnum) const;
 
+    // (re)build the index if the ergfile changed
+    void   updateIndex() const;
+
 public:
     // Const getters
     bool   hasGradient() const { return ergFile && ergFile->hasGradient(); }
     bool   hasWatts()    const { return ergFile && ergFile->hasWatts();    }
     bool   hasGPS()      const { return ergFile && ergFile->hasGPS();      }
 
-    double nextLap   (double x) const { return !ergFile ? -1 : ergFile->nextLap(x);    }
-    double prevLap   (double x) const { return !ergFile ? -1 : ergFile->prevLap(x);    }
-    double currentLap(double x) const { return !ergFile ? -1 : ergFile->currentLap(x); }
+    double nextLap   (double x) const;
+    double prevLap   (double x) const;
+    double currentLap(double x) const;
 
     bool   textsInRange(double searchStart, double searchRange, int& rangeStart, int& rangeEnd) const {
         return !ergFile ? false : ergFile->textsInRange(searchStart, searchRange, rangeStart, rangeEnd);
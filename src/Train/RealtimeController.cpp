@@ -34,7 +34,7 @@ void VirtualPowerTrainer::to_string(std::string& s) const {
 // Abstract base class for Realtime device controllers
 
 RealtimeController::RealtimeController(TrainSidebar *parent, DeviceConfiguration *dc) :
-    parent(parent), dc(dc), polyFit(NULL), fUseWheelRpm(false), 
+    parent(parent), telemetryBus(NULL), telemetryChannel(-1), dc(dc), polyFit(NULL), fUseWheelRpm(false), 
     inertialMomentKGM2(0.), fAdvancedSpeedPowerMapping(true),
     prevTime(), prevRpm(0.), prevWatts(0.)
 {
@@ -174,6 +174,24 @@ void RealtimeController::processRealtimeData(RealtimeData &rtData)
     }
 }
 
+void RealtimeController::publishRealtimeData(RealtimeData &rtData)
+{
+    if (telemetryBus == NULL) return;
+
+    processRealtimeData(rtData);
+    telemetryBus->publish(telemetryChannel, rtData);
+}
+
+bool RealtimeController::latestRealtimeData(RealtimeData &rtData) const
+{
+    TelemetryRing *ring = telemetryBus ? telemetryBus->channel(telemetryChannel) : NULL;
+    TelemetrySample sample;
+    if (ring == NULL || !ring->latest(sample)) return false;
+
+    rtData = sample.data;
+    return true;
+}
+
 // Wrap static array in function to ensure it is init on use, which is after PolyFitGenerator
 // who is static init at load time.
 const VirtualPowerTrainer * PredefinedVirtualPowerTrainerArray(size_t &size) {
@@ -23,6 +23,7 @@
 #include "RealtimeData.h"
 #include "CalibrationData.h"
 #include "TrainSidebar.h"
+#include "TelemetryBus.h"
 #include "PolynomialRegression.h"
 
 #include "GoldenCheetah.h"
@@ -100,6 +101,16 @@ public:
     virtual void getRealtimeData(RealtimeData &rtData); // update realtime data with current values
     virtual void pushRealtimeData(RealtimeData &rtData); // update realtime data with current values
 
+    // this device publishes its telemetry on the bus from its own thread
+    virtual bool doesPublish() { return false; }
+    void setTelemetry(TelemetryBus *bus, int channel) { telemetryBus = bus; telemetryChannel = channel; }
+
+    // called from the device thread, post processes then publishes
+    void publishRealtimeData(RealtimeData &rtData);
+
+    // latest sample published, false if there isn't one (e.g. not on a bus)
+    bool latestRealtimeData(RealtimeData &rtData) const;
+
     // only relevant for Computrainer like devices
     virtual void setLoad(double) { return; }
     virtual void setGradient(double) { return; }
@@ -134,6 +145,9 @@ signals:
     void setNotification(QString text, int timeout);
 
 private:
+    TelemetryBus *telemetryBus;
+    int telemetryChannel;
+
     DeviceConfiguration *dc;
     DeviceConfiguration devConf;
     QTime lastCalTimestamp;
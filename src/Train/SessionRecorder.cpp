@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "SessionRecorder.h"
+
+#include <QtEndian>
+
+#ifdef WIN32
+#include <io.h>         // for _commit
+#else
+#include <unistd.h>     // for fsync
+#endif
+
+SessionRecorder::SessionRecorder() : samples(0)
+{
+}
+
+SessionRecorder::~SessionRecorder()
+{
+    close();
+}
+
+bool
+SessionRecorder::open(QString filename, QDateTime start, int interval, QString workout)
+{
+    close();
+
+    file.setFileName(filename);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate)) return false;
+
+    samples = 0;
+    buffer = SessionLog::header(start, interval);
+    if (!workout.isEmpty()) SessionLog::appendRecord(buffer, SessionLog::Name, workout.toUtf8());
+
+    // the header is synced straight away so the log is always importable
+    sync();
+    return true;
+}
+
+void
+SessionRecorder::close()
+{
+    if (!file.isOpen()) return;
+
+    SessionLog::appendRecord(buffer, SessionLog::End, QByteArray());
+    sync();
+    file.close();
+}
+
+void
+SessionRecorder::remove()
+{
+    close();
+    file.remove();
+}
+
+void
+SessionRecorder::record(const RealtimeData &data)
+{
+    if (!file.isOpen()) return;
+
+    SessionLogSample s;
+    s.msecs = data.getMsecs();
+    s.lap = data.getLap();
+    s.cad = data.getCadence();
+    s.hr = data.getHr();
+    s.kph = data.getSpeed();
+    s.watts = data.getWatts();
+    s.load = data.getLoad();
+    s.lrbalance = data.getLRBalance();
+    s.lte = data.getLTE();
+    s.rte = data.getRTE();
+    s.lps = data.getLPS();
+    s.rps = data.getRPS();
+    s.smo2 = data.getSmO2();
+    s.thb = data.gettHb();
+    s.o2hb = data.getO2Hb();
+    s.hhb = data.getHHb();
+    s.km = data.getDistance();
+    s.alt = data.getAltitude();
+    s.lon = data.getLongitude();
+    s.lat = data.getLatitude();
+
+    SessionLog::appendRecord(buffer, SessionLog::Sample, SessionLog::encode(s));
+    samples++;
+}
+
+void
+SessionRecorder::flush()
+{
+    if (!file.isOpen()) return;
+
+    if (lastsync.elapsed() >= SESSIONLOG_SYNCRATE) {
+
+        // checkpoint is the number of samples so far
+        QByteArray checkpoint(4, 0);
+        qToLittleEndian<quint32>(samples, checkpoint.data());
+        SessionLog::appendRecord(buffer, SessionLog::Checkpoint, checkpoint);
+
+        sync();
+
+    } else if (buffer.size()) {
+
+        // just hand it to the os
+        file.write(buffer);
+        file.flush();
+        buffer.clear();
+    }
+}
+
+void
+SessionRecorder::sync()
+{
+    file.write(buffer);
+    file.flush();
+    buffer.clear();
+
+    // and make sure it actually hits the disk
+#ifdef WIN32
+    _commit(file.handle());
+#else
+    fsync(file.handle());
+#endif
+
+    lastsync.start();
+}
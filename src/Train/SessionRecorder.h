@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef _GC_SessionRecorder_h
+#define _GC_SessionRecorder_h 1
+
+#include "SessionLogFile.h"
+#include "RealtimeData.h"
+
+#include <QFile>
+#include <QString>
+#include <QDateTime>
+#include <QElapsedTimer>
+
+//
+// Records a train session to a session log (see SessionLogFile.h)
+//
+// Samples are buffered in memory and written out by flush(), which
+// the sidebar calls once a second. Every SESSIONLOG_SYNCRATE ms a
+// checkpoint is appended and the file is synced to disk, so a crash
+// loses at most that much of the session.
+//
+#define SESSIONLOG_SYNCRATE 10000
+
+class SessionRecorder
+{
+    public:
+        SessionRecorder();
+        ~SessionRecorder();
+
+        // interval is the nominal sample interval in ms
+        bool open(QString filename, QDateTime start, int interval, QString workout);
+
+        // append the end marker and sync, remove deletes the log too
+        void close();
+        void remove();
+
+        bool isOpen() const { return file.isOpen(); }
+        QString fileName() const { return file.fileName(); }
+
+        // buffer a sample, msecs is session time
+        void record(const RealtimeData &data);
+
+        // write whatever is buffered, syncing if it's time
+        void flush();
+
+    private:
+        void sync();
+
+        QFile file;
+        QByteArray buffer;
+        QElapsedTimer lastsync;
+        quint32 samples;
+};
+
+#endif // _GC_SessionRecorder_h
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "TelemetryBus.h"
+
+//
+// TelemetryRing
+//
+TelemetryRing::TelemetryRing() : head(0)
+{
+}
+
+void
+TelemetryRing::publish(qint64 msecs, const RealtimeData &data)
+{
+    quint32 n = head.load(std::memory_order_relaxed);
+    Slot &slot = ring[n & (TELEMETRY_RING_SIZE-1)];
+
+    // mark the slot as being written before we touch it
+    slot.seq.store(2*n + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.sample.msecs = msecs;
+    slot.sample.data = data;
+
+    // and as holding sample n once we're done
+    slot.seq.store(2*n + 2, std::memory_order_release);
+    head.store(n + 1, std::memory_order_release);
+}
+
+bool
+TelemetryRing::readSlot(quint32 n, TelemetrySample &sample) const
+{
+    const Slot &slot = ring[n & (TELEMETRY_RING_SIZE-1)];
+
+    // not sample n, either it's being written or was overwritten
+    quint32 before = slot.seq.load(std::memory_order_acquire);
+    if (before != 2*n + 2) return false;
+
+    sample = slot.sample;
+
+    // if the producer got in whilst we were copying it's torn
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.seq.load(std::memory_order_relaxed) == before;
+}
+
+bool
+TelemetryRing::latest(TelemetrySample &sample) const
+{
+    // the producer may lap us whilst we copy, so try again
+    for (int tries=0; tries<3; tries++) {
+        quint32 n = head.load(std::memory_order_acquire);
+        if (n == 0) return false;
+        if (readSlot(n-1, sample)) return true;
+    }
+    return false;
+}
+
+int
+TelemetryRing::read(quint32 &cursor, QVector<TelemetrySample> &samples) const
+{
+    quint32 n = head.load(std::memory_order_acquire);
+
+    // fallen more than a ring behind, skip to what is still there
+    if (n - cursor > TELEMETRY_RING_SIZE) cursor = n - TELEMETRY_RING_SIZE;
+
+    int count = 0;
+    TelemetrySample sample;
+    for (; cursor != n; cursor++) {
+        if (readSlot(cursor, sample)) {
+            samples << sample;
+            count++;
+        }
+    }
+    return count;
+}
+
+//
+// TelemetryBus
+//
+TelemetryBus::TelemetryBus() : session(new TelemetryRing)
+{
+    clock.start();
+}
+
+TelemetryBus::~TelemetryBus()
+{
+    delete session;
+    qDeleteAll(devices);
+}
+
+void
+TelemetryBus::reset(int count)
+{
+    delete session;
+    qDeleteAll(devices);
+    devices.clear();
+
+    session = new TelemetryRing;
+    for (int i=0; i<count; i++) devices << new TelemetryRing;
+
+    clock.restart();
+}
+
+qint64
+TelemetryBus::publish(int device, const RealtimeData &data)
+{
+    qint64 msecs = clock.elapsed();
+    TelemetryRing *ring = channel(device);
+    if (ring) ring->publish(msecs, data);
+    return msecs;
+}
+
+TelemetryRing *
+TelemetryBus::channel(int device) const
+{
+    if (device == Session) return session;
+    if (device >= 0 && device < devices.count()) return devices.at(device);
+    return NULL;
+}
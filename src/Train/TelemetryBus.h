@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef _GC_TelemetryBus_h
+#define _GC_TelemetryBus_h 1
+
+#include "RealtimeData.h"
+
+#include <QVector>
+#include <QElapsedTimer>
+
+#include <atomic>
+
+//
+// The telemetry bus carries timestamped RealtimeData samples from
+// whoever produces them (a device, or the sidebar once it has merged
+// all the devices) to whoever wants them (recording, W'bal, the dials).
+//
+// Devices with their own thread (see RealtimeController::doesPublish)
+// publish from that thread, the sidebar publishes for the rest when it
+// polls them.
+//
+// Each channel is a fixed size ring with a single producer and any
+// number of consumers. Neither side ever takes a lock; a consumer
+// copies a slot and then checks the slot sequence number to see if
+// the producer overwrote it whilst it was copying (a seqlock).
+//
+// Consumers keep their own cursor so they can run at their own rate,
+// a consumer that falls more than a ring behind just loses the oldest
+// samples, it never holds up the producer.
+//
+
+// must be a power of two, at 10Hz this is over 6 seconds of history
+#define TELEMETRY_RING_SIZE 64
+
+// devices that publish from their own thread do so at most this often (ms)
+#define TELEMETRY_PERIOD 100
+
+class TelemetrySample
+{
+    public:
+        TelemetrySample() : msecs(0) {}
+
+        qint64 msecs;           // when published, ms since the bus was reset
+        RealtimeData data;
+};
+
+class TelemetryRing
+{
+    public:
+        TelemetryRing();
+
+        // producer, only one thread may publish to a ring
+        void publish(qint64 msecs, const RealtimeData &data);
+
+        // consumers, these never block the producer
+        // latest returns false if nothing has been published yet
+        bool latest(TelemetrySample &sample) const;
+
+        // samples published since cursor, which is then moved on
+        // start with a cursor of 0 or the value of published()
+        int read(quint32 &cursor, QVector<TelemetrySample> &samples) const;
+
+        // how many samples have been published, wraps
+        quint32 published() const { return head.load(std::memory_order_acquire); }
+
+    private:
+        bool readSlot(quint32 n, TelemetrySample &sample) const;
+
+        struct Slot {
+            Slot() : seq(0) {}
+            std::atomic<quint32> seq;   // odd whilst being written
+            TelemetrySample sample;
+        };
+        Slot ring[TELEMETRY_RING_SIZE];
+        std::atomic<quint32> head;      // next sample number
+};
+
+class TelemetryBus
+{
+    public:
+
+        // the merged telemetry from all devices
+        enum { Session = -1 };
+
+        TelemetryBus();
+        ~TelemetryBus();
+
+        // drop all channels and start the clock again, only call
+        // this when nothing is publishing (e.g. when devices change)
+        void reset(int devices);
+
+        // publish on a channel, device number or Session
+        // returns the timestamp given to the sample
+        qint64 publish(int device, const RealtimeData &data);
+
+        // channel for a device or Session, NULL if out of range
+        TelemetryRing *channel(int device) const;
+
+        // ms since reset, the timebase for samples
+        qint64 elapsed() const { return clock.elapsed(); }
+
+    private:
+        TelemetryRing *session;
+        QVector<TelemetryRing*> devices;
+        QElapsedTimer clock;
+};
+
+#endif // _GC_TelemetryBus_h
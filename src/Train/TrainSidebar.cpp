@@ -385,8 +385,9 @@ TrainSidebar::TrainSidebar(Context *context) : GcWindow(context), context(contex
     lap_elapsed_msec = 0;
     secs_to_start = 0;
 
-    rrFile = recordFile = vo2File = NULL;
-    lastRecordSecs = 0;
+    rrFile = vo2File = NULL;
+    recordCursor = 0;
+    lastRecordMsecs = -1;
     status = 0;
     setStatusFlags(RT_MODE_ERGO);         // ergo mode by default
     mode = ErgFileFormat::erg;
@@ -399,6 +400,9 @@ TrainSidebar::TrainSidebar(Context *context) : GcWindow(context), context(contex
     spdcount = 0;
     lodcount = 0;
     wbalr = wbal = 0;
+    wbalDevice = -1;
+    wbalCursor = 0;
+    wbalMsecs = 0;
     load_msecs = total_msecs = lap_msecs = 0;
     displayWorkoutDistance = displayDistance = displayPower = displayHeartRate =
     displaySpeed = displayCadence = slope = load = 0;
@@ -423,6 +427,51 @@ TrainSidebar::TrainSidebar(Context *context) : GcWindow(context), context(contex
     //toolbarButtons->hide();
 #endif
 
+    // once we're up, look for sessions that were never stopped
+    QTimer::singleShot(0, this, SLOT(recoverSessions()));
+}
+
+void
+TrainSidebar::recoverSessions()
+{
+    QDir records = context->athlete->home->records();
+    if (!records.exists()) return;
+
+    QList<QString> recover;
+    foreach (QString name, records.entryList(QStringList() << "*.gcsl", QDir::Files, QDir::Name)) {
+
+        QString filename = records.canonicalPath() + "/" + name;
+        if (recorder.isOpen() && recorder.fileName() == filename) continue;
+        if (SessionLog::isComplete(filename)) continue;
+
+        QMessageBox msgBox;
+        msgBox.setText(tr("A train session was not stopped cleanly, do you want to recover it?"));
+        msgBox.setInformativeText(name);
+        QPushButton *recoverButton = msgBox.addButton(tr("Recover"), QMessageBox::YesRole);
+        QPushButton *discardButton = msgBox.addButton(tr("Discard"), QMessageBox::DestructiveRole);
+        msgBox.addButton(tr("Later"), QMessageBox::RejectRole);
+        msgBox.setDefaultButton(recoverButton);
+        msgBox.setIcon(QMessageBox::Question);
+        msgBox.exec();
+
+        if (msgBox.clickedButton() == recoverButton) {
+
+            // close it off so it isn't offered again
+            if (SessionLog::finish(filename)) recover.append(filename);
+
+        } else if (msgBox.clickedButton() == discardButton) {
+
+            QString base = filename.left(filename.length() - 5);
+            QFile::remove(filename);
+            QFile::remove(base + ".rr");
+            QFile::remove(base + ".vo2");
+        }
+    }
+
+    if (recover.count()) {
+        RideImportWizard *dialog = new RideImportWizard(recover, context);
+        dialog->process(); // do it!
+    }
 }
 
 
@@ -1457,25 +1506,20 @@ void TrainSidebar::Start()       // when start button is pressed
             QDateTime now = QDateTime::currentDateTime();
 
             // setup file
-            QString filename = now.toString(QString("yyyy_MM_dd_hh_mm_ss")) + "_" + workoutName + QString(".csv");
+            QString filename = now.toString(QString("yyyy_MM_dd_hh_mm_ss")) + "_" + workoutName + QString(".gcsl");
 
             if (!context->athlete->home->records().exists())
                 context->athlete->home->createAllSubdirs();
 
             QString fulltarget = context->athlete->home->records().canonicalPath() + "/" + filename;
 
-            if (recordFile) delete recordFile;
-            recordFile = new QFile(fulltarget);
-            lastRecordSecs = 0;
-            if (!recordFile->open(QFile::WriteOnly | QFile::Truncate)) {
+            // we record every merged sample from here on
+            recordCursor = telemetry.channel(TelemetryBus::Session)->published();
+            lastRecordMsecs = -1;
+            if (!recorder.open(fulltarget, now, REFRESHRATE, workoutName)) {
                 clearStatusFlags(RT_RECORDING);
             } else {
 
-                // CSV File header
-
-                QTextStream recordFileStream(recordFile);
-                recordFileStream << "secs, cad, hr, km, kph, nm, watts, alt, lon, lat, headwind, slope, temp, interval, lrbalance, lte, rte, lps, rps, smo2, thb, o2hb, hhb, target\n";
-
                 disk_timer->start(SAMPLERATE);  // start screen
             }
         }
@@ -1579,8 +1623,9 @@ void TrainSidebar::Stop(int deviceStatus)        // when stop button is pressed
     if (status & RT_RECORDING) {
         disk_timer->stop();
 
-        // close and reset File
-        recordFile->close();
+        // record whatever is left on the bus and close
+        diskUpdate();
+        recorder.close();
 
         // Request mutual exclusion with ANT+/BTLE threads to change status and close rr/vo2 files
         rrMutex.lock();
@@ -1611,12 +1656,12 @@ void TrainSidebar::Stop(int deviceStatus)        // when stop button is pressed
 
         if(deviceStatus == DEVICE_ERROR)
         {
-            recordFile->remove();
+            recorder.remove();
         }
         else {
             // add to the view - using basename ONLY
             QString name;
-            name = recordFile->fileName();
+            name = recorder.fileName();
 
             QList<QString> list;
             list.append(name);
@@ -1738,7 +1783,12 @@ void TrainSidebar::Connect()
 
     activeDevices = devices();
 
+    // one channel per device, nothing is publishing yet
+    telemetry.reset(Devices.count());
+    wbalDevice = -1;
+
     foreach(int dev, activeDevices) {
+        Devices[dev].controller->setTelemetry(&telemetry, dev);
         Devices[dev].controller->setWheelCircumference(Devices[dev].wheelSize);
         Devices[dev].controller->setRollingResistance(bicycle.RollingResistance());
         Devices[dev].controller->setWeight(bicycle.MassKG());
@@ -1863,13 +1913,21 @@ void TrainSidebar::guiUpdate()           // refreshes the telemetry
             rtData.setSlope(slope); // always set load..
             rtData.setAltitude(displayAltitude); // always set display altitude
 
+            // the timer is not exact, so time since the last merged sample
+            double period = REFRESHRATE / 1000.00f;
+            TelemetrySample last;
+            if (telemetry.channel(TelemetryBus::Session)->latest(last))
+                period = qBound(0.0, (telemetry.elapsed() - last.msecs) / 1000.00f, 1.0);
+
             double distanceTick = 0;
 
             // fetch the right data from each device...
             foreach(int dev, activeDevices) {
 
+                // devices with their own thread have already published
                 RealtimeData local = rtData;
                 Devices[dev].controller->getRealtimeData(local);
+                if (!Devices[dev].controller->doesPublish()) telemetry.publish(dev, local);
 
                 // get spinscan data from a computrainer?
                 if (Devices[dev].type == DEV_CT) {
@@ -1941,7 +1999,7 @@ void TrainSidebar::guiUpdate()           // refreshes the telemetry
                 displaySpeed = ret.v;
                 distanceTick = ret.d;
             } else {
-                distanceTick = displaySpeed / (5 * 3600); // assumes 200ms refreshrate
+                distanceTick = displaySpeed * period / 3600;
             }
 
             // only update time & distance if actively running (not just connected, and not running but paused)
@@ -2032,7 +2090,7 @@ void TrainSidebar::guiUpdate()           // refreshes the telemetry
                 rtData.setLapMsecs(lap_msecs);
 
                 long lapTimeRemaining;
-                if (ergFile) lapTimeRemaining = ergFile->nextLap(load_msecs) - load_msecs;
+                if (ergFile) lapTimeRemaining = ergFileQueryAdapter.nextLap(load_msecs) - load_msecs;
                 else lapTimeRemaining = 0;
 
                 long ergTimeRemaining;
@@ -2130,16 +2188,37 @@ void TrainSidebar::guiUpdate()           // refreshes the telemetry
             // using Dave Waterworth's reformulation
             double TAU = appsettings->cvalue(context->athlete->cyclist, GC_WBALTAU, 300).toInt();
 
-            // any watts expended in last 200msec?
-            double JOULES = double(rtData.getWatts() - FTP) / 5.00f;
-            if (JOULES < 0) JOULES = 0;
+            // any watts expended since we last looked? every sample the power
+            // device published is used, at whatever rate it publishes
+            TelemetryRing *power = wattsTelemetry >= 0 ? telemetry.channel(wattsTelemetry) : NULL;
+            if (power == NULL) {
+                wbalDevice = -1;
+            } else {
+                if (wbalDevice != wattsTelemetry) {
+                    wbalDevice = wattsTelemetry;
+                    wbalCursor = power->published();
+                    wbalMsecs = telemetry.elapsed();
+                }
+
+                QVector<TelemetrySample> samples;
+                power->read(wbalCursor, samples);
+                foreach(const TelemetrySample &sample, samples) {
+
+                    double JOULES = double(sample.data.getWatts() - FTP) * qBound(0.0, (sample.msecs - wbalMsecs) / 1000.00f, 1.0);
+                    wbalMsecs = sample.msecs;
+                    if (JOULES < 0) JOULES = 0;
 
-            // running total of replenishment
-            wbalr += JOULES * exp((total_msecs/1000.00f) / TAU);
+                    // running total of replenishment
+                    wbalr += JOULES * exp((total_msecs/1000.00f) / TAU);
+                }
+            }
             wbal = WPRIME - (wbalr * exp((-total_msecs/1000.00f) / TAU));
 
             rtData.setWbal(wbal);
 
+            // everyone else consumes the merged sample at their own rate
+            telemetry.publish(TelemetryBus::Session, rtData);
+
             // go update the displays...
             context->notifyTelemetryUpdate(rtData); // signal everyone to update telemetry
         }
@@ -2202,80 +2281,26 @@ void TrainSidebar::warnnoConfig()
     QMessageBox::warning(this, tr("No Devices Configured"), tr("Please configure a device in Preferences."));
 }
 
-template<class T, typename T_GetMethod, typename T_SetMethod, typename T_arg>
-struct ScopedOp
-{
-    T* m_pt;
-    T_SetMethod m_setMethod;
-    T_arg m_argSave;
-
-    ScopedOp(T* pt, T_GetMethod getMethod, T_SetMethod setMethod, T_arg argNew) : m_pt(pt), m_setMethod(setMethod) {
-        m_argSave = (m_pt->*getMethod)();
-        (m_pt->*m_setMethod)(argNew);
-    }
-
-    virtual ~ScopedOp() { (m_pt->*m_setMethod)(m_argSave); }
-};
-
-struct ScopedPrecision : ScopedOp<QTextStream, int (QTextStream::*)() const, void (QTextStream::*)(int), int> {
-    ScopedPrecision(QTextStream* pc, int tempPrecision) : ScopedOp::ScopedOp(pc, &QTextStream::realNumberPrecision, &QTextStream::setRealNumberPrecision, tempPrecision) {}
-};
-
 //----------------------------------------------------------------------
 // DISK UPDATE FUNCTIONS
 //----------------------------------------------------------------------
 void TrainSidebar::diskUpdate()
 {
-    int  secs;
-
-    long torq = 0;
-    QTextStream recordFileStream(recordFile);
-
     if (calibrating) return;
 
-    // convert from milliseconds to secondes
-    total_msecs = session_elapsed_msec + session_time.elapsed();
-    secs = round(total_msecs / 1000.0);
-
-    if (secs <= lastRecordSecs) return; // Avoid duplicates
-    lastRecordSecs = secs;
+    // everything merged since we last looked
+    QVector<TelemetrySample> samples;
+    telemetry.channel(TelemetryBus::Session)->read(recordCursor, samples);
 
-    // GoldenCheetah CVS Format "secs, cad, hr, km, kph, nm, watts, alt, lon, lat, headwind, slope, temp, interval, lrbalance, lte, rte, lps, rps, smo2, thb, o2hb, hhb\n";
+    foreach(const TelemetrySample &sample, samples) {
 
-    recordFileStream    << secs
-                        << "," << displayCadence
-                        << "," << displayHeartRate
-                        << "," << displayDistance
-                        << "," << displaySpeed
-                        << "," << torq
-                        << "," << displayPower;
+        // session time doesn't move whilst paused
+        if (sample.data.getMsecs() <= lastRecordMsecs) continue;
+        lastRecordMsecs = sample.data.getMsecs();
 
-    // QTextStream default precision is 6, location data needs much more than that.
-    // Avoid extra precision for other fields since it isn't needed and would grow
-    // the intermediate file for no reason.
-    {
-        ScopedPrecision tempPrecision(&recordFileStream, 20);
-
-        recordFileStream << "," << displayAltitude
-                         << "," << displayLongitude
-                         << "," << displayLatitude;
-    }
-
-    recordFileStream    << "," // headwind
-                        << "," // slope
-                        << "," // temp
-                        << "," << displayWorkoutLap
-                        << "," << displayLRBalance
-                        << "," << displayLTE
-                        << "," << displayRTE
-                        << "," << displayLPS
-                        << "," << displayRPS
-                        << "," << displaySMO2
-                        << "," << displayTHB
-                        << "," << displayO2HB
-                        << "," << displayHHB
-                        << "," << load
-                        << "," << "\n";
+        recorder.record(sample.data);
+    }
+    recorder.flush();
 }
 
 //----------------------------------------------------------------------
@@ -3257,8 +3282,8 @@ void TrainSidebar::rrData(uint16_t  rrtime, uint8_t count, uint8_t bpm)
 
     QMutexLocker locker(&rrMutex);
 
-    if (status&RT_RECORDING && rrFile == NULL && recordFile != NULL) {
-        QString rrfile = recordFile->fileName().replace("csv", "rr");
+    if (status&RT_RECORDING && rrFile == NULL && recorder.isOpen()) {
+        QString rrfile = recorder.fileName().replace(".gcsl", ".rr");
         //fprintf(stderr, "First r-r, need to open file %s\n", rrfile.toStdString().c_str()); fflush(stderr);
 
         // setup the rr file
@@ -3292,8 +3317,8 @@ void TrainSidebar::vo2Data(double rf, double rmv, double vo2, double vco2, doubl
 {
     QMutexLocker locker(&vo2Mutex);
 
-    if (status&RT_RECORDING && vo2File == NULL && recordFile != NULL) {
-        QString vo2filename = recordFile->fileName().replace("csv", "vo2");
+    if (status&RT_RECORDING && vo2File == NULL && recorder.isOpen()) {
+        QString vo2filename = recorder.fileName().replace(".gcsl", ".vo2");
 
         // setup the rr file
         vo2File = new QFile(vo2filename);
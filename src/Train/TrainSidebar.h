@@ -34,6 +34,8 @@
 #include "PhysicsUtility.h"
 #include "MultiFilterProxyModel.h"
 #include "InfoWidget.h"
+#include "TelemetryBus.h"
+#include "SessionRecorder.h"
 
 // standard stuff
 #include <QDir>
@@ -168,6 +170,8 @@ class TrainSidebar : public GcWindow
         void removeInvalidVideoSync();
         void removeInvalidWorkout();
 
+        void recoverSessions(); // session logs left behind by a crash
+
         void viewChanged(int index);
 
         int  getCalibrationIndex(void);
@@ -202,7 +206,7 @@ class TrainSidebar : public GcWindow
 
         // Timed actions
         void guiUpdate();           // refreshes the telemetry
-        void diskUpdate();          // writes to CSV file
+        void diskUpdate();          // writes to the session log
         void loadUpdate();          // sets Load on CT like devices
 
         // When no config has been setup
@@ -283,8 +287,10 @@ class TrainSidebar : public GcWindow
 
         QString codeWorkoutKey;     // traindb-key of the workout in the case of a code-workout; empty otherwise
         QString codeWorkoutTitle;   // title of the workout in the case of a code-workout; empty otherwise
-        QFile *recordFile;      // where we record!
-        int lastRecordSecs;     // to avoid duplicates
+        TelemetryBus telemetry; // samples from each device and merged
+        SessionRecorder recorder; // where we record!
+        quint32 recordCursor;   // next sample on the bus to record
+        long lastRecordMsecs;   // to avoid duplicates whilst paused
         QMutex rrMutex;         // to coordinate async recording from ANT+ thread
         QFile *rrFile;          // r-r records, if any received.
         QMutex vo2Mutex;         // to coordinate async recording from ANT+ thread
@@ -313,7 +319,7 @@ class TrainSidebar : public GcWindow
         QTimer      *gui_timer,     // refresh the gui
                     *load_timer,    // change the load on the device
                     *start_timer,   // delayed start
-                    *disk_timer;    // write to .CSV file
+                    *disk_timer;    // write to the session log
 
         bool autoConnect;
         bool pendingConfigChange;
@@ -329,6 +335,9 @@ class TrainSidebar : public GcWindow
         QSharedPointer<QFileSystemWatcher> watcher;
         bool calibrating;
         double wbalr, wbal;
+        int wbalDevice;         // power device W'bal is reading from the bus
+        quint32 wbalCursor;     // next sample it will read
+        qint64 wbalMsecs;       // and when the last one was published
 };
 
 class MultiDeviceDialog : public QDialog